@@ -203,10 +203,8 @@ int main() {
         vision_config_path.string(),
         &autonomous_control_service,
         [&server](const std::string &payload) { server.broadcastText(payload); },
-        [&server](auto view, const std::string &payload) {
-            server.broadcastVisionFrame(view, payload);
-        },
-        [&server]() { return server.snapshotVisionSubscriptions(); },
+        [&server](const auto &frame) { return server.broadcastVisionFrame(frame); },
+        [&server]() { return server.snapshotVisionVariants(); },
         autonomous_sink);
 
     server.start();
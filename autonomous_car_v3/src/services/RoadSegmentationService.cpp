@@ -19,6 +19,9 @@
 #include <opencv2/highgui.hpp>
 
 #include "config/LabConfig.hpp"
+#include "frame_transport/SharedFrameRing.hpp"
+#include "pipeline/FramePool.hpp"
+#include "pipeline/PipelinedSegmentationExecutor.hpp"
 #include "pipeline/RoadSegmentationPipeline.hpp"
 #include "pipeline/stages/FrameSource.hpp"
 #include "services/async/LatestValueMailbox.hpp"
@@ -34,9 +37,12 @@
 #include "services/traffic_sign_detection/TrafficSignTelemetry.hpp"
 #include "services/traffic_sign_detection/TrafficSignTemporalFilter.hpp"
 #include "services/traffic_sign_detection/TrafficSignTypes.hpp"
+#include "services/vision/StreamFrameEncoder.hpp"
 #include "services/vision/VisionDebugStream.hpp"
 #include "services/vision/VisionDebugViewRenderer.hpp"
+#include "services/vision/VisionProfileTelemetry.hpp"
 #include "services/vision/VisionRuntimeTelemetry.hpp"
+#include "services/vision/VisionViewWorkerPool.hpp"
 
 namespace autonomous_car::services {
 namespace {
@@ -47,6 +53,7 @@ namespace autoctrl = autonomous_car::services::autonomous_control;
 namespace async = autonomous_car::services::async;
 namespace ts = autonomous_car::services::traffic_sign_detection;
 namespace vision = autonomous_car::services::vision;
+namespace frame_transport = shared::frame_transport;
 
 struct RuntimeState {
     rs::VisionRuntimeConfig vision_config;
@@ -63,6 +70,13 @@ struct CoreFrameSnapshot {
     std::string calibration_status;
 };
 
+// Tudo o que os trabalhos de view do stream leem de um frame; compartilhado entre as views.
+struct StreamFrameContext {
+    std::shared_ptr<CoreFrameSnapshot> snapshot;
+    vision::VisionRuntimeTelemetry runtime_telemetry;
+    ts::TrafficSignFrameResult sign_result;
+};
+
 struct TrafficSignJob {
     ts::TrafficSignInferenceInput input;
     std::int64_t timestamp_ms{0};
@@ -74,8 +88,30 @@ struct RuntimeMetrics {
     std::atomic<double> traffic_sign_fps{0.0};
     std::atomic<double> traffic_sign_inference_ms{0.0};
     std::atomic<double> stream_encode_ms{0.0};
+    std::atomic<double> stream_sent_kbytes_per_sec{0.0};
+    std::atomic<std::uint64_t> stream_skipped_views{0};
+    std::atomic<int> segmentation_pipeline_depth{0};
+    std::atomic<double> segmentation_prepare_ms{0.0};
+    std::atomic<double> segmentation_segment_ms{0.0};
+    std::atomic<double> segmentation_analyze_ms{0.0};
+    std::atomic<double> segmentation_pipeline_added_ms{0.0};
 };
 
+// Media exponencial com o mesmo peso do RateTracker; cada metrica tem um unico escritor.
+void storeSmoothed(std::atomic<double> &metric, double value) {
+    const double previous = metric.load(std::memory_order_relaxed);
+    metric.store(previous <= 0.0 ? value : (previous * 0.75) + (value * 0.25),
+                 std::memory_order_relaxed);
+}
+
+void recordPipelineTiming(RuntimeMetrics &metrics,
+                          const rsl::pipeline::PipelineStageTiming &timing) {
+    storeSmoothed(metrics.segmentation_prepare_ms, timing.prepare_ms);
+    storeSmoothed(metrics.segmentation_segment_ms, timing.segment_ms);
+    storeSmoothed(metrics.segmentation_analyze_ms, timing.analyze_ms);
+    storeSmoothed(metrics.segmentation_pipeline_added_ms, timing.added_latency_ms);
+}
+
 struct RateTracker {
     std::chrono::steady_clock::time_point last_mark =
         std::chrono::steady_clock::time_point::min();
@@ -263,6 +299,37 @@ bool loadRuntimeState(const std::string &vision_config_path, RuntimeState &state
     return true;
 }
 
+vision::StreamEncoderConfig streamEncoderConfigFor(const rs::VisionRuntimeConfig &config) {
+    vision::StreamEncoderConfig encoder_config;
+    encoder_config.jpeg_quality = config.stream_jpeg_quality;
+    encoder_config.jpeg_fast_dct = config.stream_jpeg_fast_dct;
+    encoder_config.jpeg_subsampling =
+        config.stream_jpeg_subsampling == 444   ? vision::JpegChromaSubsampling::Yuv444
+        : config.stream_jpeg_subsampling == 422 ? vision::JpegChromaSubsampling::Yuv422
+                                                : vision::JpegChromaSubsampling::Yuv420;
+    encoder_config.byte_budget_per_second =
+        static_cast<std::size_t>(config.stream_budget_kbytes_per_sec) * 1024;
+    return encoder_config;
+}
+
+// Consumidores locais (traffic_sign_service) recebem o frame capturado cru, sem JPEG.
+void publishLocalFrame(frame_transport::SharedFrameRingWriter &writer,
+                       const cv::Mat &frame, std::int64_t timestamp_ms) {
+    if (frame.depth() != CV_8U || (frame.channels() != 3 && frame.channels() != 1)) {
+        return;
+    }
+
+    frame_transport::FrameView view;
+    view.data = frame.ptr<std::uint8_t>();
+    view.width = frame.cols;
+    view.height = frame.rows;
+    view.step = frame.step;
+    view.format = frame.channels() == 3 ? frame_transport::PixelFormat::Bgr8
+                                        : frame_transport::PixelFormat::Gray8;
+    view.timestamp_ms = timestamp_ms;
+    writer.publish(view);
+}
+
 std::unique_ptr<ts::TrafficSignDetector> createTrafficSignDetector(
     const ts::TrafficSignConfig &config,
     const RoadSegmentationService::TrafficSignDetectorFactory &factory) {
@@ -300,8 +367,21 @@ vision::VisionRuntimeTelemetry captureVisionRuntimeTelemetry(
     telemetry.traffic_sign_inference_ms =
         metrics.traffic_sign_inference_ms.load(std::memory_order_relaxed);
     telemetry.stream_encode_ms = metrics.stream_encode_ms.load(std::memory_order_relaxed);
+    telemetry.stream_sent_kbytes_per_sec =
+        metrics.stream_sent_kbytes_per_sec.load(std::memory_order_relaxed);
+    telemetry.segmentation_pipeline_depth =
+        metrics.segmentation_pipeline_depth.load(std::memory_order_relaxed);
+    telemetry.segmentation_prepare_ms =
+        metrics.segmentation_prepare_ms.load(std::memory_order_relaxed);
+    telemetry.segmentation_segment_ms =
+        metrics.segmentation_segment_ms.load(std::memory_order_relaxed);
+    telemetry.segmentation_analyze_ms =
+        metrics.segmentation_analyze_ms.load(std::memory_order_relaxed);
+    telemetry.segmentation_pipeline_added_ms =
+        metrics.segmentation_pipeline_added_ms.load(std::memory_order_relaxed);
     telemetry.traffic_sign_dropped_frames = sign_dropped_frames;
     telemetry.stream_dropped_frames = stream_dropped_frames;
+    telemetry.stream_skipped_views = metrics.stream_skipped_views.load(std::memory_order_relaxed);
     telemetry.sign_result_age_ms =
         ts::trafficSignResultAgeMs(latest_traffic_sign_result, timestamp_ms);
     return telemetry;
@@ -373,6 +453,7 @@ void RoadSegmentationService::run() {
 
         std::atomic<bool> toggle_pause_requested{false};
         std::atomic<bool> step_requested{false};
+        std::atomic<bool> toggle_profiling_requested{false};
 
         const bool stream_worker_enabled =
             state.vision_config.debug_window_enabled ||
@@ -518,14 +599,20 @@ void RoadSegmentationService::run() {
                                          traffic_sign_debug_window_enabled =
                                              state.vision_config.traffic_sign_debug_window_enabled,
                                          stream_max_fps = state.vision_config.stream_max_fps,
-                                         stream_jpeg_quality =
-                                             state.vision_config.stream_jpeg_quality,
+                                         stream_encoder_config =
+                                             streamEncoderConfigFor(state.vision_config),
+                                         stream_encode_workers = static_cast<std::size_t>(
+                                             state.vision_config.stream_encode_workers),
                                          traffic_sign_window_name =
                                              trafficSignDebugWindowNameFor(window_name_)] {
                 try {
                     vision::VisionDebugViewRenderer vision_renderer;
+                    vision::StreamFrameEncoder stream_encoder(stream_encoder_config);
+                    // Declarado depois do renderer e do encoder: o destrutor espera os
+                    // trabalhos em andamento, que usam os dois.
+                    vision::VisionViewWorkerPool stream_workers(stream_encode_workers);
                     ts::TrafficSignDebugRenderer traffic_sign_renderer;
-                    vision::VisionDebugViewSet last_requested_views;
+                    std::vector<vision::VisionViewVariant> last_requested_variants;
                     auto last_stream_publish = std::chrono::steady_clock::time_point::min();
                     std::shared_ptr<CoreFrameSnapshot> latest_snapshot;
                     const bool local_window_enabled =
@@ -544,9 +631,10 @@ void RoadSegmentationService::run() {
                     bool last_sign_has_debug_roi = false;
                     bool last_sign_has_model_input = false;
 
-                    auto requestedViews = [&] {
-                        return vision_subscription_provider_ ? vision_subscription_provider_()
-                                                             : vision::VisionDebugViewSet{};
+                    auto requestedVariants = [&] {
+                        return vision_subscription_provider_
+                                   ? vision_subscription_provider_()
+                                   : std::vector<vision::VisionViewVariant>{};
                     };
 
                     auto showLocalWindowsAndHandleKeys = [&] {
@@ -589,6 +677,10 @@ void RoadSegmentationService::run() {
                         case 'N':
                             step_requested.store(true);
                             break;
+                        case 't':
+                        case 'T':
+                            toggle_profiling_requested.store(true);
+                            break;
                         default:
                             break;
                         }
@@ -598,14 +690,16 @@ void RoadSegmentationService::run() {
                         auto snapshot = stream_mailbox.waitPopFor(
                             std::chrono::milliseconds(local_window_enabled ? 30 : 100),
                             [&] { return stop_requested_.load(); });
+                        stream_workers.rethrowWorkerError();
                         const bool received_snapshot = snapshot.has_value();
                         if (received_snapshot) {
                             latest_snapshot = std::move(*snapshot);
                         }
 
-                        const auto requested_views = requestedViews();
-                        const bool vision_requests_changed = requested_views != last_requested_views;
-                        last_requested_views = requested_views;
+                        const auto requested_variants = requestedVariants();
+                        const bool vision_requests_changed =
+                            requested_variants != last_requested_variants;
+                        last_requested_variants = requested_variants;
 
                         if (!latest_snapshot) {
                             showLocalWindowsAndHandleKeys();
@@ -630,7 +724,7 @@ void RoadSegmentationService::run() {
                             stream_mailbox.droppedCount());
 
                         bool should_publish_stream = false;
-                        if (vision_frame_publisher_ && !requested_views.empty()) {
+                        if (vision_frame_publisher_ && !requested_variants.empty()) {
                             const auto now = std::chrono::steady_clock::now();
                             if (vision_requests_changed || traffic_sign_visuals_changed) {
                                 should_publish_stream = true;
@@ -654,50 +748,82 @@ void RoadSegmentationService::run() {
                             continue;
                         }
 
-                        std::unordered_map<vision::VisionDebugViewId, cv::Mat,
-                                           vision::VisionDebugViewIdHash>
-                            rendered_views;
-                        auto renderView = [&](vision::VisionDebugViewId view) -> const cv::Mat & {
-                            auto [it, inserted] =
-                                rendered_views.try_emplace(view, cv::Mat{});
-                            if (inserted || it->second.empty()) {
-                                it->second = vision_renderer.render(
-                                    view, latest_snapshot->segmentation_result,
-                                    segmentation_config, source_label,
-                                    latest_snapshot->calibration_status,
-                                    latest_snapshot->control_snapshot, runtime_telemetry,
-                                    renderable_sign_result);
-                            }
-                            return it->second;
-                        };
+                        if (should_update_dashboard) {
+                            current_dashboard = vision_renderer.render(
+                                vision::VisionDebugViewId::Dashboard,
+                                latest_snapshot->segmentation_result, segmentation_config,
+                                source_label, latest_snapshot->calibration_status,
+                                latest_snapshot->control_snapshot, runtime_telemetry,
+                                renderable_sign_result);
+                        }
 
-                        double encode_ms = 0.0;
                         if (should_publish_stream) {
-                            const auto encode_started = std::chrono::steady_clock::now();
+                            // Cada view vira um trabalho no pool e e publicada assim que fica
+                            // pronta; view com o frame anterior ainda em andamento e pulada.
+                            const auto frame_context = std::make_shared<const StreamFrameContext>(
+                                StreamFrameContext{latest_snapshot, runtime_telemetry,
+                                                   renderable_sign_result});
+                            bool submitted = false;
                             for (const auto view : vision::allVisionDebugViews()) {
-                                if (requested_views.find(view) == requested_views.end()) {
+                                std::vector<vision::VisionViewVariant> view_variants;
+                                for (const auto &variant : requested_variants) {
+                                    if (variant.view == view) {
+                                        view_variants.push_back(variant);
+                                    }
+                                }
+                                if (view_variants.empty()) {
                                     continue;
                                 }
 
-                                const cv::Mat &frame = renderView(view);
-                                const auto payload = vision::buildVisionFrameJson(
-                                    view, frame, latest_snapshot->timestamp_ms, stream_jpeg_quality);
-                                if (payload) {
-                                    vision_frame_publisher_(view, *payload);
-                                }
+                                // O dashboard da janela local ja foi desenhado com este frame.
+                                cv::Mat prerendered =
+                                    view == vision::VisionDebugViewId::Dashboard &&
+                                            should_update_dashboard
+                                        ? current_dashboard
+                                        : cv::Mat{};
+                                submitted |= stream_workers.trySubmit(
+                                    view, [&, view, frame_context,
+                                           view_variants = std::move(view_variants),
+                                           prerendered = std::move(prerendered)] {
+                                        const auto encode_started = std::chrono::steady_clock::now();
+                                        const CoreFrameSnapshot &snapshot = *frame_context->snapshot;
+                                        const cv::Mat frame =
+                                            prerendered.empty()
+                                                ? vision_renderer.render(
+                                                      view, snapshot.segmentation_result,
+                                                      segmentation_config, source_label,
+                                                      snapshot.calibration_status,
+                                                      snapshot.control_snapshot,
+                                                      frame_context->runtime_telemetry,
+                                                      frame_context->sign_result)
+                                                : prerendered;
+                                        for (const auto &variant : view_variants) {
+                                            const cv::Mat variant_frame =
+                                                vision::renderVisionViewVariant(frame, variant);
+                                            if (const auto *encoded = stream_encoder.encode(
+                                                    view, variant_frame, snapshot.timestamp_ms,
+                                                    variant.label)) {
+                                                stream_encoder.recordSent(
+                                                    view, vision_frame_publisher_(*encoded));
+                                            }
+                                        }
+                                        runtime_metrics.stream_encode_ms.store(
+                                            std::chrono::duration<double, std::milli>(
+                                                std::chrono::steady_clock::now() - encode_started)
+                                                .count(),
+                                            std::memory_order_relaxed);
+                                        runtime_metrics.stream_sent_kbytes_per_sec.store(
+                                            stream_encoder.sentBytesPerSecond() / 1024.0,
+                                            std::memory_order_relaxed);
+                                    });
+                            }
+                            runtime_metrics.stream_skipped_views.store(
+                                stream_workers.skippedCount(), std::memory_order_relaxed);
+                            if (submitted) {
+                                runtime_metrics.stream_fps.store(
+                                    rate_tracker.mark(std::chrono::steady_clock::now()),
+                                    std::memory_order_relaxed);
                             }
-                            encode_ms = std::chrono::duration<double, std::milli>(
-                                            std::chrono::steady_clock::now() - encode_started)
-                                            .count();
-                            runtime_metrics.stream_encode_ms.store(encode_ms,
-                                                                   std::memory_order_relaxed);
-                            runtime_metrics.stream_fps.store(
-                                rate_tracker.mark(std::chrono::steady_clock::now()),
-                                std::memory_order_relaxed);
-                        }
-
-                        if (should_update_dashboard) {
-                            current_dashboard = renderView(vision::VisionDebugViewId::Dashboard).clone();
                         }
 
                         if (should_update_traffic_sign_debug) {
@@ -714,7 +840,7 @@ void RoadSegmentationService::run() {
 
                         if (local_window_enabled) {
                             showLocalWindowsAndHandleKeys();
-                        } else if (encode_ms <= 0.0 && received_snapshot) {
+                        } else if (requested_variants.empty() && received_snapshot) {
                             runtime_metrics.stream_encode_ms.store(0.0, std::memory_order_relaxed);
                         }
                     }
@@ -733,44 +859,38 @@ void RoadSegmentationService::run() {
         std::thread core_thread([&, source_label = state.source_label] {
             try {
                 rsl::pipeline::RoadSegmentationPipeline pipeline(state.segmentation_config);
+                // Imagem estatica reprocessa um unico frame por vez; nao ha o que sobrepor.
+                std::unique_ptr<rsl::pipeline::PipelinedSegmentationExecutor> executor;
+                if (state.vision_config.segmentation_pipeline_depth >=
+                        static_cast<int>(rsl::pipeline::PipelinedSegmentationExecutor::kMinDepth) &&
+                    !state.source->isStaticImage()) {
+                    executor = std::make_unique<rsl::pipeline::PipelinedSegmentationExecutor>(
+                        state.segmentation_config,
+                        static_cast<std::size_t>(state.vision_config.segmentation_pipeline_depth));
+                    runtime_metrics.segmentation_pipeline_depth.store(
+                        static_cast<int>(executor->depth()), std::memory_order_relaxed);
+                }
+                const rsl::pipeline::FramePool &frame_pool = rsl::pipeline::FramePool::shared();
+                std::unique_ptr<frame_transport::SharedFrameRingWriter> local_frame_ring;
+                if (!state.vision_config.local_frame_ring_name.empty()) {
+                    local_frame_ring = std::make_unique<frame_transport::SharedFrameRingWriter>(
+                        state.vision_config.local_frame_ring_name);
+                }
                 cv::Mat current_frame;
                 bool paused = state.source->isStaticImage();
                 bool step_once = true;
                 bool need_reprocess = true;
                 auto next_traffic_sign_enqueue = std::chrono::steady_clock::time_point::min();
                 auto last_telemetry_enqueue = std::chrono::steady_clock::time_point::min();
+                auto last_profile_enqueue = std::chrono::steady_clock::time_point::min();
+                auto last_capture = rsl::pipeline::CaptureRequest::None;
                 RateTracker rate_tracker;
+                rsl::pipeline::StageProfiler &profiler =
+                    executor ? executor->profiler() : pipeline.profiler();
 
-                while (!stop_requested_.load()) {
-                    if (toggle_pause_requested.exchange(false) && !state.source->isStaticImage()) {
-                        paused = !paused;
-                    }
-                    if (step_requested.exchange(false) && !state.source->isStaticImage() && paused) {
-                        step_once = true;
-                    }
-
-                    const bool should_read_static_image =
-                        state.source->isStaticImage() && (need_reprocess || current_frame.empty());
-                    const bool should_read_dynamic_frame =
-                        !state.source->isStaticImage() && !need_reprocess &&
-                        (!paused || step_once || current_frame.empty());
-                    bool processed_frame = false;
-
-                    if (should_read_static_image || should_read_dynamic_frame) {
-                        if (!state.source->read(current_frame) || current_frame.empty()) {
-                            std::cerr << "[RoadSegmentationService] Falha ao ler a fonte de video."
-                                      << std::endl;
-                            requestStop();
-                            break;
-                        }
-                    }
-
-                    if (need_reprocess || should_read_static_image || should_read_dynamic_frame) {
-                        processed_frame = true;
-                        const auto processing_started = std::chrono::steady_clock::now();
-                        rsl::pipeline::RoadSegmentationResult segmentation_result =
-                            pipeline.process(current_frame);
-                        const auto timestamp_ms = currentTimestampMs();
+                auto publishSegmentationResult =
+                    [&](rsl::pipeline::RoadSegmentationResult segmentation_result,
+                        std::string calibration_status, std::int64_t timestamp_ms) {
 
                         autoctrl::AutonomousControlSnapshot control_snapshot;
                         if (control_service_) {
@@ -786,7 +906,7 @@ void RoadSegmentationService::run() {
                         snapshot->segmentation_result = std::move(segmentation_result);
                         snapshot->control_snapshot = control_snapshot;
                         snapshot->timestamp_ms = timestamp_ms;
-                        snapshot->calibration_status = pipeline.calibrationStatus();
+                        snapshot->calibration_status = std::move(calibration_status);
 
                         runtime_metrics.core_fps.store(rate_tracker.mark(std::chrono::steady_clock::now()),
                                                        std::memory_order_relaxed);
@@ -795,35 +915,6 @@ void RoadSegmentationService::run() {
                             stream_mailbox.offer(snapshot);
                         }
 
-                        if (state.traffic_sign_config.enabled) {
-                            const auto now = std::chrono::steady_clock::now();
-                            if (next_traffic_sign_enqueue ==
-                                    std::chrono::steady_clock::time_point::min() ||
-                                now >= next_traffic_sign_enqueue) {
-                                const ts::TrafficSignRoi roi = ts::buildTrafficSignRoi(
-                                    current_frame.size(),
-                                    state.traffic_sign_config.roi_left_ratio,
-                                    state.traffic_sign_config.roi_right_ratio,
-                                    state.traffic_sign_config.roi_top_ratio,
-                                    state.traffic_sign_config.roi_bottom_ratio,
-                                    state.traffic_sign_config.debug_roi_enabled);
-                                if (roi.frame_rect.area() > 0) {
-                                    TrafficSignJob job;
-                                    job.timestamp_ms = timestamp_ms;
-                                    job.input.frame = current_frame(roi.frame_rect).clone();
-                                    job.input.full_frame_size = current_frame.size();
-                                    job.input.roi = roi;
-                                    job.input.capture_debug_frames =
-                                        state.vision_config.traffic_sign_debug_window_enabled;
-                                    traffic_sign_mailbox.offer(std::move(job));
-                                    next_traffic_sign_enqueue =
-                                        now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
-                                                  std::chrono::duration<double>(
-                                                      1.0 / state.vision_config.traffic_sign_target_fps));
-                                }
-                            }
-                        }
-
                         const auto now = std::chrono::steady_clock::now();
                         if (telemetry_publisher_ &&
                             shouldPublishNow(state.vision_config.telemetry_max_fps, now,
@@ -838,8 +929,150 @@ void RoadSegmentationService::run() {
                                     autoctrl::buildAutonomousControlTelemetryJson(control_snapshot));
                             }
                         }
+                        if (telemetry_publisher_ && profiler.enabled() &&
+                            shouldPublishNow(state.vision_config.telemetry_max_fps, now,
+                                             last_profile_enqueue)) {
+                            telemetry_queue.publish("telemetry.vision_profile",
+                                                    vision::buildVisionProfileTelemetryJson(
+                                                        profiler.snapshot(), source_label,
+                                                        timestamp_ms));
+                        }
+                    };
+
+                auto publishPipelinedResult = [&](rsl::pipeline::PipelinedFrameResult ready) {
+                    recordPipelineTiming(runtime_metrics, ready.timing);
+                    publishSegmentationResult(std::move(ready.result), executor->calibrationStatus(),
+                                              ready.timestamp_ms);
+                };
+
+                // A janela local mostra o dashboard completo; a janela de placas nao desenha
+                // nenhuma imagem da segmentacao.
+                auto currentCaptureRequest = [&] {
+                    if (state.vision_config.debug_window_enabled) {
+                        return rsl::pipeline::CaptureRequest::All;
+                    }
+                    if (!vision_frame_publisher_ || !vision_subscription_provider_) {
+                        return rsl::pipeline::CaptureRequest::None;
+                    }
+                    return vision::captureRequestForViews(
+                        vision::viewsOf(vision_subscription_provider_()));
+                };
+
+                auto enqueueTrafficSignJob = [&](std::int64_t timestamp_ms) {
+                    if (!state.traffic_sign_config.enabled) {
+                        return;
+                    }
+
+                    const auto now = std::chrono::steady_clock::now();
+                    if (next_traffic_sign_enqueue != std::chrono::steady_clock::time_point::min() &&
+                        now < next_traffic_sign_enqueue) {
+                        return;
+                    }
+
+                    const ts::TrafficSignRoi roi = ts::buildTrafficSignRoi(
+                        current_frame.size(), state.traffic_sign_config.roi_left_ratio,
+                        state.traffic_sign_config.roi_right_ratio,
+                        state.traffic_sign_config.roi_top_ratio,
+                        state.traffic_sign_config.roi_bottom_ratio,
+                        state.traffic_sign_config.debug_roi_enabled);
+                    if (roi.frame_rect.area() <= 0) {
+                        return;
+                    }
+
+                    TrafficSignJob job;
+                    job.timestamp_ms = timestamp_ms;
+                    // O frame capturado e imutavel (a proxima leitura vai para outro bloco do
+                    // pool), entao o job so precisa de uma view da ROI.
+                    job.input.frame = frame_pool.owns(current_frame)
+                                          ? current_frame(roi.frame_rect)
+                                          : frame_pool.copyOf(current_frame(roi.frame_rect));
+                    job.input.full_frame_size = current_frame.size();
+                    job.input.roi = roi;
+                    job.input.capture_debug_frames =
+                        state.vision_config.traffic_sign_debug_window_enabled;
+                    traffic_sign_mailbox.offer(std::move(job));
+                    next_traffic_sign_enqueue =
+                        now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                  std::chrono::duration<double>(
+                                      1.0 / state.vision_config.traffic_sign_target_fps));
+                };
+
+                while (!stop_requested_.load()) {
+                    if (toggle_pause_requested.exchange(false) && !state.source->isStaticImage()) {
+                        paused = !paused;
+                    }
+                    if (step_requested.exchange(false) && !state.source->isStaticImage() && paused) {
+                        step_once = true;
+                    }
+                    if (toggle_profiling_requested.exchange(false)) {
+                        profiler.setEnabled(!profiler.enabled());
+                        profiler.reset();
+                        if (telemetry_publisher_) {
+                            telemetry_queue.publish("telemetry.vision_profile",
+                                                    vision::buildVisionProfileTelemetryJson(
+                                                        profiler.snapshot(), source_label,
+                                                        currentTimestampMs()));
+                        }
+                    }
+
+                    const auto capture = currentCaptureRequest();
+                    if ((capture | last_capture) != last_capture && !current_frame.empty() &&
+                        (paused || state.source->isStaticImage())) {
+                        // Um viewer novo com o video parado precisa das imagens do frame atual.
+                        need_reprocess = true;
+                    }
+                    last_capture = capture;
+
+                    const bool should_read_static_image =
+                        state.source->isStaticImage() && (need_reprocess || current_frame.empty());
+                    const bool should_read_dynamic_frame =
+                        !state.source->isStaticImage() && !need_reprocess &&
+                        (!paused || step_once || current_frame.empty());
+                    bool processed_frame = false;
+
+                    if (should_read_static_image || should_read_dynamic_frame) {
+                        if (current_frame.u != nullptr && current_frame.u->refcount > 1) {
+                            // Ainda lido pelo job de placas ou por um resultado retido.
+                            current_frame.release();
+                        }
+                        frame_pool.bind(current_frame);
+                        if (!state.source->read(current_frame) || current_frame.empty()) {
+                            std::cerr << "[RoadSegmentationService] Falha ao ler a fonte de video."
+                                      << std::endl;
+                            requestStop();
+                            break;
+                        }
+                        if (local_frame_ring) {
+                            publishLocalFrame(*local_frame_ring, current_frame, currentTimestampMs());
+                        }
+                    }
+
+                    if (need_reprocess || should_read_static_image || should_read_dynamic_frame) {
+                        processed_frame = true;
+                        if (executor) {
+                            while (executor->full()) {
+                                publishPipelinedResult(executor->waitPop());
+                            }
+                            // Controle e job de placas usam o instante do submit.
+                            const std::int64_t submitted_at_ms = currentTimestampMs();
+                            executor->submit(current_frame, capture, submitted_at_ms);
+                            enqueueTrafficSignJob(submitted_at_ms);
+                            while (auto ready = executor->tryPop()) {
+                                publishPipelinedResult(std::move(*ready));
+                            }
+                            // Pausado, o frame do passo precisa aparecer sem esperar o proximo.
+                            while (paused && executor->inFlight() > 0) {
+                                publishPipelinedResult(executor->waitPop());
+                            }
+                        } else {
+                            rsl::pipeline::RoadSegmentationResult segmentation_result =
+                                pipeline.process(current_frame, capture);
+                            const std::int64_t timestamp_ms = currentTimestampMs();
+                            publishSegmentationResult(std::move(segmentation_result),
+                                                      pipeline.calibrationStatus(), timestamp_ms);
+                            enqueueTrafficSignJob(timestamp_ms);
+                        }
 
-                        (void)processing_started;
                         step_once = false;
                         need_reprocess = false;
                     }
@@ -1,10 +1,12 @@
 #pragma once
 
 #include <atomic>
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "services/vision/VisionDebugStream.hpp"
 
@@ -23,11 +25,12 @@ namespace autonomous_car::services {
 class RoadSegmentationService {
 public:
     using TelemetryPublisher = std::function<void(const std::string &)>;
+    // Recebe a imagem ja codificada e devolve os bytes enfileirados por todos os assinantes.
     using VisionFramePublisher =
-        std::function<void(autonomous_car::services::vision::VisionDebugViewId,
-                           const std::string &)>;
+        std::function<std::size_t(const autonomous_car::services::vision::EncodedVisionFrame &)>;
+    // Variantes distintas pedidas pelas sessoes.
     using VisionSubscriptionProvider = std::function<
-        autonomous_car::services::vision::VisionDebugViewSet()>;
+        std::vector<autonomous_car::services::vision::VisionViewVariant>()>;
     using ControlSink =
         std::function<void(const autonomous_car::services::autonomous_control::AutonomousControlSnapshot &)>;
     using TrafficSignDetectorFactory = std::function<std::unique_ptr<
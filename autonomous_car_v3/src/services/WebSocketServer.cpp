@@ -3,19 +3,24 @@
 #include <arpa/inet.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include <algorithm>
 #include <array>
 #include <atomic>
 #include <cerrno>
+#include <chrono>
 #include <cstdint>
 #include <cstring>
 #include <iostream>
-#include <limits>
+#include <iterator>
 #include <optional>
 #include <sstream>
+#include <string_view>
 #include <string>
 #include <thread>
 #include <utility>
@@ -26,7 +31,17 @@
 
 namespace {
 constexpr char kWebSocketGuid[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
-constexpr int kClientSendTimeoutMs = 40;
+// Limites por cliente: a memoria de uma conexao nao cresce com a lentidao dela.
+constexpr std::size_t kMaxHandshakeBytes = 8 * 1024;
+constexpr std::size_t kMaxInboundPayloadBytes = 64 * 1024;
+constexpr std::size_t kReadChunkBytes = 16 * 1024;
+constexpr int kMaxEpollEvents = 32;
+// Cabecalho + payload de ate 8 frames por sendmsg.
+constexpr std::size_t kMaxSendSegments = 16;
+constexpr auto kClientTelemetryInterval = std::chrono::seconds(1);
+// Ids de epoll reservados; sessoes comecam em 1.
+constexpr std::uint64_t kListenerEventId = 0;
+constexpr std::uint64_t kWakeEventId = ~std::uint64_t{0};
 
 class Sha1 {
 public:
@@ -179,54 +194,6 @@ std::string computeAcceptKey(const std::string &client_key) {
     return base64Encode(sha1(client_key + kWebSocketGuid));
 }
 
-bool recvAll(int socket_fd, void *buffer, size_t length) {
-    auto *bytes = static_cast<unsigned char *>(buffer);
-    size_t received = 0;
-    while (received < length) {
-        ssize_t chunk = recv(socket_fd, bytes + received, length - received, 0);
-        if (chunk < 0 && errno == EINTR) {
-            continue;
-        }
-        if (chunk <= 0) {
-            return false;
-        }
-        received += static_cast<size_t>(chunk);
-    }
-    return true;
-}
-
-bool sendAll(int socket_fd, const void *buffer, size_t length) {
-    const auto *bytes = static_cast<const unsigned char *>(buffer);
-    size_t sent_total = 0;
-    while (sent_total < length) {
-        const ssize_t sent = send(socket_fd, bytes + sent_total, length - sent_total, 0);
-        if (sent < 0 && errno == EINTR) {
-            continue;
-        }
-        if (sent <= 0) {
-            return false;
-        }
-        sent_total += static_cast<size_t>(sent);
-    }
-    return true;
-}
-
-std::optional<std::string> readHttpRequest(int client_fd) {
-    std::string request;
-    std::array<char, 1024> buffer{};
-    while (true) {
-        const ssize_t bytes = recv(client_fd, buffer.data(), buffer.size(), 0);
-        if (bytes <= 0) {
-            return std::nullopt;
-        }
-        request.append(buffer.data(), static_cast<size_t>(bytes));
-        if (request.find("\r\n\r\n") != std::string::npos) {
-            break;
-        }
-    }
-    return request;
-}
-
 std::optional<std::string> extractHeader(const std::string &request, const std::string &header_name) {
     std::istringstream stream(request);
     std::string line;
@@ -247,104 +214,19 @@ std::optional<std::string> extractHeader(const std::string &request, const std::
     return std::nullopt;
 }
 
-bool sendHandshakeResponse(int client_fd, const std::string &accept_key) {
+std::string buildHandshakeResponse(const std::string &accept_key) {
     std::ostringstream response;
     response << "HTTP/1.1 101 Switching Protocols\r\n"
              << "Upgrade: websocket\r\n"
              << "Connection: Upgrade\r\n"
              << "Sec-WebSocket-Accept: " << accept_key << "\r\n\r\n";
-    const auto response_str = response.str();
-    return sendAll(client_fd, response_str.data(), response_str.size());
-}
-
-std::optional<std::string> readTextFrame(int client_fd) {
-    unsigned char header[2];
-    if (!recvAll(client_fd, header, sizeof(header))) {
-        return std::nullopt;
-    }
-
-    const bool fin = (header[0] & 0x80) != 0;
-    const unsigned char opcode = header[0] & 0x0F;
-    const bool masked = (header[1] & 0x80) != 0;
-    uint64_t payload_length = header[1] & 0x7F;
-
-    if (!fin || !masked) {
-        return std::nullopt;
-    }
-
-    if (opcode == 0x8) {
-        return std::nullopt;
-    }
-
-    if (payload_length == 126) {
-        unsigned char extended[2];
-        if (!recvAll(client_fd, extended, sizeof(extended))) {
-            return std::nullopt;
-        }
-        payload_length = (static_cast<uint64_t>(extended[0]) << 8) | extended[1];
-    } else if (payload_length == 127) {
-        unsigned char extended[8];
-        if (!recvAll(client_fd, extended, sizeof(extended))) {
-            return std::nullopt;
-        }
-        payload_length = 0;
-        for (int i = 0; i < 8; ++i) {
-            payload_length = (payload_length << 8) | extended[i];
-        }
-    }
-
-    unsigned char mask_key[4];
-    if (!recvAll(client_fd, mask_key, sizeof(mask_key))) {
-        return std::nullopt;
-    }
-
-    if (payload_length > static_cast<uint64_t>(std::numeric_limits<size_t>::max())) {
-        return std::nullopt;
-    }
-
-    std::string payload(static_cast<size_t>(payload_length), '\0');
-    if (!recvAll(client_fd, payload.data(), static_cast<size_t>(payload_length))) {
-        return std::nullopt;
-    }
-
-    for (uint64_t i = 0; i < payload_length; ++i) {
-        payload[static_cast<size_t>(i)] =
-            payload[static_cast<size_t>(i)] ^ mask_key[i % 4];
-    }
-
-    if (opcode != 0x1) {
-        return std::nullopt;
-    }
-
-    return payload;
-}
-
-bool sendTextFrame(int client_fd, const std::string &payload) {
-    std::vector<unsigned char> frame;
-    frame.reserve(payload.size() + 10);
-    frame.push_back(0x81);
-
-    const size_t payload_length = payload.size();
-    if (payload_length <= 125) {
-        frame.push_back(static_cast<unsigned char>(payload_length));
-    } else if (payload_length <= 0xFFFFu) {
-        frame.push_back(126);
-        frame.push_back(static_cast<unsigned char>((payload_length >> 8) & 0xFFu));
-        frame.push_back(static_cast<unsigned char>(payload_length & 0xFFu));
-    } else {
-        frame.push_back(127);
-        for (int shift = 56; shift >= 0; shift -= 8) {
-            frame.push_back(static_cast<unsigned char>((payload_length >> shift) & 0xFFu));
-        }
-    }
-
-    frame.insert(frame.end(), payload.begin(), payload.end());
-    return sendAll(client_fd, frame.data(), frame.size());
+    return response.str();
 }
 
-bool sendCloseFrame(int client_fd) {
-    const unsigned char frame[2] = {0x88, 0x00};
-    return sendAll(client_fd, frame, sizeof(frame));
+const std::shared_ptr<const autonomous_car::services::websocket::OutboundFrame> &closeFrame() {
+    static const auto frame =
+        autonomous_car::services::websocket::makeRawFrame(std::string("\x88\x00", 2));
+    return frame;
 }
 
 void configureClientSocket(int client_fd) {
@@ -353,15 +235,13 @@ void configureClientSocket(int client_fd) {
         std::cerr << "Aviso: falha ao ativar TCP_NODELAY no cliente WebSocket: "
                   << std::strerror(errno) << std::endl;
     }
+}
 
-    timeval send_timeout{};
-    send_timeout.tv_sec = 0;
-    send_timeout.tv_usec = kClientSendTimeoutMs * 1000;
-    if (setsockopt(client_fd, SOL_SOCKET, SO_SNDTIMEO, &send_timeout,
-                   sizeof(send_timeout)) < 0) {
-        std::cerr << "Aviso: falha ao configurar timeout de envio do cliente WebSocket: "
-                  << std::strerror(errno) << std::endl;
-    }
+bool watch(int epoll_fd, int op, int fd, std::uint32_t events, std::uint64_t id) {
+    epoll_event event{};
+    event.events = events;
+    event.data.u64 = id;
+    return epoll_ctl(epoll_fd, op, fd, &event) == 0;
 }
 
 } // namespace
@@ -372,15 +252,16 @@ WebSocketServer::WebSocketServer(const std::string &host, int port,
                                  controllers::CommandRouter &command_router,
                                  ConfigUpdateHandler config_handler,
                                  DrivingModeProvider mode_provider,
-                                 SignalDetectedHandler signal_detected_handler)
+                                 SignalDetectedHandler signal_detected_handler,
+                                 websocket::SendQueuePolicy send_policy)
     : host_{host},
       port_{port},
       command_router_{command_router},
       config_handler_{std::move(config_handler)},
       driving_mode_provider_{std::move(mode_provider)},
       signal_detected_handler_{std::move(signal_detected_handler)},
-      running_{false},
-      server_fd_{-1} {}
+      send_policy_{send_policy},
+      running_{false} {}
 
 WebSocketServer::~WebSocketServer() { stop(); }
 
@@ -389,89 +270,290 @@ void WebSocketServer::start() {
         return;
     }
 
+    if (!openListener()) {
+        running_.store(false);
+        return;
+    }
+
     server_thread_ = std::thread(&WebSocketServer::run, this);
 }
 
 void WebSocketServer::stop() {
-    const bool was_running = running_.exchange(false);
-
-    if (was_running) {
-        const int fd = server_fd_.exchange(-1);
-        if (fd >= 0) {
-            shutdown(fd, SHUT_RDWR);
-            close(fd);
-        }
-
-        const auto sessions = snapshotSessions();
-        for (const auto &session : sessions) {
-            shutdownSession(session, true);
-        }
+    if (running_.exchange(false) && wake_fd_ >= 0) {
+        const std::uint64_t signal = 1;
+        [[maybe_unused]] const auto written = write(wake_fd_, &signal, sizeof(signal));
     }
 
     if (server_thread_.joinable()) {
         server_thread_.join();
     }
 
-    for (auto &thread : client_threads_) {
-        if (thread.joinable()) {
-            thread.join();
+    // So depois do join: o reactor e os broadcasts ainda podem usar estes fds ate aqui.
+    for (int *fd : {&server_fd_, &epoll_fd_, &wake_fd_}) {
+        if (*fd >= 0) {
+            close(*fd);
+            *fd = -1;
         }
     }
-    client_threads_.clear();
 }
 
 void WebSocketServer::broadcastText(const std::string &payload) {
-    const auto sessions = snapshotSessions();
-    for (const auto &session : sessions) {
-        if (!session) {
-            continue;
-        }
+    broadcastText(std::make_shared<const std::string>(payload));
+}
 
-        std::lock_guard<std::mutex> lock(session->send_mutex);
+void WebSocketServer::broadcastVisionFrame(vision::VisionDebugViewId view,
+                                           const std::string &payload) {
+    broadcastVisionFrame(view, std::make_shared<const std::string>(payload));
+}
+
+void WebSocketServer::broadcastText(std::shared_ptr<const std::string> payload) {
+    auto sessions = snapshotSessions();
+    const auto compact_begin = std::stable_partition(
+        sessions.begin(), sessions.end(), [](const ClientSessionPtr &session) {
+            return !session->compact_telemetry.load(std::memory_order_relaxed);
+        });
+    std::vector<ClientSessionPtr> compact_sessions(std::make_move_iterator(compact_begin),
+                                                   std::make_move_iterator(sessions.end()));
+    sessions.erase(compact_begin, sessions.end());
+
+    std::shared_ptr<const websocket::OutboundFrame> full_frame;
+    if (!sessions.empty()) {
+        full_frame = websocket::makeTextFrame(payload);
+        broadcastFrame(sessions, websocket::OutboundTopic::Telemetry, 0, full_frame, "texto");
+    }
+    if (compact_sessions.empty()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(compact_telemetry_mutex_);
+    const auto messages = compact_telemetry_encoder_.encode(*payload);
+    if (messages.empty()) {
+        // Nao e telemetria: segue inteiro tambem para as sessoes compactas.
+        broadcastFrame(compact_sessions, websocket::OutboundTopic::Telemetry, 0,
+                       full_frame ? full_frame : websocket::makeTextFrame(std::move(payload)),
+                       "texto");
+        return;
+    }
+    const auto makeFrames = [](const std::vector<std::string> &texts) {
+        std::vector<std::shared_ptr<const websocket::OutboundFrame>> frames;
+        for (const auto &text : texts) {
+            frames.push_back(websocket::makeTextFrame(std::make_shared<const std::string>(text)));
+        }
+        return frames;
+    };
+    const auto frames = makeFrames(messages);
+    std::vector<std::shared_ptr<const websocket::OutboundFrame>> resync_frames;
+    const std::string &type = compact_telemetry_encoder_.lastType();
+    for (const auto &session : compact_sessions) {
+        std::lock_guard<std::mutex> send_lock(session->send_mutex);
         if (!session->alive.load()) {
             continue;
         }
-
-        if (!sendTextFrame(session->fd, payload)) {
-            const int send_error = errno;
-            session->alive.store(false);
-            shutdown(session->fd, SHUT_RDWR);
-            std::cerr << "Cliente WebSocket " << session->id
-                      << " desconectado apos falha no envio de texto: "
-                      << std::strerror(send_error) << std::endl;
+        // Quem perdeu telemetria na fila recebe schema e keyframe em vez do delta compartilhado.
+        websocket::CompactTelemetrySession &compact = session->compact;
+        compact.observeDrops(session->outbound.stats().dropped_telemetry);
+        const bool resync = compact.needsResync(type);
+        if (resync && resync_frames.empty()) {
+            resync_frames = makeFrames(compact_telemetry_encoder_.resyncMessages());
+        }
+        bool sent = true;
+        for (const auto &frame : resync ? resync_frames : frames) {
+            if (!sendFrameLocked(*session, websocket::OutboundTopic::Telemetry, 0, frame)) {
+                failSessionLocked(*session, "telemetria compacta");
+                sent = false;
+                break;
+            }
+        }
+        if (sent) {
+            compact.markSynced(type);
+            compact.observeDrops(session->outbound.stats().dropped_telemetry);
         }
     }
 }
 
 void WebSocketServer::broadcastVisionFrame(vision::VisionDebugViewId view,
-                                           const std::string &payload) {
-    const auto sessions = snapshotSessions();
-    for (const auto &session : sessions) {
-        if (!session || !vision_subscription_registry_.hasSubscription(session->id, view)) {
+                                           std::shared_ptr<const std::string> payload) {
+    auto sessions = snapshotSessions();
+    sessions.erase(std::remove_if(sessions.begin(), sessions.end(),
+                                  [&](const ClientSessionPtr &session) {
+                                      return !vision_subscription_registry_.hasSubscription(
+                                          session->id, view);
+                                  }),
+                   sessions.end());
+    if (sessions.empty()) {
+        return;
+    }
+
+    const std::string description = std::string("view ").append(vision::toString(view));
+    broadcastFrame(sessions, websocket::OutboundTopic::VisionFrame, static_cast<int>(view),
+                   websocket::makeTextFrame(std::move(payload)), description);
+}
+
+std::size_t WebSocketServer::broadcastVisionFrame(const vision::EncodedVisionFrame &frame) {
+    std::vector<ClientSessionPtr> json_sessions;
+    std::vector<ClientSessionPtr> binary_sessions;
+    for (auto &session : snapshotSessions()) {
+        const auto format = vision_subscription_registry_.subscriptionFormat(
+            session->id, frame.view, frame.variant);
+        if (!format) {
             continue;
         }
+        (*format == vision::VisionFrameFormat::Binary ? binary_sessions : json_sessions)
+            .push_back(std::move(session));
+    }
+
+    const std::string description =
+        frame.variant.empty() ? std::string("view ").append(vision::toString(frame.view))
+                              : "view " + frame.variant;
+    // Cada variante tem a propria vaga na fila KeepLatest; a view inteira fica com a da view.
+    const auto key = vision_subscription_registry_.frameQueueKey(frame.view, frame.variant);
+    if (!key) {
+        return 0;
+    }
+    // Cada formato so e montado se alguma sessao o pediu; base64 nao existe no caminho binario.
+    std::size_t queued_bytes = 0;
+    if (!json_sessions.empty()) {
+        queued_bytes += broadcastFrame(
+            json_sessions, websocket::OutboundTopic::VisionFrame, *key,
+            websocket::makeTextFrame(
+                std::make_shared<const std::string>(vision::buildVisionFrameJson(frame))),
+            description);
+    }
+    if (!binary_sessions.empty()) {
+        queued_bytes += broadcastFrame(
+            binary_sessions, websocket::OutboundTopic::VisionFrame, *key,
+            websocket::makeBinaryFrame(
+                std::make_shared<const std::string>(vision::buildVisionFrameBinary(frame))),
+            description);
+    }
+    return queued_bytes;
+}
 
+std::size_t WebSocketServer::broadcastFrame(
+    const std::vector<ClientSessionPtr> &sessions, websocket::OutboundTopic topic, int key,
+    const std::shared_ptr<const websocket::OutboundFrame> &frame, std::string_view description) {
+    std::size_t queued_bytes = 0;
+    for (const auto &session : sessions) {
         std::lock_guard<std::mutex> lock(session->send_mutex);
         if (!session->alive.load()) {
             continue;
         }
-
-        if (!sendTextFrame(session->fd, payload)) {
-            const int send_error = errno;
-            session->alive.store(false);
-            shutdown(session->fd, SHUT_RDWR);
-            std::cerr << "Cliente WebSocket " << session->id
-                      << " desconectado apos falha no envio da view "
-                      << vision::toString(view) << ": " << std::strerror(send_error)
-                      << std::endl;
+        if (sendFrameLocked(*session, topic, key, frame)) {
+            queued_bytes += frame->size();
+        } else {
+            failSessionLocked(*session, description);
         }
     }
+    return queued_bytes;
 }
 
 vision::VisionDebugViewSet WebSocketServer::snapshotVisionSubscriptions() const {
     return vision_subscription_registry_.unionOfRequestedViews();
 }
 
+std::vector<vision::VisionViewVariant> WebSocketServer::snapshotVisionVariants() const {
+    return vision_subscription_registry_.unionOfRequestedVariants();
+}
+
+int WebSocketServer::boundPort() const { return bound_port_.load(); }
+
+std::vector<websocket::ClientSendTelemetry> WebSocketServer::snapshotClientSendStats() const {
+    std::vector<websocket::ClientSendTelemetry> clients;
+    for (const auto &session : snapshotSessions()) {
+        websocket::ClientSendTelemetry client;
+        client.session_id = session->id;
+        client.role = client_registry_.roleOf(session->id);
+        {
+            std::lock_guard<std::mutex> lock(session->send_mutex);
+            client.stats = session->outbound.stats();
+        }
+        clients.push_back(client);
+    }
+    std::sort(clients.begin(), clients.end(), [](const auto &left, const auto &right) {
+        return left.session_id < right.session_id;
+    });
+    return clients;
+}
+
+void WebSocketServer::publishClientSendTelemetry() {
+    const auto clients = snapshotClientSendStats();
+    if (clients.empty()) {
+        return;
+    }
+
+    const auto timestamp_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                  std::chrono::system_clock::now().time_since_epoch())
+                                  .count();
+    broadcastText(std::make_shared<const std::string>(
+        websocket::buildClientSendTelemetryJson(timestamp_ms, clients)));
+}
+
+bool WebSocketServer::sendFrameLocked(ClientSession &session, websocket::OutboundTopic topic,
+                                      int key,
+                                      const std::shared_ptr<const websocket::OutboundFrame> &frame) {
+    const bool was_idle = session.outbound.empty();
+    if (session.outbound.push(topic, key, frame) ==
+        websocket::SessionSendQueue::PushResult::Overflow) {
+        errno = ENOBUFS;
+        return false;
+    }
+
+    if (was_idle && !writeQueuedLocked(session)) {
+        return false;
+    }
+    updateWriteInterestLocked(session);
+    return true;
+}
+
+bool WebSocketServer::writeQueuedLocked(ClientSession &session) {
+    std::array<iovec, kMaxSendSegments> segments{};
+    while (!session.outbound.empty()) {
+        msghdr message{};
+        message.msg_iov = segments.data();
+        message.msg_iovlen = session.outbound.gather(segments.data(), segments.size());
+        std::size_t pending = 0;
+        for (std::size_t index = 0; index < message.msg_iovlen; ++index) {
+            pending += segments[index].iov_len;
+        }
+
+        const ssize_t sent = sendmsg(session.fd, &message, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+
+        session.outbound.consume(static_cast<std::size_t>(sent));
+        if (static_cast<std::size_t>(sent) < pending) {
+            return true;
+        }
+    }
+    return true;
+}
+
+void WebSocketServer::updateWriteInterestLocked(ClientSession &session) {
+    const bool wants_write = !session.outbound.empty();
+    if (wants_write == session.write_armed) {
+        return;
+    }
+
+    const std::uint32_t events = EPOLLIN | EPOLLRDHUP | (wants_write ? EPOLLOUT : 0u);
+    if (watch(epoll_fd_, EPOLL_CTL_MOD, session.fd, events, session.id)) {
+        session.write_armed = wants_write;
+    }
+}
+
+void WebSocketServer::failSessionLocked(ClientSession &session, std::string_view reason) {
+    const int send_error = errno;
+    session.alive.store(false);
+    session.outbound.clear();
+    // O reactor ve o hangup e fecha o fd.
+    shutdown(session.fd, SHUT_RDWR);
+    std::cerr << "Cliente WebSocket " << session.id << " desconectado apos falha no envio de "
+              << reason << ": " << std::strerror(send_error) << std::endl;
+}
+
 std::vector<WebSocketServer::ClientSessionPtr> WebSocketServer::snapshotSessions() const {
     std::lock_guard<std::mutex> lock(clients_mutex_);
     std::vector<ClientSessionPtr> sessions;
@@ -507,177 +589,328 @@ void WebSocketServer::removeSession(const ClientSessionPtr &session) {
     vision_subscription_registry_.removeSession(session->id);
 }
 
-void WebSocketServer::shutdownSession(const ClientSessionPtr &session, bool send_close_frame) {
-    if (!session) {
-        return;
+void WebSocketServer::closeSession(const ClientSessionPtr &session, bool send_close_frame) {
+    {
+        std::lock_guard<std::mutex> lock(session->send_mutex);
+        if (session->alive.exchange(false) && send_close_frame && session->handshake_done) {
+            // Melhor esforco: o close entra atras do que ja estava na fila.
+            session->outbound.push(websocket::OutboundTopic::Control, 0, closeFrame());
+            writeQueuedLocked(*session);
+        }
+        session->outbound.clear();
+        epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, session->fd, nullptr);
+        shutdown(session->fd, SHUT_RDWR);
+        close(session->fd);
     }
 
-    std::lock_guard<std::mutex> lock(session->send_mutex);
-    if (!session->alive.exchange(false)) {
-        return;
+    connections_.erase(session->id);
+    if (session->handshake_done) {
+        removeSession(session);
     }
+}
 
-    if (send_close_frame) {
-        sendCloseFrame(session->fd);
+void WebSocketServer::handleMessage(const ClientSessionPtr &session, const std::string &payload) {
+    const auto parsed_message = websocket::parseInboundMessage(payload);
+    if (!parsed_message) {
+        std::cerr << "Mensagem recebida em formato invalido: " << payload << std::endl;
+        return;
     }
-    shutdown(session->fd, SHUT_RDWR);
-}
 
-void WebSocketServer::handleClient(const ClientSessionPtr &session) {
-    while (running_.load() && session->alive.load()) {
-        auto payload_opt = readTextFrame(session->fd);
-        if (!payload_opt) {
-            break;
+    if (parsed_message->channel == websocket::MessageChannel::Client) {
+        if (parsed_message->key == "telemetry_format") {
+            const std::string format = parsed_message->value.value_or("");
+            if (format != "compact" && format != "json") {
+                std::cerr << "Formato de telemetria desconhecido: " << format << std::endl;
+                return;
+            }
+            session->compact_telemetry.store(format == "compact", std::memory_order_relaxed);
+            if (format == "compact") {
+                // Pedido repetido tambem serve para o cliente se ressincronizar.
+                std::lock_guard<std::mutex> lock(compact_telemetry_mutex_);
+                session->compact.requestResync();
+            }
+            return;
         }
 
-        const auto parsed_message = websocket::parseInboundMessage(*payload_opt);
-        if (!parsed_message) {
-            std::cerr << "Mensagem recebida em formato invalido: " << *payload_opt << std::endl;
-            continue;
+        const auto requested_role = websocket::parseClientRole(parsed_message->key);
+        if (!requested_role) {
+            std::cerr << "Papel de cliente desconhecido: " << parsed_message->key << std::endl;
+            return;
         }
 
-        if (parsed_message->channel == websocket::MessageChannel::Client) {
-            const auto requested_role = websocket::parseClientRole(parsed_message->key);
-            if (!requested_role) {
-                std::cerr << "Papel de cliente desconhecido: " << parsed_message->key << std::endl;
-                continue;
-            }
+        if (!assignRequestedRole(session, *requested_role)) {
+            std::cerr << "Papel control indisponivel; cliente mantido como telemetry."
+                      << std::endl;
+        }
+        return;
+    }
 
-            if (!assignRequestedRole(session, *requested_role)) {
-                std::cerr << "Papel control indisponivel; cliente mantido como telemetry."
-                          << std::endl;
+    if (websocket::messageRequiresControllerRole(parsed_message->channel) &&
+        !ensureControllerRole(session)) {
+        std::cerr << "Cliente sem permissao de controle; mensagem ignorada." << std::endl;
+        return;
+    }
+
+    if (parsed_message->channel == websocket::MessageChannel::Command) {
+        const auto normalized_value = websocket::parseCommandValue(parsed_message->value);
+        if (parsed_message->value && !normalized_value) {
+            std::cerr << "Valor de comando invalido: " << *parsed_message->value
+                      << " para comando " << parsed_message->key << std::endl;
+            return;
+        }
+
+        CommandSource command_source = CommandSource::Manual;
+        if (parsed_message->source_token) {
+            const auto parsed_source = commandSourceFromString(*parsed_message->source_token);
+            if (!parsed_source) {
+                std::cerr << "Origem de comando desconhecida: "
+                          << *parsed_message->source_token << std::endl;
+                return;
             }
-            continue;
+            command_source = *parsed_source;
         }
 
-        if (websocket::messageRequiresControllerRole(parsed_message->channel) &&
-            !ensureControllerRole(session)) {
-            std::cerr << "Cliente sem permissao de controle; mensagem ignorada." << std::endl;
-            continue;
+        const auto current_mode =
+            driving_mode_provider_ ? driving_mode_provider_() : DrivingMode::Manual;
+        const auto status =
+            command_router_.route(command_source, parsed_message->key, normalized_value,
+                                  current_mode);
+        if (status == controllers::CommandRouteStatus::Handled) {
+            return;
         }
 
-        if (parsed_message->channel == websocket::MessageChannel::Command) {
-            const auto normalized_value = websocket::parseCommandValue(parsed_message->value);
-            if (parsed_message->value && !normalized_value) {
-                std::cerr << "Valor de comando invalido: " << *parsed_message->value
-                          << " para comando " << parsed_message->key << std::endl;
-                continue;
-            }
+        if (status == controllers::CommandRouteStatus::RejectedByMode) {
+            std::cerr << "Comando " << parsed_message->key << " ignorado. Origem "
+                      << toString(command_source) << " nao permitida no modo "
+                      << toString(current_mode) << std::endl;
+            return;
+        }
 
-            CommandSource command_source = CommandSource::Manual;
-            if (parsed_message->source_token) {
-                const auto parsed_source = commandSourceFromString(*parsed_message->source_token);
-                if (!parsed_source) {
-                    std::cerr << "Origem de comando desconhecida: "
-                              << *parsed_message->source_token << std::endl;
-                    continue;
-                }
-                command_source = *parsed_source;
-            }
+        if (status == controllers::CommandRouteStatus::RejectedBySource) {
+            std::cerr << "Comando " << parsed_message->key
+                      << " nao registrado para a origem "
+                      << toString(command_source) << std::endl;
+            return;
+        }
 
-            const auto current_mode =
-                driving_mode_provider_ ? driving_mode_provider_() : DrivingMode::Manual;
-            const auto status =
-                command_router_.route(command_source, parsed_message->key, normalized_value,
-                                      current_mode);
-            if (status == controllers::CommandRouteStatus::Handled) {
-                continue;
-            }
+        if (status == controllers::CommandRouteStatus::UnknownCommand) {
+            std::cerr << "Comando desconhecido recebido: " << parsed_message->key
+                      << std::endl;
+        }
+        return;
+    }
 
-            if (status == controllers::CommandRouteStatus::RejectedByMode) {
-                std::cerr << "Comando " << parsed_message->key << " ignorado. Origem "
-                          << toString(command_source) << " nao permitida no modo "
-                          << toString(current_mode) << std::endl;
-                continue;
-            }
+    if (parsed_message->channel == websocket::MessageChannel::Config) {
+        if (!parsed_message->value || parsed_message->value->empty()) {
+            std::cerr << "Mensagem de configuracao sem valor." << std::endl;
+            return;
+        }
 
-            if (status == controllers::CommandRouteStatus::RejectedBySource) {
-                std::cerr << "Comando " << parsed_message->key
-                          << " nao registrado para a origem "
-                          << toString(command_source) << std::endl;
-                continue;
-            }
+        if (!config_handler_) {
+            std::cerr << "Handler de configuracao nao definido." << std::endl;
+            return;
+        }
 
-            if (status == controllers::CommandRouteStatus::UnknownCommand) {
-                std::cerr << "Comando desconhecido recebido: " << parsed_message->key
+        if (!config_handler_(parsed_message->key, *parsed_message->value)) {
+            std::cerr << "Falha ao aplicar configuracao: " << parsed_message->key
+                      << "=" << *parsed_message->value << std::endl;
+        }
+        return;
+    }
+
+    if (parsed_message->channel == websocket::MessageChannel::Stream) {
+        if (parsed_message->key == "format" && parsed_message->value) {
+            const auto format = vision::visionFrameFormatFromString(*parsed_message->value);
+            if (!format) {
+                std::cerr << "Formato de stream desconhecido: " << *parsed_message->value
                           << std::endl;
+                return;
             }
-            continue;
+            vision_subscription_registry_.setFormat(session->id, *format);
+            return;
         }
 
-        if (parsed_message->channel == websocket::MessageChannel::Config) {
-            if (!parsed_message->value || parsed_message->value->empty()) {
-                std::cerr << "Mensagem de configuracao sem valor." << std::endl;
-                continue;
-            }
+        if (parsed_message->key != "subscribe" || !parsed_message->value) {
+            std::cerr << "Mensagem de stream invalida: " << payload << std::endl;
+            return;
+        }
 
-            if (!config_handler_) {
-                std::cerr << "Handler de configuracao nao definido." << std::endl;
-                continue;
-            }
+        std::vector<std::string> invalid_tokens;
+        auto subscriptions =
+            vision::parseVisionViewVariantCsv(*parsed_message->value, &invalid_tokens);
+        vision_subscription_registry_.replaceSubscriptions(session->id,
+                                                           std::move(subscriptions));
 
-            if (!config_handler_(parsed_message->key, *parsed_message->value)) {
-                std::cerr << "Falha ao aplicar configuracao: " << parsed_message->key
-                          << "=" << *parsed_message->value << std::endl;
-            }
-            continue;
+        for (const auto &token : invalid_tokens) {
+            std::cerr << "View de stream desconhecida ou invalida ignorada: " << token
+                      << std::endl;
         }
+        return;
+    }
 
-        if (parsed_message->channel == websocket::MessageChannel::Stream) {
-            if (parsed_message->key != "subscribe" || !parsed_message->value) {
-                std::cerr << "Mensagem de stream invalida: " << *payload_opt << std::endl;
-                continue;
-            }
+    if (parsed_message->channel == websocket::MessageChannel::Signal) {
+        if (parsed_message->key != "detected" || !parsed_message->value ||
+            parsed_message->value->empty()) {
+            std::cerr << "Mensagem de sinalizacao invalida: " << payload << std::endl;
+            return;
+        }
+
+        if (!signal_detected_handler_) {
+            std::cerr << "Handler de sinalizacao nao definido." << std::endl;
+            return;
+        }
+
+        if (!signal_detected_handler_(*parsed_message->value)) {
+            std::cerr << "Sinalizacao desconhecida recebida: " << *parsed_message->value
+                      << std::endl;
+        }
+        return;
+    }
+
+    std::cerr << "Canal de mensagem desconhecido: " << payload << std::endl;
+}
+
+bool WebSocketServer::completeHandshake(const ClientSessionPtr &session) {
+    const auto header_end = session->inbound.find("\r\n\r\n");
+    if (header_end == std::string::npos) {
+        return session->inbound.size() <= kMaxHandshakeBytes;
+    }
 
-            std::vector<std::string> invalid_tokens;
-            auto subscriptions = vision::parseVisionDebugSubscriptionCsv(
-                *parsed_message->value, &invalid_tokens);
-            vision_subscription_registry_.replaceSubscriptions(session->id,
-                                                               std::move(subscriptions));
+    const auto request = session->inbound.substr(0, header_end + 4);
+    const auto key_opt = extractHeader(request, "Sec-WebSocket-Key");
+    if (!key_opt) {
+        return false;
+    }
+
+    session->inbound.erase(0, header_end + 4);
+    {
+        std::lock_guard<std::mutex> lock(session->send_mutex);
+        const auto response =
+            websocket::makeRawFrame(buildHandshakeResponse(computeAcceptKey(*key_opt)));
+        if (!sendFrameLocked(*session, websocket::OutboundTopic::Control, 0, response)) {
+            return false;
+        }
+        session->handshake_done = true;
+    }
 
-            for (const auto &token : invalid_tokens) {
-                std::cerr << "View de stream desconhecida ignorada: " << token << std::endl;
+    std::lock_guard<std::mutex> lock(clients_mutex_);
+    sessions_[session->id] = session;
+    client_registry_.addSession(session->id);
+    vision_subscription_registry_.addSession(session->id);
+    return true;
+}
+
+void WebSocketServer::handleReadable(const ClientSessionPtr &session) {
+    static thread_local std::array<char, kReadChunkBytes> buffer{};
+    const std::size_t max_inbound = kMaxHandshakeBytes + kMaxInboundPayloadBytes;
+    bool peer_closed = false;
+    while (session->inbound.size() <= max_inbound) {
+        const ssize_t bytes = recv(session->fd, buffer.data(), buffer.size(), MSG_DONTWAIT);
+        if (bytes > 0) {
+            session->inbound.append(buffer.data(), static_cast<std::size_t>(bytes));
+            if (static_cast<std::size_t>(bytes) < buffer.size()) {
+                break;
             }
             continue;
         }
+        if (bytes < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        peer_closed = true;
+        break;
+    }
 
-        if (parsed_message->channel == websocket::MessageChannel::Signal) {
-            if (parsed_message->key != "detected" || !parsed_message->value ||
-                parsed_message->value->empty()) {
-                std::cerr << "Mensagem de sinalizacao invalida: " << *payload_opt << std::endl;
-                continue;
+    if (!session->handshake_done) {
+        if (!completeHandshake(session)) {
+            closeSession(session, false);
+            return;
+        }
+        if (!session->handshake_done) {
+            if (peer_closed) {
+                closeSession(session, false);
             }
+            return;
+        }
+    }
+
+    std::size_t consumed = 0;
+    while (session->alive.load()) {
+        auto frame = websocket::decodeClientFrame(
+            std::string_view(session->inbound).substr(consumed), kMaxInboundPayloadBytes);
+        if (frame.status == websocket::FrameDecodeStatus::Incomplete) {
+            break;
+        }
+        if (frame.status == websocket::FrameDecodeStatus::Invalid || frame.opcode != 0x1) {
+            // Close, binario, ping ou frame fora do protocolo encerram a sessao, como antes.
+            closeSession(session, true);
+            return;
+        }
+
+        consumed += frame.consumed;
+        handleMessage(session, frame.payload);
+    }
+    session->inbound.erase(0, consumed);
+
+    if (peer_closed || !session->alive.load()) {
+        closeSession(session, true);
+    }
+}
 
-            if (!signal_detected_handler_) {
-                std::cerr << "Handler de sinalizacao nao definido." << std::endl;
+void WebSocketServer::flushSession(const ClientSessionPtr &session) {
+    std::lock_guard<std::mutex> lock(session->send_mutex);
+    if (!session->alive.load()) {
+        return;
+    }
+
+    if (!writeQueuedLocked(*session)) {
+        failSessionLocked(*session, "fila pendente");
+        return;
+    }
+    updateWriteInterestLocked(*session);
+}
+
+void WebSocketServer::acceptClients() {
+    while (true) {
+        sockaddr_in client_address{};
+        socklen_t client_len = sizeof(client_address);
+        const int client_fd = accept4(server_fd_, reinterpret_cast<sockaddr *>(&client_address),
+                                      &client_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (client_fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
                 continue;
             }
-
-            if (!signal_detected_handler_(*parsed_message->value)) {
-                std::cerr << "Sinalizacao desconhecida recebida: " << *parsed_message->value
-                          << std::endl;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                std::cerr << "Falha ao aceitar conexao: " << std::strerror(errno) << std::endl;
             }
-            continue;
+            return;
         }
 
-        std::cerr << "Canal de mensagem desconhecido: " << *payload_opt << std::endl;
-    }
+        configureClientSocket(client_fd);
 
-    shutdownSession(session, true);
-    close(session->fd);
-    removeSession(session);
+        auto session = std::make_shared<ClientSession>();
+        session->id = next_session_id_++;
+        session->fd = client_fd;
+        session->outbound = websocket::SessionSendQueue(send_policy_);
+        if (!watch(epoll_fd_, EPOLL_CTL_ADD, client_fd, EPOLLIN | EPOLLRDHUP, session->id)) {
+            std::cerr << "Falha ao registrar cliente no epoll: " << std::strerror(errno)
+                      << std::endl;
+            close(client_fd);
+            continue;
+        }
+        connections_[session->id] = std::move(session);
+    }
 }
 
-void WebSocketServer::run() {
-    const int server_fd = socket(AF_INET, SOCK_STREAM, 0);
+bool WebSocketServer::openListener() {
+    const int server_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
     if (server_fd < 0) {
         std::cerr << "Falha ao criar socket" << std::endl;
-        running_.store(false);
-        return;
+        return false;
     }
 
-    server_fd_.store(server_fd);
-
     int opt = 1;
     setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
 
@@ -689,63 +922,98 @@ void WebSocketServer::run() {
     if (bind(server_fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0) {
         std::cerr << "Falha ao fazer bind no socket" << std::endl;
         close(server_fd);
-        server_fd_.store(-1);
-        running_.store(false);
-        return;
+        return false;
     }
 
     if (listen(server_fd, SOMAXCONN) < 0) {
         std::cerr << "Falha ao colocar socket em listen" << std::endl;
         close(server_fd);
-        server_fd_.store(-1);
-        running_.store(false);
-        return;
+        return false;
     }
 
-    while (running_.load()) {
-        sockaddr_in client_address{};
-        socklen_t client_len = sizeof(client_address);
-        const int client_fd =
-            accept(server_fd, reinterpret_cast<sockaddr *>(&client_address), &client_len);
-        if (client_fd < 0) {
-            if (running_.load() && errno != EINTR) {
-                std::cerr << "Falha ao aceitar conexao" << std::endl;
-            }
-            continue;
-        }
-
-        configureClientSocket(client_fd);
+    sockaddr_in bound_address{};
+    socklen_t bound_len = sizeof(bound_address);
+    if (getsockname(server_fd, reinterpret_cast<sockaddr *>(&bound_address), &bound_len) == 0) {
+        bound_port_.store(ntohs(bound_address.sin_port));
+    }
 
-        const auto request_opt = readHttpRequest(client_fd);
-        if (!request_opt) {
-            close(client_fd);
-            continue;
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epoll_fd_ < 0 || wake_fd_ < 0 ||
+        !watch(epoll_fd_, EPOLL_CTL_ADD, server_fd, EPOLLIN, kListenerEventId) ||
+        !watch(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, EPOLLIN, kWakeEventId)) {
+        std::cerr << "Falha ao criar o epoll do servidor WebSocket: " << std::strerror(errno)
+                  << std::endl;
+        close(server_fd);
+        for (int *fd : {&epoll_fd_, &wake_fd_}) {
+            if (*fd >= 0) {
+                close(*fd);
+                *fd = -1;
+            }
         }
+        return false;
+    }
 
-        const auto key_opt = extractHeader(*request_opt, "Sec-WebSocket-Key");
-        if (!key_opt) {
-            close(client_fd);
-            continue;
-        }
+    server_fd_ = server_fd;
+    return true;
+}
 
-        const auto accept_key = computeAcceptKey(*key_opt);
-        if (!sendHandshakeResponse(client_fd, accept_key)) {
-            close(client_fd);
-            continue;
+void WebSocketServer::run() {
+    std::array<epoll_event, kMaxEpollEvents> events{};
+    auto next_telemetry_at = std::chrono::steady_clock::now() + kClientTelemetryInterval;
+    while (running_.load()) {
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= next_telemetry_at) {
+            publishClientSendTelemetry();
+            next_telemetry_at = now + kClientTelemetryInterval;
+        }
+
+        const auto wait_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                 next_telemetry_at - now)
+                                 .count();
+        const int ready = epoll_wait(epoll_fd_, events.data(), kMaxEpollEvents,
+                                     static_cast<int>(wait_ms) + 1);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "Falha no epoll do servidor WebSocket: " << std::strerror(errno)
+                      << std::endl;
+            break;
         }
 
-        auto session = std::make_shared<ClientSession>();
-        session->id = next_session_id_.fetch_add(1);
-        session->fd = client_fd;
+        for (int index = 0; index < ready; ++index) {
+            const auto id = events[index].data.u64;
+            const auto flags = events[index].events;
+            if (id == kWakeEventId) {
+                continue;
+            }
+            if (id == kListenerEventId) {
+                acceptClients();
+                continue;
+            }
 
-        {
-            std::lock_guard<std::mutex> lock(clients_mutex_);
-            sessions_[session->id] = session;
-            client_registry_.addSession(session->id);
-            vision_subscription_registry_.addSession(session->id);
+            const auto it = connections_.find(static_cast<std::size_t>(id));
+            if (it == connections_.end()) {
+                continue;
+            }
+            const auto session = it->second;
+            if ((flags & EPOLLOUT) != 0) {
+                flushSession(session);
+            }
+            if ((flags & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) != 0) {
+                handleReadable(session);
+            }
         }
+    }
 
-        client_threads_.emplace_back(&WebSocketServer::handleClient, this, session);
+    std::vector<ClientSessionPtr> remaining;
+    remaining.reserve(connections_.size());
+    for (const auto &[_, session] : connections_) {
+        remaining.push_back(session);
+    }
+    for (const auto &session : remaining) {
+        closeSession(session, true);
     }
 }
 
@@ -6,6 +6,7 @@
 #include <mutex>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <unordered_map>
 #include <vector>
@@ -15,6 +16,9 @@
 #include "services/vision/VisionDebugStream.hpp"
 #include "services/vision/VisionSubscriptionRegistry.hpp"
 #include "services/websocket/ClientRegistry.hpp"
+#include "services/websocket/ClientSendTelemetry.hpp"
+#include "services/websocket/CompactTelemetryEncoder.hpp"
+#include "services/websocket/SessionSendQueue.hpp"
 
 namespace autonomous_car::controllers {
 class CommandRouter;
@@ -31,32 +35,72 @@ public:
 
     WebSocketServer(const std::string &host, int port, controllers::CommandRouter &command_router,
                     ConfigUpdateHandler config_handler, DrivingModeProvider mode_provider,
-                    SignalDetectedHandler signal_detected_handler = {});
+                    SignalDetectedHandler signal_detected_handler = {},
+                    websocket::SendQueuePolicy send_policy = {});
     ~WebSocketServer();
 
     void start();
     void stop();
     void broadcastText(const std::string &payload);
     void broadcastVisionFrame(vision::VisionDebugViewId view, const std::string &payload);
+    // Sem copia: o mesmo buffer vai para a fila de todas as sessoes.
+    void broadcastText(std::shared_ptr<const std::string> payload);
+    void broadcastVisionFrame(vision::VisionDebugViewId view,
+                              std::shared_ptr<const std::string> payload);
+    // Monta JSON e/ou frame binario conforme o formato negociado por cada sessao assinante.
+    // Retorna os bytes enfileirados somando todas as sessoes, para o controle de taxa do stream.
+    std::size_t broadcastVisionFrame(const vision::EncodedVisionFrame &frame);
     [[nodiscard]] vision::VisionDebugViewSet snapshotVisionSubscriptions() const;
+    [[nodiscard]] std::vector<vision::VisionViewVariant> snapshotVisionVariants() const;
+    // Porta em escuta depois de start(); util quando o servidor foi criado com porta 0.
+    [[nodiscard]] int boundPort() const;
+    // Fila e descartes de envio por cliente; tambem publicado em telemetry.websocket_clients.
+    [[nodiscard]] std::vector<websocket::ClientSendTelemetry> snapshotClientSendStats() const;
 
 private:
     struct ClientSession {
         std::size_t id{0};
         int fd{-1};
         std::atomic<bool> alive{true};
+        // client:telemetry_format=compact; ver CompactTelemetryEncoder.
+        std::atomic<bool> compact_telemetry{false};
+        // Protegido por compact_telemetry_mutex_.
+        websocket::CompactTelemetrySession compact;
+        // Somente a thread do reactor toca nestes dois campos.
+        bool handshake_done{false};
+        std::string inbound;
+        // Broadcast so enfileira; com a fila vazia, quem publica ja tenta escrever sem
+        // bloquear e o reactor termina o resto no EPOLLOUT.
         mutable std::mutex send_mutex;
+        websocket::SessionSendQueue outbound;
+        bool write_armed{false};
     };
 
     using ClientSessionPtr = std::shared_ptr<ClientSession>;
 
+    bool openListener();
     void run();
-    void handleClient(const ClientSessionPtr &session);
+    void acceptClients();
+    void handleReadable(const ClientSessionPtr &session);
+    bool completeHandshake(const ClientSessionPtr &session);
+    void handleMessage(const ClientSessionPtr &session, const std::string &payload);
+    void flushSession(const ClientSessionPtr &session);
+    // Retorna os bytes enfileirados nas sessoes que aceitaram o frame.
+    std::size_t broadcastFrame(const std::vector<ClientSessionPtr> &sessions,
+                               websocket::OutboundTopic topic, int key,
+                               const std::shared_ptr<const websocket::OutboundFrame> &frame,
+                               std::string_view description);
+    bool sendFrameLocked(ClientSession &session, websocket::OutboundTopic topic, int key,
+                         const std::shared_ptr<const websocket::OutboundFrame> &frame);
+    bool writeQueuedLocked(ClientSession &session);
+    void updateWriteInterestLocked(ClientSession &session);
+    void failSessionLocked(ClientSession &session, std::string_view reason);
+    void publishClientSendTelemetry();
     std::vector<ClientSessionPtr> snapshotSessions() const;
     bool assignRequestedRole(const ClientSessionPtr &session, ClientRole requested_role);
     bool ensureControllerRole(const ClientSessionPtr &session);
     void removeSession(const ClientSessionPtr &session);
-    void shutdownSession(const ClientSessionPtr &session, bool send_close_frame);
+    void closeSession(const ClientSessionPtr &session, bool send_close_frame);
 
     std::string host_;
     int port_;
@@ -64,15 +108,24 @@ private:
     ConfigUpdateHandler config_handler_;
     DrivingModeProvider driving_mode_provider_;
     SignalDetectedHandler signal_detected_handler_;
+    websocket::SendQueuePolicy send_policy_;
     std::thread server_thread_;
     std::atomic<bool> running_;
-    std::atomic<int> server_fd_;
+    std::atomic<int> bound_port_{0};
+    int server_fd_{-1};
+    int epoll_fd_{-1};
+    int wake_fd_{-1};
+    // Todas as conexoes, inclusive em handshake; somente o reactor acessa.
+    std::unordered_map<std::size_t, ClientSessionPtr> connections_;
+    // Sessoes ja abertas, visiveis para broadcast.
     mutable std::mutex clients_mutex_;
     std::unordered_map<std::size_t, ClientSessionPtr> sessions_;
-    std::vector<std::thread> client_threads_;
-    std::atomic<std::size_t> next_session_id_{1};
+    std::size_t next_session_id_{1};
     websocket::ClientRegistry client_registry_;
     vision::VisionSubscriptionRegistry vision_subscription_registry_;
+    // Travado do encode ao enfileiramento, para schema, keyframe e deltas sairem em ordem.
+    std::mutex compact_telemetry_mutex_;
+    websocket::CompactTelemetryEncoder compact_telemetry_encoder_;
 };
 
 } // namespace autonomous_car::services
@@ -1,6 +1,8 @@
 #include "services/autonomous_control/AutonomousControlDebugRenderer.hpp"
 
 #include <algorithm>
+#include <array>
+#include <cmath>
 #include <iomanip>
 #include <sstream>
 #include <vector>
@@ -199,149 +201,244 @@ std::string formatAgeLabel(std::int64_t age_ms) {
 
 } // namespace
 
+bool AutonomousControlDebugRenderer::PanelText::operator==(const PanelText &other) const {
+    return text == other.text && y_offset == other.y_offset && scale == other.scale &&
+           color == other.color && thickness == other.thickness;
+}
+
+bool AutonomousControlDebugRenderer::SteeringGaugeState::operator==(
+    const SteeringGaugeState &other) const {
+    return arrow_x == other.arrow_x && color == other.color;
+}
+
+bool AutonomousControlDebugRenderer::TopDownState::operator==(const TopDownState &other) const {
+    return references == other.references && path == other.path &&
+           path_color == other.path_color;
+}
+
 cv::Mat AutonomousControlDebugRenderer::render(
     const road_segmentation_lab::pipeline::RoadSegmentationResult &result,
     const road_segmentation_lab::config::LabConfig &config, const std::string &source_label,
     const std::string &calibration_status, const AutonomousControlSnapshot &snapshot,
     const vision::VisionRuntimeTelemetry &runtime_telemetry,
     const ts::TrafficSignFrameResult &traffic_sign_result) const {
-    cv::Mat segmentation_panel =
-        segmentation_renderer_.render(result, config, source_label, calibration_status);
-    if (segmentation_panel.empty()) {
-        return segmentation_panel;
+    const cv::Size segmentation_size = segmentation_renderer_.panelSize(result);
+    if (segmentation_size.empty()) {
+        return cv::Mat();
     }
 
+    // Um canvas so: a segmentacao e o painel de controle sao desenhados direto nos seus ROIs.
+    cv::Mat full_panel(segmentation_size.height, segmentation_size.width + kPanelWidth, CV_8UC3);
+    cv::Mat segmentation_panel = full_panel(cv::Rect({0, 0}, segmentation_size));
+    segmentation_renderer_.renderInto(segmentation_panel, result, config, source_label,
+                                      calibration_status);
     drawTrafficSignOverlayOnSegmentationPanel(segmentation_panel, result, traffic_sign_result);
 
-    cv::Mat control_panel = buildControlPanel(snapshot, runtime_telemetry, traffic_sign_result,
-                                              {kPanelWidth, segmentation_panel.rows});
-    cv::Mat full_panel;
-    cv::hconcat(segmentation_panel, control_panel, full_panel);
+    paintControlPanel(
+        full_panel(cv::Rect(segmentation_size.width, 0, kPanelWidth, segmentation_size.height)),
+        snapshot, runtime_telemetry, traffic_sign_result);
     return full_panel;
 }
 
-cv::Mat AutonomousControlDebugRenderer::buildControlPanel(
-    const AutonomousControlSnapshot &snapshot,
+void AutonomousControlDebugRenderer::paintControlPanel(
+    cv::Mat target, const AutonomousControlSnapshot &snapshot,
     const vision::VisionRuntimeTelemetry &runtime_telemetry,
-    const ts::TrafficSignFrameResult &traffic_sign_result,
-    cv::Size size) {
-    cv::Mat panel(size, CV_8UC3, kPanelBackground);
+    const ts::TrafficSignFrameResult &traffic_sign_result) const {
+    std::lock_guard<std::mutex> lock(panel_mutex_);
+    ControlPanelCache &cache = panel_cache_;
+    if (cache.chrome.size() != target.size()) {
+        cache = ControlPanelCache{};
+        cache.layout = buildPanelLayout(target.size());
+        cache.chrome.create(target.size(), CV_8UC3);
+        cache.chrome.setTo(kPanelBackground);
+        drawPanelChrome(cache.chrome, cache.layout);
+        cache.chrome.copyTo(cache.canvas);
+    }
+
+    // Cada secao e dona das linhas ate o inicio da proxima, como quando o painel era desenhado
+    // de cima para baixo: texto que passa da caixa aparece no vao e e cortado pela secao seguinte.
+    const PanelLayout &layout = cache.layout;
+    bool repainted = false;
+    const auto repaint_section = [&](int begin_y, int end_y, const cv::Rect &area,
+                                     const auto &draw) {
+        const cv::Range rows(begin_y, end_y);
+        cache.chrome.rowRange(rows).copyTo(cache.canvas.rowRange(rows));
+        cv::Mat band = cache.canvas.rowRange(rows);
+        draw(band, area - cv::Point(0, begin_y));
+        repainted = true;
+    };
+
+    auto control = controlStatusText(snapshot);
+    if (cache.control != control) {
+        repaint_section(0, layout.traffic.y, layout.control,
+                        [&](cv::Mat &band, const cv::Rect &area) {
+                            drawPanelText(band, area, control);
+                        });
+        cache.control = std::move(control);
+    }
+
+    auto traffic = trafficSignStatusText(runtime_telemetry, traffic_sign_result);
+    if (cache.traffic != traffic) {
+        repaint_section(layout.traffic.y, layout.gauge.y, layout.traffic,
+                        [&](cv::Mat &band, const cv::Rect &area) {
+                            drawPanelText(band, area, traffic);
+                        });
+        cache.traffic = std::move(traffic);
+    }
+
+    const cv::Point gauge_origin(0, layout.gauge.y);
+    const SteeringGaugeState gauge = steeringGaugeState(snapshot, layout.gauge - gauge_origin);
+    if (cache.gauge != gauge) {
+        repaint_section(layout.gauge.y, layout.top_down.y, layout.gauge,
+                        [&](cv::Mat &band, const cv::Rect &area) {
+                            drawSteeringGauge(band, gauge, area);
+                        });
+        cache.gauge = gauge;
+    }
+
+    const cv::Point top_down_origin(0, layout.top_down.y);
+    TopDownState top_down = topDownState(snapshot, layout.top_down - top_down_origin);
+    if (cache.top_down != top_down) {
+        repaint_section(layout.top_down.y, cache.canvas.rows, layout.top_down,
+                        [&](cv::Mat &band, const cv::Rect &) {
+                            drawTopDownPreview(band, top_down);
+                        });
+        cache.top_down = std::move(top_down);
+    }
+
+    if (repainted) {
+        cv::rectangle(cache.canvas, {0, 0}, {cache.canvas.cols - 1, cache.canvas.rows - 1},
+                      kPanelBorder, 1, cv::LINE_AA);
+    }
+    cache.canvas.copyTo(target);
+}
+
+AutonomousControlDebugRenderer::PanelLayout
+AutonomousControlDebugRenderer::buildPanelLayout(cv::Size size) {
     const int padding = 18;
     const int gap = 12;
-    const int inner_width = panel.cols - padding * 2;
+    const int inner_width = size.width - padding * 2;
     const int control_height = 102;
     const int gauge_height = 78;
     const int min_preview_height = 64;
     const int traffic_height = std::max(
-        140, panel.rows - (padding * 2 + gap * 3 + control_height + gauge_height +
-                           min_preview_height));
-
-    const cv::Rect control_area(padding, padding, inner_width, control_height);
-    const cv::Rect traffic_area(padding, control_area.y + control_area.height + gap, inner_width,
-                                traffic_height);
-    const cv::Rect gauge_area(padding, traffic_area.y + traffic_area.height + gap, inner_width,
-                              gauge_height);
-    const int top_down_y = gauge_area.y + gauge_area.height + gap;
-    const int top_down_height = std::max(48, panel.rows - top_down_y - padding);
-
-    drawControlStatus(panel, snapshot, control_area);
-    drawTrafficSignStatus(panel, runtime_telemetry, traffic_sign_result, traffic_area);
-    drawSteeringGauge(panel, snapshot, gauge_area);
-    drawTopDownPreview(panel, snapshot,
-                       {padding, top_down_y, inner_width, top_down_height});
+        140, size.height - (padding * 2 + gap * 3 + control_height + gauge_height +
+                            min_preview_height));
+
+    PanelLayout layout;
+    layout.control = {padding, padding, inner_width, control_height};
+    layout.traffic = {padding, layout.control.y + layout.control.height + gap, inner_width,
+                      traffic_height};
+    layout.gauge = {padding, layout.traffic.y + layout.traffic.height + gap, inner_width,
+                    gauge_height};
+    const int top_down_y = layout.gauge.y + layout.gauge.height + gap;
+    layout.top_down = {padding, top_down_y, inner_width,
+                       std::max(48, size.height - top_down_y - padding)};
+    return layout;
+}
+
+void AutonomousControlDebugRenderer::drawPanelChrome(cv::Mat &panel, const PanelLayout &layout) {
+    for (const cv::Rect &area : {layout.control, layout.traffic, layout.gauge, layout.top_down}) {
+        cv::rectangle(panel, area, kPanelSection, cv::FILLED);
+        cv::rectangle(panel, area, kPanelBorder, 1, cv::LINE_AA);
+    }
+
+    const cv::Rect &control = layout.control;
+    cv::putText(panel, "Controle autonomo", {control.x + 14, control.y + 26},
+                cv::FONT_HERSHEY_SIMPLEX, 0.64, kTextPrimary, 2, cv::LINE_AA);
+
+    const cv::Rect &traffic = layout.traffic;
+    cv::putText(panel, "Sinalizacao", {traffic.x + 14, traffic.y + 26}, cv::FONT_HERSHEY_SIMPLEX,
+                0.6, kTextPrimary, 1, cv::LINE_AA);
+
+    const cv::Rect &gauge = layout.gauge;
+    cv::putText(panel, "Comando de direcao", {gauge.x + 14, gauge.y + 24},
+                cv::FONT_HERSHEY_SIMPLEX, 0.52, kTextPrimary, 1, cv::LINE_AA);
+    const int center_y = gauge.y + gauge.height / 2 + 8;
+    const int center_x = gauge.x + gauge.width / 2;
+    const int half_width = (gauge.width - 60) / 2;
+    cv::line(panel, {center_x - half_width, center_y}, {center_x + half_width, center_y},
+             {110, 110, 110}, 2, cv::LINE_AA);
+    cv::line(panel, {center_x, center_y - 24}, {center_x, center_y + 24}, kNeutralColor, 1,
+             cv::LINE_AA);
+
+    const cv::Rect &top_down = layout.top_down;
+    cv::putText(panel, "Mapa superior / previsao", {top_down.x + 14, top_down.y + 24},
+                cv::FONT_HERSHEY_SIMPLEX, 0.52, kTextPrimary, 1, cv::LINE_AA);
+    const cv::Point vehicle_center(top_down.x + top_down.width / 2,
+                                   top_down.y + top_down.height - 30);
+    const std::vector<cv::Point> vehicle_polygon = {
+        {vehicle_center.x, vehicle_center.y - 18},
+        {vehicle_center.x - 14, vehicle_center.y + 12},
+        {vehicle_center.x + 14, vehicle_center.y + 12},
+    };
+    cv::fillConvexPoly(panel, vehicle_polygon, {220, 220, 220}, cv::LINE_AA);
+    cv::line(panel, {vehicle_center.x, top_down.y + 36},
+             {vehicle_center.x, vehicle_center.y - 28}, {100, 100, 100}, 1, cv::LINE_AA);
+
     cv::rectangle(panel, {0, 0}, {panel.cols - 1, panel.rows - 1}, kPanelBorder, 1, cv::LINE_AA);
-    return panel;
 }
 
-void AutonomousControlDebugRenderer::drawControlStatus(cv::Mat &panel,
-                                                       const AutonomousControlSnapshot &snapshot,
-                                                       const cv::Rect &area) {
-    cv::rectangle(panel, area, kPanelSection, cv::FILLED);
-    cv::rectangle(panel, area, kPanelBorder, 1, cv::LINE_AA);
-
-    cv::putText(panel, "Controle autonomo", {area.x + 14, area.y + 26},
-                cv::FONT_HERSHEY_SIMPLEX, 0.64,
-                kTextPrimary, 2, cv::LINE_AA);
-    cv::putText(panel, "Modo: " + std::string(toString(snapshot.driving_mode)),
-                {area.x + 14, area.y + 46}, cv::FONT_HERSHEY_SIMPLEX, 0.46, kTextSecondary, 1,
-                cv::LINE_AA);
-    cv::putText(panel, "Estado: " + std::string(toString(snapshot.tracking_state)),
-                {area.x + 14, area.y + 66}, cv::FONT_HERSHEY_SIMPLEX, 0.48,
-                stateColor(snapshot), 1, cv::LINE_AA);
-    cv::putText(panel,
-                "Start: " + std::string(snapshot.autonomous_started ? "on" : "off") +
-                    " | Motion: " + std::string(toString(snapshot.motion_command)),
-                {area.x + 14, area.y + 86}, cv::FONT_HERSHEY_SIMPLEX, 0.40, kTextSecondary, 1,
-                cv::LINE_AA);
+std::vector<AutonomousControlDebugRenderer::PanelText>
+AutonomousControlDebugRenderer::controlStatusText(const AutonomousControlSnapshot &snapshot) {
+    std::vector<PanelText> lines = {
+        {"Modo: " + std::string(toString(snapshot.driving_mode)), 46, 0.46, kTextSecondary},
+        {"Estado: " + std::string(toString(snapshot.tracking_state)), 66, 0.48,
+         stateColor(snapshot)},
+        {"Start: " + std::string(snapshot.autonomous_started ? "on" : "off") +
+             " | Motion: " + std::string(toString(snapshot.motion_command)),
+         86, 0.40, kTextSecondary},
+    };
 
     if (snapshot.driving_mode == DrivingMode::Manual) {
-        cv::putText(panel, "PID inativo no modo manual", {area.x + 14, area.y + 104},
-                    cv::FONT_HERSHEY_SIMPLEX, 0.38, kNeutralColor, 1, cv::LINE_AA);
-        return;
+        lines.push_back({"PID inativo no modo manual", 104, 0.38, kNeutralColor});
+    } else {
+        lines.push_back({"Conf.: " + formatDouble(snapshot.confidence_score, 2) +
+                             " | Steering: " + formatDouble(snapshot.steering_command, 2),
+                         104, 0.38, snapshot.confidence_ok ? kPositiveColor : kWarningColor});
     }
+    return lines;
+}
 
-    cv::putText(panel,
-                "Conf.: " + formatDouble(snapshot.confidence_score, 2) +
-                    " | Steering: " + formatDouble(snapshot.steering_command, 2),
-                {area.x + 14, area.y + 104}, cv::FONT_HERSHEY_SIMPLEX, 0.38,
-                snapshot.confidence_ok ? kPositiveColor : kWarningColor, 1, cv::LINE_AA);
+std::vector<AutonomousControlDebugRenderer::PanelText>
+AutonomousControlDebugRenderer::trafficSignStatusText(
+    const vision::VisionRuntimeTelemetry &runtime_telemetry,
+    const ts::TrafficSignFrameResult &traffic_sign_result) {
+    const cv::Scalar state_color = trafficStateColor(traffic_sign_result.detector_state);
+    return {
+        {"Estado: " + std::string(ts::toString(traffic_sign_result.detector_state)), 46, 0.45,
+         state_color},
+        {"ROI X: " + formatDouble(traffic_sign_result.roi.left_ratio, 2) + " -> " +
+             formatDouble(traffic_sign_result.roi.right_ratio, 2),
+         64, 0.36, kTextSecondary},
+        {"ROI Y: " + formatDouble(traffic_sign_result.roi.top_ratio, 2) + " -> " +
+             formatDouble(traffic_sign_result.roi.bottom_ratio, 2) + " | overlay: " +
+             std::string(traffic_sign_result.roi.debug_roi_enabled ? "on" : "off"),
+         82, 0.36, kTextSecondary},
+        {detectorSummaryLabel(traffic_sign_result), 100, 0.36,
+         !traffic_sign_result.last_error.empty() ? kDangerColor : state_color},
+        {"Deteccoes: " + std::to_string(traffic_sign_result.raw_detections.size()) +
+             " | Core FPS: " + formatDouble(runtime_telemetry.core_fps, 1),
+         118, 0.36, kTextSecondary},
+        {"UI FPS: " + formatDouble(runtime_telemetry.stream_fps, 1) +
+             " | Placa FPS: " + formatDouble(runtime_telemetry.traffic_sign_fps, 1),
+         136, 0.36, kTextSecondary},
+        {"Infer placa: " + formatDouble(runtime_telemetry.traffic_sign_inference_ms, 1) + " / " +
+             "UI enc: " + formatDouble(runtime_telemetry.stream_encode_ms, 1) + " ms",
+         154, 0.36, kTextSecondary},
+        {"Drop P/UI: " + std::to_string(runtime_telemetry.traffic_sign_dropped_frames) + " / " +
+             std::to_string(runtime_telemetry.stream_dropped_frames) + " | idade: " +
+             formatAgeLabel(runtime_telemetry.sign_result_age_ms),
+         172, 0.36, kTextSecondary},
+    };
 }
 
-void AutonomousControlDebugRenderer::drawTrafficSignStatus(
-    cv::Mat &panel, const vision::VisionRuntimeTelemetry &runtime_telemetry,
-    const ts::TrafficSignFrameResult &traffic_sign_result,
-    const cv::Rect &area) {
-    cv::rectangle(panel, area, kPanelSection, cv::FILLED);
-    cv::rectangle(panel, area, kPanelBorder, 1, cv::LINE_AA);
-    cv::putText(panel, "Sinalizacao", {area.x + 14, area.y + 26}, cv::FONT_HERSHEY_SIMPLEX,
-                0.6, kTextPrimary, 1, cv::LINE_AA);
-    cv::putText(panel,
-                "Estado: " +
-                    std::string(ts::toString(traffic_sign_result.detector_state)),
-                {area.x + 14, area.y + 46}, cv::FONT_HERSHEY_SIMPLEX, 0.45,
-                trafficStateColor(traffic_sign_result.detector_state), 1, cv::LINE_AA);
-    cv::putText(panel,
-                "ROI X: " + formatDouble(traffic_sign_result.roi.left_ratio, 2) + " -> " +
-                    formatDouble(traffic_sign_result.roi.right_ratio, 2),
-                {area.x + 14, area.y + 64}, cv::FONT_HERSHEY_SIMPLEX, 0.36, kTextSecondary, 1,
-                cv::LINE_AA);
-    cv::putText(panel,
-                "ROI Y: " + formatDouble(traffic_sign_result.roi.top_ratio, 2) + " -> " +
-                    formatDouble(traffic_sign_result.roi.bottom_ratio, 2) + " | overlay: " +
-                    std::string(traffic_sign_result.roi.debug_roi_enabled ? "on" : "off"),
-                {area.x + 14, area.y + 82}, cv::FONT_HERSHEY_SIMPLEX, 0.36, kTextSecondary, 1,
-                cv::LINE_AA);
-    cv::putText(panel,
-                detectorSummaryLabel(traffic_sign_result),
-                {area.x + 14, area.y + 100}, cv::FONT_HERSHEY_SIMPLEX, 0.36,
-                !traffic_sign_result.last_error.empty() ? kDangerColor
-                                                        : trafficStateColor(
-                                                              traffic_sign_result.detector_state),
-                1, cv::LINE_AA);
-    cv::putText(panel,
-                "Deteccoes: " + std::to_string(traffic_sign_result.raw_detections.size()) +
-                    " | Core FPS: " + formatDouble(runtime_telemetry.core_fps, 1),
-                {area.x + 14, area.y + 118}, cv::FONT_HERSHEY_SIMPLEX, 0.36, kTextSecondary, 1,
-                cv::LINE_AA);
-    cv::putText(panel,
-                "UI FPS: " + formatDouble(runtime_telemetry.stream_fps, 1) +
-                    " | Placa FPS: " +
-                    formatDouble(runtime_telemetry.traffic_sign_fps, 1),
-                {area.x + 14, area.y + 136}, cv::FONT_HERSHEY_SIMPLEX, 0.36, kTextSecondary, 1,
-                cv::LINE_AA);
-    cv::putText(panel,
-                "Infer placa: " +
-                    formatDouble(runtime_telemetry.traffic_sign_inference_ms, 1) + " / " +
-                    "UI enc: " + formatDouble(runtime_telemetry.stream_encode_ms, 1) + " ms",
-                {area.x + 14, area.y + 154}, cv::FONT_HERSHEY_SIMPLEX, 0.36, kTextSecondary, 1,
-                cv::LINE_AA);
-    cv::putText(panel,
-                "Drop P/UI: " +
-                    std::to_string(runtime_telemetry.traffic_sign_dropped_frames) + " / " +
-                    std::to_string(runtime_telemetry.stream_dropped_frames) + " | idade: " +
-                    formatAgeLabel(runtime_telemetry.sign_result_age_ms),
-                {area.x + 14, area.y + 172}, cv::FONT_HERSHEY_SIMPLEX, 0.36, kTextSecondary, 1,
-                cv::LINE_AA);
+void AutonomousControlDebugRenderer::drawPanelText(cv::Mat &panel, const cv::Rect &area,
+                                                   const std::vector<PanelText> &lines) {
+    for (const PanelText &line : lines) {
+        cv::putText(panel, line.text, {area.x + 14, area.y + line.y_offset},
+                    cv::FONT_HERSHEY_SIMPLEX, line.scale, line.color, line.thickness, cv::LINE_AA);
+    }
 }
 
 void AutonomousControlDebugRenderer::drawTrafficSignOverlayOnSegmentationPanel(
@@ -371,29 +468,23 @@ void AutonomousControlDebugRenderer::drawTrafficSignOverlayOnSegmentationPanel(
     }
 }
 
+AutonomousControlDebugRenderer::SteeringGaugeState
+AutonomousControlDebugRenderer::steeringGaugeState(const AutonomousControlSnapshot &snapshot,
+                                                   const cv::Rect &area) {
+    const int center_x = area.x + area.width / 2;
+    const int half_width = (area.width - 60) / 2;
+    const double command = std::clamp(snapshot.steering_command, -1.0, 1.0);
+    return {center_x + static_cast<int>(std::round(command * half_width)),
+            command < 0.0 ? kNegativeColor : (command > 0.0 ? kPositiveColor : kNeutralColor)};
+}
+
 void AutonomousControlDebugRenderer::drawSteeringGauge(cv::Mat &panel,
-                                                       const AutonomousControlSnapshot &snapshot,
+                                                       const SteeringGaugeState &state,
                                                        const cv::Rect &area) {
-    cv::rectangle(panel, area, kPanelSection, cv::FILLED);
-    cv::rectangle(panel, area, kPanelBorder, 1, cv::LINE_AA);
-    cv::putText(panel, "Comando de direcao", {area.x + 14, area.y + 24},
-                cv::FONT_HERSHEY_SIMPLEX, 0.52, kTextPrimary, 1, cv::LINE_AA);
-
     const int center_y = area.y + area.height / 2 + 8;
     const int center_x = area.x + area.width / 2;
-    const int half_width = (area.width - 60) / 2;
-
-    cv::line(panel, {center_x - half_width, center_y}, {center_x + half_width, center_y},
-             {110, 110, 110}, 2, cv::LINE_AA);
-    cv::line(panel, {center_x, center_y - 24}, {center_x, center_y + 24}, kNeutralColor, 1,
-             cv::LINE_AA);
 
-    const double command = std::clamp(snapshot.steering_command, -1.0, 1.0);
-    const int arrow_x = center_x + static_cast<int>(std::round(command * half_width));
-    const cv::Scalar arrow_color =
-        command < 0.0 ? kNegativeColor : (command > 0.0 ? kPositiveColor : kNeutralColor);
-
-    cv::arrowedLine(panel, {center_x, center_y}, {arrow_x, center_y}, arrow_color, 4,
+    cv::arrowedLine(panel, {center_x, center_y}, {state.arrow_x, center_y}, state.color, 4,
                     cv::LINE_AA, 0, 0.18);
     cv::putText(panel, "L", {area.x + 18, center_y + 6}, cv::FONT_HERSHEY_SIMPLEX, 0.56,
                 kNegativeColor, 1, cv::LINE_AA);
@@ -401,49 +492,51 @@ void AutonomousControlDebugRenderer::drawSteeringGauge(cv::Mat &panel,
                 0.56, kPositiveColor, 1, cv::LINE_AA);
 }
 
-void AutonomousControlDebugRenderer::drawTopDownPreview(
-    cv::Mat &panel, const AutonomousControlSnapshot &snapshot, const cv::Rect &area) {
-    cv::rectangle(panel, area, kPanelSection, cv::FILLED);
-    cv::rectangle(panel, area, kPanelBorder, 1, cv::LINE_AA);
-    cv::putText(panel, "Mapa superior / previsao", {area.x + 14, area.y + 24},
-                cv::FONT_HERSHEY_SIMPLEX, 0.52, kTextPrimary, 1, cv::LINE_AA);
-
-    const cv::Point vehicle_center(area.x + area.width / 2, area.y + area.height - 30);
-    const std::vector<cv::Point> vehicle_polygon = {
-        {vehicle_center.x, vehicle_center.y - 18},
-        {vehicle_center.x - 14, vehicle_center.y + 12},
-        {vehicle_center.x + 14, vehicle_center.y + 12},
-    };
-    cv::fillConvexPoly(panel, vehicle_polygon, {220, 220, 220}, cv::LINE_AA);
-
-    cv::line(panel, {vehicle_center.x, area.y + 36}, {vehicle_center.x, vehicle_center.y - 28},
-             {100, 100, 100}, 1, cv::LINE_AA);
-
-    const auto draw_reference = [&](const ReferenceControlState &reference, double y_ratio,
-                                    const std::string &label, const cv::Scalar &color) {
+AutonomousControlDebugRenderer::TopDownState
+AutonomousControlDebugRenderer::topDownState(const AutonomousControlSnapshot &snapshot,
+                                             const cv::Rect &area) {
+    TopDownState state;
+    const auto reference_point = [&](const ReferenceControlState &reference,
+                                     double y_ratio) -> std::optional<cv::Point> {
         if (!reference.valid) {
-            return;
+            return std::nullopt;
         }
-
-        const int x = mapNormalizedX(reference.steering_error_normalized, area);
-        const int y = mapNormalizedY(y_ratio, area);
-        cv::circle(panel, {x, y}, 5, color, cv::FILLED, cv::LINE_AA);
-        cv::putText(panel, label, {x + 8, y - 6}, cv::FONT_HERSHEY_SIMPLEX, 0.42, color, 1,
-                    cv::LINE_AA);
+        return cv::Point(mapNormalizedX(reference.steering_error_normalized, area),
+                         mapNormalizedY(y_ratio, area));
     };
-
-    draw_reference(snapshot.far_reference, 0.2, "FAR", {90, 90, 255});
-    draw_reference(snapshot.mid_reference, 0.48, "MID", {255, 180, 0});
-    draw_reference(snapshot.near_reference, 0.75, "NEAR", {60, 220, 120});
+    state.references = {reference_point(snapshot.far_reference, 0.2),
+                        reference_point(snapshot.mid_reference, 0.48),
+                        reference_point(snapshot.near_reference, 0.75)};
 
     if (snapshot.projected_path.size() >= 2) {
-        std::vector<cv::Point> path;
-        path.reserve(snapshot.projected_path.size());
+        state.path.reserve(snapshot.projected_path.size());
         for (const TrajectoryPoint &point : snapshot.projected_path) {
-            path.emplace_back(mapNormalizedX(point.x, area),
-                              mapNormalizedY(1.0 - point.y * 0.92, area));
+            state.path.emplace_back(mapNormalizedX(point.x, area),
+                                    mapNormalizedY(1.0 - point.y * 0.92, area));
+        }
+    }
+    state.path_color = stateColor(snapshot);
+    return state;
+}
+
+void AutonomousControlDebugRenderer::drawTopDownPreview(cv::Mat &panel,
+                                                        const TopDownState &state) {
+    static const std::array<const char *, 3> kLabels = {"FAR", "MID", "NEAR"};
+    static const std::array<cv::Scalar, 3> kColors = {
+        cv::Scalar{90, 90, 255}, cv::Scalar{255, 180, 0}, cv::Scalar{60, 220, 120}};
+    for (std::size_t index = 0; index < state.references.size(); ++index) {
+        if (!state.references[index]) {
+            continue;
         }
-        cv::polylines(panel, path, false, stateColor(snapshot), 3, cv::LINE_AA);
+
+        const cv::Point point = *state.references[index];
+        cv::circle(panel, point, 5, kColors[index], cv::FILLED, cv::LINE_AA);
+        cv::putText(panel, kLabels[index], {point.x + 8, point.y - 6}, cv::FONT_HERSHEY_SIMPLEX,
+                    0.42, kColors[index], 1, cv::LINE_AA);
+    }
+
+    if (state.path.size() >= 2) {
+        cv::polylines(panel, state.path, false, state.path_color, 3, cv::LINE_AA);
     }
 }
 
@@ -2,7 +2,11 @@
 
 #include <opencv2/core.hpp>
 
+#include <array>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <vector>
 
 #include "config/LabConfig.hpp"
 #include "pipeline/RoadSegmentationResult.hpp"
@@ -13,6 +17,10 @@
 
 namespace autonomous_car::services::autonomous_control {
 
+// Dashboard do carro: painel da segmentacao com o overlay de placas e, a direita, o painel de
+// controle. O painel de controle fica retido entre chamadas: fundo, caixas e titulos sao
+// compostos uma vez por tamanho, e cada secao (controle, sinalizacao, direcao, mapa) so e
+// redesenhada quando o que ela mostra mudou. Cada chamada devolve um Mat novo.
 class AutonomousControlDebugRenderer {
 public:
     cv::Mat render(const road_segmentation_lab::pipeline::RoadSegmentationResult &result,
@@ -25,33 +33,84 @@ public:
                        &traffic_sign_result) const;
 
 private:
-    static cv::Mat buildControlPanel(
-        const AutonomousControlSnapshot &snapshot,
+    struct PanelText {
+        std::string text;
+        int y_offset{0};
+        double scale{0.0};
+        cv::Scalar color;
+        int thickness{1};
+
+        bool operator==(const PanelText &other) const;
+        bool operator!=(const PanelText &other) const { return !(*this == other); }
+    };
+
+    struct PanelLayout {
+        cv::Rect control;
+        cv::Rect traffic;
+        cv::Rect gauge;
+        cv::Rect top_down;
+    };
+
+    struct SteeringGaugeState {
+        int arrow_x{0};
+        cv::Scalar color;
+
+        bool operator==(const SteeringGaugeState &other) const;
+        bool operator!=(const SteeringGaugeState &other) const { return !(*this == other); }
+    };
+
+    struct TopDownState {
+        std::array<std::optional<cv::Point>, 3> references;
+        std::vector<cv::Point> path;
+        cv::Scalar path_color;
+
+        bool operator==(const TopDownState &other) const;
+        bool operator!=(const TopDownState &other) const { return !(*this == other); }
+    };
+
+    // Ultimo painel desenhado e o que cada secao mostrava nele.
+    struct ControlPanelCache {
+        cv::Mat chrome;
+        cv::Mat canvas;
+        PanelLayout layout;
+        std::optional<std::vector<PanelText>> control;
+        std::optional<std::vector<PanelText>> traffic;
+        std::optional<SteeringGaugeState> gauge;
+        std::optional<TopDownState> top_down;
+    };
+
+    void paintControlPanel(
+        cv::Mat target, const AutonomousControlSnapshot &snapshot,
         const autonomous_car::services::vision::VisionRuntimeTelemetry &runtime_telemetry,
         const autonomous_car::services::traffic_sign_detection::TrafficSignFrameResult
-            &traffic_sign_result,
-        cv::Size size);
-    static void drawControlStatus(cv::Mat &panel, const AutonomousControlSnapshot &snapshot,
-                                  const cv::Rect &area);
-    static void drawTrafficSignStatus(
-        cv::Mat &panel,
+            &traffic_sign_result) const;
+    static PanelLayout buildPanelLayout(cv::Size size);
+    static void drawPanelChrome(cv::Mat &panel, const PanelLayout &layout);
+    static std::vector<PanelText> controlStatusText(const AutonomousControlSnapshot &snapshot);
+    static std::vector<PanelText> trafficSignStatusText(
         const autonomous_car::services::vision::VisionRuntimeTelemetry &runtime_telemetry,
         const autonomous_car::services::traffic_sign_detection::TrafficSignFrameResult
-            &traffic_sign_result,
-        const cv::Rect &area);
+            &traffic_sign_result);
+    static SteeringGaugeState steeringGaugeState(const AutonomousControlSnapshot &snapshot,
+                                                 const cv::Rect &area);
+    static TopDownState topDownState(const AutonomousControlSnapshot &snapshot,
+                                     const cv::Rect &area);
+    static void drawPanelText(cv::Mat &panel, const cv::Rect &area,
+                              const std::vector<PanelText> &lines);
+    static void drawSteeringGauge(cv::Mat &panel, const SteeringGaugeState &state,
+                                  const cv::Rect &area);
+    static void drawTopDownPreview(cv::Mat &panel, const TopDownState &state);
     static void drawTrafficSignOverlayOnSegmentationPanel(
         cv::Mat &panel, const road_segmentation_lab::pipeline::RoadSegmentationResult &result,
         const autonomous_car::services::traffic_sign_detection::TrafficSignFrameResult
             &traffic_sign_result);
-    static void drawSteeringGauge(cv::Mat &panel, const AutonomousControlSnapshot &snapshot,
-                                  const cv::Rect &area);
-    static void drawTopDownPreview(cv::Mat &panel, const AutonomousControlSnapshot &snapshot,
-                                   const cv::Rect &area);
     static int mapNormalizedX(double x, const cv::Rect &area);
     static int mapNormalizedY(double y, const cv::Rect &area);
     static std::string formatDouble(double value, int precision = 3);
 
     road_segmentation_lab::render::DebugRenderer segmentation_renderer_;
+    mutable std::mutex panel_mutex_;
+    mutable ControlPanelCache panel_cache_;
 };
 
 } // namespace autonomous_car::services::autonomous_control
@@ -1,95 +1,72 @@
 #include "services/autonomous_control/AutonomousControlTelemetry.hpp"
 
-#include <iomanip>
-#include <sstream>
-#include <string_view>
+#include "services/telemetry/JsonWriter.hpp"
 
 namespace autonomous_car::services::autonomous_control {
 namespace {
 
-void appendNumber(std::ostringstream &stream, double value) {
-    stream << std::fixed << std::setprecision(6) << value;
-}
-
-void appendReference(std::ostringstream &stream, const ReferenceControlState &reference) {
-    stream << "{";
-    stream << "\"valid\":" << (reference.valid ? "true" : "false");
-    stream << ",\"used\":" << (reference.used ? "true" : "false");
-    stream << ",\"configured_weight\":";
-    appendNumber(stream, reference.configured_weight);
-    stream << ",\"applied_weight\":";
-    appendNumber(stream, reference.applied_weight);
-    stream << ",\"steering_error_normalized\":";
-    appendNumber(stream, reference.steering_error_normalized);
-    stream << ",\"lateral_offset_px\":";
-    appendNumber(stream, reference.lateral_offset_px);
-    stream << "}";
+void appendReference(telemetry::JsonWriter &json, const ReferenceControlState &reference) {
+    json.raw("{");
+    json.raw("\"valid\":").boolean(reference.valid);
+    json.raw(",\"used\":").boolean(reference.used);
+    json.raw(",\"configured_weight\":").number(reference.configured_weight);
+    json.raw(",\"applied_weight\":").number(reference.applied_weight);
+    json.raw(",\"steering_error_normalized\":").number(reference.steering_error_normalized);
+    json.raw(",\"lateral_offset_px\":").number(reference.lateral_offset_px);
+    json.raw("}");
 }
 
 } // namespace
 
 std::string buildAutonomousControlTelemetryJson(const AutonomousControlSnapshot &snapshot) {
-    std::ostringstream stream;
-    stream << "{";
-    stream << "\"type\":\"telemetry.autonomous_control\"";
-    stream << ",\"timestamp_ms\":" << snapshot.timestamp_ms;
-    stream << ",\"driving_mode\":\"" << toString(snapshot.driving_mode) << "\"";
-    stream << ",\"autonomous_started\":" << (snapshot.autonomous_started ? "true" : "false");
-    stream << ",\"tracking_state\":\"" << toString(snapshot.tracking_state) << "\"";
-    stream << ",\"stop_reason\":\"" << toString(snapshot.stop_reason) << "\"";
-    stream << ",\"fail_safe_active\":" << (snapshot.fail_safe_active ? "true" : "false");
-    stream << ",\"lane_available\":" << (snapshot.lane_available ? "true" : "false");
-    stream << ",\"confidence_ok\":" << (snapshot.confidence_ok ? "true" : "false");
-    stream << ",\"confidence_score\":";
-    appendNumber(stream, snapshot.confidence_score);
-    stream << ",\"preview_error\":";
-    appendNumber(stream, snapshot.preview_error);
-    stream << ",\"heading_error_rad\":";
-    appendNumber(stream, snapshot.heading_error_rad);
-    stream << ",\"heading_valid\":" << (snapshot.heading_valid ? "true" : "false");
-    stream << ",\"curvature_indicator_rad\":";
-    appendNumber(stream, snapshot.curvature_indicator_rad);
-    stream << ",\"curvature_valid\":" << (snapshot.curvature_valid ? "true" : "false");
-    stream << ",\"references\":{";
-    stream << "\"near\":";
-    appendReference(stream, snapshot.near_reference);
-    stream << ",\"mid\":";
-    appendReference(stream, snapshot.mid_reference);
-    stream << ",\"far\":";
-    appendReference(stream, snapshot.far_reference);
-    stream << "}";
-    stream << ",\"pid\":{";
-    stream << "\"error\":";
-    appendNumber(stream, snapshot.pid.error);
-    stream << ",\"p\":";
-    appendNumber(stream, snapshot.pid.proportional);
-    stream << ",\"i\":";
-    appendNumber(stream, snapshot.pid.integral);
-    stream << ",\"d\":";
-    appendNumber(stream, snapshot.pid.derivative);
-    stream << ",\"raw_output\":";
-    appendNumber(stream, snapshot.pid.raw_output);
-    stream << ",\"output\":";
-    appendNumber(stream, snapshot.pid.pid_output);
-    stream << "}";
-    stream << ",\"steering_command\":";
-    appendNumber(stream, snapshot.steering_command);
-    stream << ",\"motion_command\":\"" << toString(snapshot.motion_command) << "\"";
-    stream << ",\"projected_path\":[";
+    telemetry::JsonWriter &json = telemetry::threadJsonWriter();
+    json.raw("{");
+    json.raw("\"type\":\"telemetry.autonomous_control\"");
+    json.raw(",\"timestamp_ms\":").integer(snapshot.timestamp_ms);
+    json.raw(",\"driving_mode\":\"").raw(toString(snapshot.driving_mode)).raw("\"");
+    json.raw(",\"autonomous_started\":").boolean(snapshot.autonomous_started);
+    json.raw(",\"tracking_state\":\"").raw(toString(snapshot.tracking_state)).raw("\"");
+    json.raw(",\"stop_reason\":\"").raw(toString(snapshot.stop_reason)).raw("\"");
+    json.raw(",\"fail_safe_active\":").boolean(snapshot.fail_safe_active);
+    json.raw(",\"lane_available\":").boolean(snapshot.lane_available);
+    json.raw(",\"confidence_ok\":").boolean(snapshot.confidence_ok);
+    json.raw(",\"confidence_score\":").number(snapshot.confidence_score);
+    json.raw(",\"preview_error\":").number(snapshot.preview_error);
+    json.raw(",\"heading_error_rad\":").number(snapshot.heading_error_rad);
+    json.raw(",\"heading_valid\":").boolean(snapshot.heading_valid);
+    json.raw(",\"curvature_indicator_rad\":").number(snapshot.curvature_indicator_rad);
+    json.raw(",\"curvature_valid\":").boolean(snapshot.curvature_valid);
+    json.raw(",\"references\":{");
+    json.raw("\"near\":");
+    appendReference(json, snapshot.near_reference);
+    json.raw(",\"mid\":");
+    appendReference(json, snapshot.mid_reference);
+    json.raw(",\"far\":");
+    appendReference(json, snapshot.far_reference);
+    json.raw("}");
+    json.raw(",\"pid\":{");
+    json.raw("\"error\":").number(snapshot.pid.error);
+    json.raw(",\"p\":").number(snapshot.pid.proportional);
+    json.raw(",\"i\":").number(snapshot.pid.integral);
+    json.raw(",\"d\":").number(snapshot.pid.derivative);
+    json.raw(",\"raw_output\":").number(snapshot.pid.raw_output);
+    json.raw(",\"output\":").number(snapshot.pid.pid_output);
+    json.raw("}");
+    json.raw(",\"steering_command\":").number(snapshot.steering_command);
+    json.raw(",\"motion_command\":\"").raw(toString(snapshot.motion_command)).raw("\"");
+    json.raw(",\"projected_path\":[");
     for (std::size_t index = 0; index < snapshot.projected_path.size(); ++index) {
         if (index > 0) {
-            stream << ",";
+            json.raw(",");
         }
-        stream << "{";
-        stream << "\"x\":";
-        appendNumber(stream, snapshot.projected_path[index].x);
-        stream << ",\"y\":";
-        appendNumber(stream, snapshot.projected_path[index].y);
-        stream << "}";
+        json.raw("{");
+        json.raw("\"x\":").number(snapshot.projected_path[index].x);
+        json.raw(",\"y\":").number(snapshot.projected_path[index].y);
+        json.raw("}");
     }
-    stream << "]";
-    stream << "}";
-    return stream.str();
+    json.raw("]");
+    json.raw("}");
+    return json.str();
 }
 
 } // namespace autonomous_car::services::autonomous_control
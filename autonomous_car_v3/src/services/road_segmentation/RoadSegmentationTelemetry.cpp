@@ -1,61 +1,23 @@
 #include "services/road_segmentation/RoadSegmentationTelemetry.hpp"
 
-#include <iomanip>
-#include <sstream>
+#include "services/telemetry/JsonWriter.hpp"
 
 namespace autonomous_car::services::road_segmentation {
 namespace {
 
-std::string jsonEscape(std::string_view value) {
-    std::string escaped;
-    escaped.reserve(value.size());
-
-    for (char ch : value) {
-        switch (ch) {
-        case '\\':
-            escaped += "\\\\";
-            break;
-        case '"':
-            escaped += "\\\"";
-            break;
-        case '\n':
-            escaped += "\\n";
-            break;
-        case '\r':
-            escaped += "\\r";
-            break;
-        case '\t':
-            escaped += "\\t";
-            break;
-        default:
-            escaped.push_back(ch);
-            break;
-        }
-    }
-
-    return escaped;
-}
-
-void appendNumber(std::ostringstream &stream, double value) {
-    stream << std::fixed << std::setprecision(6) << value;
-}
-
-void appendReference(std::ostringstream &stream,
+void appendReference(telemetry::JsonWriter &json,
                      const road_segmentation_lab::pipeline::LookaheadReference &reference) {
-    stream << "{";
-    stream << "\"valid\":" << (reference.valid ? "true" : "false");
-    stream << ",\"point_x\":" << reference.point.x;
-    stream << ",\"point_y\":" << reference.point.y;
-    stream << ",\"top_y\":" << reference.top_y;
-    stream << ",\"bottom_y\":" << reference.bottom_y;
-    stream << ",\"center_ratio\":";
-    appendNumber(stream, reference.center_ratio);
-    stream << ",\"lateral_offset_px\":";
-    appendNumber(stream, reference.lateral_offset_px);
-    stream << ",\"steering_error_normalized\":";
-    appendNumber(stream, reference.steering_error_normalized);
-    stream << ",\"sample_count\":" << reference.sample_count;
-    stream << "}";
+    json.raw("{");
+    json.raw("\"valid\":").boolean(reference.valid);
+    json.raw(",\"point_x\":").integer(reference.point.x);
+    json.raw(",\"point_y\":").integer(reference.point.y);
+    json.raw(",\"top_y\":").integer(reference.top_y);
+    json.raw(",\"bottom_y\":").integer(reference.bottom_y);
+    json.raw(",\"center_ratio\":").number(reference.center_ratio);
+    json.raw(",\"lateral_offset_px\":").number(reference.lateral_offset_px);
+    json.raw(",\"steering_error_normalized\":").number(reference.steering_error_normalized);
+    json.raw(",\"sample_count\":").integer(reference.sample_count);
+    json.raw("}");
 }
 
 } // namespace
@@ -63,36 +25,30 @@ void appendReference(std::ostringstream &stream,
 std::string buildRoadSegmentationTelemetryJson(
     const road_segmentation_lab::pipeline::RoadSegmentationResult &result,
     std::string_view source, std::int64_t timestamp_ms) {
-    std::ostringstream stream;
-    stream << "{";
-    stream << "\"type\":\"telemetry.road_segmentation\"";
-    stream << ",\"timestamp_ms\":" << timestamp_ms;
-    stream << ",\"source\":\"" << jsonEscape(source) << "\"";
-    stream << ",\"lane_found\":" << (result.lane_found ? "true" : "false");
-    stream << ",\"confidence_score\":";
-    appendNumber(stream, result.confidence_score);
-    stream << ",\"lane_center_ratio\":";
-    appendNumber(stream, result.lane_center_ratio);
-    stream << ",\"steering_error_normalized\":";
-    appendNumber(stream, result.steering_error_normalized);
-    stream << ",\"lateral_offset_px\":";
-    appendNumber(stream, result.lateral_offset_px);
-    stream << ",\"heading_error_rad\":";
-    appendNumber(stream, result.heading_error_rad);
-    stream << ",\"heading_valid\":" << (result.heading_valid ? "true" : "false");
-    stream << ",\"curvature_indicator_rad\":";
-    appendNumber(stream, result.curvature_indicator_rad);
-    stream << ",\"curvature_valid\":" << (result.curvature_valid ? "true" : "false");
-    stream << ",\"references\":{";
-    stream << "\"near\":";
-    appendReference(stream, result.near_reference);
-    stream << ",\"mid\":";
-    appendReference(stream, result.mid_reference);
-    stream << ",\"far\":";
-    appendReference(stream, result.far_reference);
-    stream << "}";
-    stream << "}";
-    return stream.str();
+    telemetry::JsonWriter &json = telemetry::threadJsonWriter();
+    json.raw("{");
+    json.raw("\"type\":\"telemetry.road_segmentation\"");
+    json.raw(",\"timestamp_ms\":").integer(timestamp_ms);
+    json.raw(",\"source\":").string(source);
+    json.raw(",\"lane_found\":").boolean(result.lane_found);
+    json.raw(",\"confidence_score\":").number(result.confidence_score);
+    json.raw(",\"lane_center_ratio\":").number(result.lane_center_ratio);
+    json.raw(",\"steering_error_normalized\":").number(result.steering_error_normalized);
+    json.raw(",\"lateral_offset_px\":").number(result.lateral_offset_px);
+    json.raw(",\"heading_error_rad\":").number(result.heading_error_rad);
+    json.raw(",\"heading_valid\":").boolean(result.heading_valid);
+    json.raw(",\"curvature_indicator_rad\":").number(result.curvature_indicator_rad);
+    json.raw(",\"curvature_valid\":").boolean(result.curvature_valid);
+    json.raw(",\"references\":{");
+    json.raw("\"near\":");
+    appendReference(json, result.near_reference);
+    json.raw(",\"mid\":");
+    appendReference(json, result.mid_reference);
+    json.raw(",\"far\":");
+    appendReference(json, result.far_reference);
+    json.raw("}");
+    json.raw("}");
+    return json.str();
 }
 
 } // namespace autonomous_car::services::road_segmentation
@@ -95,6 +95,15 @@ std::optional<VisionSourceMode> parseSourceMode(const std::string &value) {
     return std::nullopt;
 }
 
+// shm_open aceita so "/nome", sem outras barras; a barra inicial e opcional no arquivo.
+std::optional<std::string> parseSharedMemoryName(const std::string &value) {
+    const std::string name = value.front() == '/' ? value : "/" + value;
+    if (name.size() < 2 || name.size() > 255 || name.find('/', 1) != std::string::npos) {
+        return std::nullopt;
+    }
+    return name;
+}
+
 std::string resolveMaybeRelativePath(const std::filesystem::path &config_path,
                                      const std::string &raw_value) {
     if (raw_value.empty()) {
@@ -238,6 +247,52 @@ bool loadVisionRuntimeConfigFromFile(const std::string &path, VisionRuntimeConfi
             continue;
         }
 
+        if (key == "VISION_STREAM_JPEG_FAST_DCT") {
+            if (const auto parsed = parseBool(value)) {
+                config.stream_jpeg_fast_dct = *parsed;
+            } else {
+                pushWarning(warnings, "Valor invalido para " + key);
+            }
+            continue;
+        }
+
+        if (key == "VISION_STREAM_JPEG_SUBSAMPLING") {
+            const auto parsed = parseInt(value);
+            if (parsed && (*parsed == 444 || *parsed == 422 || *parsed == 420)) {
+                config.stream_jpeg_subsampling = *parsed;
+            } else {
+                pushWarning(warnings, "Valor invalido para " + key);
+            }
+            continue;
+        }
+
+        if (key == "VISION_STREAM_BUDGET_KBYTES_PER_SEC") {
+            if (const auto parsed = parseInt(value)) {
+                config.stream_budget_kbytes_per_sec = std::max(0, *parsed);
+            } else {
+                pushWarning(warnings, "Valor invalido para " + key);
+            }
+            continue;
+        }
+
+        if (key == "VISION_STREAM_ENCODE_WORKERS") {
+            if (const auto parsed = parseInt(value)) {
+                config.stream_encode_workers = std::clamp(*parsed, 1, 5);
+            } else {
+                pushWarning(warnings, "Valor invalido para " + key);
+            }
+            continue;
+        }
+
+        if (key == "VISION_SEGMENTATION_PIPELINE_DEPTH") {
+            if (const auto parsed = parseInt(value)) {
+                config.segmentation_pipeline_depth = *parsed <= 1 ? 0 : std::min(*parsed, 3);
+            } else {
+                pushWarning(warnings, "Valor invalido para " + key);
+            }
+            continue;
+        }
+
         if (key == "VISION_SEGMENTATION_CONFIG_PATH") {
             config.segmentation_config_path = resolveMaybeRelativePath(config_path, value);
             continue;
@@ -248,6 +303,17 @@ bool loadVisionRuntimeConfigFromFile(const std::string &path, VisionRuntimeConfi
             continue;
         }
 
+        if (key == "VISION_LOCAL_FRAME_RING") {
+            if (value.empty()) {
+                config.local_frame_ring_name.clear();
+            } else if (const auto parsed = parseSharedMemoryName(value)) {
+                config.local_frame_ring_name = *parsed;
+            } else {
+                pushWarning(warnings, "Valor invalido para " + key);
+            }
+            continue;
+        }
+
         pushWarning(warnings, "Chave desconhecida em vision.env: " + key);
     }
 
@@ -21,8 +21,19 @@ struct VisionRuntimeConfig {
     double stream_max_fps{5.0};
     double traffic_sign_target_fps{4.0};
     int stream_jpeg_quality{70};
+    bool stream_jpeg_fast_dct{true};
+    // 444, 422 ou 420.
+    int stream_jpeg_subsampling{420};
+    // Orcamento de banda do stream somando todos os clientes; 0 mantem a qualidade fixa.
+    int stream_budget_kbytes_per_sec{0};
+    // Threads que renderizam e codificam as views do stream em paralelo (1 a 5).
+    int stream_encode_workers{2};
+    // 0 roda o pipeline de segmentacao em serie; 2 ou 3 liga o executor em pipeline.
+    int segmentation_pipeline_depth{0};
     std::string segmentation_config_path;
     std::string traffic_sign_config_path;
+    // Nome POSIX do anel de frames crus para consumidores locais; vazio desliga.
+    std::string local_frame_ring_name;
 };
 
 std::string toString(VisionSourceMode mode);
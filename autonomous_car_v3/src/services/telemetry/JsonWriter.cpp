@@ -0,0 +1,63 @@
+#include "services/telemetry/JsonWriter.hpp"
+
+namespace autonomous_car::services::telemetry {
+namespace {
+
+constexpr std::size_t kInitialCapacity = 2048;
+// Maior double em notacao fixa com 6 casas: sinal + 309 digitos + ponto + 6.
+constexpr std::size_t kMaxFixedDoubleChars = 320;
+
+char escapeOf(char ch) {
+    switch (ch) {
+    case '\\':
+        return '\\';
+    case '"':
+        return '"';
+    case '\n':
+        return 'n';
+    case '\r':
+        return 'r';
+    case '\t':
+        return 't';
+    default:
+        return '\0';
+    }
+}
+
+} // namespace
+
+JsonWriter &JsonWriter::number(double value) {
+    char digits[kMaxFixedDoubleChars];
+    const auto result =
+        std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::fixed, 6);
+    buffer_.append(digits, result.ptr);
+    return *this;
+}
+
+JsonWriter &JsonWriter::string(std::string_view value) {
+    buffer_.push_back('"');
+    // Caminho rapido: copia de uma vez cada trecho sem caractere a escapar.
+    std::size_t start = 0;
+    for (std::size_t index = 0; index < value.size(); ++index) {
+        const char escaped = escapeOf(value[index]);
+        if (escaped == '\0') {
+            continue;
+        }
+        buffer_.append(value.data() + start, index - start);
+        buffer_.push_back('\\');
+        buffer_.push_back(escaped);
+        start = index + 1;
+    }
+    buffer_.append(value.data() + start, value.size() - start);
+    buffer_.push_back('"');
+    return *this;
+}
+
+JsonWriter &threadJsonWriter() {
+    thread_local JsonWriter writer;
+    writer.clear();
+    writer.reserve(kInitialCapacity);
+    return writer;
+}
+
+} // namespace autonomous_car::services::telemetry
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace autonomous_car::services::telemetry {
+
+// Escritor de JSON so de acrescimo sobre um buffer reaproveitado. O chamador escreve a pontuacao
+// e as chaves com raw(), como fazia com o ostringstream; o escritor so formata valores. A saida
+// e identica a do ostringstream antigo: doubles com std::fixed e 6 casas, inteiros em decimal,
+// strings com \\, ", \n, \r e \t escapados e o resto copiado como veio. Nao depende de locale.
+class JsonWriter {
+public:
+    JsonWriter &raw(std::string_view text) {
+        buffer_.append(text);
+        return *this;
+    }
+
+    JsonWriter &number(double value);
+
+    template <typename Integer,
+              typename = std::enable_if_t<std::is_integral_v<Integer> &&
+                                          !std::is_same_v<Integer, bool>>>
+    JsonWriter &integer(Integer value) {
+        char digits[24];
+        const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        buffer_.append(digits, result.ptr);
+        return *this;
+    }
+
+    JsonWriter &boolean(bool value) { return raw(value ? "true" : "false"); }
+
+    // Valor entre aspas, escapado.
+    JsonWriter &string(std::string_view value);
+
+    void reserve(std::size_t capacity) { buffer_.reserve(capacity); }
+    void clear() noexcept { buffer_.clear(); }
+    [[nodiscard]] const std::string &str() const noexcept { return buffer_; }
+    [[nodiscard]] std::size_t size() const noexcept { return buffer_.size(); }
+
+private:
+    std::string buffer_;
+};
+
+// Escritor da thread, ja limpo; a capacidade do buffer fica de uma mensagem para a outra.
+JsonWriter &threadJsonWriter();
+
+} // namespace autonomous_car::services::telemetry
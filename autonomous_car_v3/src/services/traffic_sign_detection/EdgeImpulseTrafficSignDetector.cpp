@@ -1,6 +1,7 @@
 #include "services/traffic_sign_detection/EdgeImpulseTrafficSignDetector.hpp"
 
 #include <algorithm>
+#include <cstdint>
 #include <cstring>
 #include <sstream>
 
@@ -15,6 +16,48 @@ namespace {
 constexpr const char *kModelCompatibilityError =
     "Modelo Edge Impulse sem classes esperadas. Substitua o export pelo pacote atualizado do V3.";
 
+// O SDK pede a entrada em pedacos; cada pedaco sai direto dos pixels do buffer do modelo,
+// convertido de uma vez (vetorizado pelo OpenCV), sem um buffer float do tamanho da imagem.
+ei::signal_t signalFromPixels(const cv::Mat &pixels) {
+    ei::signal_t signal;
+    signal.total_length = pixels.total();
+    signal.get_data = [&pixels](size_t offset, size_t length, float *out_ptr) -> int {
+        if (!pixels.isContinuous() || offset + length > pixels.total()) {
+            return -1;
+        }
+
+        const cv::Mat source(1, static_cast<int>(length), CV_8UC1,
+                             const_cast<std::uint8_t *>(pixels.ptr<std::uint8_t>() + offset));
+        cv::Mat target(1, static_cast<int>(length), CV_32FC1, out_ptr);
+        source.convertTo(target, CV_32F);
+        return 0;
+    };
+    return signal;
+}
+
+// Com modelo int8 o SDK tem um caminho de imagem que aplica escala e zero-point direto no tensor
+// de entrada, sem a matriz float de features. probe decide no aquecimento se o modelo o aceita.
+EI_IMPULSE_ERROR runClassifierOn(const cv::Mat &pixels, QuantizedInputSelector &selector,
+                                 bool probe, ei_impulse_result_t &result) {
+    ei::signal_t signal = signalFromPixels(pixels);
+    const auto run_float = [&] {
+        result = {};
+        return run_classifier(&signal, &result, false);
+    };
+#if defined(EI_CLASSIFIER_QUANTIZATION_ENABLED) && EI_CLASSIFIER_QUANTIZATION_ENABLED == 1 && \
+    EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE
+    const auto run_quantized = [&] {
+        return run_classifier_image_quantized(&signal, &result, false);
+    };
+    return probe ? selector.probe(EI_IMPULSE_OK, run_quantized, run_float)
+                 : selector.run(EI_IMPULSE_OK, run_quantized, run_float);
+#else
+    static_cast<void>(selector);
+    static_cast<void>(probe);
+    return run_float();
+#endif
+}
+
 std::string describeModelLabels() {
     std::ostringstream stream;
     for (int index = 0; index < EI_CLASSIFIER_LABEL_COUNT; ++index) {
@@ -29,13 +72,22 @@ std::string describeModelLabels() {
 } // namespace
 
 EdgeImpulseTrafficSignDetector::EdgeImpulseTrafficSignDetector(TrafficSignConfig config)
-    : config_(std::move(config)),
-      input_buffer_(EI_CLASSIFIER_RAW_SAMPLE_COUNT, 0.0f) {
+    : config_(std::move(config)) {
     model_labels_summary_ = describeModelLabels();
     std::string validation_error;
     model_ready_ = validateModelLabels(validation_error);
     if (!model_ready_) {
         last_error_ = std::move(validation_error);
+        return;
+    }
+
+    if (config_.enabled) {
+        // Inferencia de aquecimento: interpretador, arena e escolha do caminho int8 ficam
+        // resolvidos antes do primeiro frame, que nao paga esse custo no traffic_sign_inference_ms.
+        resized_buffer_ = cv::Mat::zeros(EI_CLASSIFIER_INPUT_HEIGHT, EI_CLASSIFIER_INPUT_WIDTH,
+                                         CV_8UC1);
+        ei_impulse_result_t warmup_result = {};
+        runClassifierOn(resized_buffer_, input_selector_, true, warmup_result);
     }
 }
 
@@ -96,23 +148,11 @@ TrafficSignFrameResult EdgeImpulseTrafficSignDetector::detect(
         roi_frame = frame(roi.frame_rect);
     }
 
-    prepareInputBuffer(roi_frame);
-
-    ei::signal_t signal;
-    signal.total_length = input_buffer_.size();
-    signal.get_data = [this](size_t offset, size_t length, float *out_ptr) -> int {
-        if (offset + length > input_buffer_.size()) {
-            return -1;
-        }
-
-        std::copy(input_buffer_.begin() + static_cast<std::ptrdiff_t>(offset),
-                  input_buffer_.begin() + static_cast<std::ptrdiff_t>(offset + length),
-                  out_ptr);
-        return 0;
-    };
+    prepareModelInput(roi_frame);
 
     ei_impulse_result_t result = {};
-    const EI_IMPULSE_ERROR run_error = run_classifier(&signal, &result, false);
+    const EI_IMPULSE_ERROR run_error =
+        runClassifierOn(resized_buffer_, input_selector_, false, result);
     if (run_error != EI_IMPULSE_OK) {
         last_error_ = "Falha ao executar inferencia do Edge Impulse.";
         return makeErrorResult(full_frame_size, timestamp_ms, last_error_);
@@ -225,7 +265,7 @@ void EdgeImpulseTrafficSignDetector::attachModelDebugInfo(
     }
 }
 
-void EdgeImpulseTrafficSignDetector::prepareInputBuffer(const cv::Mat &roi_frame) {
+void EdgeImpulseTrafficSignDetector::prepareModelInput(const cv::Mat &roi_frame) {
     if (roi_frame.channels() == 1) {
         grayscale_buffer_ = roi_frame;
     } else if (roi_frame.channels() == 4) {
@@ -234,23 +274,10 @@ void EdgeImpulseTrafficSignDetector::prepareInputBuffer(const cv::Mat &roi_frame
         cv::cvtColor(roi_frame, grayscale_buffer_, cv::COLOR_BGR2GRAY);
     }
 
+    // resize reaproveita resized_buffer_, que sai continuo: o signal le dele sem copia.
     cv::resize(grayscale_buffer_, resized_buffer_,
                cv::Size(EI_CLASSIFIER_INPUT_WIDTH, EI_CLASSIFIER_INPUT_HEIGHT), 0.0, 0.0,
                cv::INTER_AREA);
-
-    const std::size_t expected_size =
-        static_cast<std::size_t>(resized_buffer_.rows * resized_buffer_.cols);
-    if (input_buffer_.size() != expected_size) {
-        input_buffer_.assign(expected_size, 0.0f);
-    }
-
-    for (int row = 0; row < resized_buffer_.rows; ++row) {
-        const auto *row_ptr = resized_buffer_.ptr<std::uint8_t>(row);
-        for (int col = 0; col < resized_buffer_.cols; ++col) {
-            input_buffer_[static_cast<std::size_t>(row * resized_buffer_.cols + col)] =
-                static_cast<float>(row_ptr[col]);
-        }
-    }
 }
 
 } // namespace autonomous_car::services::traffic_sign_detection
@@ -1,10 +1,10 @@
 #pragma once
 
 #include <string>
-#include <vector>
 
 #include <opencv2/core.hpp>
 
+#include "services/traffic_sign_detection/QuantizedInputSelector.hpp"
 #include "services/traffic_sign_detection/TrafficSignConfig.hpp"
 #include "services/traffic_sign_detection/TrafficSignDetector.hpp"
 
@@ -28,15 +28,17 @@ private:
     void attachModelDebugInfo(TrafficSignFrameResult &frame_result,
                               const cv::Mat &roi_frame,
                               bool capture_debug_frames);
-    void prepareInputBuffer(const cv::Mat &roi_frame);
+    // Deixa em resized_buffer_ a entrada do modelo, em cinza 8 bits.
+    void prepareModelInput(const cv::Mat &roi_frame);
 
     TrafficSignConfig config_;
     bool model_ready_{false};
+    // Caminho int8 do SDK, decidido na inferencia de aquecimento do construtor.
+    QuantizedInputSelector input_selector_;
     std::string last_error_;
     std::string model_labels_summary_;
     cv::Mat grayscale_buffer_;
     cv::Mat resized_buffer_;
-    std::vector<float> input_buffer_;
 };
 
 } // namespace autonomous_car::services::traffic_sign_detection
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+
+namespace autonomous_car::services::traffic_sign_detection {
+
+// Escolhe entre o caminho int8 do classificador (quantiza direto no tensor de entrada) e o
+// caminho float. O suporte e decidido uma unica vez, em probe(), na inferencia de aquecimento:
+// se o modelo recusar a entrada quantizada ali, o int8 fica desligado. Depois disso, um erro do
+// int8 em um frame so vale para aquele frame, que e refeito pelo caminho float.
+// Nao depende do SDK: Status e o codigo de erro dele e ok o valor de sucesso.
+class QuantizedInputSelector {
+public:
+    template <typename Status, typename RunQuantized, typename RunFloat>
+    Status probe(Status ok, RunQuantized &&run_quantized, RunFloat &&run_float) {
+        quantized_enabled_ = run_quantized() == ok;
+        return quantized_enabled_ ? ok : run_float();
+    }
+
+    template <typename Status, typename RunQuantized, typename RunFloat>
+    Status run(Status ok, RunQuantized &&run_quantized, RunFloat &&run_float) {
+        if (quantized_enabled_) {
+            if (run_quantized() == ok) {
+                return ok;
+            }
+            ++quantized_fallbacks_;
+        }
+        return run_float();
+    }
+
+    [[nodiscard]] bool quantizedEnabled() const noexcept { return quantized_enabled_; }
+    // Frames em que o int8 falhou depois de aceito no aquecimento.
+    [[nodiscard]] std::uint64_t quantizedFallbacks() const noexcept { return quantized_fallbacks_; }
+
+private:
+    bool quantized_enabled_{false};
+    std::uint64_t quantized_fallbacks_{0};
+};
+
+} // namespace autonomous_car::services::traffic_sign_detection
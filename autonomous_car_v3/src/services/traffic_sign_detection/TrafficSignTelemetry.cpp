@@ -1,132 +1,89 @@
 #include "services/traffic_sign_detection/TrafficSignTelemetry.hpp"
 
-#include <iomanip>
-#include <sstream>
-#include <string_view>
+#include "services/telemetry/JsonWriter.hpp"
 
 namespace autonomous_car::services::traffic_sign_detection {
 namespace {
 
-std::string jsonEscape(std::string_view value) {
-    std::string escaped;
-    escaped.reserve(value.size());
-
-    for (char ch : value) {
-        switch (ch) {
-        case '\\':
-            escaped += "\\\\";
-            break;
-        case '"':
-            escaped += "\\\"";
-            break;
-        case '\n':
-            escaped += "\\n";
-            break;
-        case '\r':
-            escaped += "\\r";
-            break;
-        case '\t':
-            escaped += "\\t";
-            break;
-        default:
-            escaped.push_back(ch);
-            break;
-        }
-    }
-
-    return escaped;
-}
-
-void appendNumber(std::ostringstream &stream, double value) {
-    stream << std::fixed << std::setprecision(6) << value;
-}
-
-void appendBoundingBoxJson(std::ostringstream &stream, const TrafficSignBoundingBox &bbox) {
-    stream << "{";
-    stream << "\"x\":" << bbox.x;
-    stream << ",\"y\":" << bbox.y;
-    stream << ",\"width\":" << bbox.width;
-    stream << ",\"height\":" << bbox.height;
-    stream << "}";
+void appendBoundingBoxJson(telemetry::JsonWriter &json, const TrafficSignBoundingBox &bbox) {
+    json.raw("{");
+    json.raw("\"x\":").integer(bbox.x);
+    json.raw(",\"y\":").integer(bbox.y);
+    json.raw(",\"width\":").integer(bbox.width);
+    json.raw(",\"height\":").integer(bbox.height);
+    json.raw("}");
 }
 
-void appendDetectionJson(std::ostringstream &stream, const TrafficSignDetection &detection) {
-    stream << "{";
-    stream << "\"sign_id\":\"" << toString(detection.sign_id) << "\"";
-    stream << ",\"model_label\":\"" << jsonEscape(detection.model_label) << "\"";
-    stream << ",\"display_label\":\"" << jsonEscape(detection.display_label) << "\"";
-    stream << ",\"confidence_score\":";
-    appendNumber(stream, detection.confidence_score);
-    stream << ",\"bbox_frame\":";
-    appendBoundingBoxJson(stream, detection.bbox_frame);
-    stream << ",\"bbox_roi\":";
-    appendBoundingBoxJson(stream, detection.bbox_roi);
-    stream << ",\"consecutive_frames\":" << detection.consecutive_frames;
-    stream << ",\"required_frames\":" << detection.required_frames;
-    stream << ",\"confirmed_at_ms\":" << detection.confirmed_at_ms;
-    stream << ",\"last_seen_at_ms\":" << detection.last_seen_at_ms;
-    stream << "}";
+void appendDetectionJson(telemetry::JsonWriter &json, const TrafficSignDetection &detection) {
+    json.raw("{");
+    json.raw("\"sign_id\":\"").raw(toString(detection.sign_id)).raw("\"");
+    json.raw(",\"model_label\":").string(detection.model_label);
+    json.raw(",\"display_label\":").string(detection.display_label);
+    json.raw(",\"confidence_score\":").number(detection.confidence_score);
+    json.raw(",\"bbox_frame\":");
+    appendBoundingBoxJson(json, detection.bbox_frame);
+    json.raw(",\"bbox_roi\":");
+    appendBoundingBoxJson(json, detection.bbox_roi);
+    json.raw(",\"consecutive_frames\":").integer(detection.consecutive_frames);
+    json.raw(",\"required_frames\":").integer(detection.required_frames);
+    json.raw(",\"confirmed_at_ms\":").integer(detection.confirmed_at_ms);
+    json.raw(",\"last_seen_at_ms\":").integer(detection.last_seen_at_ms);
+    json.raw("}");
 }
 
-void appendOptionalDetection(std::ostringstream &stream,
+void appendOptionalDetection(telemetry::JsonWriter &json,
                              const std::optional<TrafficSignDetection> &detection) {
     if (!detection.has_value()) {
-        stream << "null";
+        json.raw("null");
         return;
     }
 
-    appendDetectionJson(stream, *detection);
+    appendDetectionJson(json, *detection);
 }
 
 } // namespace
 
 std::string buildTrafficSignTelemetryJson(const TrafficSignFrameResult &result,
                                           std::string_view source) {
-    std::ostringstream stream;
-    stream << "{";
-    stream << "\"type\":\"telemetry.traffic_sign_detection\"";
-    stream << ",\"timestamp_ms\":" << result.timestamp_ms;
-    stream << ",\"source\":\"" << jsonEscape(source) << "\"";
-    stream << ",\"detector_state\":\"" << toString(result.detector_state) << "\"";
-    stream << ",\"roi\":{";
-    stream << "\"left_ratio\":";
-    appendNumber(stream, result.roi.left_ratio);
-    stream << ",\"right_ratio\":";
-    appendNumber(stream, result.roi.right_ratio);
-    stream << ",\"top_ratio\":";
-    appendNumber(stream, result.roi.top_ratio);
-    stream << ",\"bottom_ratio\":";
-    appendNumber(stream, result.roi.bottom_ratio);
-    stream << ",\"right_width_ratio\":";
-    appendNumber(stream, trafficSignRoiRightWidthRatio(result.roi));
-    stream << ",\"debug_roi_enabled\":"
-           << (result.roi.debug_roi_enabled ? "true" : "false");
-    stream << ",\"source_frame_size\":{";
-    stream << "\"width\":" << result.roi.source_frame_size.width;
-    stream << ",\"height\":" << result.roi.source_frame_size.height;
-    stream << "}";
-    stream << ",\"frame_rect\":{";
-    stream << "\"x\":" << result.roi.frame_rect.x;
-    stream << ",\"y\":" << result.roi.frame_rect.y;
-    stream << ",\"width\":" << result.roi.frame_rect.width;
-    stream << ",\"height\":" << result.roi.frame_rect.height;
-    stream << "}";
-    stream << "}";
-    stream << ",\"raw_detections\":[";
+    telemetry::JsonWriter &json = telemetry::threadJsonWriter();
+    json.raw("{");
+    json.raw("\"type\":\"telemetry.traffic_sign_detection\"");
+    json.raw(",\"timestamp_ms\":").integer(result.timestamp_ms);
+    json.raw(",\"source\":").string(source);
+    json.raw(",\"detector_state\":\"").raw(toString(result.detector_state)).raw("\"");
+    json.raw(",\"roi\":{");
+    json.raw("\"left_ratio\":").number(result.roi.left_ratio);
+    json.raw(",\"right_ratio\":").number(result.roi.right_ratio);
+    json.raw(",\"top_ratio\":").number(result.roi.top_ratio);
+    json.raw(",\"bottom_ratio\":").number(result.roi.bottom_ratio);
+    json.raw(",\"right_width_ratio\":").number(trafficSignRoiRightWidthRatio(result.roi));
+    json.raw(",\"debug_roi_enabled\":").boolean(result.roi.debug_roi_enabled);
+    json.raw(",\"source_frame_size\":{");
+    json.raw("\"width\":").integer(result.roi.source_frame_size.width);
+    json.raw(",\"height\":").integer(result.roi.source_frame_size.height);
+    json.raw("}");
+    json.raw(",\"frame_rect\":{");
+    json.raw("\"x\":").integer(result.roi.frame_rect.x);
+    json.raw(",\"y\":").integer(result.roi.frame_rect.y);
+    json.raw(",\"width\":").integer(result.roi.frame_rect.width);
+    json.raw(",\"height\":").integer(result.roi.frame_rect.height);
+    json.raw("}");
+    json.raw("}");
+    json.raw(",\"raw_detections\":[");
     for (std::size_t index = 0; index < result.raw_detections.size(); ++index) {
         if (index > 0) {
-            stream << ",";
+            json.raw(",");
         }
-        appendDetectionJson(stream, result.raw_detections[index]);
+        appendDetectionJson(json, result.raw_detections[index]);
     }
-    stream << "]";
-    stream << ",\"candidate\":";
-    appendOptionalDetection(stream, result.candidate);
-    stream << ",\"active_detection\":";
-    appendOptionalDetection(stream, result.active_detection);
-    stream << ",\"last_error\":\"" << jsonEscape(result.last_error) << "\"";
-    stream << "}";
-    return stream.str();
+    json.raw("]");
+    json.raw(",\"candidate\":");
+    appendOptionalDetection(json, result.candidate);
+    json.raw(",\"active_detection\":");
+    appendOptionalDetection(json, result.active_detection);
+    json.raw(",\"last_error\":").string(result.last_error);
+    json.raw("}");
+    return json.str();
 }
 
 } // namespace autonomous_car::services::traffic_sign_detection
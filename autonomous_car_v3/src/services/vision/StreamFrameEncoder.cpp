@@ -0,0 +1,317 @@
+#include "services/vision/StreamFrameEncoder.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <csetjmp>
+#include <cstdio>
+#include <vector>
+
+#include <jpeglib.h>
+
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+
+namespace autonomous_car::services::vision {
+namespace {
+
+constexpr std::size_t kInitialOutputBytes = 64 * 1024;
+constexpr double kBudgetWindowSeconds = 1.0;
+
+std::size_t indexOf(VisionDebugViewId view) { return static_cast<std::size_t>(view); }
+
+} // namespace
+
+// Compressor libjpeg reaproveitado entre frames. Erros da libjpeg voltam por longjmp para
+// writeRows(), que nao tem objetos com destrutor vivos entre o setjmp e a biblioteca.
+class StreamFrameEncoder::JpegCompressor {
+public:
+    JpegCompressor() {
+        compress_.err = jpeg_std_error(&error_.manager);
+        error_.manager.error_exit = &JpegCompressor::onError;
+        error_.manager.output_message = [](j_common_ptr) {};
+        if (setjmp(error_.jump) != 0) {
+            return;
+        }
+        jpeg_create_compress(&compress_);
+        created_ = true;
+
+        destination_.manager.init_destination = &JpegCompressor::initDestination;
+        destination_.manager.empty_output_buffer = &JpegCompressor::emptyOutputBuffer;
+        destination_.manager.term_destination = &JpegCompressor::termDestination;
+        compress_.dest = &destination_.manager;
+    }
+
+    ~JpegCompressor() {
+        if (created_) {
+            jpeg_destroy_compress(&compress_);
+        }
+    }
+
+    JpegCompressor(const JpegCompressor &) = delete;
+    JpegCompressor &operator=(const JpegCompressor &) = delete;
+
+    bool compress(const cv::Mat &frame, int quality, bool fast_dct,
+                  JpegChromaSubsampling subsampling, std::vector<unsigned char> &output) {
+        const int channels = frame.channels();
+        if (!created_ || frame.empty() || frame.depth() != CV_8U ||
+            (channels != 3 && channels != 1)) {
+            return false;
+        }
+
+        const cv::Mat *source = &frame;
+        J_COLOR_SPACE color_space = channels == 3 ? JCS_RGB : JCS_GRAYSCALE;
+#ifdef JCS_EXTENSIONS
+        // libjpeg-turbo le BGR direto, sem a conversao do cv::imencode.
+        if (channels == 3) {
+            color_space = JCS_EXT_BGR;
+        }
+#else
+        if (channels == 3) {
+            cv::cvtColor(frame, rgb_, cv::COLOR_BGR2RGB);
+            source = &rgb_;
+        }
+#endif
+        rows_.resize(static_cast<std::size_t>(source->rows));
+        for (int row = 0; row < source->rows; ++row) {
+            rows_[static_cast<std::size_t>(row)] = const_cast<JSAMPROW>(source->ptr<JSAMPLE>(row));
+        }
+        destination_.output = &output;
+        settings_ = {static_cast<JDIMENSION>(source->cols), static_cast<JDIMENSION>(source->rows),
+                     channels, color_space, std::clamp(quality, 1, 100), fast_dct, subsampling};
+        return writeRows();
+    }
+
+private:
+    // Tudo o que writeRows() usa depois do setjmp vive em membros, a salvo do longjmp.
+    struct Settings {
+        JDIMENSION width;
+        JDIMENSION height;
+        int channels;
+        J_COLOR_SPACE color_space;
+        int quality;
+        bool fast_dct;
+        JpegChromaSubsampling subsampling;
+    };
+
+    bool writeRows() {
+        if (setjmp(error_.jump) != 0) {
+            jpeg_abort_compress(&compress_);
+            return false;
+        }
+
+        compress_.image_width = settings_.width;
+        compress_.image_height = settings_.height;
+        compress_.input_components = settings_.channels;
+        compress_.in_color_space = settings_.color_space;
+        jpeg_set_defaults(&compress_);
+        jpeg_set_quality(&compress_, settings_.quality, TRUE);
+        compress_.dct_method = settings_.fast_dct ? JDCT_IFAST : JDCT_ISLOW;
+        if (settings_.channels == 3) {
+            compress_.comp_info[0].h_samp_factor =
+                settings_.subsampling == JpegChromaSubsampling::Yuv444 ? 1 : 2;
+            compress_.comp_info[0].v_samp_factor =
+                settings_.subsampling == JpegChromaSubsampling::Yuv420 ? 2 : 1;
+            for (int component = 1; component < 3; ++component) {
+                compress_.comp_info[component].h_samp_factor = 1;
+                compress_.comp_info[component].v_samp_factor = 1;
+            }
+        }
+
+        jpeg_start_compress(&compress_, TRUE);
+        while (compress_.next_scanline < compress_.image_height) {
+            jpeg_write_scanlines(&compress_, rows_.data() + compress_.next_scanline,
+                                 compress_.image_height - compress_.next_scanline);
+        }
+        jpeg_finish_compress(&compress_);
+        return true;
+    }
+
+    struct ErrorManager {
+        jpeg_error_mgr manager;
+        std::jmp_buf jump;
+    };
+
+    // Escreve no vetor da view, que guarda a capacidade para o proximo frame.
+    struct Destination {
+        jpeg_destination_mgr manager;
+        std::vector<unsigned char> *output{nullptr};
+    };
+
+    static void onError(j_common_ptr info) {
+        std::longjmp(reinterpret_cast<ErrorManager *>(info->err)->jump, 1);
+    }
+
+    static Destination &destinationOf(j_compress_ptr info) {
+        return *reinterpret_cast<Destination *>(info->dest);
+    }
+
+    static void initDestination(j_compress_ptr info) {
+        Destination &destination = destinationOf(info);
+        auto &output = *destination.output;
+        output.resize(std::max(output.capacity(), kInitialOutputBytes));
+        destination.manager.next_output_byte = output.data();
+        destination.manager.free_in_buffer = output.size();
+    }
+
+    static boolean emptyOutputBuffer(j_compress_ptr info) {
+        Destination &destination = destinationOf(info);
+        auto &output = *destination.output;
+        const std::size_t used = output.size();
+        output.resize(used * 2);
+        destination.manager.next_output_byte = output.data() + used;
+        destination.manager.free_in_buffer = output.size() - used;
+        return TRUE;
+    }
+
+    static void termDestination(j_compress_ptr info) {
+        Destination &destination = destinationOf(info);
+        destination.output->resize(destination.output->size() -
+                                   destination.manager.free_in_buffer);
+    }
+
+    jpeg_compress_struct compress_{};
+    ErrorManager error_{};
+    Destination destination_{};
+    bool created_{false};
+    Settings settings_{};
+    std::vector<JSAMPROW> rows_;
+    cv::Mat rgb_;
+};
+
+StreamFrameEncoder::StreamFrameEncoder(StreamEncoderConfig config) : config_{config} {
+    config_.jpeg_quality = std::clamp(config_.jpeg_quality, 10, 100);
+    config_.min_jpeg_quality = std::clamp(config_.min_jpeg_quality, 10, config_.jpeg_quality);
+    for (auto &state : views_) {
+        state.jpeg_quality = config_.jpeg_quality;
+    }
+}
+
+StreamFrameEncoder::~StreamFrameEncoder() = default;
+
+const EncodedVisionFrame *StreamFrameEncoder::encode(VisionDebugViewId view, const cv::Mat &frame,
+                                                     std::int64_t timestamp_ms,
+                                                     std::string_view variant) {
+    if (frame.empty()) {
+        return nullptr;
+    }
+
+    ViewState &state = stateOf(view);
+    EncodedVisionFrame &encoded = state.frame;
+    bool encoded_ok = false;
+    if (view == VisionDebugViewId::Mask) {
+        encoded.codec = VisionFrameCodec::Png;
+        encoded_ok = encodeMask(frame, encoded);
+    } else {
+        int quality = 0;
+        {
+            std::lock_guard<std::mutex> lock(budget_mutex_);
+            quality = state.jpeg_quality;
+        }
+        if (!state.jpeg) {
+            state.jpeg = std::make_unique<JpegCompressor>();
+        }
+        encoded.codec = VisionFrameCodec::Jpeg;
+        encoded_ok = state.jpeg->compress(frame, quality, config_.jpeg_fast_dct,
+                                          config_.jpeg_subsampling, encoded.data);
+    }
+    if (!encoded_ok) {
+        return nullptr;
+    }
+
+    encoded.view = view;
+    encoded.variant.assign(variant);
+    encoded.timestamp_ms = timestamp_ms;
+    encoded.width = frame.cols;
+    encoded.height = frame.rows;
+    return &encoded;
+}
+
+void StreamFrameEncoder::recordSent(VisionDebugViewId view, std::size_t bytes,
+                                    Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(budget_mutex_);
+    if (window_started_ == Clock::time_point{}) {
+        window_started_ = now;
+    }
+    stateOf(view).window_bytes += bytes;
+
+    const double elapsed = std::chrono::duration<double>(now - window_started_).count();
+    if (elapsed >= kBudgetWindowSeconds) {
+        adaptQuality(elapsed);
+        window_started_ = now;
+    }
+}
+
+int StreamFrameEncoder::jpegQuality(VisionDebugViewId view) const {
+    std::lock_guard<std::mutex> lock(budget_mutex_);
+    return views_[indexOf(view)].jpeg_quality;
+}
+
+double StreamFrameEncoder::sentBytesPerSecond() const {
+    std::lock_guard<std::mutex> lock(budget_mutex_);
+    return sent_bytes_per_second_;
+}
+
+StreamFrameEncoder::ViewState &StreamFrameEncoder::stateOf(VisionDebugViewId view) {
+    return views_[indexOf(view)];
+}
+
+bool StreamFrameEncoder::encodeMask(const cv::Mat &frame, EncodedVisionFrame &encoded) {
+    // O tile da mascara so tem a mascara (preto/branco) e o fundo escuro: 1 bit basta.
+    if (frame.channels() == 3) {
+        cv::cvtColor(frame, mask_gray_, cv::COLOR_BGR2GRAY);
+    } else {
+        mask_gray_ = frame;
+    }
+    cv::threshold(mask_gray_, mask_bits_, 127, 255, cv::THRESH_BINARY);
+
+    static const std::vector<int> kPngParams = {
+        cv::IMWRITE_PNG_BILEVEL, 1,
+        cv::IMWRITE_PNG_COMPRESSION, 1,
+    };
+    return cv::imencode(".png", mask_bits_, encoded.data, kPngParams);
+}
+
+void StreamFrameEncoder::adaptQuality(double window_seconds) {
+    std::size_t total_bytes = 0;
+    std::size_t fixed_bytes = 0;
+    std::size_t active_jpeg_views = 0;
+    for (std::size_t index = 0; index < views_.size(); ++index) {
+        total_bytes += views_[index].window_bytes;
+        if (index == indexOf(VisionDebugViewId::Mask)) {
+            fixed_bytes += views_[index].window_bytes;
+        } else if (views_[index].window_bytes > 0) {
+            ++active_jpeg_views;
+        }
+    }
+    sent_bytes_per_second_ = static_cast<double>(total_bytes) / window_seconds;
+
+    if (config_.byte_budget_per_second > 0 && active_jpeg_views > 0) {
+        const double budget = static_cast<double>(config_.byte_budget_per_second);
+        // O PNG da mascara nao tem qualidade para ajustar; o que ele usa sai da parte do JPEG.
+        const double jpeg_budget =
+            std::max(budget - static_cast<double>(fixed_bytes) / window_seconds, budget * 0.1);
+        const double share = jpeg_budget / static_cast<double>(active_jpeg_views);
+        for (std::size_t index = 0; index < views_.size(); ++index) {
+            ViewState &state = views_[index];
+            if (index == indexOf(VisionDebugViewId::Mask) || state.window_bytes == 0) {
+                continue;
+            }
+
+            const double ratio = static_cast<double>(state.window_bytes) / window_seconds / share;
+            if (ratio > 1.05) {
+                state.jpeg_quality -= std::clamp(static_cast<int>(std::lround((ratio - 1.0) * 20.0)),
+                                                 2, 15);
+            } else if (ratio < 0.85) {
+                state.jpeg_quality += 2;
+            }
+            state.jpeg_quality =
+                std::clamp(state.jpeg_quality, config_.min_jpeg_quality, config_.jpeg_quality);
+        }
+    }
+
+    for (auto &state : views_) {
+        state.window_bytes = 0;
+    }
+}
+
+} // namespace autonomous_car::services::vision
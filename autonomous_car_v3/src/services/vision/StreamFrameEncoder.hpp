@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+
+#include <opencv2/core.hpp>
+
+#include "services/vision/VisionDebugStream.hpp"
+
+namespace autonomous_car::services::vision {
+
+enum class JpegChromaSubsampling { Yuv444, Yuv422, Yuv420 };
+
+struct StreamEncoderConfig {
+    // Qualidade inicial e teto; com orcamento ligado a qualidade de cada view desce a partir dela.
+    int jpeg_quality{70};
+    int min_jpeg_quality{25};
+    bool jpeg_fast_dct{true};
+    JpegChromaSubsampling jpeg_subsampling{JpegChromaSubsampling::Yuv420};
+    // Bytes por segundo somando todos os clientes; 0 mantem a qualidade fixa.
+    std::size_t byte_budget_per_second{0};
+};
+
+// Codificador do stream de debug. encode() e recordSent() podem rodar em paralelo para views
+// diferentes, nunca para a mesma view; recordSent() recebe os bytes de fato enfileirados.
+class StreamFrameEncoder {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit StreamFrameEncoder(StreamEncoderConfig config = {});
+    ~StreamFrameEncoder();
+    StreamFrameEncoder(const StreamFrameEncoder &) = delete;
+    StreamFrameEncoder &operator=(const StreamFrameEncoder &) = delete;
+
+    // Frame codificado da view, valido ate a proxima chamada para a mesma view; nullptr em falha.
+    // variant e o label da variante ja recortada/reduzida em frame (vazio na view inteira).
+    const EncodedVisionFrame *encode(VisionDebugViewId view, const cv::Mat &frame,
+                                     std::int64_t timestamp_ms, std::string_view variant = {});
+    void recordSent(VisionDebugViewId view, std::size_t bytes, Clock::time_point now = Clock::now());
+
+    [[nodiscard]] int jpegQuality(VisionDebugViewId view) const;
+    // Taxa medida na ultima janela completa.
+    [[nodiscard]] double sentBytesPerSecond() const;
+
+private:
+    class JpegCompressor;
+
+    struct ViewState {
+        EncodedVisionFrame frame;
+        std::unique_ptr<JpegCompressor> jpeg;
+        // Protegidos por budget_mutex_.
+        int jpeg_quality{0};
+        std::size_t window_bytes{0};
+    };
+
+    static constexpr std::size_t kViewCount = 5;
+
+    ViewState &stateOf(VisionDebugViewId view);
+    bool encodeMask(const cv::Mat &frame, EncodedVisionFrame &encoded);
+    // Chamado com budget_mutex_ travado.
+    void adaptQuality(double window_seconds);
+
+    StreamEncoderConfig config_;
+    std::array<ViewState, kViewCount> views_;
+    // So a view Mask usa.
+    cv::Mat mask_gray_;
+    cv::Mat mask_bits_;
+    mutable std::mutex budget_mutex_;
+    Clock::time_point window_started_{};
+    double sent_bytes_per_second_{0.0};
+};
+
+} // namespace autonomous_car::services::vision
@@ -3,6 +3,10 @@
 #include <algorithm>
 #include <array>
 #include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <system_error>
 #include <vector>
 
 #include <opencv2/imgcodecs.hpp>
@@ -62,6 +66,107 @@ std::string base64Encode(const std::vector<unsigned char> &input) {
     return encoded;
 }
 
+
+constexpr double kMinVariantScale = 0.05;
+constexpr int kMinVariantDimension = 16;
+constexpr int kMaxVariantDimension = 4096;
+
+std::optional<double> parseFraction(std::string_view value) {
+    double parsed = 0.0;
+    const auto result = std::from_chars(value.data(), value.data() + value.size(), parsed);
+    if (value.empty() || result.ec != std::errc{} || result.ptr != value.data() + value.size() ||
+        !std::isfinite(parsed)) {
+        return std::nullopt;
+    }
+
+    // Tres casas bastam e deixam o label canonico estavel.
+    return std::round(parsed * 1000.0) / 1000.0;
+}
+
+std::string formatFraction(double value) {
+    char digits[32];
+    const int length = std::snprintf(digits, sizeof(digits), "%.3f", value);
+    std::string text(digits, static_cast<std::size_t>(std::max(length, 0)));
+    text.erase(text.find_last_not_of('0') + 1);
+    if (!text.empty() && text.back() == '.') {
+        text.pop_back();
+    }
+    return text;
+}
+
+bool parseVariantScale(std::string_view value, VisionViewVariant &variant) {
+    constexpr std::string_view kPixelSuffix = "px";
+    if (value.size() > kPixelSuffix.size() &&
+        value.substr(value.size() - kPixelSuffix.size()) == kPixelSuffix) {
+        const std::string_view digits = value.substr(0, value.size() - kPixelSuffix.size());
+        int max_dimension = 0;
+        const auto result =
+            std::from_chars(digits.data(), digits.data() + digits.size(), max_dimension);
+        if (result.ec != std::errc{} || result.ptr != digits.data() + digits.size() ||
+            max_dimension < kMinVariantDimension || max_dimension > kMaxVariantDimension) {
+            return false;
+        }
+        variant.max_dimension = max_dimension;
+        return true;
+    }
+
+    const auto scale = parseFraction(value);
+    if (!scale || *scale < kMinVariantScale || *scale > 1.0) {
+        return false;
+    }
+    variant.scale = *scale;
+    return true;
+}
+
+bool parseVariantCrop(std::string_view value, VisionViewVariant &variant) {
+    std::array<double, 4> parts{};
+    std::size_t start = 0;
+    for (std::size_t index = 0; index < parts.size(); ++index) {
+        const std::size_t delimiter = value.find(':', start);
+        const bool last = index + 1 == parts.size();
+        if (last != (delimiter == std::string_view::npos)) {
+            return false;
+        }
+        const auto part = parseFraction(
+            value.substr(start, last ? std::string_view::npos : delimiter - start));
+        if (!part) {
+            return false;
+        }
+        parts[index] = *part;
+        start = delimiter + 1;
+    }
+
+    const auto [x, y, width, height] = parts;
+    constexpr double kTolerance = 1e-9;
+    if (x < 0.0 || y < 0.0 || width <= 0.0 || height <= 0.0 || x + width > 1.0 + kTolerance ||
+        y + height > 1.0 + kTolerance) {
+        return false;
+    }
+    variant.crop = {x, y, width, height};
+    return true;
+}
+
+std::string buildVariantLabel(const VisionViewVariant &variant) {
+    const cv::Rect2d &crop = variant.crop;
+    const bool cropped =
+        crop.x > 0.0 || crop.y > 0.0 || crop.width < 1.0 || crop.height < 1.0;
+    if (variant.max_dimension == 0 && variant.scale >= 1.0 && !cropped) {
+        return {};
+    }
+
+    std::string label(toString(variant.view));
+    if (variant.max_dimension > 0) {
+        label += "@" + std::to_string(variant.max_dimension) + "px";
+    } else if (variant.scale < 1.0) {
+        label += "@" + formatFraction(variant.scale);
+    }
+    if (cropped) {
+        label += "#" + formatFraction(crop.x) + ":" + formatFraction(crop.y) + ":" +
+                 formatFraction(crop.width) + ":" + formatFraction(crop.height);
+    }
+    return label;
+}
+
 } // namespace
 
 std::size_t VisionDebugViewIdHash::operator()(VisionDebugViewId view) const noexcept {
@@ -118,9 +223,36 @@ std::optional<VisionDebugViewId> visionDebugViewFromString(std::string_view valu
     return std::nullopt;
 }
 
-VisionDebugViewSet parseVisionDebugSubscriptionCsv(
+std::optional<VisionViewVariant> visionViewVariantFromString(std::string_view value) {
+    const std::string normalized = toLower(trim(value));
+    const std::string_view token(normalized);
+    const std::size_t crop_start = token.find('#');
+    const std::string_view head = token.substr(0, crop_start);
+    const std::size_t scale_start = head.find('@');
+
+    const auto view = visionDebugViewFromString(head.substr(0, scale_start));
+    if (!view) {
+        return std::nullopt;
+    }
+
+    VisionViewVariant variant;
+    variant.view = *view;
+    if (scale_start != std::string_view::npos &&
+        !parseVariantScale(head.substr(scale_start + 1), variant)) {
+        return std::nullopt;
+    }
+    if (crop_start != std::string_view::npos &&
+        !parseVariantCrop(token.substr(crop_start + 1), variant)) {
+        return std::nullopt;
+    }
+
+    variant.label = buildVariantLabel(variant);
+    return variant;
+}
+
+std::vector<VisionViewVariant> parseVisionViewVariantCsv(
     std::string_view csv, std::vector<std::string> *invalid_tokens) {
-    VisionDebugViewSet subscriptions;
+    std::vector<VisionViewVariant> variants;
 
     std::size_t start = 0;
     while (start <= csv.size()) {
@@ -130,8 +262,10 @@ VisionDebugViewSet parseVisionDebugSubscriptionCsv(
         const std::string token = trim(csv.substr(start, end - start));
 
         if (!token.empty()) {
-            if (const auto parsed = visionDebugViewFromString(token)) {
-                subscriptions.insert(*parsed);
+            if (auto parsed = visionViewVariantFromString(token)) {
+                if (std::find(variants.begin(), variants.end(), *parsed) == variants.end()) {
+                    variants.push_back(std::move(*parsed));
+                }
             } else if (invalid_tokens) {
                 invalid_tokens->push_back(token);
             }
@@ -144,10 +278,43 @@ VisionDebugViewSet parseVisionDebugSubscriptionCsv(
         start = delimiter + 1;
     }
 
-    return subscriptions;
+    return variants;
 }
 
-std::optional<std::string> buildVisionFrameJson(
+VisionDebugViewSet parseVisionDebugSubscriptionCsv(
+    std::string_view csv, std::vector<std::string> *invalid_tokens) {
+    return viewsOf(parseVisionViewVariantCsv(csv, invalid_tokens));
+}
+
+VisionDebugViewSet viewsOf(const std::vector<VisionViewVariant> &variants) {
+    VisionDebugViewSet views;
+    for (const auto &variant : variants) {
+        views.insert(variant.view);
+    }
+    return views;
+}
+
+std::string_view toString(VisionFrameFormat format) {
+    return format == VisionFrameFormat::Binary ? "binary" : "json";
+}
+
+std::optional<VisionFrameFormat> visionFrameFormatFromString(std::string_view value) {
+    const std::string normalized = toLower(trim(value));
+    if (normalized == "json") {
+        return VisionFrameFormat::Json;
+    }
+    if (normalized == "binary") {
+        return VisionFrameFormat::Binary;
+    }
+
+    return std::nullopt;
+}
+
+std::string_view mimeTypeOf(VisionFrameCodec codec) {
+    return codec == VisionFrameCodec::Png ? "image/png" : "image/jpeg";
+}
+
+std::optional<EncodedVisionFrame> encodeVisionFrame(
     VisionDebugViewId view, const cv::Mat &frame, std::int64_t timestamp_ms, int jpeg_quality) {
     if (frame.empty()) {
         return std::nullopt;
@@ -157,26 +324,41 @@ std::optional<std::string> buildVisionFrameJson(
         cv::IMWRITE_JPEG_QUALITY,
         std::clamp(jpeg_quality, 10, 100),
     };
-    std::vector<unsigned char> encoded_frame;
-    if (!cv::imencode(".jpg", frame, encoded_frame, encode_params)) {
+    EncodedVisionFrame encoded;
+    if (!cv::imencode(".jpg", frame, encoded.data, encode_params)) {
         return std::nullopt;
     }
 
-    const std::string base64 = base64Encode(encoded_frame);
+    encoded.view = view;
+    encoded.timestamp_ms = timestamp_ms;
+    encoded.width = frame.cols;
+    encoded.height = frame.rows;
+    return encoded;
+}
+
+std::string buildVisionFrameJson(const EncodedVisionFrame &frame) {
+    const std::string base64 = base64Encode(frame.data);
 
     std::string payload;
-    payload.reserve(base64.size() + 160);
+    payload.reserve(base64.size() + frame.variant.size() + 176);
     payload += "{\"type\":\"vision.frame\"";
     payload += ",\"view\":\"";
-    payload += toString(view);
+    payload += toString(frame.view);
     payload += "\"";
     payload += ",\"timestamp_ms\":";
-    payload += std::to_string(timestamp_ms);
-    payload += ",\"mime\":\"image/jpeg\"";
+    payload += std::to_string(frame.timestamp_ms);
+    payload += ",\"mime\":\"";
+    payload += mimeTypeOf(frame.codec);
+    payload += "\"";
     payload += ",\"width\":";
-    payload += std::to_string(frame.cols);
+    payload += std::to_string(frame.width);
     payload += ",\"height\":";
-    payload += std::to_string(frame.rows);
+    payload += std::to_string(frame.height);
+    if (!frame.variant.empty()) {
+        payload += ",\"variant\":\"";
+        payload += frame.variant;
+        payload += "\"";
+    }
     payload += ",\"data\":\"";
     payload += base64;
     payload += "\"}";
@@ -184,4 +366,41 @@ std::optional<std::string> buildVisionFrameJson(
     return payload;
 }
 
+std::string buildVisionFrameBinary(const EncodedVisionFrame &frame) {
+    std::string payload;
+    const std::size_t variant_size = std::min<std::size_t>(frame.variant.size(), 0xFF);
+    payload.reserve(kVisionFrameBinaryHeaderSize + variant_size + frame.data.size());
+
+    const auto putBigEndian = [&payload](std::uint64_t value, int bytes) {
+        for (int shift = (bytes - 1) * 8; shift >= 0; shift -= 8) {
+            payload.push_back(static_cast<char>((value >> shift) & 0xFF));
+        }
+    };
+
+    payload += "VF";
+    payload.push_back(static_cast<char>(kVisionFrameBinaryVersion));
+    payload.push_back(static_cast<char>(frame.view));
+    payload.push_back(static_cast<char>(frame.codec));
+    payload.push_back(static_cast<char>(variant_size));
+    payload.append(2, '\0');
+    putBigEndian(static_cast<std::uint64_t>(std::max<std::int64_t>(frame.timestamp_ms, 0)), 8);
+    putBigEndian(static_cast<std::uint64_t>(std::clamp(frame.width, 0, 0xFFFF)), 2);
+    putBigEndian(static_cast<std::uint64_t>(std::clamp(frame.height, 0, 0xFFFF)), 2);
+    putBigEndian(frame.data.size(), 4);
+    payload.append(frame.variant, 0, variant_size);
+    payload.append(reinterpret_cast<const char *>(frame.data.data()), frame.data.size());
+
+    return payload;
+}
+
+std::optional<std::string> buildVisionFrameJson(
+    VisionDebugViewId view, const cv::Mat &frame, std::int64_t timestamp_ms, int jpeg_quality) {
+    const auto encoded = encodeVisionFrame(view, frame, timestamp_ms, jpeg_quality);
+    if (!encoded) {
+        return std::nullopt;
+    }
+
+    return buildVisionFrameJson(*encoded);
+}
+
 } // namespace autonomous_car::services::vision
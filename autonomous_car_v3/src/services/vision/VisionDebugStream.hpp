@@ -28,8 +28,68 @@ using VisionDebugViewSet = std::unordered_set<VisionDebugViewId, VisionDebugView
 const std::vector<VisionDebugViewId> &allVisionDebugViews();
 std::string_view toString(VisionDebugViewId view);
 std::optional<VisionDebugViewId> visionDebugViewFromString(std::string_view value);
+
+// Variante pedida em stream:subscribe como <view>[@<fator>|@<lado>px][#x:y:w:h], recorte em
+// fracoes do frame; so a view e a inteira.
+struct VisionViewVariant {
+    VisionDebugViewId view{VisionDebugViewId::Raw};
+    double scale{1.0};
+    int max_dimension{0};
+    cv::Rect2d crop{0.0, 0.0, 1.0, 1.0};
+    // Token canonico ("annotated@0.5#0.5:0:0.5:1"); vazio na view inteira.
+    std::string label;
+
+    [[nodiscard]] bool isFullView() const noexcept { return label.empty(); }
+    bool operator==(const VisionViewVariant &other) const {
+        return view == other.view && label == other.label;
+    }
+    bool operator!=(const VisionViewVariant &other) const { return !(*this == other); }
+};
+
+std::optional<VisionViewVariant> visionViewVariantFromString(std::string_view value);
+// Variantes validas, sem repetir, na ordem do CSV.
+std::vector<VisionViewVariant> parseVisionViewVariantCsv(
+    std::string_view csv, std::vector<std::string> *invalid_tokens = nullptr);
 VisionDebugViewSet parseVisionDebugSubscriptionCsv(
     std::string_view csv, std::vector<std::string> *invalid_tokens = nullptr);
+VisionDebugViewSet viewsOf(const std::vector<VisionViewVariant> &variants);
+
+// Formato negociado por sessao com stream:format=json|binary; json e o padrao.
+enum class VisionFrameFormat { Json, Binary };
+
+std::string_view toString(VisionFrameFormat format);
+std::optional<VisionFrameFormat> visionFrameFormatFromString(std::string_view value);
+
+// Codec do frame; tambem e o byte de codec do frame binario.
+enum class VisionFrameCodec : unsigned char { Jpeg = 1, Png = 2 };
+
+std::string_view mimeTypeOf(VisionFrameCodec codec);
+
+// Imagem de uma view, codificada uma vez por frame; o servidor monta a partir dela so os
+// formatos que alguma sessao pediu.
+struct EncodedVisionFrame {
+    VisionDebugViewId view{VisionDebugViewId::Raw};
+    std::int64_t timestamp_ms{0};
+    int width{0};
+    int height{0};
+    VisionFrameCodec codec{VisionFrameCodec::Jpeg};
+    // Label da variante; vazio na view inteira.
+    std::string variant;
+    std::vector<unsigned char> data;
+};
+
+// Cabecalho do frame binario, big-endian, seguido do label da variante (ASCII, sem terminador)
+// e dos bytes da imagem:
+//   0 "VF" | 2 versao (1) | 3 view | 4 codec (1 = jpeg, 2 = png)
+//   5 tamanho do label (0 na view inteira) | 6..7 reservado (0)
+//   8 timestamp_ms u64 | 16 width u16 | 18 height u16 | 20 tamanho da imagem u32
+inline constexpr std::size_t kVisionFrameBinaryHeaderSize = 24;
+inline constexpr unsigned char kVisionFrameBinaryVersion = 1;
+
+std::optional<EncodedVisionFrame> encodeVisionFrame(
+    VisionDebugViewId view, const cv::Mat &frame, std::int64_t timestamp_ms, int jpeg_quality);
+std::string buildVisionFrameJson(const EncodedVisionFrame &frame);
+std::string buildVisionFrameBinary(const EncodedVisionFrame &frame);
 std::optional<std::string> buildVisionFrameJson(
     VisionDebugViewId view, const cv::Mat &frame, std::int64_t timestamp_ms, int jpeg_quality);
 
@@ -1,6 +1,7 @@
 #include "services/vision/VisionDebugViewRenderer.hpp"
 
 #include <algorithm>
+#include <cmath>
 
 #include <opencv2/imgproc.hpp>
 
@@ -124,6 +125,69 @@ void drawTrafficSignOverlay(cv::Mat &image, const ts::TrafficSignFrameResult &tr
 
 } // namespace
 
+road_segmentation_lab::pipeline::CaptureRequest captureRequestForViews(
+    const VisionDebugViewSet &views) {
+    using road_segmentation_lab::pipeline::CaptureRequest;
+
+    CaptureRequest capture = CaptureRequest::None;
+    for (const auto view : views) {
+        switch (view) {
+        case VisionDebugViewId::Raw:
+        case VisionDebugViewId::Annotated:
+            capture = capture | CaptureRequest::Frame;
+            break;
+        case VisionDebugViewId::Preprocess:
+            capture = capture | CaptureRequest::Frame | CaptureRequest::Preprocessed;
+            break;
+        case VisionDebugViewId::Mask:
+            capture = capture | CaptureRequest::Frame | CaptureRequest::Mask;
+            break;
+        case VisionDebugViewId::Dashboard:
+            capture = CaptureRequest::All;
+            break;
+        }
+    }
+
+    return capture;
+}
+
+cv::Mat renderVisionViewVariant(const cv::Mat &frame, const VisionViewVariant &variant) {
+    if (frame.empty() || variant.isFullView()) {
+        return frame;
+    }
+
+    const auto edge = [](double ratio, int length) {
+        return std::clamp(static_cast<int>(std::lround(ratio * length)), 0, length);
+    };
+    // Recorte colado na borda pode arredondar para zero: fica com ao menos um pixel.
+    const int left = std::min(edge(variant.crop.x, frame.cols), frame.cols - 1);
+    const int top = std::min(edge(variant.crop.y, frame.rows), frame.rows - 1);
+    const int right = std::max(left + 1, edge(variant.crop.x + variant.crop.width, frame.cols));
+    const int bottom =
+        std::max(top + 1, edge(variant.crop.y + variant.crop.height, frame.rows));
+    const cv::Rect crop = cv::Rect(left, top, right - left, bottom - top) &
+                          cv::Rect(0, 0, frame.cols, frame.rows);
+    if (crop.width <= 0 || crop.height <= 0) {
+        return {};
+    }
+    const cv::Mat cropped = frame(crop);
+
+    const double factor =
+        variant.max_dimension > 0
+            ? std::min(1.0, static_cast<double>(variant.max_dimension) /
+                                std::max(cropped.cols, cropped.rows))
+            : variant.scale;
+    const cv::Size size(std::max(1, static_cast<int>(std::lround(cropped.cols * factor))),
+                        std::max(1, static_cast<int>(std::lround(cropped.rows * factor))));
+    if (size == cropped.size()) {
+        return cropped;
+    }
+
+    cv::Mat resized;
+    cv::resize(cropped, resized, size, 0.0, 0.0, cv::INTER_AREA);
+    return resized;
+}
+
 cv::Mat VisionDebugViewRenderer::render(
     VisionDebugViewId view, const road_segmentation_lab::pipeline::RoadSegmentationResult &result,
     const road_segmentation_lab::config::LabConfig &config, const std::string &source_label,
@@ -15,6 +15,13 @@
 
 namespace autonomous_car::services::vision {
 
+// Imagens do RoadSegmentationResult que as views pedidas desenham.
+road_segmentation_lab::pipeline::CaptureRequest captureRequestForViews(
+    const VisionDebugViewSet &views);
+
+// Recorte e reducao da variante; sem mudanca de tamanho volta um ROI de frame, sem copia.
+cv::Mat renderVisionViewVariant(const cv::Mat &frame, const VisionViewVariant &variant);
+
 class VisionDebugViewRenderer {
 public:
     cv::Mat render(VisionDebugViewId view,
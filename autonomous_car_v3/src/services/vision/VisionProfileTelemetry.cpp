@@ -0,0 +1,39 @@
+#include "services/vision/VisionProfileTelemetry.hpp"
+
+#include "services/telemetry/JsonWriter.hpp"
+
+namespace autonomous_car::services::vision {
+
+namespace rsl = road_segmentation_lab;
+
+std::string buildVisionProfileTelemetryJson(const rsl::pipeline::StageProfileSnapshot &profile,
+                                            std::string_view source, std::int64_t timestamp_ms) {
+    services::telemetry::JsonWriter &json = services::telemetry::threadJsonWriter();
+    json.raw("{");
+    json.raw("\"type\":\"telemetry.vision_profile\"");
+    json.raw(",\"timestamp_ms\":").integer(timestamp_ms);
+    json.raw(",\"source\":").string(source);
+    json.raw(",\"enabled\":").boolean(profile.enabled);
+    json.raw(",\"frames\":").integer(profile.frames);
+    json.raw(",\"window_size\":").integer(rsl::pipeline::StageProfiler::kWindowSize);
+    json.raw(",\"stages\":[");
+    for (std::size_t index = 0; index < profile.stages.size(); ++index) {
+        const auto &stage = profile.stages[index];
+        if (index > 0) {
+            json.raw(",");
+        }
+        json.raw("{");
+        json.raw("\"name\":\"").raw(rsl::pipeline::toString(stage.stage)).raw("\"");
+        json.raw(",\"samples\":").integer(stage.samples);
+        json.raw(",\"p50_ms\":").number(stage.p50_ms);
+        json.raw(",\"p95_ms\":").number(stage.p95_ms);
+        json.raw(",\"p99_ms\":").number(stage.p99_ms);
+        json.raw(",\"max_ms\":").number(stage.max_ms);
+        json.raw("}");
+    }
+    json.raw("]");
+    json.raw("}");
+    return json.str();
+}
+
+} // namespace autonomous_car::services::vision
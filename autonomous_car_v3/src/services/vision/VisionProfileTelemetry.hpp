@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "pipeline/StageProfiler.hpp"
+
+namespace autonomous_car::services::vision {
+
+std::string buildVisionProfileTelemetryJson(
+    const road_segmentation_lab::pipeline::StageProfileSnapshot &profile, std::string_view source,
+    std::int64_t timestamp_ms);
+
+} // namespace autonomous_car::services::vision
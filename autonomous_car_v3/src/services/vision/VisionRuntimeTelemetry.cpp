@@ -1,69 +1,33 @@
 #include "services/vision/VisionRuntimeTelemetry.hpp"
 
-#include <iomanip>
-#include <sstream>
-#include <string_view>
+#include "services/telemetry/JsonWriter.hpp"
 
 namespace autonomous_car::services::vision {
-namespace {
-
-std::string jsonEscape(std::string_view value) {
-    std::string escaped;
-    escaped.reserve(value.size());
-
-    for (char ch : value) {
-        switch (ch) {
-        case '\\':
-            escaped += "\\\\";
-            break;
-        case '"':
-            escaped += "\\\"";
-            break;
-        case '\n':
-            escaped += "\\n";
-            break;
-        case '\r':
-            escaped += "\\r";
-            break;
-        case '\t':
-            escaped += "\\t";
-            break;
-        default:
-            escaped.push_back(ch);
-            break;
-        }
-    }
-
-    return escaped;
-}
-
-void appendNumber(std::ostringstream &stream, double value) {
-    stream << std::fixed << std::setprecision(6) << value;
-}
-
-} // namespace
 
 std::string buildVisionRuntimeTelemetryJson(const VisionRuntimeTelemetry &telemetry) {
-    std::ostringstream stream;
-    stream << "{";
-    stream << "\"type\":\"telemetry.vision_runtime\"";
-    stream << ",\"timestamp_ms\":" << telemetry.timestamp_ms;
-    stream << ",\"source\":\"" << jsonEscape(telemetry.source) << "\"";
-    stream << ",\"core_fps\":";
-    appendNumber(stream, telemetry.core_fps);
-    stream << ",\"stream_fps\":";
-    appendNumber(stream, telemetry.stream_fps);
-    stream << ",\"traffic_sign_fps\":";
-    appendNumber(stream, telemetry.traffic_sign_fps);
-    stream << ",\"traffic_sign_inference_ms\":";
-    appendNumber(stream, telemetry.traffic_sign_inference_ms);
-    stream << ",\"stream_encode_ms\":";
-    appendNumber(stream, telemetry.stream_encode_ms);
-    stream << ",\"traffic_sign_dropped_frames\":" << telemetry.traffic_sign_dropped_frames;
-    stream << ",\"stream_dropped_frames\":" << telemetry.stream_dropped_frames;
-    stream << ",\"sign_result_age_ms\":" << telemetry.sign_result_age_ms;
-    stream << "}";
-    return stream.str();
+    services::telemetry::JsonWriter &json = services::telemetry::threadJsonWriter();
+    json.raw("{");
+    json.raw("\"type\":\"telemetry.vision_runtime\"");
+    json.raw(",\"timestamp_ms\":").integer(telemetry.timestamp_ms);
+    json.raw(",\"source\":").string(telemetry.source);
+    json.raw(",\"core_fps\":").number(telemetry.core_fps);
+    json.raw(",\"stream_fps\":").number(telemetry.stream_fps);
+    json.raw(",\"traffic_sign_fps\":").number(telemetry.traffic_sign_fps);
+    json.raw(",\"traffic_sign_inference_ms\":").number(telemetry.traffic_sign_inference_ms);
+    json.raw(",\"stream_encode_ms\":").number(telemetry.stream_encode_ms);
+    json.raw(",\"stream_sent_kbytes_per_sec\":").number(telemetry.stream_sent_kbytes_per_sec);
+    json.raw(",\"segmentation_pipeline_depth\":").integer(telemetry.segmentation_pipeline_depth);
+    json.raw(",\"segmentation_prepare_ms\":").number(telemetry.segmentation_prepare_ms);
+    json.raw(",\"segmentation_segment_ms\":").number(telemetry.segmentation_segment_ms);
+    json.raw(",\"segmentation_analyze_ms\":").number(telemetry.segmentation_analyze_ms);
+    json.raw(",\"segmentation_pipeline_added_ms\":")
+        .number(telemetry.segmentation_pipeline_added_ms);
+    json.raw(",\"traffic_sign_dropped_frames\":").integer(telemetry.traffic_sign_dropped_frames);
+    json.raw(",\"stream_dropped_frames\":").integer(telemetry.stream_dropped_frames);
+    json.raw(",\"stream_skipped_views\":").integer(telemetry.stream_skipped_views);
+    json.raw(",\"sign_result_age_ms\":").integer(telemetry.sign_result_age_ms);
+    json.raw("}");
+    return json.str();
 }
 
 } // namespace autonomous_car::services::vision
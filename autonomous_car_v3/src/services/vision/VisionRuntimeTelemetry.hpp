@@ -13,8 +13,15 @@ struct VisionRuntimeTelemetry {
     double traffic_sign_fps{0.0};
     double traffic_sign_inference_ms{0.0};
     double stream_encode_ms{0.0};
+    double stream_sent_kbytes_per_sec{0.0};
+    int segmentation_pipeline_depth{0};
+    double segmentation_prepare_ms{0.0};
+    double segmentation_segment_ms{0.0};
+    double segmentation_analyze_ms{0.0};
+    double segmentation_pipeline_added_ms{0.0};
     std::uint64_t traffic_sign_dropped_frames{0};
     std::uint64_t stream_dropped_frames{0};
+    std::uint64_t stream_skipped_views{0};
     std::int64_t sign_result_age_ms{-1};
 };
 
@@ -1,5 +1,9 @@
 #include "services/vision/VisionSubscriptionRegistry.hpp"
 
+#include <algorithm>
+#include <unordered_set>
+#include <utility>
+
 namespace autonomous_car::services::vision {
 
 void VisionSubscriptionRegistry::addSession(std::size_t session_id) {
@@ -10,34 +14,126 @@ void VisionSubscriptionRegistry::addSession(std::size_t session_id) {
 void VisionSubscriptionRegistry::removeSession(std::size_t session_id) {
     std::lock_guard<std::mutex> lock(mutex_);
     subscriptions_.erase(session_id);
+    refreshVariantKeysLocked();
 }
 
 void VisionSubscriptionRegistry::replaceSubscriptions(
-    std::size_t session_id, VisionDebugViewSet subscriptions) {
+    std::size_t session_id, const VisionDebugViewSet &subscriptions) {
+    std::vector<VisionViewVariant> variants;
+    for (const auto view : allVisionDebugViews()) {
+        if (subscriptions.find(view) != subscriptions.end()) {
+            VisionViewVariant variant;
+            variant.view = view;
+            variants.push_back(std::move(variant));
+        }
+    }
+    replaceSubscriptions(session_id, std::move(variants));
+}
+
+void VisionSubscriptionRegistry::replaceSubscriptions(
+    std::size_t session_id, std::vector<VisionViewVariant> variants) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    subscriptions_[session_id].variants = std::move(variants);
+    refreshVariantKeysLocked();
+}
+
+void VisionSubscriptionRegistry::setFormat(std::size_t session_id, VisionFrameFormat format) {
     std::lock_guard<std::mutex> lock(mutex_);
-    subscriptions_[session_id] = std::move(subscriptions);
+    subscriptions_[session_id].format = format;
 }
 
 bool VisionSubscriptionRegistry::hasSubscription(
     std::size_t session_id, VisionDebugViewId view) const {
+    return subscriptionFormat(session_id, view).has_value();
+}
+
+std::optional<VisionFrameFormat> VisionSubscriptionRegistry::subscriptionFormat(
+    std::size_t session_id, VisionDebugViewId view, std::string_view variant) const {
     std::lock_guard<std::mutex> lock(mutex_);
     const auto iterator = subscriptions_.find(session_id);
     if (iterator == subscriptions_.end()) {
-        return false;
+        return std::nullopt;
+    }
+
+    const auto &variants = iterator->second.variants;
+    const bool subscribed =
+        std::any_of(variants.begin(), variants.end(), [&](const VisionViewVariant &candidate) {
+            return candidate.view == view && candidate.label == variant;
+        });
+    if (!subscribed) {
+        return std::nullopt;
+    }
+
+    return iterator->second.format;
+}
+
+std::optional<int> VisionSubscriptionRegistry::frameQueueKey(VisionDebugViewId view,
+                                                            std::string_view variant) const {
+    if (variant.empty()) {
+        return static_cast<int>(view);
     }
 
-    return iterator->second.find(view) != iterator->second.end();
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto iterator = variant_keys_.find(std::string(variant));
+    if (iterator == variant_keys_.end()) {
+        return std::nullopt;
+    }
+    return iterator->second;
 }
 
 VisionDebugViewSet VisionSubscriptionRegistry::unionOfRequestedViews() const {
     std::lock_guard<std::mutex> lock(mutex_);
 
     VisionDebugViewSet requested_views;
-    for (const auto &[_, session_subscriptions] : subscriptions_) {
-        requested_views.insert(session_subscriptions.begin(), session_subscriptions.end());
+    for (const auto &[_, session_subscription] : subscriptions_) {
+        for (const auto &variant : session_subscription.variants) {
+            requested_views.insert(variant.view);
+        }
     }
 
     return requested_views;
 }
 
+std::vector<VisionViewVariant> VisionSubscriptionRegistry::unionOfRequestedVariants() const {
+    std::vector<VisionViewVariant> requested_variants;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto &[_, session_subscription] : subscriptions_) {
+            requested_variants.insert(requested_variants.end(),
+                                      session_subscription.variants.begin(),
+                                      session_subscription.variants.end());
+        }
+    }
+
+    std::sort(requested_variants.begin(), requested_variants.end(),
+              [](const VisionViewVariant &left, const VisionViewVariant &right) {
+                  return left.view != right.view ? left.view < right.view
+                                                 : left.label < right.label;
+              });
+    requested_variants.erase(std::unique(requested_variants.begin(), requested_variants.end()),
+                             requested_variants.end());
+    return requested_variants;
+}
+
+void VisionSubscriptionRegistry::refreshVariantKeysLocked() {
+    std::unordered_set<std::string> requested_labels;
+    for (const auto &[_, session_subscription] : subscriptions_) {
+        for (const auto &variant : session_subscription.variants) {
+            if (!variant.label.empty()) {
+                requested_labels.insert(variant.label);
+            }
+        }
+    }
+
+    for (auto iterator = variant_keys_.begin(); iterator != variant_keys_.end();) {
+        iterator = requested_labels.count(iterator->first) != 0 ? std::next(iterator)
+                                                                 : variant_keys_.erase(iterator);
+    }
+    for (const auto &label : requested_labels) {
+        if (variant_keys_.try_emplace(label, next_variant_key_).second) {
+            ++next_variant_key_;
+        }
+    }
+}
+
 } // namespace autonomous_car::services::vision
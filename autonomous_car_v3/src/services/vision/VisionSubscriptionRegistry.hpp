@@ -2,7 +2,11 @@
 
 #include <cstddef>
 #include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
 
 #include "services/vision/VisionDebugStream.hpp"
 
@@ -12,13 +16,35 @@ class VisionSubscriptionRegistry {
 public:
     void addSession(std::size_t session_id);
     void removeSession(std::size_t session_id);
-    void replaceSubscriptions(std::size_t session_id, VisionDebugViewSet subscriptions);
+    // Assina as views inteiras.
+    void replaceSubscriptions(std::size_t session_id, const VisionDebugViewSet &subscriptions);
+    void replaceSubscriptions(std::size_t session_id, std::vector<VisionViewVariant> variants);
+    void setFormat(std::size_t session_id, VisionFrameFormat format);
     [[nodiscard]] bool hasSubscription(std::size_t session_id, VisionDebugViewId view) const;
+    // Formato pedido pela sessao para a variante (label vazio e a view inteira); nullopt sem ela.
+    [[nodiscard]] std::optional<VisionFrameFormat> subscriptionFormat(
+        std::size_t session_id, VisionDebugViewId view, std::string_view variant = {}) const;
+    // Chave KeepLatest da variante na fila de envio, estavel enquanto ela existir; nullopt sem
+    // assinante.
+    [[nodiscard]] std::optional<int> frameQueueKey(VisionDebugViewId view,
+                                                   std::string_view variant) const;
     [[nodiscard]] VisionDebugViewSet unionOfRequestedViews() const;
+    // Variantes distintas pedidas por todas as sessoes, ordenadas por view e label.
+    [[nodiscard]] std::vector<VisionViewVariant> unionOfRequestedVariants() const;
 
 private:
+    struct SessionSubscription {
+        std::vector<VisionViewVariant> variants;
+        VisionFrameFormat format{VisionFrameFormat::Json};
+    };
+
+    // Chamado com mutex_ travado.
+    void refreshVariantKeysLocked();
+
     mutable std::mutex mutex_;
-    std::unordered_map<std::size_t, VisionDebugViewSet> subscriptions_;
+    std::unordered_map<std::size_t, SessionSubscription> subscriptions_;
+    std::unordered_map<std::string, int> variant_keys_;
+    int next_variant_key_{0x100};
 };
 
 } // namespace autonomous_car::services::vision
@@ -0,0 +1,96 @@
+#include "services/vision/VisionViewWorkerPool.hpp"
+
+#include <algorithm>
+
+namespace autonomous_car::services::vision {
+namespace {
+
+std::size_t indexOf(VisionDebugViewId view) { return static_cast<std::size_t>(view); }
+
+} // namespace
+
+VisionViewWorkerPool::VisionViewWorkerPool(std::size_t worker_count) {
+    const std::size_t count = std::clamp<std::size_t>(worker_count, 1, kViewCount);
+    workers_.reserve(count);
+    for (std::size_t index = 0; index < count; ++index) {
+        workers_.emplace_back([this] { workerLoop(); });
+    }
+}
+
+VisionViewWorkerPool::~VisionViewWorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        queue_.clear();
+    }
+    wake_.notify_all();
+    for (auto &worker : workers_) {
+        worker.join();
+    }
+}
+
+bool VisionViewWorkerPool::trySubmit(VisionDebugViewId view, Task task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (busy_[indexOf(view)]) {
+            ++skipped_count_;
+            return false;
+        }
+        busy_[indexOf(view)] = true;
+        queue_.emplace_back(view, std::move(task));
+    }
+    wake_.notify_one();
+    return true;
+}
+
+bool VisionViewWorkerPool::busy(VisionDebugViewId view) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return busy_[indexOf(view)];
+}
+
+std::uint64_t VisionViewWorkerPool::skippedCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return skipped_count_;
+}
+
+void VisionViewWorkerPool::rethrowWorkerError() {
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::swap(error, worker_error_);
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void VisionViewWorkerPool::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        wake_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+        if (stopping_) {
+            return;
+        }
+
+        auto [view, task] = std::move(queue_.front());
+        queue_.pop_front();
+        lock.unlock();
+
+        std::exception_ptr error;
+        try {
+            task();
+        } catch (...) {
+            error = std::current_exception();
+        }
+        // O task (e o que ele captura, como o snapshot) e destruido fora do mutex.
+        task = nullptr;
+
+        lock.lock();
+        busy_[indexOf(view)] = false;
+        if (error && !worker_error_) {
+            worker_error_ = error;
+        }
+    }
+}
+
+} // namespace autonomous_car::services::vision
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "services/vision/VisionDebugStream.hpp"
+
+namespace autonomous_car::services::vision {
+
+// Um trabalho por view de cada vez, submetido sempre pela mesma thread, que recebe as excecoes em
+// rethrowWorkerError(). O destrutor descarta a fila e espera os trabalhos em andamento.
+class VisionViewWorkerPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit VisionViewWorkerPool(std::size_t worker_count);
+    ~VisionViewWorkerPool();
+    VisionViewWorkerPool(const VisionViewWorkerPool &) = delete;
+    VisionViewWorkerPool &operator=(const VisionViewWorkerPool &) = delete;
+
+    // false quando a view ainda tem trabalho pendente; o task nao roda.
+    bool trySubmit(VisionDebugViewId view, Task task);
+    [[nodiscard]] bool busy(VisionDebugViewId view) const;
+    // Frames de view descartados por trySubmit() com a view ocupada.
+    [[nodiscard]] std::uint64_t skippedCount() const;
+    [[nodiscard]] std::size_t workerCount() const noexcept { return workers_.size(); }
+    void rethrowWorkerError();
+
+private:
+    static constexpr std::size_t kViewCount = 5;
+
+    void workerLoop();
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<std::pair<VisionDebugViewId, Task>> queue_;
+    std::array<bool, kViewCount> busy_{};
+    std::uint64_t skipped_count_{0};
+    std::exception_ptr worker_error_;
+    bool stopping_{false};
+    std::vector<std::thread> workers_;
+};
+
+} // namespace autonomous_car::services::vision
@@ -0,0 +1,47 @@
+#include "services/websocket/ClientSendTelemetry.hpp"
+
+#include "services/telemetry/JsonWriter.hpp"
+
+namespace autonomous_car::services::websocket {
+namespace {
+
+const char *roleName(ClientRole role) {
+    switch (role) {
+    case ClientRole::Control:
+        return "control";
+    case ClientRole::Telemetry:
+        return "telemetry";
+    case ClientRole::Unknown:
+        break;
+    }
+    return "unknown";
+}
+
+} // namespace
+
+std::string buildClientSendTelemetryJson(std::int64_t timestamp_ms,
+                                         const std::vector<ClientSendTelemetry> &clients) {
+    telemetry::JsonWriter &json = telemetry::threadJsonWriter();
+    json.raw("{");
+    json.raw("\"type\":\"telemetry.websocket_clients\"");
+    json.raw(",\"timestamp_ms\":").integer(timestamp_ms);
+    json.raw(",\"clients\":[");
+    for (std::size_t index = 0; index < clients.size(); ++index) {
+        const auto &client = clients[index];
+        if (index > 0) {
+            json.raw(",");
+        }
+        json.raw("{\"id\":").integer(client.session_id);
+        json.raw(",\"role\":\"").raw(roleName(client.role)).raw("\"");
+        json.raw(",\"queued_messages\":").integer(client.stats.queued_messages);
+        json.raw(",\"queued_bytes\":").integer(client.stats.queued_bytes);
+        json.raw(",\"sent_messages\":").integer(client.stats.sent_messages);
+        json.raw(",\"dropped_telemetry\":").integer(client.stats.dropped_telemetry);
+        json.raw(",\"dropped_vision_frames\":").integer(client.stats.dropped_vision_frames);
+        json.raw("}");
+    }
+    json.raw("]}");
+    return json.str();
+}
+
+} // namespace autonomous_car::services::websocket
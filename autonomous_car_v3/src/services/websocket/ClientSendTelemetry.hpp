@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "services/websocket/ClientRegistry.hpp"
+#include "services/websocket/SessionSendQueue.hpp"
+
+namespace autonomous_car::services::websocket {
+
+struct ClientSendTelemetry {
+    std::size_t session_id{0};
+    ClientRole role{ClientRole::Unknown};
+    SendQueueStats stats;
+};
+
+std::string buildClientSendTelemetryJson(std::int64_t timestamp_ms,
+                                         const std::vector<ClientSendTelemetry> &clients);
+
+} // namespace autonomous_car::services::websocket
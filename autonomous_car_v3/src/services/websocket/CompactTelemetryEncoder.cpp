@@ -0,0 +1,357 @@
+#include "services/websocket/CompactTelemetryEncoder.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <system_error>
+
+#include "services/telemetry/JsonWriter.hpp"
+
+namespace autonomous_car::services::websocket {
+namespace {
+
+constexpr std::string_view kTelemetryTypePrefix = "\"telemetry.";
+constexpr int kMaxFloatDecimals = 9;
+
+// Parser minimo para a telemetria que o proprio carro gera: sem validacao completa de JSON,
+// mas qualquer coisa fora do esperado devolve false e a mensagem segue inteira.
+struct Cursor {
+    std::string_view text;
+    std::size_t pos{0};
+    int decimals{4};
+
+    void skipSpace() {
+        while (pos < text.size() &&
+               (text[pos] == ' ' || text[pos] == '\n' || text[pos] == '\r' || text[pos] == '\t')) {
+            ++pos;
+        }
+    }
+
+    [[nodiscard]] bool at(char ch) const { return pos < text.size() && text[pos] == ch; }
+};
+
+// Copia a string com aspas e escapes como veio.
+bool readString(Cursor &cursor, std::string &out) {
+    if (!cursor.at('"')) {
+        return false;
+    }
+    const std::size_t start = cursor.pos++;
+    while (cursor.pos < cursor.text.size()) {
+        const char ch = cursor.text[cursor.pos++];
+        if (ch == '\\') {
+            ++cursor.pos;
+        } else if (ch == '"') {
+            out.append(cursor.text.substr(start, cursor.pos - start));
+            return true;
+        }
+    }
+    return false;
+}
+
+bool appendQuantized(double value, int decimals, std::string &out) {
+    char digits[340];
+    const auto result = std::to_chars(digits, digits + sizeof(digits), value,
+                                      std::chars_format::fixed, decimals);
+    if (result.ec != std::errc{}) {
+        return false;
+    }
+    const char *end = result.ptr;
+    if (decimals > 0) {
+        while (end[-1] == '0') {
+            --end;
+        }
+        if (end[-1] == '.') {
+            --end;
+        }
+    }
+    const std::string_view text(digits, static_cast<std::size_t>(end - digits));
+    out.append(text == "-0" ? std::string_view("0") : text);
+    return true;
+}
+
+// Inteiros passam como vieram; os demais numeros sao quantizados.
+bool readNumber(Cursor &cursor, std::string &out) {
+    const std::size_t start = cursor.pos;
+    bool fractional = false;
+    while (cursor.pos < cursor.text.size()) {
+        const char ch = cursor.text[cursor.pos];
+        if (ch == '.' || ch == 'e' || ch == 'E') {
+            fractional = true;
+        } else if (!(ch == '-' || ch == '+' || (ch >= '0' && ch <= '9'))) {
+            break;
+        }
+        ++cursor.pos;
+    }
+    const std::string_view token = cursor.text.substr(start, cursor.pos - start);
+    if (token.empty()) {
+        return false;
+    }
+    if (!fractional) {
+        out.append(token);
+        return true;
+    }
+
+    double value = 0.0;
+    const auto result = std::from_chars(token.data(), token.data() + token.size(), value);
+    if (result.ec != std::errc{} || result.ptr != token.data() + token.size()) {
+        return false;
+    }
+    return appendQuantized(value, cursor.decimals, out);
+}
+
+bool readLiteral(Cursor &cursor, std::string &out) {
+    for (const std::string_view literal : {"true", "false", "null"}) {
+        if (cursor.text.substr(cursor.pos, literal.size()) == literal) {
+            cursor.pos += literal.size();
+            out.append(literal);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Reescreve um valor inteiro (arrays e objetos dentro de arrays inclusive) sem espacos e com os
+// numeros quantizados.
+bool readValue(Cursor &cursor, std::string &out) {
+    cursor.skipSpace();
+    if (cursor.pos >= cursor.text.size()) {
+        return false;
+    }
+
+    const char ch = cursor.text[cursor.pos];
+    if (ch == '"') {
+        return readString(cursor, out);
+    }
+    if (ch == '[' || ch == '{') {
+        const char close = ch == '[' ? ']' : '}';
+        out.push_back(ch);
+        ++cursor.pos;
+        cursor.skipSpace();
+        if (cursor.at(close)) {
+            out.push_back(close);
+            ++cursor.pos;
+            return true;
+        }
+        while (true) {
+            if (ch == '{') {
+                cursor.skipSpace();
+                if (!readString(cursor, out)) {
+                    return false;
+                }
+                cursor.skipSpace();
+                if (!cursor.at(':')) {
+                    return false;
+                }
+                out.push_back(':');
+                ++cursor.pos;
+            }
+            if (!readValue(cursor, out)) {
+                return false;
+            }
+            cursor.skipSpace();
+            if (cursor.at(',')) {
+                out.push_back(',');
+                ++cursor.pos;
+                continue;
+            }
+            if (!cursor.at(close)) {
+                return false;
+            }
+            out.push_back(close);
+            ++cursor.pos;
+            return true;
+        }
+    }
+    if (ch == '-' || (ch >= '0' && ch <= '9')) {
+        return readNumber(cursor, out);
+    }
+    return readLiteral(cursor, out);
+}
+
+// Achata um objeto em caminhos com ponto; o cursor esta no '{'. emitted conta os campos gerados.
+template <typename Emit>
+bool readObjectFields(Cursor &cursor, const std::string &prefix, Emit &emit,
+                      std::size_t &emitted) {
+    ++cursor.pos;
+    cursor.skipSpace();
+    if (cursor.at('}')) {
+        ++cursor.pos;
+        return true;
+    }
+
+    std::string key;
+    while (true) {
+        cursor.skipSpace();
+        key.clear();
+        if (!readString(cursor, key) || key.find('\\') != std::string::npos) {
+            return false;
+        }
+        const std::string path = prefix + key.substr(1, key.size() - 2);
+        cursor.skipSpace();
+        if (!cursor.at(':')) {
+            return false;
+        }
+        ++cursor.pos;
+        cursor.skipSpace();
+
+        if (cursor.at('{')) {
+            const std::size_t before = emitted;
+            if (!readObjectFields(cursor, path + ".", emit, emitted)) {
+                return false;
+            }
+            // Objeto vazio nao gera campos; vira um valor para nao sumir na reconstrucao.
+            if (emitted == before) {
+                emit(path, std::string("{}"));
+                ++emitted;
+            }
+        } else {
+            std::string value;
+            if (!readValue(cursor, value)) {
+                return false;
+            }
+            emit(path, std::move(value));
+            ++emitted;
+        }
+
+        cursor.skipSpace();
+        if (cursor.at(',')) {
+            ++cursor.pos;
+            continue;
+        }
+        if (!cursor.at('}')) {
+            return false;
+        }
+        ++cursor.pos;
+        return true;
+    }
+}
+
+} // namespace
+
+CompactTelemetryEncoder::CompactTelemetryEncoder(CompactTelemetryPolicy policy)
+    : policy_{policy} {
+    policy_.float_decimals = std::clamp(policy_.float_decimals, 0, kMaxFloatDecimals);
+}
+
+std::vector<std::string> CompactTelemetryEncoder::encode(std::string_view payload,
+                                                         Clock::time_point now) {
+    if (!flatten(payload)) {
+        return {};
+    }
+
+    TypeState &state = types_[type_];
+    const bool schema_changed =
+        state.schema_id == 0 || state.paths.size() != fields_.size() ||
+        !std::equal(fields_.begin(), fields_.end(), state.paths.begin(),
+                    [](const Field &field, const std::string &path) { return field.path == path; });
+    const bool keyframe = schema_changed || now - state.last_keyframe >= policy_.keyframe_interval;
+
+    std::vector<std::string> messages;
+    telemetry::JsonWriter json;
+    if (schema_changed) {
+        state.schema_id = next_schema_id_++;
+        state.paths.clear();
+        for (const Field &field : fields_) {
+            state.paths.push_back(field.path);
+        }
+        state.values.assign(fields_.size(), std::string());
+    }
+    if (schema_changed) {
+        appendSchema(json, type_, state);
+        messages.push_back(json.str());
+        json.clear();
+    }
+
+    json.raw("{\"t\":").integer(state.schema_id);
+    json.raw(",\"s\":").integer(++state.sequence);
+    json.raw(keyframe ? ",\"k\":[" : ",\"d\":[");
+    bool first = true;
+    for (std::size_t index = 0; index < fields_.size(); ++index) {
+        std::string &value = fields_[index].value;
+        if (!keyframe && value == state.values[index]) {
+            continue;
+        }
+        json.raw(first ? "" : ",");
+        first = false;
+        if (!keyframe) {
+            json.integer(index).raw(",");
+        }
+        json.raw(value);
+        state.values[index].swap(value);
+    }
+    json.raw("]}");
+    messages.push_back(json.str());
+
+    if (keyframe) {
+        state.last_keyframe = now;
+    }
+    return messages;
+}
+
+std::vector<std::string> CompactTelemetryEncoder::resyncMessages() const {
+    const auto it = types_.find(type_);
+    if (it == types_.end() || it->second.schema_id == 0) {
+        return {};
+    }
+
+    const TypeState &state = it->second;
+    std::vector<std::string> messages;
+    telemetry::JsonWriter json;
+    appendSchema(json, type_, state);
+    messages.push_back(json.str());
+    json.clear();
+    json.raw("{\"t\":").integer(state.schema_id);
+    json.raw(",\"s\":").integer(state.sequence);
+    json.raw(",\"k\":[");
+    for (std::size_t index = 0; index < state.values.size(); ++index) {
+        json.raw(index == 0 ? "" : ",").raw(state.values[index]);
+    }
+    json.raw("]}");
+    messages.push_back(json.str());
+    return messages;
+}
+
+void CompactTelemetryEncoder::appendSchema(telemetry::JsonWriter &json, std::string_view type,
+                                           const TypeState &state) {
+    json.raw("{\"type\":\"telemetry.schema\",\"id\":").integer(state.schema_id);
+    json.raw(",\"for\":").string(type);
+    json.raw(",\"fields\":[");
+    for (std::size_t index = 0; index < state.paths.size(); ++index) {
+        json.raw(index == 0 ? "" : ",").string(state.paths[index]);
+    }
+    json.raw("]}");
+}
+
+bool CompactTelemetryEncoder::flatten(std::string_view payload) {
+    fields_.clear();
+    type_.clear();
+
+    Cursor cursor{payload, 0, policy_.float_decimals};
+    cursor.skipSpace();
+    if (!cursor.at('{')) {
+        return false;
+    }
+
+    bool type_found = false;
+    bool valid_type = false;
+    auto emit = [&](const std::string &path, std::string value) {
+        if (path == "type") {
+            type_found = true;
+            valid_type = value.size() > kTelemetryTypePrefix.size() + 1 &&
+                         value.compare(0, kTelemetryTypePrefix.size(), kTelemetryTypePrefix) == 0 &&
+                         value.find('\\') == std::string::npos;
+            if (valid_type) {
+                type_ = value.substr(1, value.size() - 2);
+            }
+            return;
+        }
+        fields_.push_back({path, std::move(value)});
+    };
+    std::size_t emitted = 0;
+    if (!readObjectFields(cursor, std::string(), emit, emitted)) {
+        return false;
+    }
+    cursor.skipSpace();
+    return type_found && valid_type && cursor.pos == payload.size();
+}
+
+} // namespace autonomous_car::services::websocket
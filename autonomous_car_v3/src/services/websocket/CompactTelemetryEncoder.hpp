@@ -0,0 +1,84 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "services/telemetry/JsonWriter.hpp"
+
+namespace autonomous_car::services::websocket {
+
+struct CompactTelemetryPolicy {
+    // Keyframe periodico por tipo, para quem entrou depois ou perdeu um delta.
+    std::chrono::milliseconds keyframe_interval{2000};
+    // Casas decimais dos numeros nao inteiros; a comparacao de mudanca usa o valor ja quantizado.
+    int float_decimals{4};
+};
+
+// Telemetria em schema + keyframe/delta (client:telemetry_format=compact). Nao e thread-safe: quem
+// publica serializa o encode e o que le o estado dele.
+class CompactTelemetryEncoder {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit CompactTelemetryEncoder(CompactTelemetryPolicy policy = {});
+
+    // Mensagens a enviar, em ordem; vazio quando o payload deve seguir em JSON completo.
+    std::vector<std::string> encode(std::string_view payload, Clock::time_point now = Clock::now());
+    // Schema e keyframe do ultimo tipo codificado, com o mesmo s: base para uma sessao que a perdeu.
+    [[nodiscard]] std::vector<std::string> resyncMessages() const;
+    [[nodiscard]] const std::string &lastType() const noexcept { return type_; }
+
+private:
+    struct Field {
+        std::string path;
+        std::string value;
+    };
+
+    struct TypeState {
+        std::uint32_t schema_id{0};
+        std::uint64_t sequence{0};
+        Clock::time_point last_keyframe{};
+        std::vector<std::string> paths;
+        std::vector<std::string> values;
+    };
+
+    bool flatten(std::string_view payload);
+    static void appendSchema(telemetry::JsonWriter &json, std::string_view type,
+                             const TypeState &state);
+
+    CompactTelemetryPolicy policy_;
+    std::unordered_map<std::string, TypeState> types_;
+    std::uint32_t next_schema_id_{1};
+    // Reaproveitados entre chamadas.
+    std::vector<Field> fields_;
+    std::string type_;
+};
+
+// Tipos dos quais a sessao ja tem schema e keyframe. Um descarte na fila dela ou um novo pedido
+// de compact so a ressincroniza, sem mexer no encoder compartilhado.
+class CompactTelemetrySession {
+public:
+    [[nodiscard]] bool needsResync(const std::string &type) const {
+        return synced_types_.count(type) == 0;
+    }
+    void markSynced(const std::string &type) { synced_types_.insert(type); }
+    void requestResync() noexcept { synced_types_.clear(); }
+    // dropped_telemetry e o contador acumulado da fila da sessao.
+    void observeDrops(std::uint64_t dropped_telemetry) {
+        if (dropped_telemetry != dropped_seen_) {
+            dropped_seen_ = dropped_telemetry;
+            requestResync();
+        }
+    }
+
+private:
+    std::unordered_set<std::string> synced_types_;
+    std::uint64_t dropped_seen_{0};
+};
+
+} // namespace autonomous_car::services::websocket
@@ -0,0 +1,145 @@
+#include "services/websocket/SessionSendQueue.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace autonomous_car::services::websocket {
+
+std::shared_ptr<const OutboundFrame> makeTextFrame(std::shared_ptr<const std::string> payload) {
+    auto frame = std::make_shared<OutboundFrame>();
+    frame->header = encodeTextFrameHeader(payload->size());
+    frame->payload = std::move(payload);
+    return frame;
+}
+
+std::shared_ptr<const OutboundFrame> makeBinaryFrame(std::shared_ptr<const std::string> payload) {
+    auto frame = std::make_shared<OutboundFrame>();
+    frame->header = encodeBinaryFrameHeader(payload->size());
+    frame->payload = std::move(payload);
+    return frame;
+}
+
+std::shared_ptr<const OutboundFrame> makeRawFrame(std::string bytes) {
+    auto frame = std::make_shared<OutboundFrame>();
+    frame->payload = std::make_shared<const std::string>(std::move(bytes));
+    return frame;
+}
+
+SessionSendQueue::SessionSendQueue(SendQueuePolicy policy) : policy_{policy} {}
+
+SessionSendQueue::PushResult SessionSendQueue::push(OutboundTopic topic, int key,
+                                                    std::shared_ptr<const OutboundFrame> frame) {
+    bool dropped = false;
+    if (const auto *topic_policy = policyFor(topic)) {
+        const auto matches = [&](const Entry &entry) {
+            return entry.topic == topic &&
+                   (topic_policy->drop_policy == DropPolicy::BoundedFifo || entry.key == key);
+        };
+        // O frame da frente ja pode ter ido em parte para o socket; ele nao entra na conta.
+        const auto first_pending = entries_.begin() + (front_offset_ > 0 ? 1 : 0);
+        auto pending = static_cast<std::size_t>(std::count_if(first_pending, entries_.end(), matches));
+        const std::size_t capacity = std::max<std::size_t>(topic_policy->capacity, 1);
+        while (pending >= capacity && dropOldest(topic, key, topic_policy->drop_policy)) {
+            --pending;
+            dropped = true;
+        }
+    }
+
+    queued_bytes_ += frame->size();
+    entries_.push_back(Entry{topic, key, std::move(frame)});
+    if (queued_bytes_ > policy_.max_queued_bytes) {
+        return PushResult::Overflow;
+    }
+    return dropped ? PushResult::QueuedAfterDrop : PushResult::Queued;
+}
+
+std::size_t SessionSendQueue::gather(iovec *segments, std::size_t max_segments) const {
+    std::size_t used = 0;
+    std::size_t skip = front_offset_;
+    const auto add = [&](const char *data, std::size_t size) {
+        if (skip >= size) {
+            skip -= size;
+            return;
+        }
+        segments[used].iov_base = const_cast<char *>(data + skip);
+        segments[used].iov_len = size - skip;
+        skip = 0;
+        ++used;
+    };
+
+    for (const auto &entry : entries_) {
+        add(entry.frame->header.bytes.data(), entry.frame->header.size);
+        if (used == max_segments) {
+            break;
+        }
+        add(entry.frame->payload->data(), entry.frame->payload->size());
+        if (used == max_segments) {
+            break;
+        }
+    }
+    return used;
+}
+
+void SessionSendQueue::consume(std::size_t bytes) {
+    while (bytes > 0 && !entries_.empty()) {
+        const std::size_t remaining = entries_.front().frame->size() - front_offset_;
+        const std::size_t taken = std::min(bytes, remaining);
+        front_offset_ += taken;
+        queued_bytes_ -= taken;
+        bytes -= taken;
+        if (taken == remaining) {
+            entries_.pop_front();
+            front_offset_ = 0;
+            ++sent_messages_;
+        }
+    }
+}
+
+void SessionSendQueue::clear() {
+    entries_.clear();
+    front_offset_ = 0;
+    queued_bytes_ = 0;
+}
+
+SendQueueStats SessionSendQueue::stats() const {
+    SendQueueStats stats;
+    stats.queued_messages = entries_.size();
+    stats.queued_bytes = queued_bytes_;
+    stats.sent_messages = sent_messages_;
+    stats.dropped_telemetry = dropped_telemetry_;
+    stats.dropped_vision_frames = dropped_vision_frames_;
+    return stats;
+}
+
+const TopicQueuePolicy *SessionSendQueue::policyFor(OutboundTopic topic) const {
+    switch (topic) {
+    case OutboundTopic::Telemetry:
+        return &policy_.telemetry;
+    case OutboundTopic::VisionFrame:
+        return &policy_.vision_frame;
+    case OutboundTopic::Control:
+        break;
+    }
+    return nullptr;
+}
+
+bool SessionSendQueue::dropOldest(OutboundTopic topic, int key, DropPolicy drop_policy) {
+    const auto first_pending = entries_.begin() + (front_offset_ > 0 ? 1 : 0);
+    const auto it = std::find_if(first_pending, entries_.end(), [&](const Entry &entry) {
+        return entry.topic == topic && (drop_policy == DropPolicy::BoundedFifo || entry.key == key);
+    });
+    if (it == entries_.end()) {
+        return false;
+    }
+
+    queued_bytes_ -= it->frame->size();
+    entries_.erase(it);
+    if (topic == OutboundTopic::VisionFrame) {
+        ++dropped_vision_frames_;
+    } else {
+        ++dropped_telemetry_;
+    }
+    return true;
+}
+
+} // namespace autonomous_car::services::websocket
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <sys/uio.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+
+#include "services/websocket/WebSocketProtocol.hpp"
+
+namespace autonomous_car::services::websocket {
+
+// Frame pronto para envio: o cabecalho e montado uma vez por broadcast e o payload e o mesmo
+// buffer imutavel para todas as sessoes; o envio junta os dois com sendmsg, sem copia.
+struct OutboundFrame {
+    FrameHeader header;
+    std::shared_ptr<const std::string> payload;
+
+    [[nodiscard]] std::size_t size() const noexcept { return header.size + payload->size(); }
+};
+
+std::shared_ptr<const OutboundFrame> makeTextFrame(std::shared_ptr<const std::string> payload);
+std::shared_ptr<const OutboundFrame> makeBinaryFrame(std::shared_ptr<const std::string> payload);
+// Bytes enviados como estao, sem cabecalho WebSocket (resposta do handshake, close).
+std::shared_ptr<const OutboundFrame> makeRawFrame(std::string bytes);
+
+// Controle cobre handshake e close, que nunca sao descartados.
+enum class OutboundTopic { Control, Telemetry, VisionFrame };
+
+enum class DropPolicy {
+    // Mantem so os capacity frames mais novos de cada chave (a view, para vision.frame).
+    KeepLatest,
+    // Fila FIFO de ate capacity mensagens; cheia, descarta a mais antiga ainda nao iniciada.
+    BoundedFifo,
+};
+
+struct TopicQueuePolicy {
+    DropPolicy drop_policy{DropPolicy::BoundedFifo};
+    std::size_t capacity{1};
+};
+
+struct SendQueuePolicy {
+    TopicQueuePolicy telemetry{DropPolicy::BoundedFifo, 64};
+    TopicQueuePolicy vision_frame{DropPolicy::KeepLatest, 1};
+    // Limite duro; quem passa disso mesmo apos os descartes e desconectado.
+    std::size_t max_queued_bytes{4 * 1024 * 1024};
+};
+
+struct SendQueueStats {
+    std::size_t queued_messages{0};
+    std::size_t queued_bytes{0};
+    std::uint64_t sent_messages{0};
+    std::uint64_t dropped_telemetry{0};
+    std::uint64_t dropped_vision_frames{0};
+};
+
+// Fila de saida de uma sessao WebSocket. Nao e thread-safe: o servidor a protege com o
+// send_mutex da sessao. Os frames sao compartilhados entre todas as sessoes do broadcast.
+class SessionSendQueue {
+public:
+    enum class PushResult { Queued, QueuedAfterDrop, Overflow };
+
+    explicit SessionSendQueue(SendQueuePolicy policy = {});
+
+    PushResult push(OutboundTopic topic, int key, std::shared_ptr<const OutboundFrame> frame);
+
+    [[nodiscard]] bool empty() const noexcept { return entries_.empty(); }
+    // Preenche ate max_segments iovecs com o que falta enviar, na ordem da fila; retorna
+    // quantos foram usados. Os ponteiros valem ate o proximo push/consume/clear.
+    std::size_t gather(iovec *segments, std::size_t max_segments) const;
+    void consume(std::size_t bytes);
+    void clear();
+
+    [[nodiscard]] SendQueueStats stats() const;
+
+private:
+    struct Entry {
+        OutboundTopic topic{OutboundTopic::Control};
+        int key{0};
+        std::shared_ptr<const OutboundFrame> frame;
+    };
+
+    const TopicQueuePolicy *policyFor(OutboundTopic topic) const;
+    bool dropOldest(OutboundTopic topic, int key, DropPolicy drop_policy);
+
+    SendQueuePolicy policy_;
+    std::deque<Entry> entries_;
+    std::size_t front_offset_{0};
+    std::size_t queued_bytes_{0};
+    std::uint64_t sent_messages_{0};
+    std::uint64_t dropped_telemetry_{0};
+    std::uint64_t dropped_vision_frames_{0};
+};
+
+} // namespace autonomous_car::services::websocket
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <cctype>
 #include <cmath>
+#include <cstdint>
 #include <exception>
 
 namespace {
@@ -23,6 +24,26 @@ std::string toLower(std::string value) {
     return value;
 }
 
+autonomous_car::services::websocket::FrameHeader encodeFrameHeader(unsigned char opcode,
+                                                                  std::size_t payload_size) {
+    autonomous_car::services::websocket::FrameHeader header;
+    header.bytes[header.size++] = static_cast<char>(0x80 | opcode);
+    if (payload_size <= 125) {
+        header.bytes[header.size++] = static_cast<char>(payload_size);
+    } else if (payload_size <= 0xFFFFu) {
+        header.bytes[header.size++] = static_cast<char>(126);
+        header.bytes[header.size++] = static_cast<char>((payload_size >> 8) & 0xFFu);
+        header.bytes[header.size++] = static_cast<char>(payload_size & 0xFFu);
+    } else {
+        header.bytes[header.size++] = static_cast<char>(127);
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            header.bytes[header.size++] = static_cast<char>(
+                (static_cast<std::uint64_t>(payload_size) >> shift) & 0xFFu);
+        }
+    }
+    return header;
+}
+
 } // namespace
 
 namespace autonomous_car::services::websocket {
@@ -47,7 +68,12 @@ std::optional<ParsedMessage> parseInboundMessage(const std::string &payload) {
     if (channel_token == "client") {
         ParsedMessage parsed;
         parsed.channel = MessageChannel::Client;
-        parsed.key = toLower(remainder);
+        // client:<papel> ou client:<opcao>=<valor> (telemetry_format=compact|json).
+        const auto equals_pos = remainder.find('=');
+        parsed.key = toLower(trim(remainder.substr(0, equals_pos)));
+        if (equals_pos != std::string::npos) {
+            parsed.value = toLower(trim(remainder.substr(equals_pos + 1)));
+        }
         return parsed;
     }
 
@@ -168,4 +194,78 @@ bool messageRequiresControllerRole(MessageChannel channel) {
     return channel == MessageChannel::Command || channel == MessageChannel::Config;
 }
 
+ClientFrame decodeClientFrame(std::string_view buffer, std::size_t max_payload_bytes) {
+    ClientFrame frame;
+    if (buffer.size() < 2) {
+        return frame;
+    }
+
+    const auto byte = [&buffer](std::size_t index) {
+        return static_cast<unsigned char>(buffer[index]);
+    };
+    const bool fin = (byte(0) & 0x80) != 0;
+    const bool masked = (byte(1) & 0x80) != 0;
+    if (!fin || !masked) {
+        frame.status = FrameDecodeStatus::Invalid;
+        return frame;
+    }
+
+    std::size_t header_size = 2;
+    std::uint64_t payload_length = byte(1) & 0x7F;
+    if (payload_length == 126) {
+        header_size += 2;
+        if (buffer.size() < header_size) {
+            return frame;
+        }
+        payload_length = (static_cast<std::uint64_t>(byte(2)) << 8) | byte(3);
+    } else if (payload_length == 127) {
+        header_size += 8;
+        if (buffer.size() < header_size) {
+            return frame;
+        }
+        payload_length = 0;
+        for (std::size_t i = 2; i < 10; ++i) {
+            payload_length = (payload_length << 8) | byte(i);
+        }
+    }
+
+    if (payload_length > max_payload_bytes) {
+        frame.status = FrameDecodeStatus::Invalid;
+        return frame;
+    }
+
+    const std::size_t mask_offset = header_size;
+    header_size += 4;
+    const auto length = static_cast<std::size_t>(payload_length);
+    if (buffer.size() < header_size + length) {
+        return frame;
+    }
+
+    frame.payload.assign(buffer.substr(header_size, length));
+    for (std::size_t i = 0; i < length; ++i) {
+        frame.payload[i] = static_cast<char>(frame.payload[i] ^ buffer[mask_offset + i % 4]);
+    }
+    frame.status = FrameDecodeStatus::Complete;
+    frame.opcode = byte(0) & 0x0F;
+    frame.consumed = header_size + length;
+    return frame;
+}
+
+FrameHeader encodeTextFrameHeader(std::size_t payload_size) {
+    return encodeFrameHeader(0x1, payload_size);
+}
+
+FrameHeader encodeBinaryFrameHeader(std::size_t payload_size) {
+    return encodeFrameHeader(0x2, payload_size);
+}
+
+std::string encodeTextFrame(std::string_view payload) {
+    const auto header = encodeTextFrameHeader(payload.size());
+    std::string frame;
+    frame.reserve(header.size + payload.size());
+    frame.append(header.bytes.data(), header.size);
+    frame.append(payload);
+    return frame;
+}
+
 } // namespace autonomous_car::services::websocket
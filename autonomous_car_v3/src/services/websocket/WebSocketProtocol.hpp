@@ -1,7 +1,10 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <optional>
 #include <string>
+#include <string_view>
 
 #include "services/websocket/ClientRegistry.hpp"
 
@@ -21,4 +24,27 @@ std::optional<ClientRole> parseClientRole(const std::string &value);
 std::optional<double> parseCommandValue(const std::optional<std::string> &raw_value);
 bool messageRequiresControllerRole(MessageChannel channel);
 
+enum class FrameDecodeStatus { Incomplete, Complete, Invalid };
+
+struct ClientFrame {
+    FrameDecodeStatus status{FrameDecodeStatus::Incomplete};
+    unsigned char opcode{0};
+    std::size_t consumed{0};
+    std::string payload;
+};
+
+// Decodifica o primeiro frame de cliente em buffer. Frames fragmentados, sem mascara ou com
+// payload acima de max_payload_bytes sao Invalid; Incomplete enquanto faltarem bytes.
+ClientFrame decodeClientFrame(std::string_view buffer, std::size_t max_payload_bytes);
+
+struct FrameHeader {
+    std::array<char, 10> bytes{};
+    std::size_t size{0};
+};
+
+// Cabecalho de um frame de texto do servidor (FIN, sem mascara) para payload_size bytes.
+FrameHeader encodeTextFrameHeader(std::size_t payload_size);
+FrameHeader encodeBinaryFrameHeader(std::size_t payload_size);
+std::string encodeTextFrame(std::string_view payload);
+
 } // namespace autonomous_car::services::websocket
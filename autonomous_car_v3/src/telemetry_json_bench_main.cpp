@@ -0,0 +1,444 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "services/autonomous_control/AutonomousControlTelemetry.hpp"
+#include "services/road_segmentation/RoadSegmentationTelemetry.hpp"
+#include "services/traffic_sign_detection/TrafficSignTelemetry.hpp"
+#include "services/vision/VisionRuntimeTelemetry.hpp"
+
+namespace {
+
+std::atomic<std::uint64_t> g_allocations{0};
+// Impede o compilador de descartar as mensagens medidas.
+volatile std::size_t g_sink = 0;
+
+} // namespace
+
+// Conta alocacoes para mostrar quantas cada mensagem custa.
+void *operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+// Fora de linha para o GCC nao ver o free() casado com o operator new inlinado no chamador.
+__attribute__((noinline)) void operator delete(void *pointer) noexcept { std::free(pointer); }
+void operator delete(void *pointer, std::size_t) noexcept { ::operator delete(pointer); }
+
+namespace {
+
+namespace autoctrl = autonomous_car::services::autonomous_control;
+namespace rs = autonomous_car::services::road_segmentation;
+namespace ts = autonomous_car::services::traffic_sign_detection;
+namespace vision = autonomous_car::services::vision;
+namespace rsl = road_segmentation_lab;
+
+using Clock = std::chrono::steady_clock;
+
+// Builders com ostringstream que o JsonWriter substituiu, mantidos como referencia.
+namespace legacy {
+
+std::string jsonEscape(std::string_view value) {
+    std::string escaped;
+    escaped.reserve(value.size());
+
+    for (char ch : value) {
+        switch (ch) {
+        case '\\':
+            escaped += "\\\\";
+            break;
+        case '"':
+            escaped += "\\\"";
+            break;
+        case '\n':
+            escaped += "\\n";
+            break;
+        case '\r':
+            escaped += "\\r";
+            break;
+        case '\t':
+            escaped += "\\t";
+            break;
+        default:
+            escaped.push_back(ch);
+            break;
+        }
+    }
+
+    return escaped;
+}
+
+void appendNumber(std::ostringstream &stream, double value) {
+    stream << std::fixed << std::setprecision(6) << value;
+}
+
+void appendReference(std::ostringstream &stream, const autoctrl::ReferenceControlState &reference) {
+    stream << "{";
+    stream << "\"valid\":" << (reference.valid ? "true" : "false");
+    stream << ",\"used\":" << (reference.used ? "true" : "false");
+    stream << ",\"configured_weight\":";
+    appendNumber(stream, reference.configured_weight);
+    stream << ",\"applied_weight\":";
+    appendNumber(stream, reference.applied_weight);
+    stream << ",\"steering_error_normalized\":";
+    appendNumber(stream, reference.steering_error_normalized);
+    stream << ",\"lateral_offset_px\":";
+    appendNumber(stream, reference.lateral_offset_px);
+    stream << "}";
+}
+
+std::string buildAutonomousControlTelemetryJson(const autoctrl::AutonomousControlSnapshot &snapshot) {
+    std::ostringstream stream;
+    stream << "{";
+    stream << "\"type\":\"telemetry.autonomous_control\"";
+    stream << ",\"timestamp_ms\":" << snapshot.timestamp_ms;
+    stream << ",\"driving_mode\":\"" << toString(snapshot.driving_mode) << "\"";
+    stream << ",\"autonomous_started\":" << (snapshot.autonomous_started ? "true" : "false");
+    stream << ",\"tracking_state\":\"" << toString(snapshot.tracking_state) << "\"";
+    stream << ",\"stop_reason\":\"" << toString(snapshot.stop_reason) << "\"";
+    stream << ",\"fail_safe_active\":" << (snapshot.fail_safe_active ? "true" : "false");
+    stream << ",\"lane_available\":" << (snapshot.lane_available ? "true" : "false");
+    stream << ",\"confidence_ok\":" << (snapshot.confidence_ok ? "true" : "false");
+    stream << ",\"confidence_score\":";
+    appendNumber(stream, snapshot.confidence_score);
+    stream << ",\"preview_error\":";
+    appendNumber(stream, snapshot.preview_error);
+    stream << ",\"heading_error_rad\":";
+    appendNumber(stream, snapshot.heading_error_rad);
+    stream << ",\"heading_valid\":" << (snapshot.heading_valid ? "true" : "false");
+    stream << ",\"curvature_indicator_rad\":";
+    appendNumber(stream, snapshot.curvature_indicator_rad);
+    stream << ",\"curvature_valid\":" << (snapshot.curvature_valid ? "true" : "false");
+    stream << ",\"references\":{";
+    stream << "\"near\":";
+    appendReference(stream, snapshot.near_reference);
+    stream << ",\"mid\":";
+    appendReference(stream, snapshot.mid_reference);
+    stream << ",\"far\":";
+    appendReference(stream, snapshot.far_reference);
+    stream << "}";
+    stream << ",\"pid\":{";
+    stream << "\"error\":";
+    appendNumber(stream, snapshot.pid.error);
+    stream << ",\"p\":";
+    appendNumber(stream, snapshot.pid.proportional);
+    stream << ",\"i\":";
+    appendNumber(stream, snapshot.pid.integral);
+    stream << ",\"d\":";
+    appendNumber(stream, snapshot.pid.derivative);
+    stream << ",\"raw_output\":";
+    appendNumber(stream, snapshot.pid.raw_output);
+    stream << ",\"output\":";
+    appendNumber(stream, snapshot.pid.pid_output);
+    stream << "}";
+    stream << ",\"steering_command\":";
+    appendNumber(stream, snapshot.steering_command);
+    stream << ",\"motion_command\":\"" << toString(snapshot.motion_command) << "\"";
+    stream << ",\"projected_path\":[";
+    for (std::size_t index = 0; index < snapshot.projected_path.size(); ++index) {
+        if (index > 0) {
+            stream << ",";
+        }
+        stream << "{";
+        stream << "\"x\":";
+        appendNumber(stream, snapshot.projected_path[index].x);
+        stream << ",\"y\":";
+        appendNumber(stream, snapshot.projected_path[index].y);
+        stream << "}";
+    }
+    stream << "]";
+    stream << "}";
+    return stream.str();
+}
+
+std::string buildVisionRuntimeTelemetryJson(const vision::VisionRuntimeTelemetry &telemetry) {
+    std::ostringstream stream;
+    stream << "{";
+    stream << "\"type\":\"telemetry.vision_runtime\"";
+    stream << ",\"timestamp_ms\":" << telemetry.timestamp_ms;
+    stream << ",\"source\":\"" << jsonEscape(telemetry.source) << "\"";
+    stream << ",\"core_fps\":";
+    appendNumber(stream, telemetry.core_fps);
+    stream << ",\"stream_fps\":";
+    appendNumber(stream, telemetry.stream_fps);
+    stream << ",\"traffic_sign_fps\":";
+    appendNumber(stream, telemetry.traffic_sign_fps);
+    stream << ",\"traffic_sign_inference_ms\":";
+    appendNumber(stream, telemetry.traffic_sign_inference_ms);
+    stream << ",\"stream_encode_ms\":";
+    appendNumber(stream, telemetry.stream_encode_ms);
+    stream << ",\"stream_sent_kbytes_per_sec\":";
+    appendNumber(stream, telemetry.stream_sent_kbytes_per_sec);
+    stream << ",\"segmentation_pipeline_depth\":" << telemetry.segmentation_pipeline_depth;
+    stream << ",\"segmentation_prepare_ms\":";
+    appendNumber(stream, telemetry.segmentation_prepare_ms);
+    stream << ",\"segmentation_segment_ms\":";
+    appendNumber(stream, telemetry.segmentation_segment_ms);
+    stream << ",\"segmentation_analyze_ms\":";
+    appendNumber(stream, telemetry.segmentation_analyze_ms);
+    stream << ",\"segmentation_pipeline_added_ms\":";
+    appendNumber(stream, telemetry.segmentation_pipeline_added_ms);
+    stream << ",\"traffic_sign_dropped_frames\":" << telemetry.traffic_sign_dropped_frames;
+    stream << ",\"stream_dropped_frames\":" << telemetry.stream_dropped_frames;
+    stream << ",\"stream_skipped_views\":" << telemetry.stream_skipped_views;
+    stream << ",\"sign_result_age_ms\":" << telemetry.sign_result_age_ms;
+    stream << "}";
+    return stream.str();
+}
+
+} // namespace legacy
+
+struct CliOptions {
+    std::size_t iterations{200000};
+    double telemetry_hz{10.0};
+};
+
+struct Measurement {
+    double ns_per_message{0.0};
+    double allocations_per_message{0.0};
+    std::size_t bytes{0};
+};
+
+void printHelp(const char *program_name) {
+    std::cout << "Uso:\n"
+              << "  " << program_name << " [--iterations N] [--telemetry-hz N]\n\n"
+              << "  --iterations <N>     Mensagens por builder (padrao 200000).\n"
+              << "  --telemetry-hz <N>   Taxa usada no custo por segundo (padrao 10, o\n"
+              << "                       VISION_TELEMETRY_MAX_FPS padrao).\n"
+              << "  --help               Exibe esta ajuda.\n";
+}
+
+double parsePositive(const std::string &value, const std::string &option) {
+    try {
+        std::size_t consumed = 0;
+        const double parsed = std::stod(value, &consumed);
+        if (consumed == value.size() && parsed > 0.0) {
+            return parsed;
+        }
+    } catch (const std::exception &) {
+    }
+    throw std::runtime_error("Valor invalido para " + option + ": " + value);
+}
+
+CliOptions parseArgs(int argc, char **argv) {
+    CliOptions options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string argument = argv[i];
+        if (argument == "--help" || argument == "-h") {
+            printHelp(argv[0]);
+            std::exit(0);
+        }
+
+        if (i + 1 >= argc) {
+            throw std::runtime_error("Faltou o valor de " + argument);
+        }
+        const std::string value = argv[++i];
+        if (argument == "--iterations") {
+            options.iterations = static_cast<std::size_t>(parsePositive(value, argument));
+        } else if (argument == "--telemetry-hz") {
+            options.telemetry_hz = parsePositive(value, argument);
+        } else {
+            throw std::runtime_error("Argumento desconhecido: " + argument);
+        }
+    }
+    return options;
+}
+
+// Mensagens com o tamanho tipico de uma pista rastreada e uma placa confirmada.
+autoctrl::AutonomousControlSnapshot sampleControlSnapshot() {
+    autoctrl::AutonomousControlSnapshot snapshot;
+    snapshot.driving_mode = autonomous_car::DrivingMode::Autonomous;
+    snapshot.autonomous_started = true;
+    snapshot.tracking_state = autoctrl::TrackingState::Tracking;
+    snapshot.motion_command = autoctrl::MotionCommand::Forward;
+    snapshot.lane_available = true;
+    snapshot.confidence_ok = true;
+    snapshot.confidence_score = 0.8734;
+    snapshot.near_reference = {true, true, 0.5, 0.48, -0.0821, -13.4};
+    snapshot.mid_reference = {true, true, 0.3, 0.31, -0.1173, -19.02};
+    snapshot.far_reference = {true, false, 0.2, 0.0, 0.0, 0.0};
+    snapshot.pid = {-0.0954, -0.0763, -0.0121, 0.0034, -0.085, -0.085};
+    snapshot.preview_error = -0.0954;
+    snapshot.steering_command = -0.085;
+    snapshot.heading_error_rad = 0.0412;
+    snapshot.heading_valid = true;
+    snapshot.curvature_indicator_rad = 0.0087;
+    snapshot.curvature_valid = true;
+    snapshot.timestamp_ms = 1710000000123;
+    for (int point = 0; point < 12; ++point) {
+        snapshot.projected_path.push_back({160.0 - point * 1.37, 240.0 - point * 15.5});
+    }
+    return snapshot;
+}
+
+rsl::pipeline::RoadSegmentationResult sampleSegmentationResult() {
+    rsl::pipeline::RoadSegmentationResult result;
+    result.lane_found = true;
+    result.confidence_score = 0.8734;
+    result.lane_center_ratio = 0.4589;
+    result.steering_error_normalized = -0.0821;
+    result.lateral_offset_px = -13.4;
+    result.heading_error_rad = 0.0412;
+    result.heading_valid = true;
+    result.curvature_indicator_rad = 0.0087;
+    result.curvature_valid = true;
+    for (auto *reference : {&result.near_reference, &result.mid_reference, &result.far_reference}) {
+        reference->valid = true;
+        reference->point = {147, 180};
+        reference->top_y = 160;
+        reference->bottom_y = 200;
+        reference->center_ratio = 0.4589;
+        reference->lateral_offset_px = -13.4;
+        reference->steering_error_normalized = -0.0821;
+        reference->sample_count = 18;
+    }
+    return result;
+}
+
+ts::TrafficSignFrameResult sampleTrafficSignResult() {
+    ts::TrafficSignFrameResult result;
+    result.timestamp_ms = 1710000000123;
+    result.detector_state = ts::TrafficSignDetectorState::Confirmed;
+    result.roi.source_frame_size = {640, 480};
+    result.roi.frame_rect = {352, 38, 288, 307};
+    ts::TrafficSignDetection detection;
+    detection.sign_id = ts::TrafficSignId::Stop;
+    detection.model_label = "stop";
+    detection.display_label = "Pare";
+    detection.confidence_score = 0.9312;
+    detection.bbox_frame = {420, 90, 64, 64};
+    detection.bbox_roi = {68, 52, 64, 64};
+    detection.consecutive_frames = 3;
+    detection.required_frames = 3;
+    detection.confirmed_at_ms = 1710000000000;
+    detection.last_seen_at_ms = 1710000000123;
+    result.raw_detections = {detection, detection};
+    result.candidate = detection;
+    result.active_detection = detection;
+    return result;
+}
+
+vision::VisionRuntimeTelemetry sampleRuntimeTelemetry() {
+    vision::VisionRuntimeTelemetry telemetry;
+    telemetry.timestamp_ms = 1710000000123;
+    telemetry.source = "camera:0";
+    telemetry.core_fps = 29.87;
+    telemetry.stream_fps = 4.98;
+    telemetry.traffic_sign_fps = 3.97;
+    telemetry.traffic_sign_inference_ms = 41.2;
+    telemetry.stream_encode_ms = 6.3;
+    telemetry.stream_sent_kbytes_per_sec = 412.5;
+    telemetry.traffic_sign_dropped_frames = 1204;
+    telemetry.stream_dropped_frames = 5830;
+    telemetry.sign_result_age_ms = 83;
+    return telemetry;
+}
+
+Measurement measure(std::size_t iterations, const std::function<std::string()> &build) {
+    // Aquece o buffer reaproveitado antes de medir.
+    Measurement measurement;
+    measurement.bytes = build().size();
+    std::size_t sink = 0;
+    const auto allocations_before = g_allocations.load(std::memory_order_relaxed);
+    const auto started = Clock::now();
+    for (std::size_t iteration = 0; iteration < iterations; ++iteration) {
+        sink += build().size();
+    }
+    const auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - started).count();
+    const auto allocations =
+        g_allocations.load(std::memory_order_relaxed) - allocations_before;
+    g_sink = sink;
+    measurement.ns_per_message = elapsed / static_cast<double>(iterations);
+    measurement.allocations_per_message =
+        static_cast<double>(allocations) / static_cast<double>(iterations);
+    return measurement;
+}
+
+void printMeasurement(const std::string &builder, const std::string &variant,
+                      const Measurement &measurement, double telemetry_hz) {
+    std::cout << std::left << std::setw(30) << builder << std::setw(14) << variant << std::right
+              << std::fixed << std::setprecision(0) << std::setw(8) << measurement.ns_per_message
+              << " ns/msg | " << std::setprecision(1) << std::setw(4)
+              << measurement.allocations_per_message << " alocacoes/msg | " << std::setw(5)
+              << measurement.bytes << " bytes | " << std::setprecision(2)
+              << measurement.ns_per_message * telemetry_hz / 1000.0 << " us/s a "
+              << std::setprecision(0) << telemetry_hz << " Hz\n";
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    try {
+        const CliOptions options = parseArgs(argc, argv);
+        const auto control_snapshot = sampleControlSnapshot();
+        const auto segmentation_result = sampleSegmentationResult();
+        const auto sign_result = sampleTrafficSignResult();
+        const auto runtime_telemetry = sampleRuntimeTelemetry();
+
+        if (autoctrl::buildAutonomousControlTelemetryJson(control_snapshot) !=
+                legacy::buildAutonomousControlTelemetryJson(control_snapshot) ||
+            vision::buildVisionRuntimeTelemetryJson(runtime_telemetry) !=
+                legacy::buildVisionRuntimeTelemetryJson(runtime_telemetry)) {
+            std::cerr << "Erro: JsonWriter gerou bytes diferentes do ostringstream.\n";
+            return 1;
+        }
+
+        std::cout << options.iterations << " mensagens por builder; a alocacao restante de cada "
+                  << "mensagem e a std::string devolvida.\n\n";
+        printMeasurement("telemetry.autonomous_control", "ostringstream",
+                         measure(options.iterations,
+                                 [&] {
+                                     return legacy::buildAutonomousControlTelemetryJson(
+                                         control_snapshot);
+                                 }),
+                         options.telemetry_hz);
+        printMeasurement("telemetry.autonomous_control", "JsonWriter",
+                         measure(options.iterations,
+                                 [&] {
+                                     return autoctrl::buildAutonomousControlTelemetryJson(
+                                         control_snapshot);
+                                 }),
+                         options.telemetry_hz);
+        printMeasurement("telemetry.vision_runtime", "ostringstream",
+                         measure(options.iterations,
+                                 [&] {
+                                     return legacy::buildVisionRuntimeTelemetryJson(
+                                         runtime_telemetry);
+                                 }),
+                         options.telemetry_hz);
+        printMeasurement(
+            "telemetry.vision_runtime", "JsonWriter",
+            measure(options.iterations,
+                    [&] { return vision::buildVisionRuntimeTelemetryJson(runtime_telemetry); }),
+            options.telemetry_hz);
+        printMeasurement("telemetry.road_segmentation", "JsonWriter",
+                         measure(options.iterations,
+                                 [&] {
+                                     return rs::buildRoadSegmentationTelemetryJson(
+                                         segmentation_result, "camera:0", 1710000000123);
+                                 }),
+                         options.telemetry_hz);
+        printMeasurement(
+            "telemetry.traffic_sign", "JsonWriter",
+            measure(options.iterations,
+                    [&] { return ts::buildTrafficSignTelemetryJson(sign_result, "camera:0"); }),
+            options.telemetry_hz);
+        return 0;
+    } catch (const std::exception &ex) {
+        std::cerr << "Erro: " << ex.what() << '\n';
+        return 1;
+    }
+}
@@ -0,0 +1,97 @@
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "TestRegistry.hpp"
+#include "services/websocket/CompactTelemetryEncoder.hpp"
+
+namespace {
+
+using autonomous_car::services::websocket::CompactTelemetryEncoder;
+using autonomous_car::services::websocket::CompactTelemetryPolicy;
+using autonomous_car::tests::TestRegistrar;
+using autonomous_car::tests::expect;
+using autonomous_car::tests::expectContains;
+using Clock = CompactTelemetryEncoder::Clock;
+
+std::string roadMessage(long timestamp_ms, double near_x, bool lane_found) {
+    return "{\"type\":\"telemetry.road_segmentation\",\"timestamp_ms\":" +
+           std::to_string(timestamp_ms) + ",\"lane_found\":" + (lane_found ? "true" : "false") +
+           ",\"confidence_score\":0.812345,\"references\":{\"near\":{\"valid\":true,"
+           "\"center_ratio\":" +
+           std::to_string(near_x) + "},\"mid\":{}},\"points\":[1.500000,-0.000001]}";
+}
+
+Clock::time_point at(Clock::time_point start, int elapsed_ms) {
+    return start + std::chrono::milliseconds(elapsed_ms);
+}
+
+void testSchemaKeyframeAndDeltas() {
+    CompactTelemetryEncoder encoder;
+    const Clock::time_point start{};
+
+    const auto first = encoder.encode(roadMessage(1000, 0.5, true), start);
+    expect(first.size() == 2, "Primeira mensagem do tipo deve sair com schema e keyframe.");
+    expect(first[0] ==
+               "{\"type\":\"telemetry.schema\",\"id\":1,\"for\":\"telemetry.road_segmentation\","
+               "\"fields\":[\"timestamp_ms\",\"lane_found\",\"confidence_score\","
+               "\"references.near.valid\",\"references.near.center_ratio\","
+               "\"references.mid\",\"points\"]}",
+           "Schema deve listar os caminhos achatados, sem o type: " + first[0]);
+    expect(first[1] == "{\"t\":1,\"s\":1,\"k\":[1000,true,0.8123,true,0.5,{},[1.5,0]]}",
+           "Keyframe deve trazer todos os valores, com numeros quantizados: " + first[1]);
+
+    const auto second = encoder.encode(roadMessage(1033, 0.50001, true), at(start, 33));
+    expect(second.size() == 1 && second[0] == "{\"t\":1,\"s\":2,\"d\":[0,1033]}",
+           "Delta deve trazer so o que mudou depois da quantizacao: " + second[0]);
+
+    const auto third = encoder.encode(roadMessage(1066, 0.25, false), at(start, 66));
+    expect(third.size() == 1 && third[0] == "{\"t\":1,\"s\":3,\"d\":[0,1066,1,false,4,0.25]}",
+           "Delta deve trazer indice e valor de cada campo alterado: " + third[0]);
+
+    const std::string raw = roadMessage(1066, 0.25, false);
+    expect(third[0].size() * 4 < raw.size(),
+           "Delta deve ser bem menor que a mensagem completa.");
+}
+
+void testKeyframeResyncAndPassthrough() {
+    CompactTelemetryPolicy policy;
+    policy.keyframe_interval = std::chrono::milliseconds(500);
+    CompactTelemetryEncoder encoder(policy);
+    const Clock::time_point start{};
+
+    encoder.encode(roadMessage(1000, 0.5, true), start);
+    const auto periodic = encoder.encode(roadMessage(1600, 0.5, true), at(start, 600));
+    expect(periodic.size() == 1, "Keyframe periodico nao repete o schema.");
+    expectContains(periodic[0], "\"s\":2,\"k\":[1600,", "Passado o intervalo, deve sair keyframe.");
+
+    const auto delta = encoder.encode(roadMessage(1633, 0.5, true), at(start, 633));
+    expect(delta.size() == 1 && delta[0] == "{\"t\":1,\"s\":3,\"d\":[0,1633]}",
+           "Encoder compartilhado segue com deltas: " + delta[0]);
+    const auto resync = encoder.resyncMessages();
+    expect(resync.size() == 2, "Resync deve reenviar schema e keyframe.");
+    expectContains(resync[0], "\"id\":1,", "Resync mantem o id do schema.");
+    expectContains(resync[1], "\"s\":3,\"k\":[1633,", "Resync deve sair como keyframe do s atual.");
+
+    const auto other = encoder.encode(
+        "{\"type\":\"telemetry.autonomous_control\",\"steering_command\":-0.000020}", start);
+    expect(other.size() == 2 && other[1] == "{\"t\":2,\"s\":1,\"k\":[0]}",
+           "Cada tipo tem o proprio schema e a propria sequencia.");
+
+    const auto changed = encoder.encode(
+        "{\"type\":\"telemetry.autonomous_control\",\"mode\":\"auto\"}", at(start, 10));
+    expect(changed.size() == 2 && changed[1] == "{\"t\":3,\"s\":2,\"k\":[\"auto\"]}",
+           "Mudanca no conjunto de campos deve publicar um schema novo.");
+
+    expect(encoder.encode("{\"type\":\"vision.frame\",\"data\":\"abc\"}", start).empty(),
+           "Mensagem que nao e telemetria deve seguir inteira.");
+    expect(encoder.encode("{\"type\":\"telemetry.vision_runtime\",\"fps\":nan}", start).empty(),
+           "Payload que nao parseia deve seguir inteiro.");
+}
+
+TestRegistrar compact_telemetry_delta_test("compact_telemetry_schema_keyframe_and_deltas",
+                                           testSchemaKeyframeAndDeltas);
+TestRegistrar compact_telemetry_resync_test("compact_telemetry_keyframe_resync_and_passthrough",
+                                            testKeyframeResyncAndPassthrough);
+
+} // namespace
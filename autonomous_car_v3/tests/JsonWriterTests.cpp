@@ -0,0 +1,60 @@
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <string>
+
+#include "TestRegistry.hpp"
+#include "services/telemetry/JsonWriter.hpp"
+
+namespace {
+
+using autonomous_car::tests::TestRegistrar;
+using autonomous_car::tests::expect;
+namespace telemetry = autonomous_car::services::telemetry;
+
+std::string fixedSix(double value) {
+    std::ostringstream stream;
+    stream << std::fixed << std::setprecision(6) << value;
+    return stream.str();
+}
+
+void testJsonWriterMatchesOstringstreamFormatting() {
+    const double values[] = {0.0,     -0.0,   0.0000005, -0.0000015, 1.0000005, 123456.7890125,
+                             -412.5,  1e20,   5e-324,    std::numeric_limits<double>::max(),
+                             std::numeric_limits<double>::infinity()};
+    for (const double value : values) {
+        telemetry::JsonWriter json;
+        json.number(value);
+        expect(json.str() == fixedSix(value),
+               "number() deve gerar o mesmo texto que std::fixed com 6 casas: " + fixedSix(value));
+    }
+
+    telemetry::JsonWriter json;
+    json.raw("{\"a\":").integer(-42).raw(",\"b\":").integer(18446744073709551615ULL);
+    json.raw(",\"c\":").boolean(true).raw("}");
+    expect(json.str() == "{\"a\":-42,\"b\":18446744073709551615,\"c\":true}",
+           "Inteiros e booleanos devem sair em decimal e true/false.");
+}
+
+void testJsonWriterEscapesStringsAndReusesThreadBuffer() {
+    telemetry::JsonWriter json;
+    json.string("cam\\era \"0\"\n\r\tok");
+    expect(json.str() == "\"cam\\\\era \\\"0\\\"\\n\\r\\tok\"",
+           "string() deve escapar barra, aspas e quebras como os builders antigos.");
+
+    telemetry::JsonWriter &first = telemetry::threadJsonWriter();
+    first.raw(std::string(4096, 'x'));
+    const char *buffer = first.str().data();
+    telemetry::JsonWriter &second = telemetry::threadJsonWriter();
+    expect(&second == &first && second.size() == 0,
+           "Escritor da thread deve voltar limpo a cada mensagem.");
+    second.raw(std::string(4096, 'y'));
+    expect(second.str().data() == buffer, "Buffer da thread deve ser reaproveitado.");
+}
+
+TestRegistrar json_writer_formatting_test("json_writer_matches_ostringstream_formatting",
+                                          testJsonWriterMatchesOstringstreamFormatting);
+TestRegistrar json_writer_escape_test("json_writer_escapes_strings_and_reuses_thread_buffer",
+                                      testJsonWriterEscapesStringsAndReusesThreadBuffer);
+
+} // namespace
@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "TestRegistry.hpp"
+#include "frame_transport/SharedFrameRing.hpp"
+
+namespace {
+
+using autonomous_car::tests::TestRegistrar;
+using autonomous_car::tests::expect;
+namespace frame_transport = shared::frame_transport;
+
+std::string uniqueRingName(const std::string &suffix) {
+    return "/autonomous_car_v3_test_" + std::to_string(getpid()) + "_" + suffix;
+}
+
+void testLocalFrameRingSkipsCopiesWithoutReader() {
+    frame_transport::SharedFrameRingWriter writer(uniqueRingName("sem_leitor"));
+    std::vector<std::uint8_t> pixels(4 * 2 * 3, 7);
+    frame_transport::FrameView view{pixels.data(), 4, 2, 12, frame_transport::PixelFormat::Bgr8,
+                                    10};
+
+    expect(!writer.publish(view), "Sem leitor o anel nao deve copiar o frame.");
+    expect(!writer.hasReader(), "Escritor nao deve enxergar leitor inexistente.");
+    expect(writer.publishedCount() == 0, "Nenhum frame deve contar como publicado.");
+}
+
+void testLocalFrameRingDeliversRowsOfStridedFrame() {
+    const std::string name = uniqueRingName("roundtrip");
+    frame_transport::SharedFrameRingWriter writer(name);
+    frame_transport::SharedFrameRingReader reader(name);
+
+    // Linhas de 12 bytes dentro de um step de 16, como uma ROI de cv::Mat.
+    std::vector<std::uint8_t> pixels(16 * 2, 0);
+    for (std::size_t column = 0; column < 12; ++column) {
+        pixels[column] = static_cast<std::uint8_t>(column);
+        pixels[16 + column] = static_cast<std::uint8_t>(100 + column);
+    }
+    frame_transport::FrameView view{pixels.data(), 4, 2, 16, frame_transport::PixelFormat::Bgr8,
+                                    1234};
+
+    // O primeiro publish cria o segmento; o leitor se anexa e passa a mandar heartbeat.
+    writer.publish(view);
+    std::string received;
+    expect(!reader.waitNext(0, received, std::chrono::milliseconds(20)).has_value(),
+           "Frame publicado antes do leitor existir nao deve ser entregue.");
+    expect(reader.attached(), "Leitor deve se anexar ao segmento criado pelo escritor.");
+
+    std::thread publisher([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        writer.publish(view);
+    });
+    const auto frame = reader.waitNext(0, received, std::chrono::seconds(2));
+    publisher.join();
+
+    expect(frame.has_value(), "Leitor deve acordar com o frame publicado.");
+    expect(frame->width == 4 && frame->height == 2 &&
+               frame->format == frame_transport::PixelFormat::Bgr8,
+           "Metadados do frame devem atravessar o anel.");
+    expect(frame->timestamp_ms == 1234, "Timestamp do frame deve ser preservado.");
+    expect(received.size() == 24, "Pixels devem chegar compactos, sem o padding do step.");
+    expect(static_cast<std::uint8_t>(received[11]) == 11 &&
+               static_cast<std::uint8_t>(received[12]) == 100,
+           "Segunda linha deve vir logo depois da primeira.");
+    expect(!reader.waitNext(frame->sequence, received, std::chrono::milliseconds(20)).has_value(),
+           "Mesma sequencia nao deve ser entregue duas vezes.");
+}
+
+void testLocalFrameRingReaderHonorsDeadlineOnTornSlot() {
+    const std::string name = uniqueRingName("slot_rasgado");
+    frame_transport::SharedFrameRingWriter writer(name, 2);
+    frame_transport::SharedFrameRingReader reader(name);
+
+    std::vector<std::uint8_t> pixels(4 * 2 * 3);
+    for (std::size_t index = 0; index < pixels.size(); ++index) {
+        pixels[index] = static_cast<std::uint8_t>(200 + index);
+    }
+    frame_transport::FrameView view{pixels.data(), 4, 2, 12, frame_transport::PixelFormat::Bgr8,
+                                    1};
+    writer.publish(view);
+    std::string received;
+    reader.waitNext(0, received, std::chrono::milliseconds(20));
+
+    std::uint64_t last_sequence = 0;
+    for (std::int64_t timestamp = 2; timestamp <= 4; ++timestamp) {
+        view.timestamp_ms = timestamp;
+        expect(writer.publish(view), "Com leitor anexado o frame deve ser publicado.");
+        const auto frame = reader.waitNext(last_sequence, received, std::chrono::seconds(1));
+        expect(frame.has_value() && frame->timestamp_ms == timestamp &&
+                   frame->sequence > last_sequence,
+               "Frames seguidos devem ser entregues em ordem pelos slots do anel.");
+        last_sequence = frame ? frame->sequence : last_sequence;
+    }
+
+    // Simula um escritor que caiu no meio da copia: zera a sequencia do slot publicado, que fica
+    // nos 64 bytes antes dos pixels.
+    frame_transport::SharedSegment segment;
+    expect(segment.open(name), "Teste deve conseguir abrir o segmento do anel.");
+    auto *bytes = static_cast<std::uint8_t *>(segment.data());
+    const auto found = std::search(bytes, bytes + segment.size(), pixels.begin(), pixels.end());
+    expect(found != bytes + segment.size() && found - bytes >= 64,
+           "Pixels do frame devem estar no segmento.");
+    std::memset(found - 64, 0, sizeof(std::uint64_t));
+
+    const auto started = std::chrono::steady_clock::now();
+    expect(!reader.waitNext(0, received, std::chrono::milliseconds(50)).has_value(),
+           "Slot inconsistente nao deve ser entregue.");
+    expect(std::chrono::steady_clock::now() - started < std::chrono::seconds(1),
+           "Leitor deve respeitar o prazo mesmo com o slot publicado inconsistente.");
+}
+
+TestRegistrar local_frame_ring_no_reader_test("local_frame_ring_skips_copies_without_reader",
+                                              testLocalFrameRingSkipsCopiesWithoutReader);
+TestRegistrar local_frame_ring_roundtrip_test("local_frame_ring_delivers_rows_of_strided_frame",
+                                              testLocalFrameRingDeliversRowsOfStridedFrame);
+TestRegistrar local_frame_ring_torn_slot_test("local_frame_ring_reader_honors_deadline_on_torn_slot",
+                                              testLocalFrameRingReaderHonorsDeadlineOnTornSlot);
+
+} // namespace
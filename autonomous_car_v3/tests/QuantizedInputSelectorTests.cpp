@@ -0,0 +1,77 @@
+#include "TestRegistry.hpp"
+#include "services/traffic_sign_detection/QuantizedInputSelector.hpp"
+
+namespace {
+
+using autonomous_car::tests::TestRegistrar;
+using autonomous_car::tests::expect;
+namespace ts = autonomous_car::services::traffic_sign_detection;
+
+constexpr int kOk = 0;
+constexpr int kFailed = -1;
+
+struct FakeClassifier {
+    int quantized_status{kOk};
+    int quantized_calls{0};
+    int float_calls{0};
+
+    auto quantized() {
+        return [this] {
+            ++quantized_calls;
+            return quantized_status;
+        };
+    }
+
+    auto floating() {
+        return [this] {
+            ++float_calls;
+            return kOk;
+        };
+    }
+};
+
+void testQuantizedInputSurvivesTransientFailure() {
+    FakeClassifier classifier;
+    ts::QuantizedInputSelector selector;
+
+    expect(selector.probe(kOk, classifier.quantized(), classifier.floating()) == kOk,
+           "Aquecimento pelo int8 deve ter sucesso.");
+    expect(selector.quantizedEnabled(), "Modelo que aceita int8 deve manter o caminho quantizado.");
+    expect(classifier.float_calls == 0, "Aquecimento int8 bem sucedido nao deve rodar o float.");
+
+    classifier.quantized_status = kFailed;
+    expect(selector.run(kOk, classifier.quantized(), classifier.floating()) == kOk,
+           "Frame com falha no int8 deve ser refeito pelo caminho float.");
+    expect(classifier.float_calls == 1, "Falha no int8 deve cair no float so naquele frame.");
+    expect(selector.quantizedEnabled() && selector.quantizedFallbacks() == 1,
+           "Falha transitoria nao deve desligar o caminho int8.");
+
+    classifier.quantized_status = kOk;
+    selector.run(kOk, classifier.quantized(), classifier.floating());
+    expect(classifier.quantized_calls == 3 && classifier.float_calls == 1,
+           "Frame seguinte deve voltar a usar o int8.");
+}
+
+void testQuantizedInputDisabledWhenWarmupRejects() {
+    FakeClassifier classifier;
+    classifier.quantized_status = kFailed;
+    ts::QuantizedInputSelector selector;
+
+    expect(selector.probe(kOk, classifier.quantized(), classifier.floating()) == kOk,
+           "Aquecimento deve completar pelo float quando o int8 e recusado.");
+    expect(!selector.quantizedEnabled(), "Modelo que recusa int8 deve ficar no caminho float.");
+
+    selector.run(kOk, classifier.quantized(), classifier.floating());
+    selector.run(kOk, classifier.quantized(), classifier.floating());
+    expect(classifier.quantized_calls == 1 && classifier.float_calls == 3,
+           "Depois do aquecimento o int8 recusado nao deve ser tentado de novo.");
+    expect(selector.quantizedFallbacks() == 0,
+           "Caminho float escolhido no aquecimento nao conta como fallback.");
+}
+
+TestRegistrar quantized_input_transient_test("quantized_input_survives_transient_failure",
+                                             testQuantizedInputSurvivesTransientFailure);
+TestRegistrar quantized_input_rejected_test("quantized_input_disabled_when_warmup_rejects",
+                                            testQuantizedInputDisabledWhenWarmupRejects);
+
+} // namespace
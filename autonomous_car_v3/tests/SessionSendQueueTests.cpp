@@ -0,0 +1,205 @@
+#include <sys/uio.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "TestRegistry.hpp"
+#include "services/websocket/ClientSendTelemetry.hpp"
+#include "services/websocket/CompactTelemetryEncoder.hpp"
+#include "services/websocket/SessionSendQueue.hpp"
+
+namespace {
+
+using autonomous_car::tests::TestRegistrar;
+using autonomous_car::tests::expect;
+using autonomous_car::tests::expectContains;
+namespace websocket = autonomous_car::services::websocket;
+
+std::shared_ptr<const websocket::OutboundFrame> frame(const std::string &bytes) {
+    return websocket::makeRawFrame(bytes);
+}
+
+// Bytes pendentes do primeiro frame da fila.
+std::string frontBytes(const websocket::SessionSendQueue &queue) {
+    iovec segment{};
+    if (queue.gather(&segment, 1) == 0) {
+        return {};
+    }
+    return std::string(static_cast<const char *>(segment.iov_base), segment.iov_len);
+}
+
+void testVisionFramesKeepOnlyLatestPerView() {
+    websocket::SessionSendQueue queue;
+    using Result = websocket::SessionSendQueue::PushResult;
+
+    expect(queue.push(websocket::OutboundTopic::VisionFrame, 0, frame("raw-1")) == Result::Queued,
+           "Primeiro frame da view deve entrar na fila.");
+    expect(queue.push(websocket::OutboundTopic::VisionFrame, 1, frame("mask-1")) == Result::Queued,
+           "Views diferentes nao devem competir pelo mesmo slot.");
+    expect(queue.push(websocket::OutboundTopic::VisionFrame, 0, frame("raw-2")) ==
+               Result::QueuedAfterDrop,
+           "Frame novo da mesma view deve substituir o pendente.");
+
+    expect(frontBytes(queue) == "mask-1", "Frame substituido deve sair da fila.");
+    queue.consume(6);
+    expect(frontBytes(queue) == "raw-2", "Somente o frame mais novo da view deve ser enviado.");
+    expect(queue.stats().dropped_vision_frames == 1,
+           "Descarte de vision.frame deve ser contado por cliente.");
+}
+
+void testTelemetryFifoIsBoundedAndSparesPartialFrame() {
+    websocket::SendQueuePolicy policy;
+    policy.telemetry.capacity = 2;
+    websocket::SessionSendQueue queue(policy);
+
+    queue.push(websocket::OutboundTopic::Telemetry, 0, frame("aaaa"));
+    queue.consume(2);
+    queue.push(websocket::OutboundTopic::Telemetry, 0, frame("bbbb"));
+    queue.push(websocket::OutboundTopic::Telemetry, 0, frame("cccc"));
+    queue.push(websocket::OutboundTopic::Telemetry, 0, frame("dddd"));
+
+    expect(frontBytes(queue) == "aa", "Frame parcialmente enviado nunca pode ser descartado.");
+    queue.consume(2);
+    expect(frontBytes(queue) == "cccc", "FIFO cheia deve descartar a telemetria pendente mais antiga.");
+    queue.consume(4);
+    expect(frontBytes(queue) == "dddd", "Ordem das telemetrias restantes deve ser preservada.");
+
+    const auto stats = queue.stats();
+    expect(stats.dropped_telemetry == 1, "Uma telemetria deve ter sido descartada.");
+    expect(stats.sent_messages == 2, "Dois frames completos devem constar como enviados.");
+    expect(stats.queued_bytes == 4, "Somente o ultimo frame deve continuar na fila.");
+}
+
+void testByteLimitReportsOverflow() {
+    websocket::SendQueuePolicy policy;
+    policy.max_queued_bytes = 8;
+    websocket::SessionSendQueue queue(policy);
+
+    queue.push(websocket::OutboundTopic::Control, 0, frame("12345"));
+    expect(queue.push(websocket::OutboundTopic::Telemetry, 0, frame("67890")) ==
+               websocket::SessionSendQueue::PushResult::Overflow,
+           "Fila acima do limite de bytes deve sinalizar overflow para desconectar o cliente.");
+}
+
+void testClientSendTelemetryJson() {
+    websocket::ClientSendTelemetry client;
+    client.session_id = 7;
+    client.role = websocket::ClientRole::Control;
+    client.stats.dropped_vision_frames = 3;
+
+    const auto json = websocket::buildClientSendTelemetryJson(1234, {client});
+    expectContains(json, "\"type\":\"telemetry.websocket_clients\"",
+                   "Telemetria de clientes deve usar o tipo dedicado.");
+    expectContains(json, "{\"id\":7,\"role\":\"control\"", "Cliente deve ser identificado.");
+    expectContains(json, "\"dropped_vision_frames\":3", "Descartes por cliente devem ser publicados.");
+}
+
+void testTextFrameSharesPayloadAcrossSessions() {
+    auto payload = std::make_shared<const std::string>("ola");
+    const auto text_frame = websocket::makeTextFrame(payload);
+    websocket::SessionSendQueue first;
+    websocket::SessionSendQueue second;
+    first.push(websocket::OutboundTopic::Telemetry, 0, text_frame);
+    second.push(websocket::OutboundTopic::Telemetry, 0, text_frame);
+    second.push(websocket::OutboundTopic::Telemetry, 0, text_frame);
+
+    iovec segments[4]{};
+    expect(second.gather(segments, 4) == 4, "Cada frame deve virar cabecalho + payload no sendmsg.");
+    expect(std::string(static_cast<const char *>(segments[0].iov_base), segments[0].iov_len) ==
+               "\x81\x03",
+           "Cabecalho do frame de texto deve ser montado uma vez por broadcast.");
+    expect(segments[1].iov_base == payload->data() && segments[3].iov_base == payload->data(),
+           "Payload deve ser enviado direto do buffer compartilhado, sem copia.");
+
+    second.consume(4);
+    expect(second.gather(segments, 4) == 3, "Envio parcial deve continuar do meio do payload.");
+    expect(std::string(static_cast<const char *>(segments[0].iov_base), segments[0].iov_len) == "a",
+           "Restante do payload deve comecar no byte seguinte ao enviado.");
+}
+
+std::string roadTelemetry(int timestamp_ms) {
+    return "{\"type\":\"telemetry.road_segmentation\",\"timestamp_ms\":" +
+           std::to_string(timestamp_ms) + ",\"lane_found\":true}";
+}
+
+// Mesmo caminho do broadcast compacto do WebSocketServer para uma sessao.
+void deliverCompact(const websocket::CompactTelemetryEncoder &encoder,
+                    const std::vector<std::string> &messages,
+                    websocket::CompactTelemetrySession &session, websocket::SessionSendQueue &queue) {
+    const std::string &type = encoder.lastType();
+    session.observeDrops(queue.stats().dropped_telemetry);
+    const auto texts = session.needsResync(type) ? encoder.resyncMessages() : messages;
+    for (const auto &text : texts) {
+        queue.push(websocket::OutboundTopic::Telemetry, 0, frame(text));
+    }
+    session.markSynced(type);
+    session.observeDrops(queue.stats().dropped_telemetry);
+}
+
+std::vector<std::string> drain(websocket::SessionSendQueue &queue) {
+    std::vector<std::string> sent;
+    while (!queue.empty()) {
+        sent.push_back(frontBytes(queue));
+        queue.consume(sent.back().size());
+    }
+    return sent;
+}
+
+void testCompactTelemetryRecoversDroppedDeltaPerSession() {
+    websocket::CompactTelemetryEncoder encoder;
+    websocket::SendQueuePolicy slow_policy;
+    slow_policy.telemetry.capacity = 2;
+    websocket::SessionSendQueue slow_queue(slow_policy);
+    websocket::SessionSendQueue fast_queue;
+    websocket::CompactTelemetrySession slow_session;
+    websocket::CompactTelemetrySession fast_session;
+
+    const auto publish = [&](int timestamp_ms) {
+        const auto messages = encoder.encode(roadTelemetry(timestamp_ms));
+        deliverCompact(encoder, messages, slow_session, slow_queue);
+        deliverCompact(encoder, messages, fast_session, fast_queue);
+        return drain(fast_queue);
+    };
+
+    publish(1000);
+    drain(slow_queue);
+    publish(1033);
+    publish(1066);
+    publish(1100);
+    expect(slow_queue.stats().dropped_telemetry == 1,
+           "Cliente lento deve perder um delta na fila limitada.");
+    drain(slow_queue);
+
+    const auto fast = publish(1133);
+    expect(fast.size() == 1 && fast[0] == "{\"t\":1,\"s\":5,\"d\":[0,1133]}",
+           "Sessao sem perda deve seguir com o delta compartilhado: " +
+               (fast.empty() ? std::string() : fast[0]));
+    const auto recovered = drain(slow_queue);
+    expect(recovered.size() == 2, "Sessao que perdeu um delta deve receber schema e keyframe.");
+    expectContains(recovered[0], "\"type\":\"telemetry.schema\",\"id\":1,",
+                   "Resync da sessao deve reenviar o schema do tipo.");
+    expect(recovered[1] == "{\"t\":1,\"s\":5,\"k\":[1133,true]}",
+           "Keyframe do resync deve trazer o estado atual com o mesmo s do delta: " + recovered[1]);
+
+    publish(1166);
+    const auto after = drain(slow_queue);
+    expect(after.size() == 1 && after[0] == "{\"t\":1,\"s\":6,\"d\":[0,1166]}",
+           "Depois do keyframe a sessao volta aos deltas compartilhados.");
+}
+
+TestRegistrar session_queue_vision_test("session_send_queue_keeps_latest_vision_frame_per_view",
+                                        testVisionFramesKeepOnlyLatestPerView);
+TestRegistrar session_queue_telemetry_test("session_send_queue_bounds_telemetry_fifo",
+                                           testTelemetryFifoIsBoundedAndSparesPartialFrame);
+TestRegistrar session_queue_overflow_test("session_send_queue_reports_byte_overflow",
+                                          testByteLimitReportsOverflow);
+TestRegistrar session_queue_shared_payload_test("session_send_queue_shares_payload_without_copy",
+                                                testTextFrameSharesPayloadAcrossSessions);
+TestRegistrar session_queue_compact_resync_test(
+    "session_send_queue_compact_telemetry_recovers_dropped_delta",
+    testCompactTelemetryRecoversDroppedDeltaPerSession);
+TestRegistrar client_send_telemetry_test("client_send_telemetry_json_reports_drops",
+                                         testClientSendTelemetryJson);
+
+} // namespace
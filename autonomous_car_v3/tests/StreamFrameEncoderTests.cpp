@@ -0,0 +1,80 @@
+#include <chrono>
+#include <cstddef>
+
+#include <opencv2/core.hpp>
+
+#include "TestRegistry.hpp"
+#include "services/vision/StreamFrameEncoder.hpp"
+
+namespace {
+
+using autonomous_car::tests::TestRegistrar;
+using autonomous_car::tests::expect;
+namespace vision = autonomous_car::services::vision;
+
+void testStreamFrameEncoderReusesJpegBufferAndEncodesMaskAsBilevelPng() {
+    vision::StreamFrameEncoder encoder;
+    cv::Mat raw(48, 64, CV_8UC3, cv::Scalar(30, 120, 200));
+
+    const auto *first = encoder.encode(vision::VisionDebugViewId::Raw, raw, 10);
+    expect(first != nullptr, "Frame BGR deve ser codificado.");
+    expect(first->codec == vision::VisionFrameCodec::Jpeg, "View Raw deve sair como JPEG.");
+    expect(first->data.size() > 4 && first->data[0] == 0xFF && first->data[1] == 0xD8,
+           "Saida JPEG deve comecar com SOI.");
+    expect(first->width == 64 && first->height == 48, "Dimensoes devem acompanhar o frame.");
+    const unsigned char *buffer = first->data.data();
+
+    const auto *second = encoder.encode(vision::VisionDebugViewId::Raw, raw, 20);
+    expect(second == first && second->data.data() == buffer,
+           "Segundo frame da mesma view deve reaproveitar o buffer de saida.");
+    expect(second->timestamp_ms == 20, "Timestamp deve ser o do ultimo frame.");
+
+    cv::Mat mask(48, 64, CV_8UC3, cv::Scalar(0, 0, 0));
+    mask(cv::Rect(0, 24, 64, 24)).setTo(cv::Scalar(255, 255, 255));
+    const auto *png = encoder.encode(vision::VisionDebugViewId::Mask, mask, 30);
+    expect(png != nullptr, "Mascara deve ser codificada.");
+    expect(png->codec == vision::VisionFrameCodec::Png, "View Mask deve sair como PNG.");
+    expect(png->data.size() > 25 && png->data[0] == 0x89 && png->data[1] == 'P' &&
+               png->data[2] == 'N' && png->data[3] == 'G',
+           "Saida da mascara deve ter assinatura PNG.");
+    // Profundidade de bits no IHDR: byte 24 do arquivo.
+    expect(png->data[24] == 1, "PNG da mascara deve ter 1 bit por pixel.");
+}
+
+void testStreamFrameEncoderAdaptsQualityToByteBudget() {
+    vision::StreamEncoderConfig config;
+    config.jpeg_quality = 70;
+    config.min_jpeg_quality = 25;
+    config.byte_budget_per_second = 100000;
+    vision::StreamFrameEncoder encoder(config);
+
+    using Clock = vision::StreamFrameEncoder::Clock;
+    const Clock::time_point start{std::chrono::seconds(100)};
+    // ~400 KB/s numa view so: quatro vezes a fatia dela.
+    for (int step = 0; step <= 10; ++step) {
+        encoder.recordSent(vision::VisionDebugViewId::Raw, 40000,
+                           start + std::chrono::milliseconds(100 * step));
+    }
+    const int reduced = encoder.jpegQuality(vision::VisionDebugViewId::Raw);
+    expect(reduced < 70 && reduced >= 25, "Qualidade deve cair quando a view passa do orcamento.");
+    expect(encoder.sentBytesPerSecond() > 100000.0, "Taxa medida deve refletir os bytes enviados.");
+    expect(encoder.jpegQuality(vision::VisionDebugViewId::Dashboard) == 70,
+           "View sem trafego deve manter a qualidade configurada.");
+
+    // ~20 KB/s: bem abaixo da fatia, a qualidade volta a subir.
+    const Clock::time_point later = start + std::chrono::seconds(2);
+    for (int step = 0; step <= 10; ++step) {
+        encoder.recordSent(vision::VisionDebugViewId::Raw, 2000,
+                           later + std::chrono::milliseconds(100 * step));
+    }
+    expect(encoder.jpegQuality(vision::VisionDebugViewId::Raw) > reduced,
+           "Qualidade deve se recuperar abaixo do orcamento.");
+}
+
+TestRegistrar stream_frame_encoder_reuses_buffer_test(
+    "stream_frame_encoder_reuses_jpeg_buffer_and_encodes_mask_as_bilevel_png",
+    testStreamFrameEncoderReusesJpegBufferAndEncodesMaskAsBilevelPng);
+TestRegistrar stream_frame_encoder_budget_test("stream_frame_encoder_adapts_quality_to_byte_budget",
+                                               testStreamFrameEncoderAdaptsQualityToByteBudget);
+
+} // namespace
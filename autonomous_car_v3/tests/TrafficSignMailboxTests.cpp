@@ -1,5 +1,7 @@
+#include <atomic>
 #include <chrono>
 #include <memory>
+#include <thread>
 
 #include "TestRegistry.hpp"
 #include "services/async/LatestValueMailbox.hpp"
@@ -36,10 +38,39 @@ void testLatestValueMailboxWaitsForNewestSharedPayload() {
            "waitPopFor deve retornar o payload mais recente quando houver item disponivel.");
 }
 
+void testLatestValueMailboxWakesParkedConsumer() {
+    async::LatestValueMailbox<int> mailbox;
+    std::atomic<bool> stop{false};
+    std::atomic<int> received{0};
+    std::atomic<bool> returned_after_stop{false};
+
+    std::thread consumer([&] {
+        const auto value = mailbox.waitPop([&] { return stop.load(); });
+        received.store(value.value_or(-1));
+        // Sem valor novo, so o notifyAll depois do stop libera a segunda espera.
+        returned_after_stop.store(!mailbox.waitPop([&] { return stop.load(); }).has_value());
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    mailbox.offer(5);
+    while (received.load() == 0) {
+        std::this_thread::yield();
+    }
+    stop.store(true);
+    mailbox.notifyAll();
+    consumer.join();
+
+    expect(received.load() == 5, "offer deve acordar o consumidor estacionado em waitPop.");
+    expect(returned_after_stop.load(), "notifyAll deve liberar o consumidor depois do stop.");
+    expect(mailbox.droppedCount() == 0, "Valor entregue nao deve contar como descarte.");
+}
+
 TestRegistrar latest_mailbox_overwrite_test(
     "traffic_sign_mailbox_keeps_only_the_latest_item",
     testLatestValueMailboxKeepsOnlyNewestItem);
 TestRegistrar latest_mailbox_wait_test("traffic_sign_mailbox_waits_for_latest_payload",
                                        testLatestValueMailboxWaitsForNewestSharedPayload);
+TestRegistrar latest_mailbox_wake_test("traffic_sign_mailbox_wakes_parked_consumer",
+                                       testLatestValueMailboxWakesParkedConsumer);
 
 } // namespace
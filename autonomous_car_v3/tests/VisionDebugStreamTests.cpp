@@ -9,8 +9,11 @@
 
 namespace {
 
+using autonomous_car::services::vision::EncodedVisionFrame;
 using autonomous_car::services::vision::VisionDebugViewId;
+using autonomous_car::services::vision::VisionFrameFormat;
 using autonomous_car::services::vision::VisionSubscriptionRegistry;
+using autonomous_car::services::vision::VisionViewVariant;
 using autonomous_car::tests::TestRegistrar;
 using autonomous_car::tests::expect;
 using autonomous_car::tests::expectContains;
@@ -31,6 +34,36 @@ void testVisionDebugSubscriptionParsing() {
            "Tokens invalidos devem ser reportados.");
 }
 
+void testVisionViewVariantParsing() {
+    std::vector<std::string> invalid_tokens;
+    const auto variants = autonomous_car::services::vision::parseVisionViewVariantCsv(
+        "annotated@0.5, dashboard@480PX,raw#0.5:0:0.5:1,raw@1,mask@0.25#0:0.5:1:0.5,"
+        "raw@0,raw@2,annotated#0.5:0:0.6:1,dashboard@8px,annotated@0.500",
+        &invalid_tokens);
+
+    std::vector<std::string> labels;
+    for (const auto &variant : variants) {
+        labels.push_back(variant.label);
+    }
+    const std::vector<std::string> expected_labels = {
+        "annotated@0.5", "dashboard@480px", "raw#0.5:0:0.5:1", "", "mask@0.25#0:0.5:1:0.5"};
+    expect(labels == expected_labels,
+           "Variantes validas devem sair com label canonico, sem repetir e na ordem do CSV.");
+    expect(variants[1].max_dimension == 480 && variants[2].crop.x == 0.5 &&
+               variants[3].isFullView() && variants[3].view == VisionDebugViewId::Raw,
+           "Escala em pixels, recorte e view inteira devem ser interpretados.");
+    expect(invalid_tokens ==
+               std::vector<std::string>{"raw@0", "raw@2", "annotated#0.5:0:0.6:1",
+                                        "dashboard@8px"},
+           "Escala fora de faixa e recorte fora do frame devem ser reportados.");
+
+    const auto views = autonomous_car::services::vision::parseVisionDebugSubscriptionCsv(
+        "annotated@0.5,annotated,raw#0:0:0.5:0.5");
+    expect(views.size() == 2 && views.count(VisionDebugViewId::Annotated) == 1 &&
+               views.count(VisionDebugViewId::Raw) == 1,
+           "Variantes devem contar como a view para renderizacao e captura.");
+}
+
 void testVisionFrameSerialization() {
     const cv::Mat frame(12, 20, CV_8UC3, cv::Scalar{32, 64, 96});
     const auto payload = autonomous_car::services::vision::buildVisionFrameJson(
@@ -50,6 +83,52 @@ void testVisionFrameSerialization() {
     expectContains(*payload, "\"data\":\"", "Payload deve conter o frame codificado.");
 }
 
+void testVisionFrameBinaryLayout() {
+    EncodedVisionFrame frame;
+    frame.view = VisionDebugViewId::Annotated;
+    frame.timestamp_ms = 0x0102030405;
+    frame.width = 640;
+    frame.height = 480;
+    frame.data = {0xFF, 0xD8, 0xFF, 0xD9};
+
+    const auto payload = autonomous_car::services::vision::buildVisionFrameBinary(frame);
+    const std::string expected_header(
+        "VF\x01\x03\x01\x00\x00\x00"
+        "\x00\x00\x00\x01\x02\x03\x04\x05"
+        "\x02\x80\x01\xE0\x00\x00\x00\x04",
+        autonomous_car::services::vision::kVisionFrameBinaryHeaderSize);
+
+    expect(payload.size() == expected_header.size() + frame.data.size(),
+           "Frame binario deve ter apenas cabecalho fixo e bytes do JPEG.");
+    expect(payload.compare(0, expected_header.size(), expected_header) == 0,
+           "Cabecalho binario deve seguir o layout big-endian documentado.");
+    expect(payload.substr(expected_header.size()) == "\xFF\xD8\xFF\xD9",
+           "JPEG deve seguir o cabecalho sem base64.");
+}
+
+void testVisionFrameVariantWireFormat() {
+    EncodedVisionFrame frame;
+    frame.view = VisionDebugViewId::Dashboard;
+    frame.timestamp_ms = 7;
+    frame.width = 240;
+    frame.height = 90;
+    frame.variant = "dashboard@240px";
+    frame.data = {0xFF, 0xD8};
+
+    expectContains(autonomous_car::services::vision::buildVisionFrameJson(frame),
+                   "\"height\":90,\"variant\":\"dashboard@240px\",\"data\":",
+                   "JSON da variante deve trazer o label.");
+
+    const auto payload = autonomous_car::services::vision::buildVisionFrameBinary(frame);
+    const std::size_t header_size = autonomous_car::services::vision::kVisionFrameBinaryHeaderSize;
+    expect(payload.size() == header_size + frame.variant.size() + frame.data.size() &&
+               static_cast<unsigned char>(payload[5]) == frame.variant.size() &&
+               payload.substr(header_size, frame.variant.size()) == frame.variant &&
+               payload.substr(20, 4) == std::string("\x00\x00\x00\x02", 4) &&
+               payload.substr(header_size + frame.variant.size()) == "\xFF\xD8",
+           "Frame binario da variante deve trazer o label entre o cabecalho e a imagem.");
+}
+
 void testVisionSubscriptionRegistryTracksUnionAndCleanup() {
     VisionSubscriptionRegistry registry;
     registry.addSession(10);
@@ -67,6 +146,17 @@ void testVisionSubscriptionRegistryTracksUnionAndCleanup() {
     expect(!registry.hasSubscription(20, VisionDebugViewId::Dashboard),
            "Sessao 20 nao deve conter dashboard.");
 
+    expect(registry.subscriptionFormat(20, VisionDebugViewId::Mask) == VisionFrameFormat::Json,
+           "Sessao sem negociacao deve receber JSON.");
+    registry.setFormat(20, VisionFrameFormat::Binary);
+    expect(registry.subscriptionFormat(20, VisionDebugViewId::Mask) == VisionFrameFormat::Binary,
+           "stream:format=binary deve valer para as views assinadas.");
+    registry.replaceSubscriptions(20, {VisionDebugViewId::Mask});
+    expect(registry.subscriptionFormat(20, VisionDebugViewId::Mask) == VisionFrameFormat::Binary,
+           "Nova assinatura deve manter o formato negociado.");
+    expect(!registry.subscriptionFormat(20, VisionDebugViewId::Raw).has_value(),
+           "View nao assinada nao deve ter formato.");
+
     registry.removeSession(10);
     const auto second_union = registry.unionOfRequestedViews();
     expect(second_union.size() == 1 &&
@@ -74,11 +164,68 @@ void testVisionSubscriptionRegistryTracksUnionAndCleanup() {
            "Ao remover a sessao 10, a uniao deve refletir apenas a sessao restante.");
 }
 
+void testVisionSubscriptionRegistryMatchesVariants() {
+    VisionSubscriptionRegistry registry;
+    registry.addSession(1);
+    registry.addSession(2);
+    registry.replaceSubscriptions(
+        1, autonomous_car::services::vision::parseVisionViewVariantCsv("annotated@0.5,raw"));
+    registry.replaceSubscriptions(
+        2, autonomous_car::services::vision::parseVisionViewVariantCsv("annotated@0.5,mask"));
+
+    expect(registry.subscriptionFormat(1, VisionDebugViewId::Annotated, "annotated@0.5")
+               .has_value(),
+           "Sessao deve receber a variante que assinou.");
+    expect(!registry.subscriptionFormat(1, VisionDebugViewId::Annotated).has_value(),
+           "Assinar a variante nao deve assinar a view inteira.");
+    expect(registry.subscriptionFormat(1, VisionDebugViewId::Raw).has_value(),
+           "View inteira continua com label vazio.");
+
+    const auto variants = registry.unionOfRequestedVariants();
+    std::vector<std::string> labels;
+    for (const auto &variant : variants) {
+        labels.push_back(std::string(toString(variant.view)) + "/" + variant.label);
+    }
+    expect(labels == std::vector<std::string>{"raw/", "mask/", "annotated/annotated@0.5"},
+           "Variante pedida por duas sessoes deve aparecer uma vez, em ordem de view.");
+
+    registry.replaceSubscriptions(
+        1, autonomous_car::services::vision::parseVisionViewVariantCsv(
+               "annotated@0.5,raw@0.5,raw#0.5:0:0.5:1"));
+    const auto annotated_key = registry.frameQueueKey(VisionDebugViewId::Annotated,
+                                                      "annotated@0.5");
+    const auto scaled_key = registry.frameQueueKey(VisionDebugViewId::Raw, "raw@0.5");
+    const auto cropped_key = registry.frameQueueKey(VisionDebugViewId::Raw, "raw#0.5:0:0.5:1");
+    expect(registry.frameQueueKey(VisionDebugViewId::Raw, "") ==
+               static_cast<int>(VisionDebugViewId::Raw),
+           "View inteira usa o id da view na fila.");
+    expect(annotated_key && scaled_key && cropped_key && *annotated_key != *scaled_key &&
+               *scaled_key != *cropped_key && *annotated_key != *cropped_key &&
+               *scaled_key >= 0x100,
+           "Cada variante assinada deve ter uma vaga propria na fila.");
+
+    registry.replaceSubscriptions(
+        1, autonomous_car::services::vision::parseVisionViewVariantCsv("raw@0.5"));
+    registry.removeSession(2);
+    expect(!registry.frameQueueKey(VisionDebugViewId::Annotated, "annotated@0.5"),
+           "Variante que ninguem assina deve perder a vaga.");
+    expect(registry.frameQueueKey(VisionDebugViewId::Raw, "raw@0.5") == scaled_key,
+           "Variante ainda assinada deve manter a vaga.");
+}
+
 TestRegistrar subscription_parse_test("vision_debug_stream_subscription_parsing",
                                       testVisionDebugSubscriptionParsing);
 TestRegistrar frame_serialization_test("vision_debug_stream_frame_serialization",
                                        testVisionFrameSerialization);
+TestRegistrar frame_binary_test("vision_debug_stream_binary_frame_layout",
+                                testVisionFrameBinaryLayout);
 TestRegistrar registry_test("vision_subscription_registry_tracks_union_and_cleanup",
                             testVisionSubscriptionRegistryTracksUnionAndCleanup);
+TestRegistrar variant_parse_test("vision_debug_stream_variant_parsing",
+                                  testVisionViewVariantParsing);
+TestRegistrar variant_wire_test("vision_debug_stream_variant_wire_format",
+                                testVisionFrameVariantWireFormat);
+TestRegistrar registry_variant_test("vision_subscription_registry_matches_variants",
+                                    testVisionSubscriptionRegistryMatchesVariants);
 
 } // namespace
@@ -191,6 +191,91 @@ void testDashboardReceivesTrafficSignStatus() {
            "Dashboard local deve desenhar a ROI de sinalizacao no tile anotado.");
 }
 
+void testRetainedDashboardMatchesFreshRender() {
+    vision::VisionDebugViewRenderer retained;
+    const auto segmentation_result = makeSegmentationResult();
+    rsl::config::LabConfig config;
+    autoctrl::AutonomousControlSnapshot previous;
+    vision::VisionRuntimeTelemetry runtime_telemetry;
+
+    const cv::Mat first = retained.render(
+        vision::VisionDebugViewId::Dashboard, segmentation_result, config, "camera",
+        "calibrated", previous, runtime_telemetry, ts::TrafficSignFrameResult{});
+    const cv::Mat first_copy = first.clone();
+
+    autoctrl::AutonomousControlSnapshot snapshot;
+    snapshot.driving_mode = autonomous_car::DrivingMode::Autonomous;
+    snapshot.steering_command = -0.6;
+    runtime_telemetry.core_fps = 28.5;
+    const cv::Mat second = retained.render(
+        vision::VisionDebugViewId::Dashboard, segmentation_result, config, "camera",
+        "calibrated", snapshot, runtime_telemetry, makeTrafficSignResult());
+
+    vision::VisionDebugViewRenderer fresh;
+    const cv::Mat expected = fresh.render(
+        vision::VisionDebugViewId::Dashboard, segmentation_result, config, "camera",
+        "calibrated", snapshot, runtime_telemetry, makeTrafficSignResult());
+
+    expect(second.size() == expected.size() && cv::norm(second, expected, cv::NORM_INF) == 0.0,
+           "Dashboard com cache deve ficar igual ao desenhado do zero.");
+    expect(cv::norm(first, first_copy, cv::NORM_INF) == 0.0,
+           "Frame anterior nao deve ser alterado pelo proximo render.");
+}
+
+void testViewVariantCropsAndScalesRenderedFrame() {
+    cv::Mat frame(240, 320, CV_8UC3, cv::Scalar{0, 0, 0});
+    frame(cv::Rect(160, 0, 160, 240)).setTo(cv::Scalar{255, 255, 255});
+
+    const auto variants = vision::parseVisionViewVariantCsv(
+        "raw,raw@0.5,raw@100px,raw#0.5:0:0.5:1,raw@0.5#0.5:0:0.5:1");
+    const cv::Mat full = vision::renderVisionViewVariant(frame, variants[0]);
+    const cv::Mat half = vision::renderVisionViewVariant(frame, variants[1]);
+    const cv::Mat bounded = vision::renderVisionViewVariant(frame, variants[2]);
+    const cv::Mat cropped = vision::renderVisionViewVariant(frame, variants[3]);
+    const cv::Mat cropped_half = vision::renderVisionViewVariant(frame, variants[4]);
+
+    expect(full.data == frame.data && full.size() == frame.size(),
+           "View inteira deve sair sem copia.");
+    expect(half.size() == cv::Size(160, 120), "Fator 0.5 deve reduzir os dois lados.");
+    expect(bounded.size() == cv::Size(100, 75), "Maior lado deve ficar no limite pedido.");
+    expect(cropped.size() == cv::Size(160, 240) &&
+               cropped.data == frame.data + 160 * frame.elemSize(),
+           "Recorte sem escala deve ser um ROI do frame.");
+    expect(cropped_half.size() == cv::Size(80, 120) &&
+               cv::norm(cropped_half, cv::Mat(120, 80, CV_8UC3, cv::Scalar{255, 255, 255}),
+                        cv::NORM_INF) == 0.0,
+           "Escala deve ser aplicada depois do recorte.");
+
+    const auto edge_variants = vision::parseVisionViewVariantCsv(
+        "raw#0.999:0:0.001:1,raw@0.5#0:0.999:1:0.001");
+    expect(edge_variants.size() == 2, "Recortes colados na borda devem ser aceitos.");
+    const cv::Mat right_edge = vision::renderVisionViewVariant(frame, edge_variants[0]);
+    const cv::Mat bottom_edge = vision::renderVisionViewVariant(frame, edge_variants[1]);
+    expect(right_edge.size() == cv::Size(1, 240) &&
+               right_edge.data == frame.data + 319 * frame.elemSize(),
+           "Recorte na borda direita deve manter a ultima coluna.");
+    expect(bottom_edge.size() == cv::Size(160, 1),
+           "Recorte na borda inferior deve manter a ultima linha, ja escalada.");
+}
+
+void testCaptureRequestFollowsRequestedViews() {
+    using rsl::pipeline::CaptureRequest;
+
+    expect(vision::captureRequestForViews({}) == CaptureRequest::None,
+           "Sem views pedidas, nenhuma imagem de depuracao deve ser capturada.");
+    expect(vision::captureRequestForViews({vision::VisionDebugViewId::Raw,
+                                           vision::VisionDebugViewId::Annotated}) ==
+               CaptureRequest::Frame,
+           "Views raw e annotated precisam apenas do frame.");
+    expect(vision::captureRequestForViews({vision::VisionDebugViewId::Mask}) ==
+               (CaptureRequest::Frame | CaptureRequest::Mask),
+           "View mask deve pedir a mascara sem o preprocessado.");
+    expect(vision::captureRequestForViews({vision::VisionDebugViewId::Preprocess,
+                                           vision::VisionDebugViewId::Dashboard}) ==
+               CaptureRequest::All,
+           "Dashboard deve pedir todas as imagens.");
+}
+
 TestRegistrar vision_annotated_overlay_test("vision_debug_view_renderer_annotated_overlay",
                                             testAnnotatedViewReceivesTrafficSignOverlay);
 TestRegistrar vision_annotated_roi_toggle_test(
@@ -201,5 +286,11 @@ TestRegistrar vision_annotated_resize_test(
     testAnnotatedViewScalesTrafficSignOverlayToRenderedFrame);
 TestRegistrar vision_dashboard_overlay_test("vision_debug_view_renderer_dashboard_overlay",
                                             testDashboardReceivesTrafficSignStatus);
+TestRegistrar vision_dashboard_retained_test("vision_debug_view_renderer_retained_dashboard",
+                                             testRetainedDashboardMatchesFreshRender);
+TestRegistrar vision_view_variant_test("vision_debug_view_renderer_variant_crop_and_scale",
+                                       testViewVariantCropsAndScalesRenderedFrame);
+TestRegistrar vision_capture_request_test("vision_debug_view_renderer_capture_request",
+                                          testCaptureRequestFollowsRequestedViews);
 
 } // namespace
@@ -0,0 +1,63 @@
+#include <chrono>
+
+#include "TestRegistry.hpp"
+#include "pipeline/StageProfiler.hpp"
+#include "services/vision/VisionProfileTelemetry.hpp"
+
+namespace {
+
+using autonomous_car::tests::TestRegistrar;
+using autonomous_car::tests::expect;
+using autonomous_car::tests::expectContains;
+namespace vision = autonomous_car::services::vision;
+namespace rsl = road_segmentation_lab;
+
+void testVisionProfileTelemetryJsonContainsPercentiles() {
+    rsl::pipeline::StageProfiler profiler;
+    profiler.setEnabled(true);
+    for (int sample = 1; sample <= 100; ++sample) {
+        profiler.record(rsl::pipeline::ProfiledStage::Segmentation,
+                        std::chrono::microseconds(sample * 10));
+    }
+    profiler.record(rsl::pipeline::ProfiledStage::Frame, std::chrono::milliseconds(4));
+
+    const auto profile = profiler.snapshot();
+    expect(profile.stages.size() == 2, "Snapshot deve listar apenas estagios com amostras.");
+    expect(profile.frames == 1, "Snapshot deve contar os frames registrados.");
+
+    const std::string json = vision::buildVisionProfileTelemetryJson(profile, "Camera index 0", 42);
+
+    expectContains(json, "\"type\":\"telemetry.vision_profile\"",
+                   "JSON deve expor o tipo da telemetria de perfil.");
+    expectContains(json, "\"enabled\":true", "JSON deve expor se o perfil esta ligado.");
+    expectContains(json, "\"name\":\"segmentation\",\"samples\":100",
+                   "JSON deve expor o nome e as amostras de cada estagio.");
+    expectContains(json, "\"p50_ms\":0.500000", "JSON deve expor o p50 do estagio.");
+    expectContains(json, "\"p95_ms\":0.950000", "JSON deve expor o p95 do estagio.");
+    expectContains(json, "\"p99_ms\":0.990000", "JSON deve expor o p99 do estagio.");
+    expectContains(json, "\"max_ms\":1.000000", "JSON deve expor o maximo do estagio.");
+    expectContains(json, "\"name\":\"frame\"", "JSON deve expor o tempo total do frame.");
+}
+
+void testStageProfilerIgnoresScopesWhenDisabled() {
+    rsl::pipeline::StageProfiler profiler;
+    {
+        const rsl::pipeline::StageProfiler::Scope scope(profiler,
+                                                        rsl::pipeline::ProfiledStage::Gaussian);
+    }
+    expect(profiler.snapshot().stages.empty(), "Perfil desligado nao deve registrar amostras.");
+
+    profiler.setEnabled(true);
+    {
+        const rsl::pipeline::StageProfiler::Scope scope(profiler,
+                                                        rsl::pipeline::ProfiledStage::Gaussian);
+    }
+    expect(profiler.snapshot().stages.size() == 1, "Perfil ligado deve registrar o escopo.");
+}
+
+TestRegistrar vision_profile_json_test("vision_profile_telemetry_json_contains_percentiles",
+                                       testVisionProfileTelemetryJsonContainsPercentiles);
+TestRegistrar stage_profiler_disabled_test("stage_profiler_ignores_scopes_when_disabled",
+                                           testStageProfilerIgnoresScopesWhenDisabled);
+
+} // namespace
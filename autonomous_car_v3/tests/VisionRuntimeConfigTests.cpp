@@ -37,7 +37,13 @@ void testVisionRuntimeConfigLoadAndResolvePaths() {
         file << "VISION_STREAM_MAX_FPS=6\n";
         file << "TRAFFIC_SIGN_TARGET_FPS=4\n";
         file << "VISION_STREAM_JPEG_QUALITY=82\n";
+        file << "VISION_STREAM_JPEG_FAST_DCT=false\n";
+        file << "VISION_STREAM_JPEG_SUBSAMPLING=444\n";
+        file << "VISION_STREAM_BUDGET_KBYTES_PER_SEC=800\n";
+        file << "VISION_STREAM_ENCODE_WORKERS=3\n";
+        file << "VISION_SEGMENTATION_PIPELINE_DEPTH=3\n";
         file << "VISION_SEGMENTATION_CONFIG_PATH=config/road_segmentation.env\n";
+        file << "VISION_LOCAL_FRAME_RING=autonomous_car_frames\n";
     }
 
     VisionRuntimeConfig config;
@@ -59,9 +65,19 @@ void testVisionRuntimeConfigLoadAndResolvePaths() {
            "TRAFFIC_SIGN_TARGET_FPS deve ser carregado.");
     expect(config.stream_jpeg_quality == 82,
            "VISION_STREAM_JPEG_QUALITY deve ser carregado.");
+    expect(!config.stream_jpeg_fast_dct, "VISION_STREAM_JPEG_FAST_DCT deve ser carregado.");
+    expect(config.stream_jpeg_subsampling == 444,
+           "VISION_STREAM_JPEG_SUBSAMPLING deve ser carregado.");
+    expect(config.stream_budget_kbytes_per_sec == 800,
+           "VISION_STREAM_BUDGET_KBYTES_PER_SEC deve ser carregado.");
+    expect(config.stream_encode_workers == 3, "VISION_STREAM_ENCODE_WORKERS deve ser carregado.");
+    expect(config.segmentation_pipeline_depth == 3,
+           "VISION_SEGMENTATION_PIPELINE_DEPTH deve ser carregado.");
     expect(config.segmentation_config_path ==
                (config_dir / "config/road_segmentation.env").string(),
            "VISION_SEGMENTATION_CONFIG_PATH relativo deve ser resolvido.");
+    expect(config.local_frame_ring_name == "/autonomous_car_frames",
+           "VISION_LOCAL_FRAME_RING deve ganhar a barra inicial do nome POSIX.");
     expect(warnings.empty(), "Nao deve haver warnings para arquivo valido.");
 }
 
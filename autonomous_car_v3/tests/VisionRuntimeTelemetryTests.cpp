@@ -16,8 +16,12 @@ void testVisionRuntimeTelemetryJsonContainsRuntimeFields() {
     telemetry.traffic_sign_fps = 3.9;
     telemetry.traffic_sign_inference_ms = 11.7;
     telemetry.stream_encode_ms = 28.3;
+    telemetry.stream_sent_kbytes_per_sec = 412.5;
+    telemetry.segmentation_pipeline_depth = 3;
+    telemetry.segmentation_pipeline_added_ms = 6.5;
     telemetry.traffic_sign_dropped_frames = 5;
     telemetry.stream_dropped_frames = 8;
+    telemetry.stream_skipped_views = 3;
     telemetry.sign_result_age_ms = 120;
 
     const std::string json = vision::buildVisionRuntimeTelemetryJson(telemetry);
@@ -28,10 +32,18 @@ void testVisionRuntimeTelemetryJsonContainsRuntimeFields() {
                    "JSON deve expor core_fps com precisao fixa.");
     expectContains(json, "\"stream_fps\":4.200000",
                    "JSON deve expor stream_fps com precisao fixa.");
+    expectContains(json, "\"stream_sent_kbytes_per_sec\":412.500000",
+                   "JSON deve expor a banda enviada pelo stream.");
+    expectContains(json, "\"segmentation_pipeline_depth\":3",
+                   "JSON deve expor a profundidade do pipeline de segmentacao.");
+    expectContains(json, "\"segmentation_pipeline_added_ms\":6.500000",
+                   "JSON deve expor a latencia adicionada pelo pipeline.");
     expectContains(json, "\"traffic_sign_dropped_frames\":5",
                    "JSON deve expor descarte de frames da sinalizacao.");
     expectContains(json, "\"stream_dropped_frames\":8",
                    "JSON deve expor descarte de frames do stream.");
+    expectContains(json, "\"stream_skipped_views\":3",
+                   "JSON deve expor views puladas por codificacao em andamento.");
     expectContains(json, "\"sign_result_age_ms\":120",
                    "JSON deve expor a idade do ultimo resultado de sinalizacao.");
 }
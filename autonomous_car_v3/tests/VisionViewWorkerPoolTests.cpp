@@ -0,0 +1,84 @@
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <thread>
+
+#include "TestRegistry.hpp"
+#include "services/vision/VisionViewWorkerPool.hpp"
+
+namespace {
+
+using autonomous_car::tests::TestRegistrar;
+using autonomous_car::tests::expect;
+namespace vision = autonomous_car::services::vision;
+
+template <typename Predicate>
+bool waitFor(Predicate predicate) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (!predicate()) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+void testVisionViewWorkerPoolSkipsBusyViewAndRunsViewsInParallel() {
+    vision::VisionViewWorkerPool pool(2);
+    std::promise<void> release_promise;
+    std::shared_future<void> release = release_promise.get_future().share();
+    std::atomic<int> running{0};
+    std::atomic<int> finished{0};
+
+    auto blockingTask = [&] {
+        running.fetch_add(1);
+        release.wait();
+        finished.fetch_add(1);
+    };
+
+    expect(pool.trySubmit(vision::VisionDebugViewId::Dashboard, blockingTask),
+           "Primeiro frame da view deve entrar no pool.");
+    expect(pool.trySubmit(vision::VisionDebugViewId::Mask, blockingTask),
+           "Outra view deve entrar mesmo com o dashboard ocupado.");
+    expect(waitFor([&] { return running.load() == 2; }),
+           "As duas views devem rodar ao mesmo tempo com dois workers.");
+
+    expect(!pool.trySubmit(vision::VisionDebugViewId::Dashboard, [&] { finished.fetch_add(100); }),
+           "View com frame em andamento deve ser pulada.");
+    expect(pool.skippedCount() == 1, "Frame pulado deve ser contado.");
+    expect(pool.busy(vision::VisionDebugViewId::Dashboard), "Dashboard deve seguir ocupado.");
+
+    release_promise.set_value();
+    expect(waitFor([&] { return !pool.busy(vision::VisionDebugViewId::Dashboard) &&
+                                !pool.busy(vision::VisionDebugViewId::Mask); }),
+           "Views devem ser liberadas ao fim do trabalho.");
+    expect(finished.load() == 2, "Frame pulado nao deve ser executado depois.");
+    expect(pool.trySubmit(vision::VisionDebugViewId::Dashboard, [] {}),
+           "View liberada deve aceitar o proximo frame.");
+}
+
+void testVisionViewWorkerPoolRethrowsWorkerError() {
+    vision::VisionViewWorkerPool pool(1);
+    pool.trySubmit(vision::VisionDebugViewId::Raw, [] { throw std::runtime_error("falha"); });
+    expect(waitFor([&] { return !pool.busy(vision::VisionDebugViewId::Raw); }),
+           "Trabalho com excecao deve liberar a view.");
+
+    bool rethrown = false;
+    try {
+        pool.rethrowWorkerError();
+    } catch (const std::runtime_error &) {
+        rethrown = true;
+    }
+    expect(rethrown, "Excecao do worker deve voltar para a thread que submete.");
+    pool.rethrowWorkerError();
+}
+
+TestRegistrar vision_view_worker_pool_skip_test(
+    "vision_view_worker_pool_skips_busy_view_and_runs_views_in_parallel",
+    testVisionViewWorkerPoolSkipsBusyViewAndRunsViewsInParallel);
+TestRegistrar vision_view_worker_pool_error_test("vision_view_worker_pool_rethrows_worker_error",
+                                                 testVisionViewWorkerPoolRethrowsWorkerError);
+
+} // namespace
@@ -1,8 +1,14 @@
+#include <string>
+#include <string_view>
+
 #include "TestRegistry.hpp"
 #include "services/websocket/WebSocketProtocol.hpp"
 
 namespace {
 
+using autonomous_car::services::websocket::decodeClientFrame;
+using autonomous_car::services::websocket::encodeTextFrame;
+using autonomous_car::services::websocket::FrameDecodeStatus;
 using autonomous_car::services::websocket::MessageChannel;
 using autonomous_car::services::websocket::messageRequiresControllerRole;
 using autonomous_car::services::websocket::parseInboundMessage;
@@ -27,9 +33,65 @@ void testInvalidSignalMessageIsRejected() {
     expect(!parsed.has_value(), "Mensagens signal sem payload devem ser rejeitadas.");
 }
 
+void testClientMessagesParseRoleAndTelemetryFormat() {
+    const auto role = parseInboundMessage("client:Control");
+    expect(role.has_value() && role->channel == MessageChannel::Client && role->key == "control" &&
+               !role->value.has_value(),
+           "client:<papel> deve continuar chegando como chave, sem valor.");
+
+    const auto format = parseInboundMessage("client: telemetry_format = Compact");
+    expect(format.has_value() && format->channel == MessageChannel::Client &&
+               format->key == "telemetry_format" && format->value == std::string("compact"),
+           "client:telemetry_format=compact deve separar chave e valor.");
+}
+
+std::string maskedTextFrame(const std::string &payload) {
+    const unsigned char mask[4] = {0x12, 0x34, 0x56, 0x78};
+    std::string frame;
+    frame.push_back(static_cast<char>(0x81));
+    frame.push_back(static_cast<char>(0x80 | payload.size()));
+    frame.append(reinterpret_cast<const char *>(mask), sizeof(mask));
+    for (std::size_t i = 0; i < payload.size(); ++i) {
+        frame.push_back(static_cast<char>(payload[i] ^ mask[i % 4]));
+    }
+    return frame;
+}
+
+void testClientFrameDecodingIsIncremental() {
+    const auto frame = maskedTextFrame("command:forward");
+    const auto partial = decodeClientFrame(std::string_view(frame).substr(0, 5), 1024);
+    expect(partial.status == FrameDecodeStatus::Incomplete,
+           "Frame parcial deve aguardar mais bytes.");
+
+    const auto buffered = frame + maskedTextFrame("command:stop");
+    const auto first = decodeClientFrame(buffered, 1024);
+    expect(first.status == FrameDecodeStatus::Complete && first.opcode == 0x1,
+           "Frame completo de texto deve ser decodificado.");
+    expect(first.payload == "command:forward", "Payload deve sair sem a mascara do cliente.");
+    expect(first.consumed == frame.size(),
+           "Somente o primeiro frame deve ser consumido do buffer.");
+
+    const auto oversized = decodeClientFrame(frame, 4);
+    expect(oversized.status == FrameDecodeStatus::Invalid,
+           "Payload acima do limite deve invalidar a conexao.");
+
+    const auto unmasked = encodeTextFrame("ola");
+    expect(decodeClientFrame(unmasked, 1024).status == FrameDecodeStatus::Invalid,
+           "Frame de cliente sem mascara deve ser rejeitado.");
+    expect(unmasked == std::string("\x81\x03ola"),
+           "Frame de texto do servidor deve usar o cabecalho curto.");
+    expect(encodeTextFrame(std::string(200, 'a')).substr(0, 4) == std::string("\x81\x7e\x00\xc8", 4),
+           "Payload entre 126 e 65535 bytes deve usar tamanho estendido de 16 bits.");
+}
+
 TestRegistrar websocket_signal_parse_test("websocket_protocol_parses_signal_detected_messages",
                                           testSignalMessagesParseWithoutControlRole);
 TestRegistrar websocket_signal_invalid_test("websocket_protocol_rejects_empty_signal_payload",
                                             testInvalidSignalMessageIsRejected);
+TestRegistrar websocket_client_parse_test(
+    "websocket_protocol_parses_client_role_and_telemetry_format",
+    testClientMessagesParseRoleAndTelemetryFormat);
+TestRegistrar websocket_frame_decode_test("websocket_protocol_decodes_buffered_client_frames",
+                                          testClientFrameDecodingIsIncremental);
 
 } // namespace
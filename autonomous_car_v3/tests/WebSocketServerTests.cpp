@@ -1,7 +1,18 @@
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
 #include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
 #include <vector>
 
 #include "TestRegistry.hpp"
+#include "controllers/CommandRouter.hpp"
+#include "services/WebSocketServer.hpp"
 #include "services/websocket/ClientRegistry.hpp"
 
 namespace {
@@ -10,6 +21,8 @@ using autonomous_car::tests::TestRegistrar;
 using autonomous_car::tests::expect;
 using autonomous_car::services::websocket::ClientRegistry;
 using autonomous_car::services::websocket::ClientRole;
+using autonomous_car::services::WebSocketServer;
+namespace vision = autonomous_car::services::vision;
 
 void testRegisteredControlAndSingleControllerRule() {
     ClientRegistry registry;
@@ -58,9 +71,119 @@ void testImplicitControlCompatibilityAndReconnect() {
            "Novo cliente reconnectado deve aparecer nas sessoes ativas.");
 }
 
+std::string readExactly(int fd, std::size_t length) {
+    std::string data(length, '\0');
+    std::size_t received = 0;
+    while (received < length) {
+        const ssize_t chunk = recv(fd, data.data() + received, length - received, 0);
+        if (chunk <= 0) {
+            return data.substr(0, received);
+        }
+        received += static_cast<std::size_t>(chunk);
+    }
+    return data;
+}
+
+void sendMaskedText(int fd, const std::string &payload) {
+    const char mask[4] = {0x01, 0x02, 0x03, 0x04};
+    std::string frame;
+    frame.push_back(static_cast<char>(0x81));
+    frame.push_back(static_cast<char>(0x80 | payload.size()));
+    frame.append(mask, sizeof(mask));
+    for (std::size_t i = 0; i < payload.size(); ++i) {
+        frame.push_back(static_cast<char>(payload[i] ^ mask[i % 4]));
+    }
+    send(fd, frame.data(), frame.size(), MSG_NOSIGNAL);
+}
+
+void testServerHandshakeSubscriptionAndBroadcast() {
+    autonomous_car::controllers::CommandRouter router;
+    WebSocketServer server("127.0.0.1", 0, router, {},
+                           [] { return autonomous_car::DrivingMode::Manual; });
+    server.start();
+    expect(server.boundPort() > 0, "Servidor deve expor a porta efetiva quando criado com 0.");
+
+    const int client_fd = socket(AF_INET, SOCK_STREAM, 0);
+    timeval timeout{};
+    timeout.tv_sec = 2;
+    setsockopt(client_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = inet_addr("127.0.0.1");
+    address.sin_port = htons(static_cast<uint16_t>(server.boundPort()));
+    expect(connect(client_fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0,
+           "Cliente deve conectar no servidor local.");
+
+    // Handshake em dois pedacos para exercitar a leitura incremental do reactor.
+    const std::string request_head = "GET / HTTP/1.1\r\nHost: localhost\r\nUpgrade: websocket\r\n";
+    const std::string request_tail =
+        "Connection: Upgrade\r\nSec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n\r\n";
+    send(client_fd, request_head.data(), request_head.size(), MSG_NOSIGNAL);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    send(client_fd, request_tail.data(), request_tail.size(), MSG_NOSIGNAL);
+
+    const std::string expected_response =
+        "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+        "Sec-WebSocket-Accept: s3pPLMBiTxaQ9kYGzzhZRbK+xOo=\r\n\r\n";
+    expect(readExactly(client_fd, expected_response.size()) == expected_response,
+           "Handshake deve responder com a chave de aceite da RFC 6455.");
+
+    // Formato antes da assinatura, como fazem os clientes; a espera abaixo cobre os dois.
+    sendMaskedText(client_fd, "stream:format=binary");
+    sendMaskedText(client_fd, "stream:subscribe=raw");
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (server.snapshotVisionSubscriptions().count(vision::VisionDebugViewId::Raw) == 0 &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    expect(server.snapshotVisionSubscriptions().count(vision::VisionDebugViewId::Raw) == 1,
+           "Assinatura enviada pelo cliente deve aparecer no snapshot do servidor.");
+
+    server.broadcastVisionFrame(vision::VisionDebugViewId::Mask, "mask");
+    server.broadcastText("ola");
+    expect(readExactly(client_fd, 5) == std::string("\x81\x03ola"),
+           "Cliente deve receber o broadcast de texto e nao a view que nao assinou.");
+
+    vision::EncodedVisionFrame frame;
+    frame.view = vision::VisionDebugViewId::Raw;
+    frame.timestamp_ms = 42;
+    frame.width = 4;
+    frame.height = 2;
+    frame.data = {0xFF, 0xD8, 0xFF};
+    server.broadcastVisionFrame(frame);
+    const std::string binary_frame = readExactly(client_fd, 2 + 24 + 3);
+    expect(binary_frame.size() == 29 && binary_frame.substr(0, 2) == std::string("\x82\x1B") &&
+               binary_frame.substr(2, 2) == "VF" && binary_frame.substr(26) == "\xFF\xD8\xFF",
+           "Sessao que pediu stream:format=binary deve receber o JPEG cru em frame binario.");
+
+    // As mensagens de uma sessao sao tratadas em ordem: a assinatura da mask confirma o formato.
+    sendMaskedText(client_fd, "client:telemetry_format=compact");
+    sendMaskedText(client_fd, "stream:subscribe=mask");
+    while (server.snapshotVisionSubscriptions().count(vision::VisionDebugViewId::Mask) == 0 &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    server.broadcastText(
+        "{\"type\":\"telemetry.road_segmentation\",\"confidence_score\":0.500000}");
+    const std::string schema =
+        "{\"type\":\"telemetry.schema\",\"id\":1,\"for\":\"telemetry.road_segmentation\","
+        "\"fields\":[\"confidence_score\"]}";
+    const std::string keyframe = "{\"t\":1,\"s\":1,\"k\":[0.5]}";
+    expect(readExactly(client_fd, 2 + schema.size()).substr(2) == schema &&
+               readExactly(client_fd, 2 + keyframe.size()).substr(2) == keyframe,
+           "Sessao com telemetria compacta deve receber schema e keyframe.");
+
+    server.stop();
+    expect(readExactly(client_fd, 2) == std::string("\x88\x00", 2),
+           "stop deve enviar close frame aos clientes conectados.");
+    close(client_fd);
+}
+
 TestRegistrar websocket_control_test("websocket_registered_control_and_single_controller_rule",
                                      testRegisteredControlAndSingleControllerRule);
 TestRegistrar websocket_compat_test("websocket_implicit_control_compatibility_and_reconnect",
                                     testImplicitControlCompatibilityAndReconnect);
+TestRegistrar websocket_server_loopback_test("websocket_server_handshake_subscription_and_broadcast",
+                                             testServerHandshakeSubscriptionAndBroadcast);
 
 } // namespace
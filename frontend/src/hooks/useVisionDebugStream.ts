@@ -3,8 +3,10 @@
 import { useEffect, useRef, useState } from 'react';
 import {
   buildClientRoleMessage,
+  buildVisionStreamFormatMessage,
   buildVisionStreamSubscriptionMessage,
   ConnectionState,
+  parseBinaryVisionFrame,
   parseVisionFrameMessage,
   RECONNECT_DELAYS_MS,
   TELEMETRY_STALE_THRESHOLD_MS,
@@ -75,6 +77,7 @@ export const useVisionDebugStream = (
       );
 
       const socket = new WebSocket(normalizedUrl);
+      socket.binaryType = 'arraybuffer';
       socketRef.current = socket;
 
       socket.onopen = () => {
@@ -86,15 +89,21 @@ export const useVisionDebugStream = (
         reconnectAttemptRef.current = 0;
         setConnectionState('connected');
         socket.send(buildClientRoleMessage('telemetry'));
+        socket.send(buildVisionStreamFormatMessage('binary'));
         socket.send(subscriptionMessageRef.current);
       };
 
       socket.onmessage = (event) => {
-        if (cancelled || typeof event.data !== 'string') {
+        if (cancelled) {
           return;
         }
 
-        const parsedFrame = parseVisionFrameMessage(event.data);
+        const parsedFrame =
+          event.data instanceof ArrayBuffer
+            ? parseBinaryVisionFrame(event.data)
+            : typeof event.data === 'string'
+              ? parseVisionFrameMessage(event.data)
+              : null;
         if (!parsedFrame) {
           return;
         }
@@ -181,9 +181,13 @@ export interface VisionFrameMessage {
   mime: string;
   width: number;
   height: number;
+  // Label da variante assinada (ex. 'annotated@480px'); ausente na view inteira.
+  variant?: string;
   data: string;
 }
 
+export type VisionStreamFormat = 'json' | 'binary';
+
 export type VehicleTelemetryMessage =
   | RoadSegmentationTelemetry
   | AutonomousControlTelemetry
@@ -223,33 +227,163 @@ export const TELEMETRY_STALE_THRESHOLD_MS = 3000;
 export const MANUAL_COMMAND_INTERVAL_MS = 75;
 export const RECONNECT_DELAYS_MS = [500, 1000, 2000, 4000, 8000];
 
+const toTelemetryMessage = (
+  parsed: unknown
+): VehicleTelemetryMessage | null => {
+  const message = parsed as VehicleTelemetryMessage;
+
+  if (
+    message &&
+    typeof message === 'object' &&
+    (message.type === 'telemetry.road_segmentation' ||
+      message.type === 'telemetry.autonomous_control' ||
+      message.type === 'telemetry.traffic_sign_detection' ||
+      message.type === 'telemetry.vision_runtime')
+  ) {
+    return message;
+  }
+
+  return null;
+};
+
 export const parseTelemetryMessage = (
   payload: string
 ): VehicleTelemetryMessage | null => {
   try {
-    const parsed = JSON.parse(payload) as VehicleTelemetryMessage;
-
-    if (
-      parsed &&
-      typeof parsed === 'object' &&
-      (parsed.type === 'telemetry.road_segmentation' ||
-        parsed.type === 'telemetry.autonomous_control' ||
-        parsed.type === 'telemetry.traffic_sign_detection' ||
-        parsed.type === 'telemetry.vision_runtime')
-    ) {
-      return parsed;
-    }
-
-    return null;
+    return toTelemetryMessage(JSON.parse(payload));
   } catch (error) {
     console.warn('Mensagem WebSocket ignorada por JSON invalido.', error);
     return null;
   }
 };
 
+export type TelemetryFormat = 'json' | 'compact';
+
+// Opt-in do modo compacto (schema + keyframe + deltas), util em Wi-Fi fraco.
+export const DEFAULT_TELEMETRY_FORMAT: TelemetryFormat =
+  process.env.NEXT_PUBLIC_VEHICLE_TELEMETRY_FORMAT?.trim() === 'compact'
+    ? 'compact'
+    : 'json';
+
+export interface CompactTelemetryDecodeResult {
+  message: VehicleTelemetryMessage | null;
+  // O cliente perdeu o schema ou um delta; reenviar client:telemetry_format=compact.
+  resyncRequired: boolean;
+}
+
+interface CompactTelemetryStream {
+  type: string;
+  fields: string[];
+  values: unknown[] | null;
+  sequence: number;
+}
+
+// Reconstroi as mensagens completas a partir de telemetry.schema, keyframes ({t,s,k}) e
+// deltas ({t,s,d}). Mensagens fora do modo compacto passam por parseTelemetryMessage.
+export const createCompactTelemetryDecoder = () => {
+  const streams = new Map<number, CompactTelemetryStream>();
+  let awaitingResync = false;
+
+  const requestResync = (): CompactTelemetryDecodeResult => {
+    const resyncRequired = !awaitingResync;
+    awaitingResync = true;
+    return { message: null, resyncRequired };
+  };
+
+  const rebuild = (stream: CompactTelemetryStream) => {
+    const message: Record<string, unknown> = { type: stream.type };
+
+    stream.fields.forEach((path, index) => {
+      const keys = path.split('.');
+      let target = message;
+
+      keys.slice(0, -1).forEach((key) => {
+        if (!target[key] || typeof target[key] !== 'object') {
+          target[key] = {};
+        }
+        target = target[key] as Record<string, unknown>;
+      });
+      target[keys[keys.length - 1]] = stream.values?.[index];
+    });
+
+    return toTelemetryMessage(message);
+  };
+
+  const decode = (payload: string): CompactTelemetryDecodeResult => {
+    let parsed: {
+      type?: string;
+      id?: number;
+      for?: string;
+      fields?: string[];
+      t?: number;
+      s?: number;
+      k?: unknown[];
+      d?: unknown[];
+    };
+
+    try {
+      parsed = JSON.parse(payload);
+    } catch (error) {
+      console.warn('Mensagem WebSocket ignorada por JSON invalido.', error);
+      return { message: null, resyncRequired: false };
+    }
+
+    if (parsed?.type === 'telemetry.schema') {
+      if (
+        typeof parsed.id === 'number' &&
+        typeof parsed.for === 'string' &&
+        Array.isArray(parsed.fields)
+      ) {
+        streams.set(parsed.id, {
+          type: parsed.for,
+          fields: parsed.fields,
+          values: null,
+          sequence: 0,
+        });
+      }
+      return { message: null, resyncRequired: false };
+    }
+
+    if (typeof parsed?.t !== 'number' || typeof parsed.s !== 'number') {
+      return { message: toTelemetryMessage(parsed), resyncRequired: false };
+    }
+
+    const stream = streams.get(parsed.t);
+
+    if (!stream) {
+      return requestResync();
+    }
+
+    if (Array.isArray(parsed.k)) {
+      stream.values = parsed.k;
+    } else if (
+      Array.isArray(parsed.d) &&
+      stream.values &&
+      parsed.s === stream.sequence + 1
+    ) {
+      for (let index = 0; index + 1 < parsed.d.length; index += 2) {
+        stream.values[parsed.d[index] as number] = parsed.d[index + 1];
+      }
+    } else {
+      stream.values = null;
+      return requestResync();
+    }
+
+    stream.sequence = parsed.s;
+    awaitingResync = false;
+    return { message: rebuild(stream), resyncRequired: false };
+  };
+
+  return { decode };
+};
+
 export const buildClientRoleMessage = (role: 'control' | 'telemetry'): string =>
   `client:${role}`;
 
+export const buildClientTelemetryFormatMessage = (
+  format: TelemetryFormat
+): string => `client:telemetry_format=${format}`;
+
 export const buildDrivingModeMessage = (mode: DrivingMode): string =>
   `config:driving.mode=${mode}`;
 
@@ -270,9 +404,28 @@ export const buildAutonomousCommandMessage = (
   command: 'start' | 'stop'
 ): string => `command:autonomous:${command}`;
 
+// Opcional: maior lado, em pixels, dos frames pedidos; o carro reduz e codifica uma vez por
+// variante, o que corta banda e CPU em celular. 0 pede a resolucao do pipeline.
+export const DEFAULT_VISION_STREAM_MAX_DIMENSION = Math.max(
+  0,
+  Math.floor(
+    Number(process.env.NEXT_PUBLIC_VISION_STREAM_MAX_DIMENSION?.trim() || 0) || 0
+  )
+);
+
 export const buildVisionStreamSubscriptionMessage = (
-  views: VisionDebugViewId[]
-): string => `stream:subscribe=${views.join(',')}`;
+  views: VisionDebugViewId[],
+  maxDimension: number = DEFAULT_VISION_STREAM_MAX_DIMENSION
+): string =>
+  `stream:subscribe=${views
+    .map((view) => (maxDimension > 0 ? `${view}@${maxDimension}px` : view))
+    .join(',')}`;
+
+// Com 'binary' o carro manda cada frame como JPEG cru em frame WebSocket binario, sem
+// base64 nem JSON; enviar antes do stream:subscribe.
+export const buildVisionStreamFormatMessage = (
+  format: VisionStreamFormat
+): string => `stream:format=${format}`;
 
 export const applyRuntimeSetting = (
   current: VehicleRuntimeConfig,
@@ -368,6 +521,7 @@ export const parseVisionFrameMessage = (
       typeof parsed.mime === 'string' &&
       typeof parsed.width === 'number' &&
       typeof parsed.height === 'number' &&
+      (parsed.variant === undefined || typeof parsed.variant === 'string') &&
       typeof parsed.data === 'string'
     ) {
       return parsed as VisionFrameMessage;
@@ -380,6 +534,75 @@ export const parseVisionFrameMessage = (
   }
 };
 
+// Cabecalho big-endian do frame binario (ver README do carro): "VF", versao, view,
+// codec, tamanho do label da variante, reservado, timestamp_ms u64, width u16, height u16,
+// tamanho da imagem u32; o label (ASCII) vem entre o cabecalho e a imagem.
+const VISION_FRAME_BINARY_HEADER_SIZE = 24;
+const VISION_FRAME_BINARY_VERSION = 1;
+// A view mask chega como PNG de 1 bit; as demais, JPEG.
+const VISION_FRAME_CODEC_MIME: Record<number, string> = {
+  1: 'image/jpeg',
+  2: 'image/png',
+};
+
+const encodeBytesAsBase64 = (bytes: Uint8Array): string => {
+  let binary = '';
+  const chunkSize = 0x8000;
+
+  for (let offset = 0; offset < bytes.length; offset += chunkSize) {
+    binary += String.fromCharCode(
+      ...Array.from(bytes.subarray(offset, offset + chunkSize))
+    );
+  }
+
+  return btoa(binary);
+};
+
+export const parseBinaryVisionFrame = (
+  payload: ArrayBuffer
+): VisionFrameMessage | null => {
+  if (payload.byteLength < VISION_FRAME_BINARY_HEADER_SIZE) {
+    return null;
+  }
+
+  const header = new DataView(payload, 0, VISION_FRAME_BINARY_HEADER_SIZE);
+  const view = VISION_DEBUG_VIEW_IDS[header.getUint8(3)];
+  const variantSize = header.getUint8(5);
+  const imageSize = header.getUint32(20);
+  const imageOffset = VISION_FRAME_BINARY_HEADER_SIZE + variantSize;
+  const mime = VISION_FRAME_CODEC_MIME[header.getUint8(4)];
+
+  if (
+    header.getUint8(0) !== 0x56 ||
+    header.getUint8(1) !== 0x46 ||
+    header.getUint8(2) !== VISION_FRAME_BINARY_VERSION ||
+    !mime ||
+    !view ||
+    imageSize !== payload.byteLength - imageOffset
+  ) {
+    return null;
+  }
+
+  const variant =
+    variantSize > 0
+      ? String.fromCharCode(
+          ...new Uint8Array(payload, VISION_FRAME_BINARY_HEADER_SIZE, variantSize)
+        )
+      : undefined;
+
+  return {
+    type: 'vision.frame',
+    view,
+    timestamp_ms: header.getUint32(8) * 2 ** 32 + header.getUint32(12),
+    mime,
+    width: header.getUint16(16),
+    height: header.getUint16(18),
+    ...(variant ? { variant } : {}),
+    // Os consumidores montam data URLs; o base64 sai daqui e nao do carro.
+    data: encodeBytesAsBase64(new Uint8Array(payload, imageOffset, imageSize)),
+  };
+};
+
 export const formatConnectionStateLabel = (state: ConnectionState): string => {
   switch (state) {
     case 'disconnected':
@@ -13,11 +13,14 @@ import {
   AutonomousControlTelemetry,
   buildAutonomousCommandMessage,
   buildClientRoleMessage,
+  buildClientTelemetryFormatMessage,
   buildDrivingModeMessage,
   buildManualMotionMessage,
   buildManualSteeringMessage,
   buildRuntimeSettingMessage,
   ConnectionState,
+  createCompactTelemetryDecoder,
+  DEFAULT_TELEMETRY_FORMAT,
   DEFAULT_VEHICLE_RUNTIME_CONFIG,
   DrivingMode,
   MANUAL_COMMAND_INTERVAL_MS,
@@ -366,6 +369,10 @@ export const VehicleConfigProvider = ({
 
       const socket = new WebSocket(savedUrl);
       socketRef.current = socket;
+      const compactDecoder =
+        DEFAULT_TELEMETRY_FORMAT === 'compact'
+          ? createCompactTelemetryDecoder()
+          : null;
 
       socket.onopen = () => {
         if (cancelled) {
@@ -376,6 +383,9 @@ export const VehicleConfigProvider = ({
         reconnectAttemptRef.current = 0;
         setConnectionState('connected');
         socket.send(buildClientRoleMessage('control'));
+        if (compactDecoder) {
+          socket.send(buildClientTelemetryFormatMessage('compact'));
+        }
         syncRuntimeSettings(socket);
       };
 
@@ -384,7 +394,15 @@ export const VehicleConfigProvider = ({
           return;
         }
 
-        const parsedMessage = parseTelemetryMessage(event.data);
+        const decoded = compactDecoder?.decode(event.data);
+
+        if (decoded?.resyncRequired) {
+          socket.send(buildClientTelemetryFormatMessage('compact'));
+        }
+
+        const parsedMessage = decoded
+          ? decoded.message
+          : parseTelemetryMessage(event.data);
 
         if (!parsedMessage) {
           return;
@@ -10,8 +10,10 @@ import {
 } from 'react';
 import {
   buildClientRoleMessage,
+  buildVisionStreamFormatMessage,
   buildVisionStreamSubscriptionMessage,
   ConnectionState,
+  parseBinaryVisionFrame,
   parseVisionFrameMessage,
   RECONNECT_DELAYS_MS,
   TELEMETRY_STALE_THRESHOLD_MS,
@@ -124,6 +126,7 @@ export const VehicleVisionProvider = ({
       );
 
       const socket = new WebSocket(normalizedUrl);
+      socket.binaryType = 'arraybuffer';
       socketRef.current = socket;
 
       socket.onopen = () => {
@@ -135,15 +138,21 @@ export const VehicleVisionProvider = ({
         reconnectAttemptRef.current = 0;
         setConnectionState('connected');
         socket.send(buildClientRoleMessage('telemetry'));
+        socket.send(buildVisionStreamFormatMessage('binary'));
         socket.send(subscriptionMessageRef.current);
       };
 
       socket.onmessage = (event) => {
-        if (cancelled || typeof event.data !== 'string') {
+        if (cancelled) {
           return;
         }
 
-        const parsedFrame = parseVisionFrameMessage(event.data);
+        const parsedFrame =
+          event.data instanceof ArrayBuffer
+            ? parseBinaryVisionFrame(event.data)
+            : typeof event.data === 'string'
+              ? parseVisionFrameMessage(event.data)
+              : null;
 
         if (!parsedFrame) {
           return;
@@ -0,0 +1,534 @@
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/videoio.hpp>
+
+#include "config/LabConfig.hpp"
+#include "pipeline/PipelinedSegmentationExecutor.hpp"
+#include "pipeline/RoadSegmentationPipeline.hpp"
+#include "pipeline/StageProfiler.hpp"
+
+#ifndef ROAD_SEGMENTATION_LAB_FILE_TEST_DIR
+#define ROAD_SEGMENTATION_LAB_FILE_TEST_DIR "fileTest"
+#endif
+
+// Conta as alocacoes de heap feitas via operator new. Os buffers de cv::Mat usam o alocador
+// do OpenCV e aparecem separados em workspace_allocations_per_frame.
+namespace {
+std::atomic<std::size_t> g_heap_allocations{0};
+} // namespace
+
+void *operator new(std::size_t size) {
+    g_heap_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *pointer) noexcept { std::free(pointer); }
+
+void operator delete(void *pointer, std::size_t) noexcept { std::free(pointer); }
+
+namespace {
+
+namespace rsl = road_segmentation_lab;
+namespace fs = std::filesystem;
+
+struct CliOptions {
+    std::vector<std::string> input_paths;
+    std::vector<std::string> config_paths;
+    int iterations{3};
+    int warmup_frames{10};
+    int pipeline_depth{0};
+    bool headless{false};
+    bool json_output{false};
+};
+
+struct LatencySummary {
+    double p50_ms{0.0};
+    double p95_ms{0.0};
+    double p99_ms{0.0};
+    double max_ms{0.0};
+};
+
+struct ProfileReport {
+    std::string config_path;
+    std::size_t frames{0};
+    double elapsed_s{0.0};
+    double fps{0.0};
+    LatencySummary frame_latency;
+    rsl::pipeline::StageProfileSnapshot stages;
+    double heap_allocations_per_frame{0.0};
+    double workspace_allocations_per_frame{0.0};
+    // So no modo serial: custo do StageProfiler ligado sobre o tempo total sem ele.
+    std::optional<double> profiling_overhead_pct;
+    long peak_rss_kb{0};
+};
+
+void printHelp(const char *program_name) {
+    std::cout << "Uso:\n"
+              << "  " << program_name
+              << " [--input caminho]... [--config arquivo]... [--iterations N] [--json]\n\n"
+              << "  --input <caminho>        Video, imagem ou diretorio de frames (repetivel).\n"
+              << "                           Padrao: video e PNGs de fileTest.\n"
+              << "  --config <arquivo>       Perfil .env do pipeline (repetivel).\n"
+              << "  --iterations <N>         Passadas sobre todos os frames (padrao 3).\n"
+              << "  --warmup <N>             Frames descartados antes da medicao (padrao 10).\n"
+              << "  --pipeline-depth <N>     2 ou 3 mede o executor em pipeline.\n"
+              << "  --headless               Nenhuma imagem de depuracao no resultado.\n"
+              << "  --json                   Saida em JSON.\n"
+              << "  --help                   Exibe esta ajuda.\n";
+}
+
+int parsePositiveInt(const std::string &value, const std::string &option) {
+    try {
+        std::size_t consumed = 0;
+        const int parsed = std::stoi(value, &consumed);
+        if (consumed == value.size() && parsed >= 0) {
+            return parsed;
+        }
+    } catch (const std::exception &) {
+    }
+    throw std::runtime_error("Valor invalido para " + option + ": " + value);
+}
+
+CliOptions parseArgs(int argc, char **argv) {
+    CliOptions options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string argument = argv[i];
+        if (argument == "--help" || argument == "-h") {
+            printHelp(argv[0]);
+            std::exit(0);
+        }
+
+        if (argument == "--json") {
+            options.json_output = true;
+            continue;
+        }
+        if (argument == "--headless") {
+            options.headless = true;
+            continue;
+        }
+
+        if (i + 1 >= argc) {
+            throw std::runtime_error("Faltou o valor de " + argument);
+        }
+        const std::string value = argv[++i];
+        if (argument == "--input") {
+            options.input_paths.push_back(value);
+        } else if (argument == "--config") {
+            options.config_paths.push_back(value);
+        } else if (argument == "--iterations") {
+            options.iterations = std::max(1, parsePositiveInt(value, argument));
+        } else if (argument == "--warmup") {
+            options.warmup_frames = parsePositiveInt(value, argument);
+        } else if (argument == "--pipeline-depth") {
+            options.pipeline_depth = parsePositiveInt(value, argument);
+        } else {
+            throw std::runtime_error("Argumento desconhecido: " + argument);
+        }
+    }
+
+    if (options.input_paths.empty()) {
+        options.input_paths.push_back(ROAD_SEGMENTATION_LAB_FILE_TEST_DIR);
+    }
+    if (options.config_paths.empty()) {
+        options.config_paths.emplace_back();
+    }
+    return options;
+}
+
+bool isImageFile(const fs::path &path) {
+    std::string extension = path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char ch) { return static_cast<char>(std::tolower(ch)); });
+    return extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".bmp";
+}
+
+bool isVideoFile(const fs::path &path) {
+    std::string extension = path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char ch) { return static_cast<char>(std::tolower(ch)); });
+    return extension == ".mp4" || extension == ".avi" || extension == ".mkv" || extension == ".mov";
+}
+
+void decodeVideo(const fs::path &path, std::vector<cv::Mat> &frames) {
+    cv::VideoCapture capture(path.string());
+    if (!capture.isOpened()) {
+        throw std::runtime_error("Nao foi possivel abrir o video: " + path.string());
+    }
+
+    cv::Mat frame;
+    while (capture.read(frame) && !frame.empty()) {
+        frames.push_back(frame.clone());
+    }
+}
+
+void decodeImage(const fs::path &path, std::vector<cv::Mat> &frames) {
+    cv::Mat image = cv::imread(path.string(), cv::IMREAD_COLOR);
+    if (image.empty()) {
+        throw std::runtime_error("Nao foi possivel ler a imagem: " + path.string());
+    }
+    frames.push_back(std::move(image));
+}
+
+// Decodifica tudo antes da medicao para que leitura de disco e decode fiquem de fora.
+std::vector<cv::Mat> decodeInputs(const std::vector<std::string> &input_paths) {
+    std::vector<cv::Mat> frames;
+    for (const std::string &input : input_paths) {
+        const fs::path path(input);
+        if (!fs::is_directory(path)) {
+            if (isVideoFile(path)) {
+                decodeVideo(path, frames);
+            } else {
+                decodeImage(path, frames);
+            }
+            continue;
+        }
+
+        std::vector<fs::path> entries;
+        for (const auto &entry : fs::directory_iterator(path)) {
+            if (entry.is_regular_file() && (isImageFile(entry.path()) || isVideoFile(entry.path()))) {
+                entries.push_back(entry.path());
+            }
+        }
+        std::sort(entries.begin(), entries.end());
+        for (const fs::path &entry : entries) {
+            if (isVideoFile(entry)) {
+                decodeVideo(entry, frames);
+            } else {
+                decodeImage(entry, frames);
+            }
+        }
+    }
+
+    if (frames.empty()) {
+        throw std::runtime_error("Nenhum frame encontrado nas entradas.");
+    }
+    return frames;
+}
+
+// Zera o pico de RSS do processo (Linux >= 4.0) para medir cada perfil isoladamente.
+void resetPeakRss() {
+    std::ofstream clear_refs("/proc/self/clear_refs");
+    if (clear_refs.is_open()) {
+        clear_refs << "5";
+    }
+}
+
+long peakRssKb() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("VmHWM:", 0) == 0) {
+            return std::strtol(line.c_str() + 6, nullptr, 10);
+        }
+    }
+
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+LatencySummary summarize(std::vector<double> samples) {
+    LatencySummary summary;
+    if (samples.empty()) {
+        return summary;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    const auto percentile = [&](double value) {
+        const auto rank = static_cast<std::size_t>(
+            std::ceil((value / 100.0) * static_cast<double>(samples.size())));
+        return samples[std::clamp<std::size_t>(rank, 1, samples.size()) - 1];
+    };
+    summary.p50_ms = percentile(50.0);
+    summary.p95_ms = percentile(95.0);
+    summary.p99_ms = percentile(99.0);
+    summary.max_ms = samples.back();
+    return summary;
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end) {
+    return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+rsl::pipeline::CaptureRequest captureRequestFor(const CliOptions &options) {
+    return options.headless ? rsl::pipeline::CaptureRequest::None : rsl::pipeline::CaptureRequest::All;
+}
+
+// Alterna passadas com o perfil desligado e ligado sobre o mesmo pipeline ja aquecido, para que
+// cache e frequencia da CPU pesem igual nos dois lados, e devolve o acrescimo em porcentagem.
+double measureProfilingOverheadPct(rsl::pipeline::RoadSegmentationPipeline &pipeline,
+                                   const std::vector<cv::Mat> &frames, const CliOptions &options) {
+    std::chrono::steady_clock::duration elapsed[2]{};
+    for (int iteration = 0; iteration < options.iterations; ++iteration) {
+        for (const bool profiled : {false, true}) {
+            pipeline.profiler().setEnabled(profiled);
+            const auto started = std::chrono::steady_clock::now();
+            for (const cv::Mat &frame : frames) {
+                pipeline.process(frame, captureRequestFor(options));
+            }
+            elapsed[profiled ? 1 : 0] += std::chrono::steady_clock::now() - started;
+        }
+    }
+
+    const double unprofiled_ms = std::chrono::duration<double, std::milli>(elapsed[0]).count();
+    const double profiled_ms = std::chrono::duration<double, std::milli>(elapsed[1]).count();
+    return unprofiled_ms > 0.0 ? 100.0 * (profiled_ms - unprofiled_ms) / unprofiled_ms : 0.0;
+}
+
+ProfileReport runSerial(const std::string &config_path, const rsl::config::LabConfig &config,
+                        const std::vector<cv::Mat> &frames, const CliOptions &options) {
+    rsl::pipeline::RoadSegmentationPipeline pipeline(config);
+    pipeline.profiler().setEnabled(true);
+    for (int index = 0; index < options.warmup_frames; ++index) {
+        pipeline.process(frames[static_cast<std::size_t>(index) % frames.size()],
+                         captureRequestFor(options));
+    }
+    pipeline.profiler().reset();
+
+    ProfileReport report;
+    report.config_path = config_path;
+    std::vector<double> frame_ms;
+    frame_ms.reserve(frames.size() * static_cast<std::size_t>(options.iterations));
+    const std::size_t workspace_before = pipeline.workspace().totalAllocations();
+    const std::size_t heap_before = g_heap_allocations.load(std::memory_order_relaxed);
+    const auto started = std::chrono::steady_clock::now();
+    for (int iteration = 0; iteration < options.iterations; ++iteration) {
+        for (const cv::Mat &frame : frames) {
+            const auto frame_started = std::chrono::steady_clock::now();
+            pipeline.process(frame, captureRequestFor(options));
+            frame_ms.push_back(elapsedMs(frame_started, std::chrono::steady_clock::now()));
+        }
+    }
+    const auto finished = std::chrono::steady_clock::now();
+    // O push_back acima nunca realoca, entao o contador so ve o pipeline.
+    const std::size_t heap_allocations = g_heap_allocations.load(std::memory_order_relaxed) - heap_before;
+
+    report.frames = frame_ms.size();
+    report.elapsed_s = elapsedMs(started, finished) / 1000.0;
+    report.frame_latency = summarize(std::move(frame_ms));
+    report.stages = pipeline.profiler().snapshot();
+    report.heap_allocations_per_frame =
+        static_cast<double>(heap_allocations) / static_cast<double>(report.frames);
+    report.workspace_allocations_per_frame =
+        static_cast<double>(pipeline.workspace().totalAllocations() - workspace_before) /
+        static_cast<double>(report.frames);
+    report.profiling_overhead_pct = measureProfilingOverheadPct(pipeline, frames, options);
+    return report;
+}
+
+ProfileReport runPipelined(const std::string &config_path, const rsl::config::LabConfig &config,
+                           const std::vector<cv::Mat> &frames, const CliOptions &options) {
+    rsl::pipeline::PipelinedSegmentationExecutor executor(
+        config, static_cast<std::size_t>(options.pipeline_depth));
+    executor.profiler().setEnabled(true);
+
+    std::vector<double> frame_ms;
+    const auto run = [&](std::size_t count, bool measure) {
+        for (std::size_t index = 0; index < count; ++index) {
+            while (executor.full()) {
+                const auto ready = executor.waitPop();
+                if (measure) {
+                    frame_ms.push_back(ready.timing.total_ms);
+                }
+            }
+            executor.submit(frames[index % frames.size()], captureRequestFor(options));
+        }
+        while (executor.inFlight() > 0) {
+            const auto ready = executor.waitPop();
+            if (measure) {
+                frame_ms.push_back(ready.timing.total_ms);
+            }
+        }
+    };
+
+    run(static_cast<std::size_t>(options.warmup_frames), false);
+    executor.profiler().reset();
+
+    const std::size_t total_frames = frames.size() * static_cast<std::size_t>(options.iterations);
+    frame_ms.reserve(total_frames);
+    const std::size_t heap_before = g_heap_allocations.load(std::memory_order_relaxed);
+    const auto started = std::chrono::steady_clock::now();
+    run(total_frames, true);
+    const auto finished = std::chrono::steady_clock::now();
+    const std::size_t heap_allocations = g_heap_allocations.load(std::memory_order_relaxed) - heap_before;
+
+    ProfileReport report;
+    report.config_path = config_path;
+    report.frames = frame_ms.size();
+    report.elapsed_s = elapsedMs(started, finished) / 1000.0;
+    report.frame_latency = summarize(std::move(frame_ms));
+    report.stages = executor.profiler().snapshot();
+    report.heap_allocations_per_frame =
+        static_cast<double>(heap_allocations) / static_cast<double>(report.frames);
+    return report;
+}
+
+void appendNumber(std::ostringstream &stream, double value) {
+    stream << std::fixed << std::setprecision(6) << value;
+}
+
+void appendLatency(std::ostringstream &stream, double p50, double p95, double p99, double max) {
+    stream << "\"p50_ms\":";
+    appendNumber(stream, p50);
+    stream << ",\"p95_ms\":";
+    appendNumber(stream, p95);
+    stream << ",\"p99_ms\":";
+    appendNumber(stream, p99);
+    stream << ",\"max_ms\":";
+    appendNumber(stream, max);
+}
+
+std::string jsonEscape(const std::string &value) {
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (char ch : value) {
+        if (ch == '\\' || ch == '"') {
+            escaped.push_back('\\');
+        }
+        escaped.push_back(ch);
+    }
+    return escaped;
+}
+
+std::string buildJson(const std::vector<ProfileReport> &reports, std::size_t decoded_frames,
+                      const CliOptions &options) {
+    std::ostringstream stream;
+    stream << "{";
+    stream << "\"decoded_frames\":" << decoded_frames;
+    stream << ",\"iterations\":" << options.iterations;
+    stream << ",\"pipeline_depth\":" << options.pipeline_depth;
+    stream << ",\"headless\":" << (options.headless ? "true" : "false");
+    stream << ",\"profiles\":[";
+    for (std::size_t index = 0; index < reports.size(); ++index) {
+        const ProfileReport &report = reports[index];
+        if (index > 0) {
+            stream << ",";
+        }
+        stream << "{";
+        stream << "\"config\":\"" << jsonEscape(report.config_path) << "\"";
+        stream << ",\"frames\":" << report.frames;
+        stream << ",\"elapsed_s\":";
+        appendNumber(stream, report.elapsed_s);
+        stream << ",\"fps\":";
+        appendNumber(stream, report.fps);
+        stream << ",\"frame_latency\":{";
+        appendLatency(stream, report.frame_latency.p50_ms, report.frame_latency.p95_ms,
+                      report.frame_latency.p99_ms, report.frame_latency.max_ms);
+        stream << "}";
+        stream << ",\"stages\":[";
+        for (std::size_t stage_index = 0; stage_index < report.stages.stages.size(); ++stage_index) {
+            const auto &stage = report.stages.stages[stage_index];
+            if (stage_index > 0) {
+                stream << ",";
+            }
+            stream << "{\"name\":\"" << rsl::pipeline::toString(stage.stage) << "\"";
+            stream << ",\"samples\":" << stage.samples << ",";
+            appendLatency(stream, stage.p50_ms, stage.p95_ms, stage.p99_ms, stage.max_ms);
+            stream << "}";
+        }
+        stream << "]";
+        stream << ",\"heap_allocations_per_frame\":";
+        appendNumber(stream, report.heap_allocations_per_frame);
+        stream << ",\"workspace_allocations_per_frame\":";
+        appendNumber(stream, report.workspace_allocations_per_frame);
+        stream << ",\"profiling_overhead_pct\":";
+        if (report.profiling_overhead_pct) {
+            appendNumber(stream, *report.profiling_overhead_pct);
+        } else {
+            stream << "null";
+        }
+        stream << ",\"peak_rss_kb\":" << report.peak_rss_kb;
+        stream << "}";
+    }
+    stream << "]}";
+    return stream.str();
+}
+
+void printText(const std::vector<ProfileReport> &reports, std::size_t decoded_frames,
+               const CliOptions &options) {
+    std::cout << "Frames decodificados: " << decoded_frames << " | passadas: " << options.iterations
+              << " | pipeline: "
+              << (options.pipeline_depth >= 2 ? "depth " + std::to_string(options.pipeline_depth)
+                                              : std::string("serial"))
+              << '\n';
+    std::cout << std::fixed << std::setprecision(3);
+    for (const ProfileReport &report : reports) {
+        std::cout << "\nPerfil: " << (report.config_path.empty() ? "<padrao>" : report.config_path) << '\n'
+                  << "  fps: " << report.fps << " (" << report.frames << " frames em " << report.elapsed_s
+                  << " s)\n"
+                  << "  frame ms p50/p95/p99/max: " << report.frame_latency.p50_ms << " / "
+                  << report.frame_latency.p95_ms << " / " << report.frame_latency.p99_ms << " / "
+                  << report.frame_latency.max_ms << '\n'
+                  << "  alocacoes/frame heap: " << report.heap_allocations_per_frame
+                  << " | workspace: " << report.workspace_allocations_per_frame << '\n'
+                  << "  pico RSS: " << report.peak_rss_kb << " kB\n";
+        if (report.profiling_overhead_pct) {
+            std::cout << "  custo do perfil: " << *report.profiling_overhead_pct << " %\n";
+        }
+        for (const auto &stage : report.stages.stages) {
+            std::cout << "    " << std::left << std::setw(14) << rsl::pipeline::toString(stage.stage)
+                      << std::right << stage.p50_ms << " / " << stage.p95_ms << " / " << stage.p99_ms
+                      << " / " << stage.max_ms << " ms\n";
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    try {
+        const CliOptions options = parseArgs(argc, argv);
+        const std::vector<cv::Mat> frames = decodeInputs(options.input_paths);
+
+        std::vector<ProfileReport> reports;
+        for (const std::string &config_path : options.config_paths) {
+            rsl::config::LabConfig config;
+            if (!config_path.empty()) {
+                std::vector<std::string> warnings;
+                rsl::config::loadConfigFromFile(config_path, config, &warnings);
+                for (const std::string &warning : warnings) {
+                    std::cerr << "[config] " << warning << '\n';
+                }
+            }
+
+            resetPeakRss();
+            ProfileReport report = options.pipeline_depth >= 2
+                                       ? runPipelined(config_path, config, frames, options)
+                                       : runSerial(config_path, config, frames, options);
+            report.fps = report.elapsed_s > 0.0 ? static_cast<double>(report.frames) / report.elapsed_s : 0.0;
+            report.peak_rss_kb = peakRssKb();
+            reports.push_back(std::move(report));
+        }
+
+        if (options.json_output) {
+            std::cout << buildJson(reports, frames.size(), options) << '\n';
+        } else {
+            printText(reports, frames.size(), options);
+        }
+        return 0;
+    } catch (const std::exception &ex) {
+        std::cerr << "Erro: " << ex.what() << '\n';
+        return 1;
+    }
+}
@@ -140,7 +140,7 @@ int main(int argc, char **argv) {
 
         std::cout << "Fonte: " << source.description() << '\n';
         std::cout << "Configuracao: " << options.config_path << '\n';
-        std::cout << "Atalhos: q/ESC=sair, p=pausar, n=passo unico, r=recarregar config" << '\n';
+        std::cout << "Atalhos: q/ESC=sair, p=pausar, n=passo unico, r=recarregar config, t=perfil por estagio" << '\n';
 
         const std::string window_name = "Road Segmentation Lab";
         cv::namedWindow(window_name, cv::WINDOW_AUTOSIZE);
@@ -169,8 +169,9 @@ int main(int argc, char **argv) {
 
             if (need_reprocess || should_read_static_image || should_read_dynamic_frame) {
                 current_result = pipeline.process(current_frame);
+                const rsl::pipeline::StageProfileSnapshot profile = pipeline.profiler().snapshot();
                 current_dashboard = renderer.render(current_result, config, source.description(),
-                                                    pipeline.calibrationStatus());
+                                                    pipeline.calibrationStatus(), &profile);
                 step_once = false;
                 need_reprocess = false;
             }
@@ -198,6 +199,12 @@ int main(int argc, char **argv) {
                     step_once = true;
                 }
                 break;
+            case 't':
+            case 'T':
+                pipeline.profiler().setEnabled(!pipeline.profiler().enabled());
+                pipeline.profiler().reset();
+                need_reprocess = true;
+                break;
             case 'r':
             case 'R': {
                 std::vector<std::string> reload_warnings;
@@ -1,26 +1,69 @@
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <deque>
 #include <filesystem>
 #include <fstream>
 #include <functional>
 #include <iostream>
+#include <new>
 #include <stdexcept>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include <opencv2/calib3d.hpp>
+#include <opencv2/core/persistence.hpp>
+#include <opencv2/imgcodecs.hpp>
 #include <opencv2/imgproc.hpp>
+#include <opencv2/videoio.hpp>
 
 #include "config/LabConfig.hpp"
+#include "pipeline/FramePool.hpp"
+#include "pipeline/PipelinedSegmentationExecutor.hpp"
 #include "pipeline/RoadSegmentationPipeline.hpp"
+#include "pipeline/stages/SegmentationStage.hpp"
+#include "pipeline/stages/UndistortStage.hpp"
+
+#ifndef ROAD_SEGMENTATION_LAB_FILE_TEST_DIR
+#define ROAD_SEGMENTATION_LAB_FILE_TEST_DIR "fileTest"
+#endif
+
+// Counts operator new calls made by the current thread, so the allocation test is not
+// disturbed by the executor threads of other tests.
+namespace {
+thread_local std::size_t t_heap_allocations = 0;
+} // namespace
+
+void *operator new(std::size_t size) {
+    ++t_heap_allocations;
+    if (void *pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *pointer) noexcept { std::free(pointer); }
+
+void operator delete(void *pointer, std::size_t) noexcept { std::free(pointer); }
 
 namespace {
 
 using road_segmentation_lab::config::LabConfig;
 using road_segmentation_lab::config::SegmentationMode;
 using road_segmentation_lab::config::loadConfigFromFile;
+using road_segmentation_lab::pipeline::CaptureRequest;
+using road_segmentation_lab::pipeline::FramePool;
 using road_segmentation_lab::pipeline::LookaheadReference;
+using road_segmentation_lab::pipeline::PipelinedFrameResult;
+using road_segmentation_lab::pipeline::PipelinedSegmentationExecutor;
+using road_segmentation_lab::pipeline::ProfiledStage;
 using road_segmentation_lab::pipeline::RoadSegmentationPipeline;
 using road_segmentation_lab::pipeline::RoadSegmentationResult;
+using road_segmentation_lab::pipeline::StageProfileSnapshot;
+using road_segmentation_lab::pipeline::stages::SegmentationStage;
+using road_segmentation_lab::pipeline::stages::UndistortStage;
 
 void expect(bool condition, const std::string &message) {
     if (!condition) {
@@ -127,6 +170,71 @@ std::filesystem::path writeTempConfigFile(const std::string &name, const std::st
     return path;
 }
 
+std::filesystem::path writeTempCalibrationFile(const std::string &name, const cv::Mat &camera_matrix,
+                                               const cv::Mat &dist_coeffs) {
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+    cv::FileStorage storage(path.string(), cv::FileStorage::WRITE);
+    if (!storage.isOpened()) {
+        throw std::runtime_error("Failed to create temporary calibration file.");
+    }
+    storage << "camera_matrix" << camera_matrix;
+    storage << "dist_coeffs" << dist_coeffs;
+    return path;
+}
+
+cv::Mat makeCameraMatrix(const cv::Size &size) {
+    return (cv::Mat_<double>(3, 3) << 0.9 * size.width, 0.0, size.width / 2.0, 0.0, 0.9 * size.width,
+            size.height / 2.0, 0.0, 0.0, 1.0);
+}
+
+cv::Mat makeDistCoeffs() { return (cv::Mat_<double>(1, 5) << -0.28, 0.09, 0.001, -0.0005, 0.0); }
+
+std::vector<cv::Mat> loadFileTestFrames() {
+    const std::filesystem::path directory(ROAD_SEGMENTATION_LAB_FILE_TEST_DIR);
+    std::vector<cv::Mat> frames;
+    for (const char *name : {"01.png", "02.png", "03.png", "04.png", "05.png"}) {
+        cv::Mat image = cv::imread((directory / name).string(), cv::IMREAD_COLOR);
+        if (!image.empty()) {
+            frames.push_back(image);
+        }
+    }
+
+    cv::VideoCapture capture((directory / "video_01.mp4").string());
+    cv::Mat frame;
+    for (int index = 0; index < 90 && capture.read(frame); ++index) {
+        if (index % 15 == 0) {
+            frames.push_back(frame.clone());
+        }
+    }
+
+    expect(!frames.empty(), "fileTest images should be available.");
+    return frames;
+}
+
+cv::Mat makeEllipseSpatialMask(const cv::Size &size) {
+    cv::Mat spatial_mask(size, CV_8UC1, cv::Scalar(255));
+    cv::ellipse(spatial_mask, cv::Point(size.width / 2, size.height - 1),
+                cv::Size(size.width / 5, size.height / 4), 0, 0, 360, cv::Scalar(0), cv::FILLED);
+    return spatial_mask;
+}
+
+cv::Mat referenceDarkMask(const cv::Mat &frame, SegmentationMode mode, int threshold,
+                          const cv::Mat &spatial_mask) {
+    cv::Mat luminance;
+    if (mode == SegmentationMode::LabDark) {
+        cv::Mat lab;
+        cv::cvtColor(frame, lab, cv::COLOR_BGR2Lab);
+        cv::extractChannel(lab, luminance, 0);
+    } else {
+        cv::cvtColor(frame, luminance, cv::COLOR_BGR2GRAY);
+    }
+
+    cv::Mat mask;
+    cv::threshold(luminance, mask, threshold, 255, cv::THRESH_BINARY_INV);
+    cv::bitwise_and(mask, spatial_mask, mask);
+    return mask;
+}
+
 void expectReferenceValid(const LookaheadReference &reference, const std::string &label) {
     expect(reference.valid, label + " reference should be valid.");
     expect(reference.sample_count >= 2, label + " reference should aggregate at least two samples.");
@@ -355,6 +463,593 @@ void testMissingFarReferenceDisablesCurvature() {
     expect(!result.curvature_valid, "Curvature should be disabled when FAR reference is missing.");
 }
 
+LabConfig makeArenaConfig() {
+    LabConfig config = makeBaseConfig();
+    config.resize_enabled = true;
+    config.target_width = 320;
+    config.target_height = 240;
+    config.gaussian_enabled = true;
+    config.frame_arena_enabled = true;
+    return config;
+}
+
+void testFrameArenaReachesZeroSteadyStateAllocations() {
+    RoadSegmentationPipeline pipeline(makeArenaConfig());
+    const cv::Mat frame = makeLaneFrame(640, 480, 320, 320, 240);
+
+    for (int index = 0; index < 3; ++index) {
+        const RoadSegmentationResult result = pipeline.process(frame);
+        expect(result.lane_found, "Arena mode should keep detecting the lane.");
+    }
+
+    for (int index = 0; index < 5; ++index) {
+        const RoadSegmentationResult result = pipeline.process(frame);
+        expect(pipeline.workspace().lastFrameAllocations() == 0,
+               "Steady-state frames should not allocate workspace buffers (frame " +
+                   std::to_string(index) + ").");
+    }
+}
+
+// Tracked headless path with no OpenCV filter on it (no resize, blur, morphology or polygon
+// masking): once warm, a frame must not touch the heap at all.
+void testTrackedFrameMakesNoHeapAllocations() {
+    LabConfig config = makeBaseConfig();
+    config.morph_enabled = false;
+    config.hood_mask_enabled = false;
+    config.roi_polygon_top_width_ratio = 1.0;
+    config.roi_polygon_bottom_width_ratio = 1.0;
+    config.segmentation_mode = SegmentationMode::GrayThreshold;
+    config.tracking_enabled = true;
+    config.frame_arena_enabled = true;
+    config.profiling_enabled = false;
+    RoadSegmentationPipeline pipeline(config);
+    const cv::Mat frame = makeLaneFrame(320, 240, 160, 160, 120);
+
+    RoadSegmentationResult result;
+    for (int index = 0; index < 3; ++index) {
+        pipeline.process(frame, result, CaptureRequest::None);
+    }
+    expect(result.lane_found && result.tracking_active,
+           "Warm-up frames should end with the lane tracked.");
+
+    for (int index = 0; index < 5; ++index) {
+        const std::size_t before = t_heap_allocations;
+        pipeline.process(frame, result, CaptureRequest::None);
+        const std::size_t allocations = t_heap_allocations - before;
+        expect(allocations == 0, "Steady-state tracked frames should not allocate (frame " +
+                                     std::to_string(index) + ": " + std::to_string(allocations) +
+                                     " allocations).");
+        expect(result.lane_found && result.tracking_active,
+               "Allocation-free frames should keep tracking the lane.");
+    }
+}
+
+void testFrameArenaKeepsRetainedResultIntact() {
+    RoadSegmentationPipeline pipeline(makeArenaConfig());
+    const cv::Mat left_frame = makeLaneFrame(640, 480, 240, 270, 220);
+    const cv::Mat right_frame = makeLaneFrame(640, 480, 410, 380, 220);
+
+    const RoadSegmentationResult retained = pipeline.process(left_frame);
+    const cv::Mat retained_mask = retained.mask_frame.clone();
+    const cv::Mat retained_preprocessed = retained.preprocessed_frame.clone();
+
+    const RoadSegmentationResult next = pipeline.process(right_frame);
+
+    expect(pipeline.workspace().lastFrameAllocations() > 0,
+           "Buffers still held by a retained result must be replaced, not overwritten.");
+    expect(retained.mask_frame.data != next.mask_frame.data,
+           "Consecutive retained results must not share the same mask buffer.");
+    expectNear(cv::norm(retained.mask_frame, retained_mask, cv::NORM_INF), 0.0, 0.0,
+               "Retained mask should stay intact after the next frame.");
+    expectNear(cv::norm(retained.preprocessed_frame, retained_preprocessed, cv::NORM_INF), 0.0, 0.0,
+               "Retained preprocessed frame should stay intact after the next frame.");
+}
+
+void testDefaultModeDetachesResultFromInput() {
+    LabConfig config = makeBaseConfig();
+    config.gaussian_enabled = false;
+    config.morph_enabled = false;
+    const cv::Mat frame = makeLaneFrame(320, 240, 160, 160, 120);
+
+    RoadSegmentationPipeline pipeline(config);
+    const RoadSegmentationResult first = pipeline.process(frame);
+    const RoadSegmentationResult second = pipeline.process(frame);
+
+    expect(first.resized_frame.data != frame.data,
+           "Default mode should not alias the caller frame in the result.");
+    expect(first.roi_frame.size() == cv::Size(320, 120),
+           "Default mode should keep the ROI dimensions.");
+    expect(first.mask_frame.data != second.mask_frame.data,
+           "Default mode results should own independent masks.");
+    expectNear(cv::norm(first.mask_frame, second.mask_frame, cv::NORM_INF), 0.0, 0.0,
+               "Reusing the workspace should not change the segmentation output.");
+}
+
+void testRetainedResultsRecycleFrameBuffers() {
+    LabConfig config = makeArenaConfig();
+    config.frame_arena_enabled = false;
+    RoadSegmentationPipeline pipeline(config);
+    const cv::Mat frame = makeLaneFrame(640, 480, 320, 320, 240);
+    const FramePool &pool = FramePool::shared();
+
+    // Async consumers hold the latest results while the next one is produced.
+    std::deque<RoadSegmentationResult> retained;
+    const auto processRetaining = [&] {
+        retained.push_back(pipeline.process(frame));
+        if (retained.size() > 2) {
+            retained.pop_front();
+        }
+    };
+    for (int index = 0; index < 6; ++index) {
+        processRetaining();
+    }
+
+    const std::size_t allocations = pool.allocations();
+    const std::size_t reuses = pool.reuses();
+    for (int index = 0; index < 10; ++index) {
+        processRetaining();
+    }
+
+    expect(pool.allocations() == allocations,
+           "Steady-state frames with retained results should only reuse pooled buffers.");
+    expect(pool.reuses() > reuses, "Replaced workspace buffers should come from the pool.");
+    expect(pool.owns(retained.back().mask_frame), "Result masks should live in pooled buffers.");
+    expect(retained.front().mask_frame.data != retained.back().mask_frame.data,
+           "Retained results must not share mask buffers.");
+    expect(retained.back().lane_found, "Pooled buffers should not change the segmentation.");
+}
+
+void testUndistortRemapMatchesReference() {
+    const cv::Size size(320, 240);
+    const cv::Mat camera_matrix = makeCameraMatrix(size);
+    const cv::Mat dist_coeffs = makeDistCoeffs();
+    const auto calibration_path =
+        writeTempCalibrationFile("road_segmentation_undistort_remap.yml", camera_matrix, dist_coeffs);
+    const cv::Mat frame = makeLaneFrame(size.width, size.height, 150, 170, 120, true);
+
+    UndistortStage stage(calibration_path.string());
+    expect(stage.isActive(), "Calibration file should activate the undistort stage.");
+
+    cv::Mat expected;
+    cv::undistort(frame, expected, camera_matrix, dist_coeffs);
+    cv::Mat output;
+    const cv::Mat first = stage.apply(frame, output);
+    expect(first.data == output.data, "Undistort stage should write into the provided buffer.");
+    expect(cv::norm(first, expected, cv::NORM_INF) <= 1.0,
+           "Cached remap should match cv::undistort.");
+
+    const uchar *buffer = output.data;
+    stage.apply(frame, output);
+    expect(output.data == buffer, "Undistort stage should reuse the output buffer between frames.");
+}
+
+void testUndistortFusedWithResize() {
+    const cv::Size target_size(320, 240);
+    const cv::Mat camera_matrix = makeCameraMatrix(target_size);
+    const cv::Mat dist_coeffs = makeDistCoeffs();
+    const auto calibration_path =
+        writeTempCalibrationFile("road_segmentation_undistort_fused.yml", camera_matrix, dist_coeffs);
+
+    cv::Mat frame(480, 640, CV_8UC3);
+    for (int y = 0; y < frame.rows; ++y) {
+        for (int x = 0; x < frame.cols; ++x) {
+            frame.at<cv::Vec3b>(y, x) = cv::Vec3b(static_cast<uchar>(x * 255 / frame.cols),
+                                                  static_cast<uchar>(y * 255 / frame.rows), 128);
+        }
+    }
+
+    cv::Mat resized;
+    cv::resize(frame, resized, target_size, 0.0, 0.0, cv::INTER_AREA);
+    cv::Mat expected;
+    cv::undistort(resized, expected, camera_matrix, dist_coeffs);
+
+    LabConfig config = makeBaseConfig();
+    config.resize_enabled = true;
+    config.target_width = target_size.width;
+    config.target_height = target_size.height;
+    config.calibration_file = calibration_path.string();
+    RoadSegmentationPipeline pipeline(config);
+    const RoadSegmentationResult result = pipeline.process(frame);
+
+    expect(result.resized_frame.size() == target_size,
+           "Fused undistort should output the resize target size.");
+    const double mean_error = cv::norm(result.resized_frame, expected, cv::NORM_L1) /
+                              static_cast<double>(expected.total() * expected.channels());
+    expect(mean_error < 2.0, "Fused undistort should match resize followed by undistort.");
+}
+
+void testRectangularSpatialMaskClearsOutsideColumns() {
+    LabConfig config = makeBaseConfig();
+    config.hood_mask_enabled = false;
+    config.roi_polygon_top_width_ratio = 0.5;
+    config.roi_polygon_bottom_width_ratio = 0.5;
+    const cv::Mat frame = makeLaneFrame(320, 240, 160, 160, 240);
+
+    const RoadSegmentationResult result = runPipeline(config, frame);
+
+    expect(result.lane_found, "Lane should be found inside the rectangular ROI.");
+    expect(result.roi_polygon_points.size() == 4, "Rectangular ROI should keep its polygon.");
+    const int left = result.roi_polygon_points[0].x;
+    const int right = result.roi_polygon_points[1].x;
+    const cv::Mat inside = result.preprocessed_frame.colRange(left, right + 1);
+    const cv::Mat roi_inside = result.roi_frame.colRange(left, right + 1);
+    expectNear(cv::norm(inside, roi_inside, cv::NORM_INF), 0.0, 0.0,
+               "Pixels inside the rectangular ROI should be preserved.");
+    expect(cv::countNonZero(result.mask_frame.colRange(0, left)) == 0 &&
+               cv::countNonZero(result.mask_frame.colRange(right + 1, result.mask_frame.cols)) == 0,
+           "Mask should be cleared outside the rectangular ROI.");
+}
+
+void testSpatialMaskFollowsConfigUpdates() {
+    LabConfig config = makeBaseConfig();
+    const cv::Mat frame = addVehicleHood(makeLaneFrame(320, 240, 160, 160, 110));
+
+    RoadSegmentationPipeline pipeline(config);
+    const RoadSegmentationResult masked_result = pipeline.process(frame);
+    expect(!masked_result.hood_mask_polygon_points.empty(), "Hood mask should be active initially.");
+
+    config.hood_mask_enabled = false;
+    pipeline.updateConfig(config);
+    const RoadSegmentationResult unmasked_result = pipeline.process(frame);
+    expect(unmasked_result.hood_mask_polygon_points.empty(),
+           "Config update should drop the cached hood polygon.");
+    expect(masked_result.mask_area_px < unmasked_result.mask_area_px,
+           "Config update should rebuild the cached spatial mask.");
+
+    const RoadSegmentationResult resized_result = pipeline.process(makeLaneFrame(160, 120, 80, 80, 60));
+    expect(!resized_result.roi_polygon_points.empty() && resized_result.roi_polygon_points[2].y == 119,
+           "Frame size change should rebuild the cached ROI polygon.");
+}
+
+void testFusedSegmentationMatchesReference() {
+    const std::vector<cv::Mat> frames = loadFileTestFrames();
+    for (const SegmentationMode mode : {SegmentationMode::GrayThreshold, SegmentationMode::LabDark}) {
+        for (const int threshold : {40, 90, 150}) {
+            LabConfig config = makeBaseConfig();
+            config.segmentation_mode = mode;
+            config.gray_threshold = threshold;
+            const SegmentationStage stage(config);
+            const std::string label = stage.modeName() + " threshold " + std::to_string(threshold);
+
+            for (const cv::Mat &image : frames) {
+                // Odd-width view of the lower half: non-continuous rows and the scalar
+                // tail of the fused kernel are both exercised.
+                const cv::Mat roi = image(cv::Rect(0, image.rows / 2, image.cols - 3, image.rows / 2));
+                const cv::Mat spatial_mask = makeEllipseSpatialMask(roi.size());
+
+                cv::Mat output;
+                cv::Mat scratch;
+                const cv::Mat fused = stage.apply(roi, output, scratch, spatial_mask);
+                const cv::Mat expected = referenceDarkMask(roi, mode, threshold, spatial_mask);
+                expect(fused.size() == expected.size() && fused.type() == expected.type(),
+                       label + " should keep the mask geometry.");
+                expect(cv::norm(fused, expected, cv::NORM_INF) == 0.0,
+                       label + " should be bit-identical to cvtColor + threshold.");
+
+                const cv::Mat unmasked = stage.apply(roi, output, scratch).clone();
+                const cv::Mat expected_unmasked = referenceDarkMask(
+                    roi, mode, threshold, cv::Mat(roi.size(), CV_8UC1, cv::Scalar(255)));
+                expect(cv::norm(unmasked, expected_unmasked, cv::NORM_INF) == 0.0,
+                       label + " without spatial mask should match cvtColor + threshold.");
+            }
+        }
+    }
+}
+
+void testManyNoiseComponentsKeepMainRoad() {
+    LabConfig config = makeBaseConfig();
+    config.min_contour_area = 20.0;
+    cv::Mat frame = makeLaneFrame(320, 240, 160, 160, 110);
+    for (int index = 0; index < 24; ++index) {
+        const int x = (index % 2 == 0) ? 4 + (index % 6) * 6 : 280 + (index % 5) * 6;
+        const int y = 124 + (index / 2) * 9;
+        cv::rectangle(frame, {x, y}, {x + 4, y + 5}, cv::Scalar(0, 0, 0), cv::FILLED);
+    }
+
+    const RoadSegmentationResult result = runPipeline(config, frame);
+
+    expect(result.lane_found, "Lane should be found despite many noise components.");
+    expectNear(result.lane_center_ratio, 0.5, 0.05, "Noise components should not win the selection.");
+    expect(cv::countNonZero(result.mask_frame.colRange(0, 40)) == 0,
+           "Only the winning component should be materialized in the mask.");
+}
+
+void testCaptureRequestSkipsUnrequestedArtifacts() {
+    const LabConfig config = makeBaseConfig();
+    const cv::Mat frame = makeLaneFrame(320, 240, 140, 170, 120, true);
+
+    RoadSegmentationPipeline pipeline(config);
+    const RoadSegmentationResult full = pipeline.process(frame);
+    const RoadSegmentationResult headless = pipeline.process(frame, CaptureRequest::None);
+    const RoadSegmentationResult mask_only =
+        pipeline.process(frame, CaptureRequest::Frame | CaptureRequest::Mask);
+
+    expect(!full.resized_frame.empty() && !full.roi_frame.empty() &&
+               !full.preprocessed_frame.empty() && !full.mask_frame.empty(),
+           "Every artifact should be captured by default.");
+    expect(headless.resized_frame.empty() && headless.roi_frame.empty() &&
+               headless.preprocessed_frame.empty() && headless.mask_frame.empty(),
+           "A headless capture should not retain any image.");
+    expect(!mask_only.resized_frame.empty() && !mask_only.mask_frame.empty() &&
+               mask_only.preprocessed_frame.empty(),
+           "Only the requested artifacts should be produced.");
+    expect(headless.lane_found == full.lane_found && headless.lane_center == full.lane_center &&
+               headless.mask_area_px == full.mask_area_px &&
+               headless.near_reference.point == full.near_reference.point,
+           "Skipping debug artifacts should not change the lane estimate.");
+}
+
+LabConfig makeTrackingConfig() {
+    LabConfig config = makeBaseConfig();
+    config.tracking_enabled = true;
+    config.tracking_band_px = 16;
+    config.tracking_min_confidence = 0.45;
+    return config;
+}
+
+void testTrackingFollowsShiftingLane() {
+    LabConfig tracking_config = makeTrackingConfig();
+    tracking_config.hood_mask_enabled = false;
+    LabConfig full_config = tracking_config;
+    full_config.tracking_enabled = false;
+    RoadSegmentationPipeline tracking_pipeline(tracking_config);
+    RoadSegmentationPipeline full_pipeline(full_config);
+
+    for (int step = 0; step < 8; ++step) {
+        const int center_x = 150 + step * 4;
+        const cv::Mat frame = makeLaneFrame(320, 240, center_x, center_x + 10, 120);
+        const RoadSegmentationResult tracked = tracking_pipeline.process(frame);
+        const RoadSegmentationResult full = full_pipeline.process(frame);
+
+        expect(tracked.lane_found, "Tracked lane should stay found.");
+        expect(tracked.tracking_active == (step > 0),
+               "Tracking should take over after the first full analysis.");
+        expect(std::abs(tracked.lane_center.x - full.lane_center.x) <= 2,
+               "Tracked lane center should match the full component analysis.");
+        expectNear(tracked.lane_width_px, full.lane_width_px, 3.0,
+                   "Tracked lane width should match the full component analysis.");
+    }
+}
+
+void testTrackingFallsBackWhenLaneIsLost() {
+    RoadSegmentationPipeline pipeline(makeTrackingConfig());
+    const cv::Mat lane_frame = makeLaneFrame(320, 240, 160, 160, 120);
+    const cv::Mat empty_frame(240, 320, CV_8UC3, cv::Scalar(255, 255, 255));
+
+    pipeline.process(lane_frame);
+    expect(pipeline.process(lane_frame).tracking_active, "Second frame should be tracked.");
+
+    const RoadSegmentationResult lost = pipeline.process(empty_frame);
+    expect(!lost.lane_found && !lost.tracking_active, "Lost lane should drop the tracking state.");
+
+    const RoadSegmentationResult recovered = pipeline.process(lane_frame);
+    expect(recovered.lane_found && !recovered.tracking_active,
+           "Recovery should go through the full component analysis.");
+    expect(pipeline.process(lane_frame).tracking_active,
+           "Tracking should resume after a successful full analysis.");
+}
+
+void testTrackingFallsBackWhenEdgesLeaveTheBand() {
+    LabConfig tracking_config = makeTrackingConfig();
+    tracking_config.hood_mask_enabled = false;
+    LabConfig full_config = tracking_config;
+    full_config.tracking_enabled = false;
+    RoadSegmentationPipeline tracking_pipeline(tracking_config);
+    RoadSegmentationPipeline full_pipeline(full_config);
+
+    const cv::Mat straight = makeLaneFrame(320, 240, 160, 160, 100);
+    tracking_pipeline.process(straight);
+    expect(tracking_pipeline.process(straight).tracking_active,
+           "Second straight frame should be tracked.");
+
+    // Each edge moves more than band_px: the lane widens (edges leave the band in opposite
+    // directions) and then bends, with the far rows shifting while the near rows stay put.
+    const std::vector<std::pair<std::string, cv::Mat>> frames = {
+        {"widened", makeLaneFrame(320, 240, 160, 160, 150)},
+        {"curve", makePolylineLaneFrame(320, 240, {195, 185, 172, 164, 160}, 150)},
+    };
+    for (const auto &[name, frame] : frames) {
+        const RoadSegmentationResult tracked = tracking_pipeline.process(frame);
+        const RoadSegmentationResult full = full_pipeline.process(frame);
+
+        expect(tracked.lane_found && !tracked.tracking_active,
+               "A " + name + " lane should fall back to the full component analysis.");
+        expect(std::abs(tracked.lane_center.x - full.lane_center.x) <= 2,
+               "A " + name + " lane center should match the full component analysis.");
+        expectNear(tracked.lane_width_px, full.lane_width_px, 3.0,
+                   "A " + name + " lane width should match the full component analysis.");
+        expect(tracked.far_reference.valid == full.far_reference.valid &&
+                   std::abs(tracked.far_reference.point.x - full.far_reference.point.x) <= 2,
+               "A " + name + " lane far reference should not lag behind.");
+        expect(tracking_pipeline.process(frame).tracking_active,
+               "Tracking should resume on the " + name + " lane after the full analysis.");
+    }
+}
+
+void testPipelinedExecutorMatchesSerialOrder() {
+    LabConfig config = makeTrackingConfig();
+    config.gaussian_enabled = true;
+    RoadSegmentationPipeline serial_pipeline(config);
+    PipelinedSegmentationExecutor executor(config, 3);
+    expect(executor.depth() == 3, "Executor should honour the requested depth.");
+
+    std::vector<RoadSegmentationResult> expected;
+    std::vector<PipelinedFrameResult> delivered;
+    for (int step = 0; step < 12; ++step) {
+        const int center_x = 130 + step * 5;
+        const cv::Mat frame = makeLaneFrame(320, 240, center_x, center_x + 12, 110, step % 3 == 0);
+        expected.push_back(serial_pipeline.process(frame));
+
+        while (executor.full()) {
+            delivered.push_back(executor.waitPop());
+        }
+        expect(executor.submit(frame, CaptureRequest::All, 1000 + step * 33),
+               "Submit should succeed with a free slot.");
+        while (auto ready = executor.tryPop()) {
+            delivered.push_back(std::move(*ready));
+        }
+    }
+    while (executor.inFlight() > 0) {
+        delivered.push_back(executor.waitPop());
+    }
+
+    expect(delivered.size() == expected.size(), "Every submitted frame should be delivered.");
+    for (std::size_t index = 0; index < expected.size(); ++index) {
+        const PipelinedFrameResult &pipelined = delivered[index];
+        const RoadSegmentationResult &serial = expected[index];
+        expect(pipelined.sequence == index, "Results should be delivered in submission order.");
+        expect(pipelined.timestamp_ms == 1000 + static_cast<std::int64_t>(index) * 33,
+               "Each result should carry the timestamp given to its submit().");
+        expect(pipelined.result.lane_found == serial.lane_found &&
+                   pipelined.result.lane_center == serial.lane_center &&
+                   pipelined.result.tracking_active == serial.tracking_active &&
+                   pipelined.result.mask_area_px == serial.mask_area_px,
+               "Pipelined result should match the serial pipeline frame by frame.");
+        expect(cv::countNonZero(pipelined.result.mask_frame != serial.mask_frame) == 0,
+               "Pipelined mask should match the serial pipeline.");
+        expect(pipelined.timing.total_ms + 1e-6 >= pipelined.timing.prepare_ms +
+                                                       pipelined.timing.segment_ms +
+                                                       pipelined.timing.analyze_ms,
+               "Total latency should include every stage group.");
+    }
+}
+
+void testProfilerRecordsEveryActiveStage() {
+    LabConfig config = makeBaseConfig();
+    config.gaussian_enabled = true;
+    config.clahe_enabled = true;
+    RoadSegmentationPipeline pipeline(config);
+    const cv::Mat frame = makeLaneFrame(320, 240, 160, 160, 120);
+
+    pipeline.process(frame);
+    expect(pipeline.profiler().snapshot().stages.empty(), "Profiling should be off by default.");
+
+    pipeline.profiler().setEnabled(true);
+    for (int index = 0; index < 5; ++index) {
+        pipeline.process(frame);
+    }
+
+    const StageProfileSnapshot profile = pipeline.profiler().snapshot();
+    expect(profile.enabled && profile.frames == 5, "Profiler should count every profiled frame.");
+    for (const ProfiledStage stage :
+         {ProfiledStage::Resize, ProfiledStage::Gaussian, ProfiledStage::Illumination,
+          ProfiledStage::Segmentation, ProfiledStage::Morphology, ProfiledStage::BoundaryAnalysis,
+          ProfiledStage::Output, ProfiledStage::Frame}) {
+        const auto it = std::find_if(profile.stages.begin(), profile.stages.end(),
+                                     [&](const auto &summary) { return summary.stage == stage; });
+        expect(it != profile.stages.end() && it->samples == 5,
+               std::string("Profiler should time stage ") + road_segmentation_lab::pipeline::toString(stage));
+        expect(it->p50_ms <= it->p95_ms && it->p95_ms <= it->p99_ms && it->p99_ms <= it->max_ms,
+               "Percentiles should be ordered.");
+    }
+    expect(std::none_of(profile.stages.begin(), profile.stages.end(),
+                        [](const auto &summary) { return summary.stage == ProfiledStage::Pyramid; }),
+           "Inactive pyramid stage should not be timed.");
+}
+
+void testConfigReloadKeepsRuntimeProfilingToggle() {
+    LabConfig config = makeBaseConfig();
+    RoadSegmentationPipeline pipeline(config);
+
+    pipeline.profiler().setEnabled(true);
+    pipeline.updateConfig(config);
+    expect(pipeline.profiler().enabled(),
+           "Reloading an unchanged config should keep the runtime profiling toggle.");
+
+    config.profiling_enabled = true;
+    pipeline.updateConfig(config);
+    pipeline.profiler().setEnabled(false);
+    pipeline.updateConfig(config);
+    expect(!pipeline.profiler().enabled(),
+           "Reloading should not turn profiling back on after a runtime toggle.");
+
+    config.profiling_enabled = false;
+    pipeline.profiler().setEnabled(true);
+    pipeline.updateConfig(config);
+    expect(!pipeline.profiler().enabled(),
+           "Changing LANE_PROFILING_ENABLED in the config should still apply.");
+}
+
+void testTrackingConfigParsing() {
+    LabConfig config = makeBaseConfig();
+    std::vector<std::string> warnings;
+    const std::filesystem::path path = writeTempConfigFile(
+        "road_segmentation_lab_tracking.env",
+        "LANE_TRACKING_ENABLED=true\n"
+        "LANE_TRACKING_BAND_PX=30\n"
+        "LANE_TRACKING_MIN_CONFIDENCE=0.6\n");
+
+    const bool loaded = loadConfigFromFile(path.string(), config, &warnings);
+    std::filesystem::remove(path);
+
+    expect(loaded && warnings.empty(), "Tracking config should load without warnings.");
+    expect(config.tracking_enabled, "Tracking flag should parse correctly.");
+    expect(config.tracking_band_px == 30, "Tracking band should parse correctly.");
+    expectNear(config.tracking_min_confidence, 0.6, 1e-6,
+               "Tracking confidence threshold should parse correctly.");
+}
+
+void testPyramidModeMatchesFullResolution() {
+    LabConfig full_config = makeBaseConfig();
+    full_config.min_contour_area = 800.0;
+    full_config.hood_mask_enabled = false;
+    const cv::Mat frame = makeLaneFrame(640, 480, 300, 340, 240, true);
+    const RoadSegmentationResult full = runPipeline(full_config, frame);
+
+    for (const int level : {1, 2}) {
+        LabConfig pyramid_config = full_config;
+        pyramid_config.pyramid_level = level;
+        const RoadSegmentationResult pyramid = runPipeline(pyramid_config, frame);
+        const std::string label = "Pyramid level " + std::to_string(level);
+
+        expect(pyramid.lane_found, label + " should find the lane.");
+        expect(pyramid.roi_rect == full.roi_rect, label + " should keep the full-resolution ROI.");
+        expect(pyramid.mask_frame.size() == full.roi_rect.size() &&
+                   pyramid.preprocessed_frame.size() == full.roi_rect.size(),
+               label + " should return ROI-sized debug frames.");
+        expect(std::abs(pyramid.lane_center.x - full.lane_center.x) <= 3,
+               label + " lane center should match full resolution.");
+        expectNear(pyramid.lane_width_px, full.lane_width_px, 4.0,
+                   label + " refined lane width should match full resolution.");
+        expect(pyramid.near_reference.valid && pyramid.mid_reference.valid,
+               label + " should keep the lookahead references.");
+    }
+}
+
+void testPyramidRefinementWithPreprocessing() {
+    LabConfig full_config = makeBaseConfig();
+    full_config.min_contour_area = 800.0;
+    full_config.hood_mask_enabled = false;
+    full_config.gaussian_enabled = true;
+    full_config.gaussian_kernel = cv::Size(5, 5);
+    full_config.gaussian_sigma = 1.2;
+    const cv::Mat frame = makeLaneFrame(640, 480, 300, 340, 240, true);
+
+    for (const bool clahe : {false, true}) {
+        full_config.clahe_enabled = clahe;
+        const RoadSegmentationResult full = runPipeline(full_config, frame);
+
+        for (const int level : {1, 2}) {
+            LabConfig pyramid_config = full_config;
+            pyramid_config.pyramid_level = level;
+            const RoadSegmentationResult pyramid = runPipeline(pyramid_config, frame);
+            const std::string label = std::string(clahe ? "Blur + CLAHE" : "Blur") +
+                                      " pyramid level " + std::to_string(level);
+
+            // Sem CLAHE a borda e refinada com o mesmo blur da resolucao cheia; com CLAHE ela
+            // fica na posicao da mascara reduzida, a menos de um pixel reduzido.
+            const int scale = 1 << level;
+            const int center_tolerance = clahe ? scale + 1 : 2;
+            const double width_tolerance = clahe ? 2.0 * scale + 2.0 : 3.0;
+            expect(pyramid.lane_found, label + " should find the lane.");
+            expect(std::abs(pyramid.lane_center.x - full.lane_center.x) <= center_tolerance,
+                   label + " lane center should match full resolution.");
+            expectNear(pyramid.lane_width_px, full.lane_width_px, width_tolerance,
+                       label + " lane width should match full resolution.");
+        }
+    }
+}
+
 } // namespace
 
 int main() {
@@ -371,6 +1066,32 @@ int main() {
         {"reference_config_parsing", testReferenceConfigParsing},
         {"reference_config_fallback", testReferenceConfigFallback},
         {"missing_far_reference_disables_curvature", testMissingFarReferenceDisablesCurvature},
+        {"frame_arena_reaches_zero_steady_state_allocations",
+         testFrameArenaReachesZeroSteadyStateAllocations},
+        {"tracked_frame_makes_no_heap_allocations", testTrackedFrameMakesNoHeapAllocations},
+        {"frame_arena_keeps_retained_result_intact", testFrameArenaKeepsRetainedResultIntact},
+        {"default_mode_detaches_result_from_input", testDefaultModeDetachesResultFromInput},
+        {"retained_results_recycle_frame_buffers", testRetainedResultsRecycleFrameBuffers},
+        {"undistort_remap_matches_reference", testUndistortRemapMatchesReference},
+        {"undistort_fused_with_resize", testUndistortFusedWithResize},
+        {"rectangular_spatial_mask_clears_outside_columns",
+         testRectangularSpatialMaskClearsOutsideColumns},
+        {"spatial_mask_follows_config_updates", testSpatialMaskFollowsConfigUpdates},
+        {"fused_segmentation_matches_reference", testFusedSegmentationMatchesReference},
+        {"many_noise_components_keep_main_road", testManyNoiseComponentsKeepMainRoad},
+        {"capture_request_skips_unrequested_artifacts",
+         testCaptureRequestSkipsUnrequestedArtifacts},
+        {"tracking_follows_shifting_lane", testTrackingFollowsShiftingLane},
+        {"tracking_falls_back_when_lane_is_lost", testTrackingFallsBackWhenLaneIsLost},
+        {"tracking_falls_back_when_edges_leave_the_band",
+         testTrackingFallsBackWhenEdgesLeaveTheBand},
+        {"pipelined_executor_matches_serial_order", testPipelinedExecutorMatchesSerialOrder},
+        {"profiler_records_every_active_stage", testProfilerRecordsEveryActiveStage},
+        {"config_reload_keeps_runtime_profiling_toggle",
+         testConfigReloadKeepsRuntimeProfilingToggle},
+        {"tracking_config_parsing", testTrackingConfigParsing},
+        {"pyramid_mode_matches_full_resolution", testPyramidModeMatchesFullResolution},
+        {"pyramid_refinement_with_preprocessing", testPyramidRefinementWithPreprocessing},
     };
 
     for (const auto &[name, test] : tests) {
@@ -0,0 +1,267 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "concurrency/LatestValueChannel.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Mailbox com mutex + condvar que o LatestValueChannel substituiu, mantido como referencia.
+template <typename T>
+class MutexMailbox {
+  public:
+    bool offer(T value) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const bool replaced = value_.has_value();
+        if (replaced) {
+            dropped_count_.fetch_add(1, std::memory_order_relaxed);
+        }
+        value_ = std::move(value);
+        condition_.notify_one();
+        return replaced;
+    }
+
+    template <typename StopRequested, typename Rep, typename Period>
+    std::optional<T> waitPopFor(const std::chrono::duration<Rep, Period> &timeout,
+                                StopRequested stop_requested) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait_for(lock, timeout, [&] { return value_.has_value() || stop_requested(); });
+        std::optional<T> value = std::move(value_);
+        value_.reset();
+        return value;
+    }
+
+    void notifyAll() { condition_.notify_all(); }
+
+    std::uint64_t droppedCount() const noexcept {
+        return dropped_count_.load(std::memory_order_relaxed);
+    }
+
+  private:
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::optional<T> value_;
+    std::atomic<std::uint64_t> dropped_count_{0};
+};
+
+struct Payload {
+    Clock::time_point published;
+};
+
+using Message = std::shared_ptr<Payload>;
+
+struct CliOptions {
+    double seconds{2.0};
+    double rate_hz{30.0};
+    int consumer_work_us{200};
+};
+
+struct LatencySummary {
+    double p50{0.0};
+    double p99{0.0};
+    double max{0.0};
+};
+
+struct ScenarioReport {
+    std::string mailbox;
+    std::string scenario;
+    std::size_t offers{0};
+    std::size_t delivered{0};
+    std::uint64_t dropped{0};
+    double offers_per_second{0.0};
+    LatencySummary offer_ns;
+    LatencySummary wake_us;
+};
+
+void printHelp(const char *program_name) {
+    std::cout << "Uso:\n"
+              << "  " << program_name << " [--seconds S] [--rate-hz N] [--consumer-work-us N]\n\n"
+              << "  --seconds <S>            Duracao de cada cenario (padrao 2).\n"
+              << "  --rate-hz <N>            Taxa do produtor no cenario cadenciado (padrao 30).\n"
+              << "  --consumer-work-us <N>   Trabalho do consumidor por valor (padrao 200).\n"
+              << "  --help                   Exibe esta ajuda.\n";
+}
+
+double parsePositive(const std::string &value, const std::string &option) {
+    try {
+        std::size_t consumed = 0;
+        const double parsed = std::stod(value, &consumed);
+        if (consumed == value.size() && parsed > 0.0) {
+            return parsed;
+        }
+    } catch (const std::exception &) {
+    }
+    throw std::runtime_error("Valor invalido para " + option + ": " + value);
+}
+
+CliOptions parseArgs(int argc, char **argv) {
+    CliOptions options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string argument = argv[i];
+        if (argument == "--help" || argument == "-h") {
+            printHelp(argv[0]);
+            std::exit(0);
+        }
+
+        if (i + 1 >= argc) {
+            throw std::runtime_error("Faltou o valor de " + argument);
+        }
+        const std::string value = argv[++i];
+        if (argument == "--seconds") {
+            options.seconds = parsePositive(value, argument);
+        } else if (argument == "--rate-hz") {
+            options.rate_hz = parsePositive(value, argument);
+        } else if (argument == "--consumer-work-us") {
+            options.consumer_work_us = static_cast<int>(parsePositive(value, argument));
+        } else {
+            throw std::runtime_error("Argumento desconhecido: " + argument);
+        }
+    }
+    return options;
+}
+
+LatencySummary summarize(std::vector<double> samples) {
+    LatencySummary summary;
+    if (samples.empty()) {
+        return summary;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    const auto percentile = [&](double value) {
+        const auto rank = static_cast<std::size_t>(std::ceil(value / 100.0 * samples.size()));
+        return samples[std::clamp<std::size_t>(rank, 1, samples.size()) - 1];
+    };
+    summary.p50 = percentile(50.0);
+    summary.p99 = percentile(99.0);
+    summary.max = samples.back();
+    return summary;
+}
+
+void busyWait(std::chrono::microseconds duration) {
+    const auto until = Clock::now() + duration;
+    while (Clock::now() < until) {
+    }
+}
+
+// Produtor a toda velocidade (rate_hz <= 0) ou cadenciado; consumidor como as threads do carro.
+template <typename Mailbox>
+ScenarioReport runScenario(const std::string &mailbox_name, const std::string &scenario,
+                           double rate_hz, const CliOptions &options) {
+    constexpr std::size_t kMaxSamples = 1u << 20;
+    Mailbox mailbox;
+    std::atomic<bool> stop{false};
+    std::vector<double> wake_us;
+    wake_us.reserve(kMaxSamples);
+    std::size_t delivered = 0;
+
+    std::thread consumer([&] {
+        while (!stop.load()) {
+            auto message = mailbox.waitPopFor(std::chrono::milliseconds(100),
+                                              [&] { return stop.load(); });
+            if (!message) {
+                continue;
+            }
+            const auto received = Clock::now();
+            ++delivered;
+            if (wake_us.size() < kMaxSamples) {
+                wake_us.push_back(
+                    std::chrono::duration<double, std::micro>(received - (*message)->published).count());
+            }
+            busyWait(std::chrono::microseconds(options.consumer_work_us));
+        }
+    });
+
+    std::vector<double> offer_ns;
+    offer_ns.reserve(kMaxSamples);
+    std::size_t offers = 0;
+    const auto period = rate_hz > 0.0 ? std::chrono::duration_cast<Clock::duration>(
+                                            std::chrono::duration<double>(1.0 / rate_hz))
+                                      : Clock::duration::zero();
+    const auto started = Clock::now();
+    const auto finish = started + std::chrono::duration_cast<Clock::duration>(
+                                      std::chrono::duration<double>(options.seconds));
+    auto next_offer = started;
+    while (Clock::now() < finish) {
+        if (period > Clock::duration::zero()) {
+            std::this_thread::sleep_until(next_offer);
+            next_offer += period;
+        }
+
+        auto message = std::make_shared<Payload>();
+        const auto offer_started = Clock::now();
+        message->published = offer_started;
+        mailbox.offer(std::move(message));
+        const auto offer_finished = Clock::now();
+        ++offers;
+        if (offer_ns.size() < kMaxSamples) {
+            offer_ns.push_back(
+                std::chrono::duration<double, std::nano>(offer_finished - offer_started).count());
+        }
+    }
+    const auto elapsed = std::chrono::duration<double>(Clock::now() - started).count();
+
+    stop.store(true);
+    mailbox.notifyAll();
+    consumer.join();
+
+    ScenarioReport report;
+    report.mailbox = mailbox_name;
+    report.scenario = scenario;
+    report.offers = offers;
+    report.delivered = delivered;
+    report.dropped = mailbox.droppedCount();
+    report.offers_per_second = elapsed > 0.0 ? static_cast<double>(offers) / elapsed : 0.0;
+    report.offer_ns = summarize(std::move(offer_ns));
+    report.wake_us = summarize(std::move(wake_us));
+    return report;
+}
+
+void printReport(const ScenarioReport &report) {
+    std::cout << std::left << std::setw(20) << report.mailbox << std::setw(12) << report.scenario
+              << std::right << std::fixed << std::setprecision(0) << std::setw(12)
+              << report.offers_per_second << " offers/s | entregues " << report.delivered
+              << " | descartados " << report.dropped << '\n'
+              << std::setprecision(1) << "    offer ns p50/p99/max: " << report.offer_ns.p50 << " / "
+              << report.offer_ns.p99 << " / " << report.offer_ns.max
+              << " | publicacao->consumidor us p50/p99/max: " << report.wake_us.p50 << " / "
+              << report.wake_us.p99 << " / " << report.wake_us.max << '\n';
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    try {
+        const CliOptions options = parseArgs(argc, argv);
+        using Channel = shared::concurrency::LatestValueChannel<Message>;
+
+        std::cout << "Cenario saturado: produtor sem pausa, consumidor com "
+                  << options.consumer_work_us << " us por valor.\n"
+                  << "Cenario cadenciado: produtor a " << options.rate_hz
+                  << " Hz, consumidor quase sempre estacionado.\n\n";
+        printReport(runScenario<MutexMailbox<Message>>("mutex+condvar", "saturado", 0.0, options));
+        printReport(runScenario<Channel>("LatestValueChannel", "saturado", 0.0, options));
+        printReport(
+            runScenario<MutexMailbox<Message>>("mutex+condvar", "cadenciado", options.rate_hz, options));
+        printReport(runScenario<Channel>("LatestValueChannel", "cadenciado", options.rate_hz, options));
+        return 0;
+    } catch (const std::exception &ex) {
+        std::cerr << "Erro: " << ex.what() << '\n';
+        return 1;
+    }
+}
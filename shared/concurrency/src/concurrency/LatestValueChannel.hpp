@@ -0,0 +1,156 @@
+#pragma once
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <ctime>
+#include <optional>
+#include <utility>
+
+namespace shared::concurrency {
+namespace detail {
+
+static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t) &&
+                  std::atomic<std::uint32_t>::is_always_lock_free,
+              "futex precisa de um atomic de 32 bits sem lock");
+
+inline void futexWait(std::atomic<std::uint32_t> &word, std::uint32_t expected,
+                      const timespec *timeout) {
+    // Retorna na hora se word ja mudou; EINTR e timeout sao tratados pelo laco do chamador.
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&word), FUTEX_WAIT_PRIVATE, expected,
+            timeout, nullptr, 0);
+}
+
+inline void futexWakeAll(std::atomic<std::uint32_t> &word) {
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&word), FUTEX_WAKE_PRIVATE, INT_MAX,
+            nullptr, nullptr, 0);
+}
+
+} // namespace detail
+
+// Valor mais recente de um produtor para um consumidor; offer() nunca bloqueia. offer() vem de
+// uma thread, tryPop()/waitPop*() de outra; notifyAll() e droppedCount() de qualquer uma.
+template <typename T>
+class LatestValueChannel {
+  public:
+    LatestValueChannel() = default;
+    LatestValueChannel(const LatestValueChannel &) = delete;
+    LatestValueChannel &operator=(const LatestValueChannel &) = delete;
+
+    // Retorna true quando sobrescreveu um valor ainda nao consumido.
+    bool offer(T value) {
+        slots_[back_].value = std::move(value);
+        const std::uint32_t previous = middle_.exchange(back_ | kFreshBit, std::memory_order_acq_rel);
+        back_ = previous & kIndexMask;
+        const bool replaced = (previous & kFreshBit) != 0;
+        if (replaced) {
+            dropped_count_.fetch_add(1, std::memory_order_relaxed);
+            // O valor descartado e destruido aqui, como no mailbox com mutex.
+            slots_[back_].value.reset();
+        }
+        if ((previous & kParkedBit) != 0) {
+            detail::futexWakeAll(middle_);
+        }
+        return replaced;
+    }
+
+    std::optional<T> tryPop() {
+        if ((middle_.load(std::memory_order_acquire) & kFreshBit) == 0) {
+            return std::nullopt;
+        }
+        return take();
+    }
+
+    template <typename StopRequested, typename Rep, typename Period>
+    std::optional<T> waitPopFor(const std::chrono::duration<Rep, Period> &timeout,
+                                StopRequested stop_requested) {
+        const auto deadline =
+            Clock::now() + std::chrono::duration_cast<Clock::duration>(timeout);
+        return waitPopUntil(std::optional<Clock::time_point>(deadline), stop_requested);
+    }
+
+    template <typename StopRequested>
+    std::optional<T> waitPop(StopRequested stop_requested) {
+        return waitPopUntil(std::optional<Clock::time_point>(), stop_requested);
+    }
+
+    // Acorda o consumidor para reavaliar o predicado de parada; chame depois de setar a flag.
+    void notifyAll() {
+        // Muda a palavra para que um consumidor entre o teste do predicado e o futex nao durma.
+        middle_.fetch_xor(kNotifyBit, std::memory_order_seq_cst);
+        detail::futexWakeAll(middle_);
+    }
+
+    [[nodiscard]] std::uint64_t droppedCount() const noexcept {
+        return dropped_count_.load(std::memory_order_relaxed);
+    }
+
+  private:
+    using Clock = std::chrono::steady_clock;
+    static constexpr std::uint32_t kIndexMask = 0x3;
+    static constexpr std::uint32_t kFreshBit = 0x4;
+    static constexpr std::uint32_t kParkedBit = 0x8;
+    static constexpr std::uint32_t kNotifyBit = 0x10;
+
+    struct alignas(64) Slot {
+        std::optional<T> value;
+    };
+
+    std::optional<T> take() {
+        // So o consumidor limpa o bit de novo, entao a troca sempre entrega um valor.
+        front_ = middle_.exchange(front_, std::memory_order_acq_rel) & kIndexMask;
+        std::optional<T> value = std::move(slots_[front_].value);
+        slots_[front_].value.reset();
+        return value;
+    }
+
+    template <typename StopRequested>
+    std::optional<T> waitPopUntil(const std::optional<Clock::time_point> &deadline,
+                                  StopRequested &stop_requested) {
+        while (true) {
+            // Lida antes do predicado: um notifyAll depois daqui muda a palavra e o CAS falha.
+            std::uint32_t observed = middle_.load(std::memory_order_acquire);
+            if ((observed & kFreshBit) != 0) {
+                return take();
+            }
+            if (stop_requested()) {
+                return std::nullopt;
+            }
+
+            timespec remaining{};
+            if (deadline) {
+                const auto now = Clock::now();
+                if (now >= *deadline) {
+                    return std::nullopt;
+                }
+                const auto left =
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(*deadline - now).count();
+                remaining.tv_sec = static_cast<std::time_t>(left / 1000000000LL);
+                remaining.tv_nsec = static_cast<long>(left % 1000000000LL);
+            }
+
+            // Anuncia o estacionamento; se offer() ou notifyAll() mexeu na palavra, tenta de novo.
+            if (middle_.compare_exchange_strong(observed, observed | kParkedBit,
+                                                std::memory_order_acq_rel,
+                                                std::memory_order_acquire)) {
+                detail::futexWait(middle_, observed | kParkedBit, deadline ? &remaining : nullptr);
+                middle_.fetch_and(~kParkedBit, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::array<Slot, 3> slots_{};
+    // Produtor: back_. Consumidor: front_. Compartilhado: indice do meio e bits de estado.
+    std::uint32_t back_{0};
+    alignas(64) std::atomic<std::uint32_t> middle_{1};
+    alignas(64) std::uint32_t front_{2};
+    alignas(64) std::atomic<std::uint64_t> dropped_count_{0};
+};
+
+} // namespace shared::concurrency
@@ -0,0 +1,419 @@
+#include "frame_transport/SharedFrameRing.hpp"
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstring>
+#include <ctime>
+#include <new>
+#include <thread>
+#include <utility>
+
+namespace shared::frame_transport {
+namespace {
+
+constexpr std::uint32_t kMagic = 0x47524641; // "AFRG"
+constexpr std::uint32_t kVersion = 2;
+constexpr std::size_t kAlignment = 64;
+// Sem heartbeat do leitor por este tempo, o escritor para de copiar frames.
+constexpr std::int64_t kReaderTimeoutMs = 1000;
+// Espera maxima por rodada; o leitor renova o heartbeat a cada volta.
+constexpr std::chrono::milliseconds kMaxParkTime{100};
+
+struct RingHeader {
+    // Gravado por ultimo: o leitor so confia no resto do cabecalho depois de ver o magic.
+    std::atomic<std::uint32_t> magic;
+    std::uint32_t version;
+    std::uint32_t slot_count;
+    std::uint32_t reserved;
+    std::uint64_t slot_capacity;
+    alignas(kAlignment) std::atomic<std::uint64_t> published_sequence;
+    // Slot do frame em published_sequence; gravado antes dela.
+    std::atomic<std::uint32_t> published_slot;
+    std::atomic<std::uint32_t> notify_word;
+    std::atomic<std::uint32_t> waiters;
+    std::atomic<std::uint32_t> closed;
+    alignas(kAlignment) std::atomic<std::int64_t> reader_heartbeat_ms;
+    std::atomic<std::uint32_t> reader_min_interval_ms;
+};
+
+struct SlotHeader {
+    // 0 enquanto o escritor copia; a sequencia do frame quando o slot esta consistente.
+    std::atomic<std::uint64_t> sequence;
+    std::int64_t timestamp_ms;
+    std::uint32_t width;
+    std::uint32_t height;
+    std::uint32_t format;
+    std::uint32_t reserved;
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free &&
+                  std::atomic<std::uint32_t>::is_always_lock_free,
+              "atomics em memoria compartilhada precisam ser sem lock");
+
+constexpr std::size_t alignUp(std::size_t value) {
+    return (value + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+std::size_t slotStride(std::size_t slot_capacity) {
+    return alignUp(sizeof(SlotHeader)) + alignUp(slot_capacity);
+}
+
+std::size_t segmentSize(std::size_t slot_count, std::size_t slot_capacity) {
+    return alignUp(sizeof(RingHeader)) + slot_count * slotStride(slot_capacity);
+}
+
+RingHeader *ringHeader(const SharedSegment &segment) {
+    return static_cast<RingHeader *>(segment.data());
+}
+
+SlotHeader *slotAt(const SharedSegment &segment, std::size_t index) {
+    const RingHeader *header = ringHeader(segment);
+    auto *base = static_cast<std::uint8_t *>(segment.data()) + alignUp(sizeof(RingHeader));
+    return reinterpret_cast<SlotHeader *>(base + index * slotStride(header->slot_capacity));
+}
+
+std::uint8_t *slotPixels(SlotHeader *slot) {
+    return reinterpret_cast<std::uint8_t *>(slot) + alignUp(sizeof(SlotHeader));
+}
+
+// CLOCK_MONOTONIC e o mesmo para todos os processos da maquina.
+std::int64_t monotonicNs() {
+    timespec now{};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<std::int64_t>(now.tv_sec) * 1000000000LL + now.tv_nsec;
+}
+
+std::int64_t monotonicMs() { return monotonicNs() / 1000000LL; }
+
+// Sem FUTEX_PRIVATE_FLAG: a palavra vive em memoria compartilhada entre processos.
+void futexWait(std::atomic<std::uint32_t> &word, std::uint32_t expected,
+               std::chrono::nanoseconds timeout) {
+    timespec remaining{};
+    remaining.tv_sec = static_cast<std::time_t>(timeout.count() / 1000000000LL);
+    remaining.tv_nsec = static_cast<long>(timeout.count() % 1000000000LL);
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&word), FUTEX_WAIT, expected, &remaining,
+            nullptr, 0);
+}
+
+void futexWakeAll(std::atomic<std::uint32_t> &word) {
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&word), FUTEX_WAKE, INT_MAX, nullptr,
+            nullptr, 0);
+}
+
+void notifyReaders(RingHeader &header) {
+    header.notify_word.fetch_add(1, std::memory_order_seq_cst);
+    if (header.waiters.load(std::memory_order_seq_cst) > 0) {
+        futexWakeAll(header.notify_word);
+    }
+}
+
+} // namespace
+
+std::size_t bytesPerPixel(PixelFormat format) {
+    switch (format) {
+    case PixelFormat::Bgr8:
+        return 3;
+    case PixelFormat::Gray8:
+        return 1;
+    }
+    return 0;
+}
+
+SharedSegment::~SharedSegment() { reset(); }
+
+bool SharedSegment::create(const std::string &name, std::size_t size) {
+    reset();
+    // Sobra de um escritor que caiu; leitores antigos percebem pelo inode.
+    shm_unlink(name.c_str());
+    fd_ = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd_ < 0) {
+        return false;
+    }
+
+    struct stat info {};
+    if (ftruncate(fd_, static_cast<off_t>(size)) != 0 || fstat(fd_, &info) != 0) {
+        reset();
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    data_ = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (data_ == MAP_FAILED) {
+        data_ = nullptr;
+        reset();
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    size_ = size;
+    inode_ = info.st_ino;
+    return true;
+}
+
+bool SharedSegment::open(const std::string &name) {
+    reset();
+    fd_ = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd_ < 0) {
+        return false;
+    }
+
+    struct stat info {};
+    if (fstat(fd_, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(RingHeader))) {
+        reset();
+        return false;
+    }
+
+    const auto size = static_cast<std::size_t>(info.st_size);
+    data_ = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (data_ == MAP_FAILED) {
+        data_ = nullptr;
+        reset();
+        return false;
+    }
+
+    size_ = size;
+    inode_ = info.st_ino;
+    return true;
+}
+
+void SharedSegment::reset() {
+    if (data_ != nullptr) {
+        munmap(data_, size_);
+        data_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        close(fd_);
+        fd_ = -1;
+    }
+    size_ = 0;
+    inode_ = 0;
+}
+
+bool SharedSegment::replaced(const std::string &name) const {
+    const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return true;
+    }
+
+    struct stat info {};
+    const bool same = fstat(fd, &info) == 0 && info.st_ino == inode_;
+    close(fd);
+    return !same;
+}
+
+SharedFrameRingWriter::SharedFrameRingWriter(std::string name, std::size_t slot_count)
+    : name_{std::move(name)}, slot_count_{std::max<std::size_t>(slot_count, 2)} {}
+
+SharedFrameRingWriter::~SharedFrameRingWriter() { closeSegment(); }
+
+bool SharedFrameRingWriter::hasReader() const {
+    if (!segment_.mapped()) {
+        return false;
+    }
+    const auto heartbeat = ringHeader(segment_)->reader_heartbeat_ms.load(std::memory_order_relaxed);
+    return heartbeat > 0 && monotonicMs() - heartbeat <= kReaderTimeoutMs;
+}
+
+bool SharedFrameRingWriter::publish(const FrameView &frame) {
+    const std::size_t pixel_bytes = bytesPerPixel(frame.format);
+    const std::size_t row_bytes = static_cast<std::size_t>(std::max(frame.width, 0)) * pixel_bytes;
+    const std::size_t frame_bytes = row_bytes * static_cast<std::size_t>(std::max(frame.height, 0));
+    if (frame.data == nullptr || frame_bytes == 0 || frame.step < row_bytes ||
+        !ensureSegment(frame_bytes) || !hasReader()) {
+        return false;
+    }
+
+    RingHeader &header = *ringHeader(segment_);
+    const std::int64_t now_ms = monotonicMs();
+    const auto min_interval_ms = header.reader_min_interval_ms.load(std::memory_order_relaxed);
+    if (min_interval_ms > 0 && now_ms - last_publish_ms_ < min_interval_ms) {
+        return false;
+    }
+
+    // Do relogio monotonic: continua crescendo se o escritor reinicia.
+    const std::uint64_t sequence =
+        std::max<std::uint64_t>(last_sequence_ + 1, static_cast<std::uint64_t>(monotonicNs()));
+    // Um slot por frame: o ultimo publicado so e reescrito depois de slot_count - 1 frames.
+    const std::size_t slot_index = next_slot_;
+    next_slot_ = (next_slot_ + 1) % slot_count_;
+    SlotHeader *slot = slotAt(segment_, slot_index);
+    slot->sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot->timestamp_ms = frame.timestamp_ms;
+    slot->width = static_cast<std::uint32_t>(frame.width);
+    slot->height = static_cast<std::uint32_t>(frame.height);
+    slot->format = static_cast<std::uint32_t>(frame.format);
+    std::uint8_t *destination = slotPixels(slot);
+    if (frame.step == row_bytes) {
+        std::memcpy(destination, frame.data, frame_bytes);
+    } else {
+        for (int row = 0; row < frame.height; ++row) {
+            std::memcpy(destination + static_cast<std::size_t>(row) * row_bytes,
+                        frame.data + static_cast<std::size_t>(row) * frame.step, row_bytes);
+        }
+    }
+
+    slot->sequence.store(sequence, std::memory_order_release);
+    header.published_slot.store(static_cast<std::uint32_t>(slot_index),
+                                std::memory_order_relaxed);
+    header.published_sequence.store(sequence, std::memory_order_release);
+    notifyReaders(header);
+
+    last_sequence_ = sequence;
+    last_publish_ms_ = now_ms;
+    ++published_count_;
+    return true;
+}
+
+bool SharedFrameRingWriter::ensureSegment(std::size_t frame_bytes) {
+    if (segment_.mapped() && frame_bytes <= ringHeader(segment_)->slot_capacity) {
+        return true;
+    }
+
+    // Frame maior que os slots: recria o segmento, e os leitores se reanexam pelo closed.
+    closeSegment();
+    next_slot_ = 0;
+    if (!segment_.create(name_, segmentSize(slot_count_, frame_bytes))) {
+        return false;
+    }
+
+    auto *header = new (segment_.data()) RingHeader{};
+    header->version = kVersion;
+    header->slot_count = static_cast<std::uint32_t>(slot_count_);
+    header->slot_capacity = frame_bytes;
+    auto *base = static_cast<std::uint8_t *>(segment_.data()) + alignUp(sizeof(RingHeader));
+    for (std::size_t index = 0; index < slot_count_; ++index) {
+        new (base + index * slotStride(frame_bytes)) SlotHeader{};
+    }
+    header->magic.store(kMagic, std::memory_order_release);
+    return true;
+}
+
+void SharedFrameRingWriter::closeSegment() {
+    if (!segment_.mapped()) {
+        return;
+    }
+
+    RingHeader &header = *ringHeader(segment_);
+    header.closed.store(1, std::memory_order_release);
+    notifyReaders(header);
+    segment_.reset();
+    shm_unlink(name_.c_str());
+}
+
+SharedFrameRingReader::SharedFrameRingReader(std::string name) : name_{std::move(name)} {}
+
+void SharedFrameRingReader::setMinPublishInterval(std::chrono::milliseconds interval) {
+    min_interval_ms_ = static_cast<std::uint32_t>(std::max<std::int64_t>(interval.count(), 0));
+}
+
+std::optional<FrameInfo> SharedFrameRingReader::waitNext(std::uint64_t last_sequence,
+                                                         std::string &pixels,
+                                                         std::chrono::milliseconds timeout) {
+    using Clock = std::chrono::steady_clock;
+    const auto deadline = Clock::now() + timeout;
+
+    while (true) {
+        const auto now = Clock::now();
+        if (!segment_.mapped() && !attach()) {
+            if (now >= deadline) {
+                return std::nullopt;
+            }
+            std::this_thread::sleep_for(std::min<Clock::duration>(deadline - now, kMaxParkTime));
+            continue;
+        }
+
+        RingHeader &header = *ringHeader(segment_);
+        header.reader_min_interval_ms.store(min_interval_ms_, std::memory_order_relaxed);
+        header.reader_heartbeat_ms.store(monotonicMs(), std::memory_order_relaxed);
+
+        // Lida antes da sequencia: um publish depois daqui muda a palavra e o futex nao dorme.
+        const std::uint32_t observed = header.notify_word.load(std::memory_order_acquire);
+        const std::uint64_t published = header.published_sequence.load(std::memory_order_acquire);
+        if (published > last_sequence) {
+            const std::uint32_t slot = header.published_slot.load(std::memory_order_relaxed);
+            if (auto info = readSlot(slot, published, pixels)) {
+                return info;
+            }
+            // Slot em escrita (ou escritor caiu no meio): espera o proximo publish no futex.
+        }
+
+        if (header.closed.load(std::memory_order_acquire) != 0) {
+            segment_.reset();
+            continue;
+        }
+
+        if (now >= deadline) {
+            // Um escritor que caiu nao marca closed; o sucessor recria o nome com outro inode.
+            if (segment_.replaced(name_)) {
+                segment_.reset();
+            }
+            return std::nullopt;
+        }
+
+        header.waiters.fetch_add(1, std::memory_order_seq_cst);
+        futexWait(header.notify_word, observed,
+                  std::min<Clock::duration>(deadline - now, kMaxParkTime));
+        header.waiters.fetch_sub(1, std::memory_order_seq_cst);
+    }
+}
+
+bool SharedFrameRingReader::attach() {
+    if (!segment_.open(name_)) {
+        return false;
+    }
+
+    const RingHeader &header = *ringHeader(segment_);
+    const bool valid = header.magic.load(std::memory_order_acquire) == kMagic &&
+                       header.version == kVersion && header.slot_count > 0 &&
+                       header.closed.load(std::memory_order_acquire) == 0 &&
+                       segmentSize(header.slot_count, header.slot_capacity) <= segment_.size();
+    if (!valid) {
+        segment_.reset();
+    }
+    return valid;
+}
+
+std::optional<FrameInfo> SharedFrameRingReader::readSlot(std::uint32_t slot_index,
+                                                         std::uint64_t sequence,
+                                                         std::string &pixels) const {
+    if (slot_index >= ringHeader(segment_)->slot_count) {
+        return std::nullopt;
+    }
+    SlotHeader *slot = slotAt(segment_, slot_index);
+    if (slot->sequence.load(std::memory_order_acquire) != sequence) {
+        return std::nullopt;
+    }
+
+    FrameInfo info;
+    info.sequence = sequence;
+    info.timestamp_ms = slot->timestamp_ms;
+    info.width = static_cast<int>(slot->width);
+    info.height = static_cast<int>(slot->height);
+    info.format = static_cast<PixelFormat>(slot->format);
+    const std::size_t frame_bytes = static_cast<std::size_t>(slot->width) * slot->height *
+                                    bytesPerPixel(info.format);
+    if (frame_bytes == 0 || frame_bytes > ringHeader(segment_)->slot_capacity) {
+        return std::nullopt;
+    }
+
+    pixels.resize(frame_bytes);
+    std::memcpy(pixels.data(), slotPixels(slot), frame_bytes);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot->sequence.load(std::memory_order_relaxed) != sequence) {
+        return std::nullopt;
+    }
+    return info;
+}
+
+} // namespace shared::frame_transport
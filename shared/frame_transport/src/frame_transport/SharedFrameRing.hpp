@@ -0,0 +1,115 @@
+#pragma once
+
+#include <sys/types.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace shared::frame_transport {
+
+enum class PixelFormat : std::uint32_t { Bgr8 = 1, Gray8 = 2 };
+
+std::size_t bytesPerPixel(PixelFormat format);
+
+// Frame a publicar; step permite publicar um cv::Mat nao continuo (ROI) sem copia previa.
+struct FrameView {
+    const std::uint8_t *data{nullptr};
+    int width{0};
+    int height{0};
+    std::size_t step{0};
+    PixelFormat format{PixelFormat::Bgr8};
+    std::int64_t timestamp_ms{0};
+};
+
+struct FrameInfo {
+    std::uint64_t sequence{0};
+    std::int64_t timestamp_ms{0};
+    int width{0};
+    int height{0};
+    PixelFormat format{PixelFormat::Bgr8};
+};
+
+// Mapeamento de um segmento POSIX (shm_open + mmap); fecha e desmapeia no destrutor.
+class SharedSegment {
+  public:
+    SharedSegment() = default;
+    ~SharedSegment();
+    SharedSegment(const SharedSegment &) = delete;
+    SharedSegment &operator=(const SharedSegment &) = delete;
+
+    bool create(const std::string &name, std::size_t size);
+    bool open(const std::string &name);
+    void reset();
+
+    [[nodiscard]] bool mapped() const noexcept { return data_ != nullptr; }
+    [[nodiscard]] void *data() const noexcept { return data_; }
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+    // Outro escritor recriou o nome (ou ele sumiu) desde que este mapeamento foi aberto.
+    [[nodiscard]] bool replaced(const std::string &name) const;
+
+  private:
+    int fd_{-1};
+    void *data_{nullptr};
+    std::size_t size_{0};
+    ino_t inode_{0};
+};
+
+// Um unico escritor por nome, chamado de uma thread; o segmento vive do primeiro publish() ate o
+// destrutor. Sem leitor com heartbeat recente, publish() nao copia nada.
+class SharedFrameRingWriter {
+  public:
+    static constexpr std::size_t kDefaultSlotCount = 3;
+
+    explicit SharedFrameRingWriter(std::string name, std::size_t slot_count = kDefaultSlotCount);
+    ~SharedFrameRingWriter();
+    SharedFrameRingWriter(const SharedFrameRingWriter &) = delete;
+    SharedFrameRingWriter &operator=(const SharedFrameRingWriter &) = delete;
+
+    // Retorna true quando o frame foi copiado para o anel.
+    bool publish(const FrameView &frame);
+    [[nodiscard]] bool hasReader() const;
+    [[nodiscard]] std::uint64_t publishedCount() const noexcept { return published_count_; }
+    [[nodiscard]] const std::string &name() const noexcept { return name_; }
+
+  private:
+    bool ensureSegment(std::size_t frame_bytes);
+    void closeSegment();
+
+    std::string name_;
+    std::size_t slot_count_;
+    SharedSegment segment_;
+    std::size_t next_slot_{0};
+    std::uint64_t last_sequence_{0};
+    std::uint64_t published_count_{0};
+    std::int64_t last_publish_ms_{0};
+};
+
+class SharedFrameRingReader {
+  public:
+    explicit SharedFrameRingReader(std::string name);
+    SharedFrameRingReader(const SharedFrameRingReader &) = delete;
+    SharedFrameRingReader &operator=(const SharedFrameRingReader &) = delete;
+
+    // Intervalo minimo entre frames que o escritor deve respeitar; 0 pede todos.
+    void setMinPublishInterval(std::chrono::milliseconds interval);
+
+    // Copia o proximo frame depois de last_sequence para pixels; nullopt no timeout.
+    std::optional<FrameInfo> waitNext(std::uint64_t last_sequence, std::string &pixels,
+                                      std::chrono::milliseconds timeout);
+
+    [[nodiscard]] bool attached() const noexcept { return segment_.mapped(); }
+
+  private:
+    bool attach();
+    std::optional<FrameInfo> readSlot(std::uint32_t slot_index, std::uint64_t sequence,
+                                      std::string &pixels) const;
+
+    std::string name_;
+    SharedSegment segment_;
+    std::uint32_t min_interval_ms_{0};
+};
+
+} // namespace shared::frame_transport
@@ -525,11 +525,74 @@ bool loadConfigFromFile(const std::string &path, LabConfig &config,
             continue;
         }
 
+        if (key == "LANE_TRACKING_ENABLED") {
+            if (const auto parsed = parseBool(value)) {
+                config.tracking_enabled = *parsed;
+            } else {
+                pushWarning(warnings, "Valor invalido para " + key);
+            }
+            continue;
+        }
+
+        if (key == "LANE_TRACKING_BAND_PX") {
+            if (const auto parsed = parseInt(value)) {
+                config.tracking_band_px = std::clamp(*parsed, 2, 200);
+            } else {
+                pushWarning(warnings, "Valor invalido para " + key);
+            }
+            continue;
+        }
+
+        if (key == "LANE_TRACKING_MIN_CONFIDENCE") {
+            if (const auto parsed = parseDouble(value)) {
+                config.tracking_min_confidence = std::clamp(*parsed, 0.0, 1.0);
+            } else {
+                pushWarning(warnings, "Valor invalido para " + key);
+            }
+            continue;
+        }
+
+        if (key == "LANE_PYRAMID_LEVEL") {
+            if (const auto parsed = parseInt(value)) {
+                config.pyramid_level = std::clamp(*parsed, 0, 2);
+            } else {
+                pushWarning(warnings, "Valor invalido para " + key);
+            }
+            continue;
+        }
+
+        if (key == "LANE_PYRAMID_REFINE_BAND_PX") {
+            if (const auto parsed = parseInt(value)) {
+                config.pyramid_refine_band_px = std::clamp(*parsed, 1, 64);
+            } else {
+                pushWarning(warnings, "Valor invalido para " + key);
+            }
+            continue;
+        }
+
         if (key == "LANE_CALIBRATION_FILE") {
             config.calibration_file = resolveMaybeRelativePath(config_path, value);
             continue;
         }
 
+        if (key == "LANE_FRAME_ARENA_ENABLED") {
+            if (const auto parsed = parseBool(value)) {
+                config.frame_arena_enabled = *parsed;
+            } else {
+                pushWarning(warnings, "Valor invalido para " + key);
+            }
+            continue;
+        }
+
+        if (key == "LANE_PROFILING_ENABLED") {
+            if (const auto parsed = parseBool(value)) {
+                config.profiling_enabled = *parsed;
+            } else {
+                pushWarning(warnings, "Valor invalido para " + key);
+            }
+            continue;
+        }
+
         pushWarning(warnings, "Chave desconhecida ignorada: " + key);
     }
 
@@ -48,7 +48,14 @@ struct LabConfig {
     cv::Size morph_kernel{5, 5};
     int morph_iterations{1};
     double min_contour_area{400.0};
+    bool tracking_enabled{false};
+    int tracking_band_px{24};
+    double tracking_min_confidence{0.45};
+    int pyramid_level{0};
+    int pyramid_refine_band_px{6};
     std::string calibration_file;
+    bool frame_arena_enabled{false};
+    bool profiling_enabled{false};
 };
 
 std::string segmentationModeToString(SegmentationMode mode);
@@ -2,8 +2,10 @@
 
 #include <algorithm>
 #include <cmath>
+#include <iterator>
 #include <numeric>
 #include <optional>
+#include <utility>
 #include <vector>
 
 #include <opencv2/imgproc.hpp>
@@ -11,53 +13,18 @@
 namespace road_segmentation_lab::pipeline {
 namespace {
 
-struct RowExtent {
-    int y{0};
-    int left{-1};
-    int right{-1};
-};
+constexpr int kScanlineStep = 4;
+constexpr double kTrackedConfidenceSmoothing = 0.7;
 
+// As extensoes por linha do candidato ficam em BoundaryAnalyzerBuffers::extents.
 struct CandidateComponent {
-    cv::Mat mask;
-    std::vector<RowExtent> extents;
+    int label{0};
     double area{0.0};
     cv::Rect bounds;
     double score{0.0};
     double center_alignment{0.0};
 };
 
-std::vector<RowExtent> collectRowExtents(const cv::Mat &mask, int step) {
-    std::vector<RowExtent> extents;
-    if (mask.empty()) {
-        return extents;
-    }
-
-    step = std::max(1, step);
-    for (int y = 0; y < mask.rows; y += step) {
-        const auto *row = mask.ptr<uchar>(y);
-        int left = -1;
-        int right = -1;
-        for (int x = 0; x < mask.cols; ++x) {
-            if (row[x] > 0) {
-                left = x;
-                break;
-            }
-        }
-        for (int x = mask.cols - 1; x >= 0; --x) {
-            if (row[x] > 0) {
-                right = x;
-                break;
-            }
-        }
-
-        if (left >= 0 && right >= left) {
-            extents.push_back({y, left, right});
-        }
-    }
-
-    return extents;
-}
-
 double average(const std::vector<double> &values, double fallback = 0.0) {
     if (values.empty()) {
         return fallback;
@@ -67,13 +34,18 @@ double average(const std::vector<double> &values, double fallback = 0.0) {
     return sum / static_cast<double>(values.size());
 }
 
-std::vector<cv::Point> smoothPoints(const std::vector<cv::Point> &points, int window_size) {
+// Media movel dos pontos, ja deslocados por offset, escrita em smoothed (que mantem a
+// capacidade entre frames).
+void smoothPoints(const std::vector<cv::Point> &points, int window_size, const cv::Point &offset,
+                  std::vector<cv::Point> &smoothed) {
+    smoothed.clear();
     if (points.size() < 3 || window_size <= 1) {
-        return points;
+        for (const cv::Point &point : points) {
+            smoothed.emplace_back(point + offset);
+        }
+        return;
     }
 
-    std::vector<cv::Point> smoothed;
-    smoothed.reserve(points.size());
     const int half_window = window_size / 2;
 
     for (int index = 0; index < static_cast<int>(points.size()); ++index) {
@@ -89,11 +61,11 @@ std::vector<cv::Point> smoothPoints(const std::vector<cv::Point> &points, int wi
             ++count;
         }
 
-        smoothed.emplace_back(static_cast<int>(std::lround(sum_x / static_cast<double>(count))),
-                              static_cast<int>(std::lround(sum_y / static_cast<double>(count))));
+        smoothed.emplace_back(
+            cv::Point(static_cast<int>(std::lround(sum_x / static_cast<double>(count))),
+                      static_cast<int>(std::lround(sum_y / static_cast<double>(count)))) +
+            offset);
     }
-
-    return smoothed;
 }
 
 double clamp01(double value) { return std::clamp(value, 0.0, 1.0); }
@@ -119,62 +91,211 @@ double computeCenterAlignment(const std::vector<RowExtent> &extents, int image_w
     return 1.0 - clamp01(delta / std::max(1.0, center_x));
 }
 
-std::optional<CandidateComponent> selectBestComponent(const cv::Mat &binary_mask, double min_area) {
+double scoreComponent(double area, const cv::Rect &bounds, std::size_t extent_count,
+                      double center_alignment, const cv::Size &mask_size) {
+    const double roi_area = static_cast<double>(mask_size.height * mask_size.width);
+    const double area_score = clamp01(area / std::max(1.0, roi_area * 0.35));
+    const double vertical_span = clamp01(
+        static_cast<double>(bounds.height) / std::max(1.0, static_cast<double>(mask_size.height)));
+    const double scanline_coverage = clamp01(
+        static_cast<double>(extent_count) /
+        std::max(1.0, static_cast<double>(mask_size.height) / static_cast<double>(kScanlineStep)));
+    return (0.40 * area_score) + (0.25 * vertical_span) + (0.20 * scanline_coverage) +
+           (0.15 * center_alignment);
+}
+
+// Uma unica passada pelas linhas amostradas de labels acumula, para todos os
+// candidatos ao mesmo tempo, o primeiro e o ultimo x de cada componente por linha.
+void collectCandidateRowExtents(const cv::Mat &labels, int step, int candidate_count,
+                                BoundaryAnalyzerBuffers &buffers) {
+    const int sampled_rows = (labels.rows + step - 1) / step;
+    buffers.row_extents.assign(static_cast<std::size_t>(sampled_rows * candidate_count),
+                               cv::Vec2i(-1, -1));
+    const int *slots = buffers.candidate_slots.data();
+
+    for (int row_index = 0; row_index < sampled_rows; ++row_index) {
+        const int *row = labels.ptr<int>(row_index * step);
+        cv::Vec2i *extents = buffers.row_extents.data() + row_index * candidate_count;
+        for (int x = 0; x < labels.cols; ++x) {
+            const int slot = slots[row[x]];
+            if (slot < 0) {
+                continue;
+            }
+
+            cv::Vec2i &extent = extents[slot];
+            if (extent[0] < 0) {
+                extent[0] = x;
+            }
+            extent[1] = x;
+        }
+    }
+}
+
+std::optional<CandidateComponent> selectBestComponent(const cv::Mat &binary_mask, double min_area,
+                                                      BoundaryAnalyzerBuffers &buffers) {
     if (binary_mask.empty()) {
         return std::nullopt;
     }
 
-    cv::Mat labels;
-    cv::Mat stats;
-    cv::Mat centroids;
-    const int component_count =
-        cv::connectedComponentsWithStats(binary_mask, labels, stats, centroids, 8, CV_32S);
+    const cv::Mat &labels = buffers.labels;
+    const cv::Mat &stats = buffers.stats;
+    const int component_count = cv::connectedComponentsWithStats(
+        binary_mask, buffers.labels, buffers.stats, buffers.centroids, 8, CV_32S);
     if (component_count <= 1) {
         return std::nullopt;
     }
 
-    const double roi_area = static_cast<double>(binary_mask.rows * binary_mask.cols);
-    const int scanline_step = 4;
+    buffers.candidate_slots.assign(static_cast<std::size_t>(component_count), -1);
+    int candidate_count = 0;
+    for (int label = 1; label < component_count; ++label) {
+        if (static_cast<double>(stats.at<int>(label, cv::CC_STAT_AREA)) >= min_area) {
+            buffers.candidate_slots[label] = candidate_count++;
+        }
+    }
+    if (candidate_count == 0) {
+        return std::nullopt;
+    }
+
+    collectCandidateRowExtents(labels, kScanlineStep, candidate_count, buffers);
+    const int sampled_rows = static_cast<int>(buffers.row_extents.size()) / candidate_count;
 
+    // O candidato em teste monta as extensoes em scan_extents; o melhor ate agora fica em extents.
     std::optional<CandidateComponent> best;
+    std::vector<RowExtent> &extents = buffers.scan_extents;
     for (int label = 1; label < component_count; ++label) {
-        const double area = static_cast<double>(stats.at<int>(label, cv::CC_STAT_AREA));
-        if (area < min_area) {
+        const int slot = buffers.candidate_slots[label];
+        if (slot < 0) {
             continue;
         }
 
-        cv::Mat component_mask;
-        cv::compare(labels, label, component_mask, cv::CMP_EQ);
-        const std::vector<RowExtent> extents = collectRowExtents(component_mask, scanline_step);
+        extents.clear();
+        for (int row_index = 0; row_index < sampled_rows; ++row_index) {
+            const cv::Vec2i &extent = buffers.row_extents[row_index * candidate_count + slot];
+            if (extent[0] >= 0) {
+                extents.push_back({row_index * kScanlineStep, extent[0], extent[1]});
+            }
+        }
         if (extents.size() < 4) {
             continue;
         }
 
+        const double area = static_cast<double>(stats.at<int>(label, cv::CC_STAT_AREA));
         const cv::Rect bounds(stats.at<int>(label, cv::CC_STAT_LEFT),
                               stats.at<int>(label, cv::CC_STAT_TOP),
                               stats.at<int>(label, cv::CC_STAT_WIDTH),
                               stats.at<int>(label, cv::CC_STAT_HEIGHT));
-        const double area_score = clamp01(area / std::max(1.0, roi_area * 0.35));
-        const double vertical_span = clamp01(
-            static_cast<double>(bounds.height) / std::max(1.0, static_cast<double>(binary_mask.rows)));
-        const double scanline_coverage = clamp01(
-            static_cast<double>(extents.size()) /
-            std::max(1.0, static_cast<double>(binary_mask.rows) / static_cast<double>(scanline_step)));
         const double center_alignment = computeCenterAlignment(extents, binary_mask.cols);
         const double score =
-            (0.40 * area_score) + (0.25 * vertical_span) + (0.20 * scanline_coverage) +
-            (0.15 * center_alignment);
+            scoreComponent(area, bounds, extents.size(), center_alignment, binary_mask.size());
 
         if (!best || score > best->score) {
             best = CandidateComponent{
-                component_mask, extents, area, bounds, score, center_alignment,
+                label, area, bounds, score, center_alignment,
             };
+            buffers.extents.swap(extents);
         }
     }
 
     return best;
 }
 
+// Procura cada borda apenas em uma janela de +/- band_px em torno da borda do frame
+// anterior. Linhas sem semente usam a linha rastreada mais proxima, o que permite ao
+// corredor crescer aos poucos. A borda precisa ser uma transicao fundo -> faixa de verdade:
+// se a faixa continua alem do limite da janela, ou se so uma das bordas cai na janela, ela
+// andou mais que band_px e o rastreamento desiste para a busca completa.
+std::optional<CandidateComponent> trackComponent(const cv::Mat &binary_mask,
+                                                 const std::vector<RowExtent> &previous, int band_px,
+                                                 std::vector<RowExtent> &extents) {
+    extents.clear();
+    if (binary_mask.empty() || previous.empty()) {
+        return std::nullopt;
+    }
+
+    CandidateComponent candidate;
+    std::size_t seed_index = 0;
+    int min_x = binary_mask.cols;
+    int max_x = -1;
+    for (int y = 0; y < binary_mask.rows; y += kScanlineStep) {
+        while (seed_index + 1 < previous.size() &&
+               std::abs(previous[seed_index + 1].y - y) <= std::abs(previous[seed_index].y - y)) {
+            ++seed_index;
+        }
+
+        const RowExtent &seed = previous[seed_index];
+        const auto *row = binary_mask.ptr<uchar>(y);
+        int left = -1;
+        const int left_start = std::max(0, seed.left - band_px);
+        const int left_end = std::min(binary_mask.cols - 1, seed.left + band_px);
+        for (int x = left_start; x <= left_end; ++x) {
+            if (row[x] > 0) {
+                left = x;
+                break;
+            }
+        }
+        if (left == left_start && left > 0 && row[left - 1] > 0) {
+            return std::nullopt;
+        }
+
+        int right = -1;
+        const int right_start = std::min(binary_mask.cols - 1, seed.right + band_px);
+        const int right_end = std::max(0, seed.right - band_px);
+        for (int x = right_start; x >= right_end; --x) {
+            if (row[x] > 0) {
+                right = x;
+                break;
+            }
+        }
+        if (right == right_start && right >= 0 && right + 1 < binary_mask.cols &&
+            row[right + 1] > 0) {
+            return std::nullopt;
+        }
+
+        // So uma das bordas na janela: a outra saiu dela.
+        if ((left < 0) != (right < 0)) {
+            return std::nullopt;
+        }
+        if (left < 0 || right <= left) {
+            continue;
+        }
+
+        extents.push_back({y, left, right});
+        candidate.area += static_cast<double>((right - left + 1) * kScanlineStep);
+        min_x = std::min(min_x, left);
+        max_x = std::max(max_x, right);
+    }
+
+    if (extents.size() < 4) {
+        return std::nullopt;
+    }
+
+    const int top = extents.front().y;
+    const int bottom = std::min(binary_mask.rows, extents.back().y + kScanlineStep);
+    candidate.bounds = cv::Rect(min_x, top, max_x - min_x + 1, bottom - top);
+    candidate.center_alignment = computeCenterAlignment(extents, binary_mask.cols);
+    candidate.score = scoreComponent(candidate.area, candidate.bounds, extents.size(),
+                                     candidate.center_alignment, binary_mask.size());
+    return candidate;
+}
+
+void materializeTrackedMask(const cv::Mat &binary_mask, const std::vector<RowExtent> &extents,
+                            std::vector<cv::Point> &polygon, cv::Mat &output) {
+    polygon.clear();
+    for (const RowExtent &extent : extents) {
+        polygon.emplace_back(extent.left, extent.y);
+    }
+    for (auto it = extents.rbegin(); it != extents.rend(); ++it) {
+        polygon.emplace_back(it->right, it->y);
+    }
+
+    output.create(binary_mask.size(), CV_8UC1);
+    output.setTo(cv::Scalar(0));
+    const cv::Point *points = polygon.data();
+    const int point_count = static_cast<int>(polygon.size());
+    cv::fillPoly(output, &points, &point_count, 1, cv::Scalar(255));
+    cv::bitwise_and(output, binary_mask, output);
+}
+
 LaneBoundarySegment summarizeBoundary(const std::vector<cv::Point> &points) {
     LaneBoundarySegment boundary;
     if (points.size() < 2) {
@@ -187,14 +308,55 @@ LaneBoundarySegment summarizeBoundary(const std::vector<cv::Point> &points) {
     return boundary;
 }
 
+// Zera o resultado mas devolve aos vetores a capacidade que ja tinham.
+void resetKeepingStorage(RoadSegmentationResult &result) {
+    std::vector<cv::Point> *const point_lists[] = {
+        &result.left_boundary_points, &result.right_boundary_points, &result.centerline_points,
+        &result.road_polygon_points,  &result.roi_polygon_points,    &result.hood_mask_polygon_points,
+    };
+    std::vector<cv::Point> kept[std::size(point_lists)];
+    for (std::size_t index = 0; index < std::size(point_lists); ++index) {
+        kept[index].swap(*point_lists[index]);
+        kept[index].clear();
+    }
+    std::string segmentation_mode = std::move(result.segmentation_mode);
+
+    result = RoadSegmentationResult{};
+    for (std::size_t index = 0; index < std::size(point_lists); ++index) {
+        point_lists[index]->swap(kept[index]);
+    }
+    result.segmentation_mode = std::move(segmentation_mode);
+}
+
 } // namespace
 
-BoundaryAnalyzer::BoundaryAnalyzer(double min_contour_area) : min_contour_area_(min_contour_area) {}
+BoundaryAnalyzer::BoundaryAnalyzer(double min_contour_area, const BoundaryTrackingConfig &tracking)
+    : min_contour_area_(min_contour_area), tracking_(tracking) {}
+
+void BoundaryAnalyzer::resetTracking() noexcept {
+    tracked_extents_.clear();
+    tracked_size_ = {};
+    tracked_confidence_ = 0.0;
+}
 
 RoadSegmentationResult BoundaryAnalyzer::analyze(const cv::Mat &mask, const cv::Size &frame_size,
                                                  const cv::Rect &roi_rect,
-                                                 const std::string &segmentation_mode) const {
+                                                 const std::string &segmentation_mode,
+                                                 BoundaryAnalyzerBuffers *buffers,
+                                                 bool materialize_mask, int mask_scale,
+                                                 const RowExtentRefiner &refine_extents) {
     RoadSegmentationResult result;
+    analyze(mask, frame_size, roi_rect, segmentation_mode, result, buffers, materialize_mask,
+            mask_scale, refine_extents);
+    return result;
+}
+
+void BoundaryAnalyzer::analyze(const cv::Mat &mask, const cv::Size &frame_size,
+                               const cv::Rect &roi_rect, const std::string &segmentation_mode,
+                               RoadSegmentationResult &result, BoundaryAnalyzerBuffers *buffers,
+                               bool materialize_mask, int mask_scale,
+                               const RowExtentRefiner &refine_extents) {
+    resetKeepingStorage(result);
     result.segmentation_mode = segmentation_mode;
     result.roi_rect = roi_rect;
 
@@ -205,7 +367,7 @@ RoadSegmentationResult BoundaryAnalyzer::analyze(const cv::Mat &mask, const cv::
     result.lane_center = result.frame_center;
 
     if (mask.empty() || roi_rect.width <= 0 || roi_rect.height <= 0) {
-        return result;
+        return;
     }
 
     cv::Mat single_channel;
@@ -215,24 +377,73 @@ RoadSegmentationResult BoundaryAnalyzer::analyze(const cv::Mat &mask, const cv::
         cv::cvtColor(mask, single_channel, cv::COLOR_BGR2GRAY);
     }
 
-    const auto candidate = selectBestComponent(single_channel, min_contour_area_);
+    BoundaryAnalyzerBuffers local_buffers;
+    BoundaryAnalyzerBuffers &scratch = buffers ? *buffers : local_buffers;
+    std::optional<CandidateComponent> candidate;
+    if (tracking_.enabled && tracked_size_ == single_channel.size()) {
+        candidate =
+            trackComponent(single_channel, tracked_extents_, tracking_.band_px, scratch.extents);
+        if (candidate && candidate->area >= min_contour_area_ &&
+            candidate->score >= tracking_.min_confidence) {
+            result.tracking_active = true;
+        } else {
+            candidate.reset();
+        }
+    }
+    if (!candidate) {
+        candidate = selectBestComponent(single_channel, min_contour_area_, scratch);
+    }
     if (!candidate) {
-        return result;
+        resetTracking();
+        return;
     }
-    result.mask_area_px = candidate->area;
+
+    if (tracking_.enabled) {
+        if (result.tracking_active) {
+            candidate->score = (kTrackedConfidenceSmoothing * tracked_confidence_) +
+                               ((1.0 - kTrackedConfidenceSmoothing) * candidate->score);
+        }
+        tracked_extents_ = scratch.extents;
+        tracked_size_ = single_channel.size();
+        tracked_confidence_ = candidate->score;
+    }
+
+    mask_scale = std::max(1, mask_scale);
+    result.mask_area_px = candidate->area * static_cast<double>(mask_scale * mask_scale);
     result.confidence_score = clamp01(candidate->score);
-    result.mask_frame = candidate->mask.clone();
+    if (materialize_mask) {
+        if (result.tracking_active) {
+            materializeTrackedMask(single_channel, scratch.extents, scratch.polygon,
+                                   scratch.best_component_mask);
+        } else {
+            cv::compare(scratch.labels, candidate->label, scratch.best_component_mask, cv::CMP_EQ);
+        }
+        result.mask_frame = scratch.best_component_mask;
+    }
+
+    std::vector<RowExtent> &extents = scratch.extents;
+    if (mask_scale > 1) {
+        for (RowExtent &extent : extents) {
+            extent.y = std::min(roi_rect.height - 1, extent.y * mask_scale + mask_scale / 2);
+            extent.left *= mask_scale;
+            extent.right = std::min(roi_rect.width - 1, extent.right * mask_scale + mask_scale - 1);
+        }
+        if (refine_extents) {
+            refine_extents(extents);
+        }
+    }
 
     const cv::Point origin(roi_rect.x, roi_rect.y);
-    std::vector<cv::Point> left_local;
-    std::vector<cv::Point> right_local;
-    std::vector<cv::Point> center_local;
-    std::vector<double> widths;
-    left_local.reserve(candidate->extents.size());
-    right_local.reserve(candidate->extents.size());
-    center_local.reserve(candidate->extents.size());
-
-    for (const RowExtent &extent : candidate->extents) {
+    std::vector<cv::Point> &left_local = scratch.left_points;
+    std::vector<cv::Point> &right_local = scratch.right_points;
+    std::vector<cv::Point> &center_local = scratch.center_points;
+    std::vector<double> &widths = scratch.widths;
+    left_local.clear();
+    right_local.clear();
+    center_local.clear();
+    widths.clear();
+
+    for (const RowExtent &extent : extents) {
         if (extent.right <= extent.left) {
             continue;
         }
@@ -247,22 +458,9 @@ RoadSegmentationResult BoundaryAnalyzer::analyze(const cv::Mat &mask, const cv::
         widths.push_back(static_cast<double>(extent.right - extent.left));
     }
 
-    left_local = smoothPoints(left_local, 5);
-    right_local = smoothPoints(right_local, 5);
-    center_local = smoothPoints(center_local, 5);
-
-    result.left_boundary_points.reserve(left_local.size());
-    result.right_boundary_points.reserve(right_local.size());
-    result.centerline_points.reserve(center_local.size());
-    for (const cv::Point &point : left_local) {
-        result.left_boundary_points.emplace_back(point + origin);
-    }
-    for (const cv::Point &point : right_local) {
-        result.right_boundary_points.emplace_back(point + origin);
-    }
-    for (const cv::Point &point : center_local) {
-        result.centerline_points.emplace_back(point + origin);
-    }
+    smoothPoints(left_local, 5, origin, result.left_boundary_points);
+    smoothPoints(right_local, 5, origin, result.right_boundary_points);
+    smoothPoints(center_local, 5, origin, result.centerline_points);
 
     result.left_boundary = summarizeBoundary(result.left_boundary_points);
     result.right_boundary = summarizeBoundary(result.right_boundary_points);
@@ -286,7 +484,7 @@ RoadSegmentationResult BoundaryAnalyzer::analyze(const cv::Mat &mask, const cv::
             static_cast<int>(std::lround(lane_center_y / static_cast<double>(tail_count))));
     }
 
-    result.lane_width_px = average(widths, static_cast<double>(candidate->bounds.width));
+    result.lane_width_px = average(widths, static_cast<double>(candidate->bounds.width * mask_scale));
     result.lateral_offset_px = static_cast<double>(result.lane_center.x) - frame_center_x;
     if (frame_size.width > 1) {
         result.lane_center_ratio = std::clamp(
@@ -300,7 +498,6 @@ RoadSegmentationResult BoundaryAnalyzer::analyze(const cv::Mat &mask, const cv::
 
     result.lane_found = result.left_boundary.valid && result.right_boundary.valid &&
                         result.road_polygon_points.size() >= 6 && result.confidence_score >= 0.25;
-    return result;
 }
 
 } // namespace road_segmentation_lab::pipeline
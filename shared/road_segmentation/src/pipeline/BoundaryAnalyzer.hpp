@@ -2,22 +2,76 @@
 
 #include <opencv2/core.hpp>
 
+#include <functional>
 #include <string>
+#include <vector>
 
 #include "pipeline/RoadSegmentationResult.hpp"
 
 namespace road_segmentation_lab::pipeline {
 
+struct RowExtent {
+    int y{0};
+    int left{-1};
+    int right{-1};
+};
+
+// Recebe as extensoes por linha ja em coordenadas da ROI em resolucao cheia e pode
+// ajusta-las no lugar (usado pelo modo piramide).
+using RowExtentRefiner = std::function<void(std::vector<RowExtent> &extents)>;
+
+struct BoundaryTrackingConfig {
+    bool enabled{false};
+    int band_px{24};
+    double min_confidence{0.45};
+};
+
+// Tudo o que a analise de um frame usa como rascunho; reaproveitado entre frames, nao aloca
+// depois que as capacidades se estabilizam.
+struct BoundaryAnalyzerBuffers {
+    cv::Mat labels;
+    cv::Mat stats;
+    cv::Mat centroids;
+    cv::Mat best_component_mask;
+    std::vector<int> candidate_slots;
+    std::vector<cv::Vec2i> row_extents;
+    std::vector<RowExtent> extents;
+    std::vector<RowExtent> scan_extents;
+    std::vector<cv::Point> left_points;
+    std::vector<cv::Point> right_points;
+    std::vector<cv::Point> center_points;
+    std::vector<cv::Point> polygon;
+    std::vector<double> widths;
+};
+
 class BoundaryAnalyzer {
   public:
-    explicit BoundaryAnalyzer(double min_contour_area = 400.0);
+    explicit BoundaryAnalyzer(double min_contour_area = 400.0,
+                              const BoundaryTrackingConfig &tracking = {});
 
+    // Com o rastreamento ativo, as bordas do frame anterior definem um corredor de
+    // busca; a analise completa de componentes so roda quando a confianca cai.
+    // mask_scale > 1 indica uma mascara reduzida em relacao a roi_rect.
     RoadSegmentationResult analyze(const cv::Mat &mask, const cv::Size &frame_size,
                                    const cv::Rect &roi_rect,
-                                   const std::string &segmentation_mode) const;
+                                   const std::string &segmentation_mode,
+                                   BoundaryAnalyzerBuffers *buffers = nullptr,
+                                   bool materialize_mask = true, int mask_scale = 1,
+                                   const RowExtentRefiner &refine_extents = {});
+    // Mesmo resultado, escrito em result: os vetores de pontos mantem a capacidade do frame
+    // anterior.
+    void analyze(const cv::Mat &mask, const cv::Size &frame_size, const cv::Rect &roi_rect,
+                 const std::string &segmentation_mode, RoadSegmentationResult &result,
+                 BoundaryAnalyzerBuffers *buffers = nullptr, bool materialize_mask = true,
+                 int mask_scale = 1, const RowExtentRefiner &refine_extents = {});
+    void resetTracking() noexcept;
 
   private:
     double min_contour_area_{400.0};
+    BoundaryTrackingConfig tracking_;
+    std::vector<RowExtent> tracked_extents_;
+    cv::Size tracked_size_;
+    double tracked_confidence_{0.0};
 };
 
 } // namespace road_segmentation_lab::pipeline
@@ -0,0 +1,133 @@
+#include "pipeline/FramePool.hpp"
+
+#include <algorithm>
+
+namespace road_segmentation_lab::pipeline {
+
+FramePool &FramePool::shared() {
+    // Propositalmente nunca destruido: cv::Mat estaticos ou de threads ainda vivas no
+    // encerramento podem devolver blocos depois do fim de main.
+    static FramePool *pool = new FramePool();
+    return *pool;
+}
+
+FramePool::FramePool(std::size_t max_free_blocks) : max_free_blocks_(max_free_blocks) {}
+
+FramePool::~FramePool() { trim(); }
+
+cv::UMatData *FramePool::allocate(int dims, const int *sizes, int type, void *data, size_t *step,
+                                  cv::AccessFlag /*flags*/, cv::UMatUsageFlags /*usage*/) const {
+    // Mesmo calculo de passos do StdMatAllocator do OpenCV.
+    size_t total = CV_ELEM_SIZE(type);
+    for (int index = dims - 1; index >= 0; --index) {
+        if (step != nullptr) {
+            if (data != nullptr && step[index] != CV_AUTOSTEP) {
+                CV_Assert(total <= step[index]);
+                total = step[index];
+            } else {
+                step[index] = total;
+            }
+        }
+        total *= static_cast<size_t>(sizes[index]);
+    }
+
+    auto *umat = new cv::UMatData(this);
+    umat->data = umat->origdata = data != nullptr ? static_cast<uchar *>(data) : takeBlock(total);
+    umat->size = total;
+    if (data != nullptr) {
+        umat->flags |= cv::UMatData::USER_ALLOCATED;
+    }
+    return umat;
+}
+
+bool FramePool::allocate(cv::UMatData *data, cv::AccessFlag /*flags*/,
+                         cv::UMatUsageFlags /*usage*/) const {
+    return data != nullptr;
+}
+
+void FramePool::deallocate(cv::UMatData *data) const {
+    if (data == nullptr) {
+        return;
+    }
+
+    CV_Assert(data->urefcount == 0);
+    CV_Assert(data->refcount == 0);
+    if (!(data->flags & cv::UMatData::USER_ALLOCATED)) {
+        returnBlock(data->origdata, data->size);
+        data->origdata = nullptr;
+    }
+    delete data;
+}
+
+void FramePool::bind(cv::Mat &mat) const { mat.allocator = const_cast<FramePool *>(this); }
+
+bool FramePool::owns(const cv::Mat &mat) const noexcept {
+    return mat.u != nullptr && mat.u->currAllocator == this;
+}
+
+cv::Mat FramePool::copyOf(const cv::Mat &source) const {
+    cv::Mat copy;
+    bind(copy);
+    source.copyTo(copy);
+    return copy;
+}
+
+std::size_t FramePool::allocations() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return allocations_;
+}
+
+std::size_t FramePool::reuses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return reuses_;
+}
+
+std::size_t FramePool::freeBlocks() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return free_blocks_.size();
+}
+
+void FramePool::trim() {
+    std::vector<std::pair<std::size_t, uchar *>> released;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        released.swap(free_blocks_);
+    }
+    for (const auto &block : released) {
+        cv::fastFree(block.second);
+    }
+}
+
+uchar *FramePool::takeBlock(std::size_t size) const {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = std::find_if(free_blocks_.begin(), free_blocks_.end(),
+                                     [size](const auto &block) { return block.first == size; });
+        if (it != free_blocks_.end()) {
+            uchar *block = it->second;
+            free_blocks_.erase(it);
+            ++reuses_;
+            return block;
+        }
+        ++allocations_;
+    }
+    return static_cast<uchar *>(cv::fastMalloc(size));
+}
+
+void FramePool::returnBlock(uchar *block, std::size_t size) const {
+    uchar *evicted = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        free_blocks_.emplace_back(size, block);
+        if (free_blocks_.size() > max_free_blocks_) {
+            // Descarta o bloco livre mais antigo; tamanhos que sairam de uso somem primeiro.
+            evicted = free_blocks_.front().second;
+            free_blocks_.erase(free_blocks_.begin());
+        }
+    }
+    if (evicted != nullptr) {
+        cv::fastFree(evicted);
+    }
+}
+
+} // namespace road_segmentation_lab::pipeline
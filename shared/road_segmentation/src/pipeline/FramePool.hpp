@@ -0,0 +1,58 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+
+#include <cstddef>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace road_segmentation_lab::pipeline {
+
+// Alocador de cv::Mat que recicla blocos por tamanho exato. O refcount do cv::Mat faz o papel
+// de contador de leitores: quando o ultimo dono (workspace, resultado retido, job de placas)
+// solta o buffer, o bloco volta para a lista livre em vez de ir para o free(). Como os frames
+// do pipeline tem poucos tamanhos fixos, em regime nenhum frame chega ao malloc.
+//
+// Um cv::Mat usa o pool a partir do proximo create() depois de bind(). A instancia de shared()
+// nunca e destruida, entao um buffer pode sobreviver ao pipeline que o criou.
+class FramePool : public cv::MatAllocator {
+  public:
+    static constexpr std::size_t kDefaultMaxFreeBlocks = 64;
+
+    static FramePool &shared();
+
+    explicit FramePool(std::size_t max_free_blocks = kDefaultMaxFreeBlocks);
+    ~FramePool() override;
+
+    FramePool(const FramePool &) = delete;
+    FramePool &operator=(const FramePool &) = delete;
+
+    cv::UMatData *allocate(int dims, const int *sizes, int type, void *data, size_t *step,
+                           cv::AccessFlag flags, cv::UMatUsageFlags usage) const override;
+    bool allocate(cv::UMatData *data, cv::AccessFlag flags, cv::UMatUsageFlags usage) const override;
+    void deallocate(cv::UMatData *data) const override;
+
+    void bind(cv::Mat &mat) const;
+    bool owns(const cv::Mat &mat) const noexcept;
+    // Copia imutavel de source em um bloco do pool.
+    cv::Mat copyOf(const cv::Mat &source) const;
+
+    // Blocos pedidos ao malloc; fica estavel quando os frames passam a ser reciclados.
+    std::size_t allocations() const;
+    std::size_t reuses() const;
+    std::size_t freeBlocks() const;
+    void trim();
+
+  private:
+    uchar *takeBlock(std::size_t size) const;
+    void returnBlock(uchar *block, std::size_t size) const;
+
+    std::size_t max_free_blocks_;
+    mutable std::mutex mutex_;
+    mutable std::vector<std::pair<std::size_t, uchar *>> free_blocks_;
+    mutable std::size_t allocations_{0};
+    mutable std::size_t reuses_{0};
+};
+
+} // namespace road_segmentation_lab::pipeline
@@ -0,0 +1,143 @@
+#include "pipeline/FrameWorkspace.hpp"
+
+#include <algorithm>
+
+#include "pipeline/FramePool.hpp"
+#include "pipeline/stages/RoiStage.hpp"
+
+namespace road_segmentation_lab::pipeline {
+
+cv::Size FrameWorkspace::analysisSize(const cv::Size &roi_size, int pyramid_level) {
+    const int scale = 1 << std::clamp(pyramid_level, 0, 2);
+    return {std::max(1, roi_size.width / scale), std::max(1, roi_size.height / scale)};
+}
+
+void FrameWorkspace::reserve(const config::LabConfig &config) {
+    spatial = SpatialMaskCache{};
+    for (cv::Mat *buffer : trackedBuffers()) {
+        FramePool::shared().bind(*buffer);
+    }
+    if (!config.resize_enabled || config.target_width <= 0 || config.target_height <= 0) {
+        return;
+    }
+
+    const cv::Size frame_size(config.target_width, config.target_height);
+    const cv::Rect roi_rect =
+        stages::RoiStage(config.roi_top_ratio, config.roi_bottom_ratio).computeRect(frame_size);
+    if (roi_rect.width <= 0 || roi_rect.height <= 0) {
+        return;
+    }
+
+    const cv::Size full_roi_size = roi_rect.size();
+    const cv::Size roi_size = analysisSize(full_roi_size, config.pyramid_level);
+    if (config.pyramid_level > 0) {
+        pyramid_roi.create(roi_size, CV_8UC3);
+        pyramid_preprocessed.create(full_roi_size, CV_8UC3);
+        pyramid_mask.create(full_roi_size, CV_8UC1);
+    }
+    if (config.calibration_file.empty()) {
+        resized.create(frame_size, CV_8UC3);
+    } else {
+        corrected.create(frame_size, CV_8UC3);
+    }
+    if (config.gaussian_enabled) {
+        blurred.create(roi_size, CV_8UC3);
+    }
+    if (config.clahe_enabled) {
+        illuminated.create(roi_size, CV_8UC3);
+        lab_scratch.create(roi_size, CV_8UC3);
+        channel_scratch.create(roi_size, CV_8UC1);
+    }
+    switch (config.segmentation_mode) {
+    case config::SegmentationMode::HsvDark:
+        color_scratch.create(roi_size, CV_8UC3);
+        break;
+    case config::SegmentationMode::AdaptiveGray:
+        color_scratch.create(roi_size, CV_8UC1);
+        break;
+    case config::SegmentationMode::GrayThreshold:
+    case config::SegmentationMode::LabDark:
+        break;
+    }
+    segmentation_mask.create(roi_size, CV_8UC1);
+    if (config.morph_enabled) {
+        morphology_scratch.create(roi_size, CV_8UC1);
+        filtered_mask.create(roi_size, CV_8UC1);
+    }
+    spatial_mask.create(roi_size, CV_8UC1);
+    preprocessed.create(roi_size, CV_8UC3);
+    boundary.labels.create(roi_size, CV_32S);
+    boundary.best_component_mask.create(roi_size, CV_8UC1);
+}
+
+void FrameWorkspace::release() {
+    for (cv::Mat *buffer : trackedBuffers()) {
+        buffer->release();
+    }
+    boundary.stats.release();
+    boundary.centroids.release();
+    spatial = SpatialMaskCache{};
+    frame_start_state_ = {};
+}
+
+void FrameWorkspace::beginFrame() {
+    const auto buffers = trackedBuffers();
+    for (std::size_t index = 0; index < buffers.size(); ++index) {
+        cv::Mat &buffer = *buffers[index];
+        if (buffer.u != nullptr && buffer.u->refcount > 1) {
+            buffer.release();
+        }
+        FramePool::shared().bind(buffer);
+
+        frame_start_state_[index] = {buffer.u, buffer.data, buffer.size(), buffer.type()};
+    }
+}
+
+void FrameWorkspace::endFrame() {
+    const auto buffers = trackedBuffers();
+    last_frame_allocations_ = 0;
+    for (std::size_t index = 0; index < buffers.size(); ++index) {
+        const cv::Mat &buffer = *buffers[index];
+        const BufferState &before = frame_start_state_[index];
+        if (buffer.empty()) {
+            continue;
+        }
+
+        if (before.storage == nullptr || before.data != buffer.data ||
+            before.size != buffer.size() || before.type != buffer.type()) {
+            ++last_frame_allocations_;
+        }
+    }
+    total_allocations_ += last_frame_allocations_;
+}
+
+std::size_t FrameWorkspace::lastFrameAllocations() const noexcept { return last_frame_allocations_; }
+
+std::size_t FrameWorkspace::totalAllocations() const noexcept { return total_allocations_; }
+
+std::array<cv::Mat *, FrameWorkspace::kTrackedBufferCount> FrameWorkspace::trackedBuffers() {
+    return {
+        &resized,
+        &corrected,
+        &blurred,
+        &illuminated,
+        &lab_scratch,
+        &channel_scratch,
+        &color_scratch,
+        &segmentation_mask,
+        &morphology_scratch,
+        &filtered_mask,
+        &spatial_mask,
+        &preprocessed,
+        &boundary.labels,
+        &boundary.best_component_mask,
+        &pyramid_roi,
+        &pyramid_preprocessed,
+        &pyramid_mask,
+        &refine_blurred,
+        &refine_row,
+        &refine_scratch,
+    };
+}
+
+} // namespace road_segmentation_lab::pipeline
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+#include "config/LabConfig.hpp"
+#include "pipeline/BoundaryAnalyzer.hpp"
+
+namespace road_segmentation_lab::pipeline {
+
+// Poligonos e retangulos derivados da config para o tamanho de ROI corrente. A mascara
+// espacial em si fica em FrameWorkspace::spatial_mask.
+struct SpatialMaskCache {
+    cv::Size roi_size;
+    cv::Size analysis_size;
+    std::vector<cv::Point> roi_polygon;
+    std::vector<cv::Point> hood_polygon;
+    std::optional<cv::Rect> mask_rect;
+    cv::Mat refine_mask;
+    std::optional<cv::Rect> refine_rect;
+};
+
+// Buffers intermediarios reaproveitados entre frames pelo RoadSegmentationPipeline.
+// Um buffer ainda referenciado por um resultado retido e desacoplado no inicio do
+// frame seguinte, entao o chamador nunca ve seus dados sobrescritos. Os buffers saem do
+// FramePool::shared(): o substituto reaproveita um bloco ja devolvido por outro resultado.
+class FrameWorkspace {
+  public:
+    // Tamanho da ROI em que segmentacao, morfologia e analise rodam no modo piramide.
+    static cv::Size analysisSize(const cv::Size &roi_size, int pyramid_level);
+
+    void reserve(const config::LabConfig &config);
+    void release();
+
+    void beginFrame();
+    void endFrame();
+
+    std::size_t lastFrameAllocations() const noexcept;
+    std::size_t totalAllocations() const noexcept;
+
+    cv::Mat resized;
+    cv::Mat corrected;
+    cv::Mat blurred;
+    cv::Mat illuminated;
+    cv::Mat lab_scratch;
+    cv::Mat channel_scratch;
+    cv::Mat color_scratch;
+    cv::Mat segmentation_mask;
+    cv::Mat morphology_scratch;
+    cv::Mat filtered_mask;
+    cv::Mat spatial_mask;
+    cv::Mat preprocessed;
+    BoundaryAnalyzerBuffers boundary;
+    cv::Mat pyramid_roi;
+    cv::Mat pyramid_preprocessed;
+    cv::Mat pyramid_mask;
+    cv::Mat refine_blurred;
+    cv::Mat refine_row;
+    cv::Mat refine_scratch;
+    SpatialMaskCache spatial;
+
+  private:
+    static constexpr std::size_t kTrackedBufferCount = 20;
+
+    struct BufferState {
+        const cv::UMatData *storage{nullptr};
+        const uchar *data{nullptr};
+        cv::Size size;
+        int type{0};
+    };
+
+    std::array<cv::Mat *, kTrackedBufferCount> trackedBuffers();
+
+    std::array<BufferState, kTrackedBufferCount> frame_start_state_{};
+    std::size_t last_frame_allocations_{0};
+    std::size_t total_allocations_{0};
+};
+
+} // namespace road_segmentation_lab::pipeline
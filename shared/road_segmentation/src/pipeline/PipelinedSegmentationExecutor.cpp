@@ -0,0 +1,189 @@
+#include "pipeline/PipelinedSegmentationExecutor.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include "pipeline/FramePool.hpp"
+
+namespace road_segmentation_lab::pipeline {
+namespace {
+
+double elapsedMs(std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end) {
+    return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+} // namespace
+
+void PipelinedSegmentationExecutor::StageQueue::push(std::size_t slot_index) {
+    // O ring comporta todos os slots, entao o push nunca encontra a fila cheia.
+    ring_.push(slot_index);
+    {
+        // Sincroniza com um consumidor que acabou de ver a fila vazia e vai dormir.
+        std::lock_guard<std::mutex> lock(mutex_);
+    }
+    condition_.notify_one();
+}
+
+bool PipelinedSegmentationExecutor::StageQueue::tryPop(std::size_t &slot_index) {
+    return ring_.pop(slot_index);
+}
+
+bool PipelinedSegmentationExecutor::StageQueue::waitPop(std::size_t &slot_index,
+                                                        const std::atomic<bool> &stop_requested) {
+    while (!ring_.pop(slot_index)) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait(lock, [&] { return !ring_.empty() || stop_requested.load(); });
+        if (stop_requested.load()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void PipelinedSegmentationExecutor::StageQueue::notifyAll() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+    }
+    condition_.notify_all();
+}
+
+PipelinedSegmentationExecutor::PipelinedSegmentationExecutor(const config::LabConfig &config,
+                                                             std::size_t depth)
+    : pipeline_(config), slots_(std::clamp(depth, kMinDepth, kMaxDepth)) {
+    for (Slot &slot : slots_) {
+        slot.workspace.reserve(config);
+    }
+    for (std::size_t stage = 0; stage < kStageCount; ++stage) {
+        workers_[stage] = std::thread([this, stage] { runStage(stage); });
+    }
+}
+
+PipelinedSegmentationExecutor::~PipelinedSegmentationExecutor() {
+    stop_requested_.store(true);
+    for (StageQueue &queue : queues_) {
+        queue.notifyAll();
+    }
+    for (std::thread &worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+std::size_t PipelinedSegmentationExecutor::depth() const noexcept { return slots_.size(); }
+
+std::size_t PipelinedSegmentationExecutor::inFlight() const noexcept { return in_flight_; }
+
+bool PipelinedSegmentationExecutor::full() const noexcept { return in_flight_ >= slots_.size(); }
+
+std::string PipelinedSegmentationExecutor::calibrationStatus() const {
+    return pipeline_.calibrationStatus();
+}
+
+StageProfiler &PipelinedSegmentationExecutor::profiler() noexcept { return pipeline_.profiler(); }
+
+bool PipelinedSegmentationExecutor::submit(const cv::Mat &frame, CaptureRequest capture,
+                                           std::int64_t timestamp_ms) {
+    if (full()) {
+        return false;
+    }
+
+    const std::size_t slot_index = static_cast<std::size_t>(next_sequence_ % slots_.size());
+    Slot &slot = slots_[slot_index];
+    if (slot.input.u != nullptr && slot.input.u->refcount > 1) {
+        // Um resultado anterior ainda aponta para este frame (resize desligado).
+        slot.input.release();
+    }
+    FramePool::shared().bind(slot.input);
+    frame.copyTo(slot.input);
+    slot.capture = capture;
+    slot.result = RoadSegmentationResult{};
+    slot.error = nullptr;
+    slot.sequence = next_sequence_++;
+    slot.timestamp_ms = timestamp_ms;
+    slot.submitted = Clock::now();
+    ++in_flight_;
+    queues_[0].push(slot_index);
+    return true;
+}
+
+std::optional<PipelinedFrameResult> PipelinedSegmentationExecutor::tryPop() {
+    std::size_t slot_index = 0;
+    if (in_flight_ == 0 || !queues_[kStageCount].tryPop(slot_index)) {
+        return std::nullopt;
+    }
+    return finishSlot(slot_index);
+}
+
+PipelinedFrameResult PipelinedSegmentationExecutor::waitPop() {
+    if (in_flight_ == 0) {
+        throw std::logic_error("PipelinedSegmentationExecutor::waitPop sem frames em voo.");
+    }
+
+    std::size_t slot_index = 0;
+    if (!queues_[kStageCount].waitPop(slot_index, stop_requested_)) {
+        throw std::runtime_error("PipelinedSegmentationExecutor encerrado com frames em voo.");
+    }
+    return finishSlot(slot_index);
+}
+
+void PipelinedSegmentationExecutor::runStage(std::size_t stage) {
+    std::size_t slot_index = 0;
+    while (queues_[stage].waitPop(slot_index, stop_requested_)) {
+        Slot &slot = slots_[slot_index];
+        slot.started[stage] = Clock::now();
+        if (!slot.error) {
+            try {
+                executeStage(stage, slot);
+            } catch (...) {
+                slot.error = std::current_exception();
+                slot.state = PipelineFrame{};
+            }
+        }
+        slot.finished[stage] = Clock::now();
+        queues_[stage + 1].push(slot_index);
+    }
+}
+
+void PipelinedSegmentationExecutor::executeStage(std::size_t stage, Slot &slot) {
+    switch (stage) {
+    case 0:
+        pipeline_.prepareFrame(slot.input, slot.workspace, slot.state, slot.capture);
+        break;
+    case 1:
+        pipeline_.segmentFrame(slot.workspace, slot.state);
+        break;
+    default:
+        // So esta thread toca o BoundaryAnalyzer: o rastreamento ve os frames em ordem.
+        slot.result = pipeline_.analyzeFrame(slot.workspace, slot.state);
+        break;
+    }
+}
+
+PipelinedFrameResult PipelinedSegmentationExecutor::finishSlot(std::size_t slot_index) {
+    Slot &slot = slots_[slot_index];
+    --in_flight_;
+    if (slot.error) {
+        std::rethrow_exception(std::exchange(slot.error, nullptr));
+    }
+
+    PipelinedFrameResult output;
+    output.sequence = slot.sequence;
+    output.timestamp_ms = slot.timestamp_ms;
+    output.result = std::move(slot.result);
+    output.timing.prepare_ms = elapsedMs(slot.started[0], slot.finished[0]);
+    output.timing.segment_ms = elapsedMs(slot.started[1], slot.finished[1]);
+    output.timing.analyze_ms = elapsedMs(slot.started[2], slot.finished[2]);
+    output.timing.total_ms = elapsedMs(slot.submitted, slot.finished[kStageCount - 1]);
+    if (pipeline_.profiler().enabled()) {
+        pipeline_.profiler().record(ProfiledStage::Frame,
+                                    slot.finished[kStageCount - 1] - slot.submitted);
+    }
+    output.timing.added_latency_ms =
+        std::max(0.0, output.timing.total_ms - output.timing.prepare_ms - output.timing.segment_ms -
+                          output.timing.analyze_ms);
+    return output;
+}
+
+} // namespace road_segmentation_lab::pipeline
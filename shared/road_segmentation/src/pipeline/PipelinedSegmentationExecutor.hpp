@@ -0,0 +1,116 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "config/LabConfig.hpp"
+#include "pipeline/FrameWorkspace.hpp"
+#include "pipeline/RoadSegmentationPipeline.hpp"
+#include "pipeline/RoadSegmentationResult.hpp"
+#include "pipeline/SpscRing.hpp"
+
+namespace road_segmentation_lab::pipeline {
+
+struct PipelineStageTiming {
+    double prepare_ms{0.0};
+    double segment_ms{0.0};
+    double analyze_ms{0.0};
+    // Tempo parado nas filas entre grupos, somado ao custo dos estagios em total_ms.
+    double added_latency_ms{0.0};
+    double total_ms{0.0};
+};
+
+struct PipelinedFrameResult {
+    std::uint64_t sequence{0};
+    // O valor passado a submit(), devolvido com o resultado daquele frame.
+    std::int64_t timestamp_ms{0};
+    RoadSegmentationResult result;
+    PipelineStageTiming timing;
+};
+
+// Um grupo de estagios por thread interna, ate depth frames em voo e resultados na ordem de
+// submissao. submit() e os pops devem ser chamados sempre pela mesma thread.
+class PipelinedSegmentationExecutor {
+  public:
+    static constexpr std::size_t kMinDepth = 2;
+    static constexpr std::size_t kMaxDepth = 3;
+
+    PipelinedSegmentationExecutor(const config::LabConfig &config, std::size_t depth);
+    ~PipelinedSegmentationExecutor();
+
+    PipelinedSegmentationExecutor(const PipelinedSegmentationExecutor &) = delete;
+    PipelinedSegmentationExecutor &operator=(const PipelinedSegmentationExecutor &) = delete;
+
+    std::size_t depth() const noexcept;
+    std::size_t inFlight() const noexcept;
+    bool full() const noexcept;
+    std::string calibrationStatus() const;
+    StageProfiler &profiler() noexcept;
+
+    // Copia o frame para o proximo slot livre. Retorna false com depth frames em voo.
+    bool submit(const cv::Mat &frame, CaptureRequest capture = CaptureRequest::All,
+                std::int64_t timestamp_ms = 0);
+
+    // Resultado do frame mais antigo em voo; excecoes de um estagio sao relancadas aqui.
+    std::optional<PipelinedFrameResult> tryPop();
+    PipelinedFrameResult waitPop();
+
+  private:
+    using Clock = std::chrono::steady_clock;
+    static constexpr std::size_t kStageCount = 3;
+    static constexpr std::size_t kRingCapacity = 4;
+
+    struct Slot {
+        cv::Mat input;
+        CaptureRequest capture{CaptureRequest::All};
+        FrameWorkspace workspace;
+        PipelineFrame state;
+        RoadSegmentationResult result;
+        std::exception_ptr error;
+        std::uint64_t sequence{0};
+        std::int64_t timestamp_ms{0};
+        Clock::time_point submitted;
+        std::array<Clock::time_point, kStageCount> started{};
+        std::array<Clock::time_point, kStageCount> finished{};
+    };
+
+    class StageQueue {
+      public:
+        void push(std::size_t slot_index);
+        bool tryPop(std::size_t &slot_index);
+        bool waitPop(std::size_t &slot_index, const std::atomic<bool> &stop_requested);
+        void notifyAll();
+
+      private:
+        SpscRing<std::size_t, kRingCapacity> ring_;
+        std::mutex mutex_;
+        std::condition_variable condition_;
+    };
+
+    void runStage(std::size_t stage);
+    void executeStage(std::size_t stage, Slot &slot);
+    PipelinedFrameResult finishSlot(std::size_t slot_index);
+
+    RoadSegmentationPipeline pipeline_;
+    std::vector<Slot> slots_;
+    // queues_[i] alimenta o grupo i; queues_[kStageCount] devolve os slots prontos.
+    std::array<StageQueue, kStageCount + 1> queues_;
+    std::array<std::thread, kStageCount> workers_;
+    std::atomic<bool> stop_requested_{false};
+    std::uint64_t next_sequence_{0};
+    std::size_t in_flight_{0};
+};
+
+} // namespace road_segmentation_lab::pipeline
@@ -2,10 +2,15 @@
 
 #include <algorithm>
 #include <cmath>
+#include <functional>
+#include <optional>
+#include <utility>
 #include <vector>
 
 #include <opencv2/imgproc.hpp>
 
+#include "pipeline/FramePool.hpp"
+
 namespace road_segmentation_lab::pipeline {
 namespace {
 
@@ -52,41 +57,205 @@ std::vector<cv::Point> buildHoodMaskPolygon(const config::LabConfig &config, con
     return polygon;
 }
 
-cv::Mat buildSpatialMask(const cv::Size &size, const std::vector<cv::Point> &roi_polygon,
-                         const std::vector<cv::Point> &hood_polygon) {
-    cv::Mat spatial_mask(size, CV_8UC1, cv::Scalar(0));
+void fillPolygon(cv::Mat &image, const std::vector<cv::Point> &polygon, const cv::Scalar &color) {
+    const cv::Point *points = polygon.data();
+    const int point_count = static_cast<int>(polygon.size());
+    cv::fillPoly(image, &points, &point_count, 1, color);
+}
+
+void buildSpatialMask(const cv::Size &size, const std::vector<cv::Point> &roi_polygon,
+                      const std::vector<cv::Point> &hood_polygon, cv::Mat &spatial_mask) {
+    spatial_mask.create(size, CV_8UC1);
     if (!roi_polygon.empty()) {
-        std::vector<std::vector<cv::Point>> polygons = {roi_polygon};
-        cv::fillPoly(spatial_mask, polygons, cv::Scalar(255));
+        spatial_mask.setTo(cv::Scalar(0));
+        fillPolygon(spatial_mask, roi_polygon, cv::Scalar(255));
     } else {
         spatial_mask.setTo(cv::Scalar(255));
     }
 
     if (!hood_polygon.empty()) {
-        std::vector<std::vector<cv::Point>> polygons = {hood_polygon};
-        cv::fillPoly(spatial_mask, polygons, cv::Scalar(0));
+        fillPolygon(spatial_mask, hood_polygon, cv::Scalar(0));
+    }
+}
+
+std::optional<cv::Rect> spatialMaskRect(const cv::Size &size, const std::vector<cv::Point> &roi_polygon,
+                                        const std::vector<cv::Point> &hood_polygon) {
+    if (!hood_polygon.empty()) {
+        return std::nullopt;
+    }
+
+    if (roi_polygon.empty()) {
+        return cv::Rect(0, 0, size.width, size.height);
     }
 
-    return spatial_mask;
+    if (roi_polygon.size() != 4 || roi_polygon[0].x != roi_polygon[3].x ||
+        roi_polygon[1].x != roi_polygon[2].x || roi_polygon[0].y != roi_polygon[1].y ||
+        roi_polygon[2].y != roi_polygon[3].y) {
+        return std::nullopt;
+    }
+
+    const cv::Rect rect(cv::Point(roi_polygon[0].x, roi_polygon[0].y),
+                        cv::Point(roi_polygon[2].x + 1, roi_polygon[2].y + 1));
+    return rect & cv::Rect(0, 0, size.width, size.height);
 }
 
-cv::Mat maskColorFrame(const cv::Mat &frame, const cv::Mat &mask) {
+void clearOutsideRect(cv::Mat &image, const cv::Rect &rect) {
+    if (rect.y > 0) {
+        image.rowRange(0, rect.y).setTo(cv::Scalar::all(0));
+    }
+    if (rect.y + rect.height < image.rows) {
+        image.rowRange(rect.y + rect.height, image.rows).setTo(cv::Scalar::all(0));
+    }
+
+    cv::Mat rows = image.rowRange(rect.y, rect.y + rect.height);
+    if (rect.x > 0) {
+        rows.colRange(0, rect.x).setTo(cv::Scalar::all(0));
+    }
+    if (rect.x + rect.width < image.cols) {
+        rows.colRange(rect.x + rect.width, image.cols).setTo(cv::Scalar::all(0));
+    }
+}
+
+void applySpatialMask(cv::Mat &mask, const cv::Mat &spatial_mask, const std::optional<cv::Rect> &rect) {
+    if (rect) {
+        clearOutsideRect(mask, *rect);
+        return;
+    }
+
+    cv::bitwise_and(mask, spatial_mask, mask);
+}
+
+cv::Mat maskColorFrame(const cv::Mat &frame, const cv::Mat &mask, const std::optional<cv::Rect> &rect,
+                       cv::Mat &masked) {
     if (frame.empty()) {
         return cv::Mat();
     }
 
-    cv::Mat masked(frame.size(), frame.type(), cv::Scalar(0, 0, 0));
+    if (rect) {
+        frame.copyTo(masked);
+        clearOutsideRect(masked, *rect);
+        return masked;
+    }
+
+    masked.create(frame.size(), frame.type());
+    masked.setTo(cv::Scalar(0, 0, 0));
     frame.copyTo(masked, mask);
     return masked;
 }
 
-std::vector<cv::Point> translatePoints(const std::vector<cv::Point> &points, const cv::Point &offset) {
-    std::vector<cv::Point> translated;
-    translated.reserve(points.size());
+cv::Rect scaleRect(const cv::Rect &rect, const cv::Size &from, const cv::Size &to) {
+    const auto scale = [](int value, int from_extent, int to_extent, bool round_up) {
+        const long long scaled = static_cast<long long>(value) * to_extent;
+        return static_cast<int>(round_up ? (scaled + from_extent - 1) / from_extent : scaled / from_extent);
+    };
+    const cv::Point top_left(scale(rect.x, from.width, to.width, false),
+                             scale(rect.y, from.height, to.height, false));
+    const cv::Point bottom_right(scale(rect.x + rect.width, from.width, to.width, true),
+                                 scale(rect.y + rect.height, from.height, to.height, true));
+    return cv::Rect(top_left, bottom_right) & cv::Rect(0, 0, to.width, to.height);
+}
+
+// Kernel da resolucao cheia levado para o nivel da piramide; impar quando o filtro exige.
+cv::Size scaleKernel(const cv::Size &kernel, int scale, bool odd) {
+    const auto scaled = [&](int extent) {
+        const int value = std::max(1, static_cast<int>(std::lround(
+                                          static_cast<double>(extent) / static_cast<double>(scale))));
+        return odd && value % 2 == 0 ? value + 1 : value;
+    };
+    return {scaled(kernel.width), scaled(kernel.height)};
+}
+
+// Reposiciona cada borda vinda da mascara reduzida classificando, em resolucao cheia,
+// uma janela de uma linha em torno dela com o mesmo blur (kernel da resolucao cheia) e o
+// mesmo SegmentationStage. O blur le as linhas vizinhas da propria ROI, ja que a janela e uma
+// submatriz dela. Borda que cai no limite da janela (a janela inteira dentro da faixa) fica
+// com a posicao da mascara reduzida.
+struct EdgeRefinement {
+    const cv::Mat &roi;
+    const cv::Mat &spatial_mask;
+    const std::optional<cv::Rect> &spatial_rect;
+    const stages::GaussianStage &gaussian;
+    const stages::SegmentationStage &segmentation;
+    int band_px;
+    cv::Mat &blurred_row;
+    cv::Mat &row_mask;
+    cv::Mat &scratch;
+
+    void operator()(std::vector<RowExtent> &extents) const {
+        const int window = std::min(roi.cols, (2 * band_px) + 1);
+        for (RowExtent &extent : extents) {
+            const int left = refineEdge(extent.y, extent.left, window, true);
+            const int right = refineEdge(extent.y, extent.right, window, false);
+            if (right > left) {
+                extent.left = left;
+                extent.right = right;
+            }
+        }
+    }
+
+    int refineEdge(int y, int x, int window, bool first_dark) const {
+        const cv::Rect rect(std::clamp(x - (window / 2), 0, roi.cols - window), y, window, 1);
+        const cv::Mat pixels = gaussian.apply(roi(rect), blurred_row);
+        const cv::Mat row = segmentation.apply(pixels, row_mask, scratch,
+                                               spatial_mask.empty() ? cv::Mat() : spatial_mask(rect));
+        const auto *values = row.ptr<uchar>(0);
+        const auto inside = [&](int column) {
+            return values[column] > 0 && (!spatial_rect || spatial_rect->contains({rect.x + column, y}));
+        };
+
+        if (first_dark) {
+            for (int column = 0; column < window; ++column) {
+                if (inside(column)) {
+                    return column == 0 && rect.x > 0 ? x : rect.x + column;
+                }
+            }
+        } else {
+            for (int column = window - 1; column >= 0; --column) {
+                if (inside(column)) {
+                    return column == window - 1 && rect.x + window < roi.cols ? x : rect.x + column;
+                }
+            }
+        }
+        return x;
+    }
+};
+
+bool sharesStorage(const cv::Mat &lhs, const cv::Mat &rhs) {
+    return lhs.u != nullptr && lhs.u == rhs.u;
+}
+
+// Os buffers do workspace ja sao trocados quando retidos (FrameWorkspace::beginFrame), entao
+// so o que ainda aponta para o frame do chamador (resize desligado) precisa de copia propria.
+void detachFromInput(RoadSegmentationResult &result, const cv::Mat &input) {
+    if (sharesStorage(result.resized_frame, input)) {
+        result.resized_frame = FramePool::shared().copyOf(result.resized_frame);
+        if (!result.roi_frame.empty()) {
+            result.roi_frame = result.resized_frame(result.roi_rect);
+        }
+    }
+    if (sharesStorage(result.preprocessed_frame, input)) {
+        result.preprocessed_frame = FramePool::shared().copyOf(result.preprocessed_frame);
+    }
+    if (sharesStorage(result.mask_frame, input)) {
+        result.mask_frame = FramePool::shared().copyOf(result.mask_frame);
+    }
+}
+
+void translatePoints(const std::vector<cv::Point> &points, const cv::Point &offset,
+                     std::vector<cv::Point> &translated) {
+    translated.clear();
     for (const cv::Point &point : points) {
         translated.emplace_back(point + offset);
     }
-    return translated;
+}
+
+// Solta as imagens de um resultado reaproveitado antes do frame seguinte: se ainda
+// apontassem para o workspace, beginFrame veria o buffer compartilhado e o realocaria.
+void releaseImages(RoadSegmentationResult &result) {
+    result.resized_frame.release();
+    result.roi_frame.release();
+    result.preprocessed_frame.release();
+    result.mask_frame.release();
 }
 
 int ratioToAbsoluteY(double ratio, const cv::Rect &roi_rect) {
@@ -190,60 +359,227 @@ RoadSegmentationPipeline::RoadSegmentationPipeline(const config::LabConfig &conf
 }
 
 void RoadSegmentationPipeline::updateConfig(const config::LabConfig &config) {
+    const bool profiling_changed = config.profiling_enabled != config_.profiling_enabled;
     config_ = config;
     resize_stage_ =
         stages::ResizeStage(config_.resize_enabled, {config_.target_width, config_.target_height});
     undistort_stage_ = stages::UndistortStage(config_.calibration_file);
     roi_stage_ = stages::RoiStage(config_.roi_top_ratio, config_.roi_bottom_ratio);
-    gaussian_stage_ =
+    // Na piramide, blur e morfologia rodam com os kernels levados para a resolucao reduzida,
+    // para cobrir a mesma area da imagem original.
+    const int pyramid_scale = 1 << config_.pyramid_level;
+    gaussian_stage_ = stages::GaussianStage(
+        config_.gaussian_enabled, scaleKernel(config_.gaussian_kernel, pyramid_scale, true),
+        config_.gaussian_sigma / static_cast<double>(pyramid_scale));
+    refine_gaussian_stage_ =
         stages::GaussianStage(config_.gaussian_enabled, config_.gaussian_kernel, config_.gaussian_sigma);
     illumination_stage_ = stages::IlluminationStage(config_.clahe_enabled);
     segmentation_stage_ = stages::SegmentationStage(config_);
     morphology_stage_ =
-        stages::MorphologyStage(config_.morph_enabled, config_.morph_kernel, config_.morph_iterations);
-    boundary_analyzer_ = BoundaryAnalyzer(config_.min_contour_area);
+        stages::MorphologyStage(config_.morph_enabled,
+                                scaleKernel(config_.morph_kernel, pyramid_scale, false),
+                                config_.morph_iterations);
+    boundary_analyzer_ = BoundaryAnalyzer(
+        config_.min_contour_area / static_cast<double>(pyramid_scale * pyramid_scale),
+        {config_.tracking_enabled, config_.tracking_band_px, config_.tracking_min_confidence});
+    workspace_.reserve(config_);
+    // So segue o arquivo quando LANE_PROFILING_ENABLED muda: recarregar o mesmo arquivo nao
+    // desfaz um setEnabled() feito em runtime.
+    if (profiling_changed) {
+        profiler_.setEnabled(config_.profiling_enabled);
+    }
 }
 
 const config::LabConfig &RoadSegmentationPipeline::config() const noexcept { return config_; }
 
+const FrameWorkspace &RoadSegmentationPipeline::workspace() const noexcept { return workspace_; }
+
+StageProfiler &RoadSegmentationPipeline::profiler() noexcept { return profiler_; }
+
+const StageProfiler &RoadSegmentationPipeline::profiler() const noexcept { return profiler_; }
+
 std::string RoadSegmentationPipeline::calibrationStatus() const {
     return undistort_stage_.statusMessage();
 }
 
-RoadSegmentationResult RoadSegmentationPipeline::process(const cv::Mat &frame) const {
+void RoadSegmentationPipeline::refreshSpatialMask(FrameWorkspace &workspace, const cv::Size &roi_size,
+                                                  const cv::Size &analysis_size) const {
+    SpatialMaskCache &spatial = workspace.spatial;
+    if (roi_size == spatial.roi_size && analysis_size == spatial.analysis_size) {
+        return;
+    }
+
+    spatial.roi_polygon = buildRoiPolygon(config_, roi_size);
+    spatial.hood_polygon = buildHoodMaskPolygon(config_, roi_size);
+    spatial.refine_rect = spatialMaskRect(roi_size, spatial.roi_polygon, spatial.hood_polygon);
+    spatial.refine_mask.release();
+    if (spatial.refine_rect) {
+        spatial.mask_rect = scaleRect(*spatial.refine_rect, roi_size, analysis_size);
+        workspace.spatial_mask.release();
+    } else if (analysis_size == roi_size) {
+        spatial.mask_rect.reset();
+        buildSpatialMask(roi_size, spatial.roi_polygon, spatial.hood_polygon, workspace.spatial_mask);
+    } else {
+        spatial.mask_rect.reset();
+        buildSpatialMask(roi_size, spatial.roi_polygon, spatial.hood_polygon, spatial.refine_mask);
+        cv::resize(spatial.refine_mask, workspace.spatial_mask, analysis_size, 0.0, 0.0,
+                   cv::INTER_NEAREST);
+    }
+    spatial.roi_size = roi_size;
+    spatial.analysis_size = analysis_size;
+}
+
+RoadSegmentationResult RoadSegmentationPipeline::process(const cv::Mat &frame,
+                                                         CaptureRequest capture) {
     RoadSegmentationResult result;
+    process(frame, result, capture);
+    return result;
+}
+
+void RoadSegmentationPipeline::process(const cv::Mat &frame, RoadSegmentationResult &result,
+                                       CaptureRequest capture) {
+    const StageProfiler::Scope frame_scope(profiler_, ProfiledStage::Frame);
+    releaseImages(result);
+    PipelineFrame state;
+    prepareFrame(frame, workspace_, state, capture);
+    segmentFrame(workspace_, state);
+    analyzeFrame(workspace_, state, result);
+}
+
+void RoadSegmentationPipeline::prepareFrame(const cv::Mat &frame, FrameWorkspace &workspace,
+                                            PipelineFrame &state, CaptureRequest capture) {
+    state = PipelineFrame{};
+    state.capture = capture;
     if (frame.empty()) {
-        return result;
-    }
-
-    cv::Mat resized = resize_stage_.apply(frame);
-    cv::Mat corrected = undistort_stage_.apply(resized);
-
-    cv::Rect roi_rect;
-    cv::Mat roi = roi_stage_.apply(corrected, &roi_rect);
-    cv::Mat blurred = gaussian_stage_.apply(roi);
-    cv::Mat illuminated = illumination_stage_.apply(blurred);
-    const std::vector<cv::Point> roi_polygon = buildRoiPolygon(config_, roi.size());
-    const std::vector<cv::Point> hood_polygon = buildHoodMaskPolygon(config_, roi.size());
-    const cv::Mat spatial_mask = buildSpatialMask(roi.size(), roi_polygon, hood_polygon);
-    cv::Mat mask = segmentation_stage_.apply(illuminated);
-    cv::Mat masked_binary;
-    cv::bitwise_and(mask, spatial_mask, masked_binary);
-    cv::Mat filtered_mask = morphology_stage_.apply(masked_binary);
-    cv::bitwise_and(filtered_mask, spatial_mask, filtered_mask);
-
-    result = boundary_analyzer_.analyze(filtered_mask, corrected.size(), roi_rect,
-                                        segmentation_stage_.modeName());
-    result.resized_frame = corrected;
-    result.roi_frame = roi;
-    result.preprocessed_frame = maskColorFrame(illuminated, spatial_mask);
-    if (result.mask_frame.empty()) {
-        result.mask_frame = filtered_mask;
+        return;
+    }
+
+    workspace.beginFrame();
+    const StageProfiler::Scope scope(profiler_, ProfiledStage::Resize);
+    state.input = frame;
+    state.corrected =
+        undistort_stage_.isActive()
+            ? undistort_stage_.apply(frame, resize_stage_.outputSize(frame.size()), workspace.corrected)
+            : resize_stage_.apply(frame, workspace.resized);
+}
+
+void RoadSegmentationPipeline::segmentFrame(FrameWorkspace &workspace, PipelineFrame &state) {
+    if (state.corrected.empty()) {
+        return;
+    }
+
+    state.roi = roi_stage_.apply(state.corrected, &state.roi_rect);
+    state.pyramid_scale = state.roi.empty() ? 1 : 1 << config_.pyramid_level;
+    cv::Mat analysis_roi = state.roi;
+    if (state.pyramid_scale > 1) {
+        const StageProfiler::Scope scope(profiler_, ProfiledStage::Pyramid);
+        cv::resize(state.roi, workspace.pyramid_roi,
+                   FrameWorkspace::analysisSize(state.roi.size(), config_.pyramid_level), 0.0, 0.0,
+                   cv::INTER_AREA);
+        analysis_roi = workspace.pyramid_roi;
+    }
+
+    cv::Mat blurred;
+    {
+        const StageProfiler::Scope scope(profiler_, ProfiledStage::Gaussian);
+        blurred = gaussian_stage_.apply(analysis_roi, workspace.blurred);
+    }
+    {
+        const StageProfiler::Scope scope(profiler_, ProfiledStage::Illumination);
+        state.illuminated = illumination_stage_.apply(blurred, workspace.illuminated,
+                                                      workspace.lab_scratch, workspace.channel_scratch);
+    }
+
+    const StageProfiler::Scope scope(profiler_, ProfiledStage::Segmentation);
+    refreshSpatialMask(workspace, state.roi.size(), analysis_roi.size());
+    state.mask = segmentation_stage_.apply(state.illuminated, workspace.segmentation_mask,
+                                           workspace.color_scratch, workspace.spatial_mask);
+    if (workspace.spatial.mask_rect) {
+        clearOutsideRect(state.mask, *workspace.spatial.mask_rect);
     }
-    result.roi_polygon_points = translatePoints(roi_polygon, roi_rect.tl());
-    result.hood_mask_polygon_points = translatePoints(hood_polygon, roi_rect.tl());
-    populateLookaheadReferences(result, corrected.size(), config_);
+}
+
+RoadSegmentationResult RoadSegmentationPipeline::analyzeFrame(FrameWorkspace &workspace,
+                                                              PipelineFrame &state) {
+    RoadSegmentationResult result;
+    analyzeFrame(workspace, state, result);
     return result;
 }
 
+void RoadSegmentationPipeline::analyzeFrame(FrameWorkspace &workspace, PipelineFrame &state,
+                                            RoadSegmentationResult &result) {
+    if (state.corrected.empty()) {
+        result = RoadSegmentationResult{};
+        return;
+    }
+
+    const SpatialMaskCache &spatial = workspace.spatial;
+    cv::Mat filtered_mask;
+    {
+        const StageProfiler::Scope scope(profiler_, ProfiledStage::Morphology);
+        filtered_mask =
+            morphology_stage_.apply(state.mask, workspace.filtered_mask, workspace.morphology_scratch);
+        applySpatialMask(filtered_mask, workspace.spatial_mask, spatial.mask_rect);
+    }
+
+    const int pyramid_scale = state.pyramid_scale;
+    const bool mask_output_enabled = captures(state.capture, CaptureRequest::Mask);
+    const EdgeRefinement edge_refinement{
+        state.roi,
+        spatial.refine_mask,
+        spatial.refine_rect,
+        refine_gaussian_stage_,
+        segmentation_stage_,
+        config_.pyramid_refine_band_px,
+        workspace.refine_blurred,
+        workspace.refine_row,
+        workspace.refine_scratch,
+    };
+    // Uma linha isolada nao reproduz o CLAHE (histograma por blocos da imagem reduzida) nem o
+    // AdaptiveGray (limiar pela vizinhanca): nesses casos as bordas ficam as da mascara reduzida.
+    const bool refine_edges = pyramid_scale > 1 && !config_.clahe_enabled &&
+                              segmentation_stage_.classifiesPixelsIndependently();
+    {
+        const StageProfiler::Scope scope(profiler_, ProfiledStage::BoundaryAnalysis);
+        boundary_analyzer_.analyze(
+            filtered_mask, state.corrected.size(), state.roi_rect, segmentation_stage_.modeName(),
+            result, &workspace.boundary, mask_output_enabled, pyramid_scale,
+            refine_edges ? RowExtentRefiner(std::cref(edge_refinement)) : RowExtentRefiner());
+    }
+
+    // Imagens nao pedidas nem sao geradas: sem viewers, o frame so paga a geometria.
+    const StageProfiler::Scope scope(profiler_, ProfiledStage::Output);
+    if (captures(state.capture, CaptureRequest::Frame)) {
+        result.resized_frame = state.corrected;
+        result.roi_frame = state.roi;
+    }
+    if (captures(state.capture, CaptureRequest::Preprocessed)) {
+        result.preprocessed_frame = maskColorFrame(state.illuminated, workspace.spatial_mask,
+                                                   spatial.mask_rect, workspace.preprocessed);
+        if (pyramid_scale > 1 && !result.preprocessed_frame.empty()) {
+            cv::resize(result.preprocessed_frame, workspace.pyramid_preprocessed, state.roi.size(),
+                       0.0, 0.0, cv::INTER_LINEAR);
+            result.preprocessed_frame = workspace.pyramid_preprocessed;
+        }
+    }
+    if (mask_output_enabled && result.mask_frame.empty()) {
+        result.mask_frame = filtered_mask;
+    }
+    if (pyramid_scale > 1 && !result.mask_frame.empty()) {
+        cv::resize(result.mask_frame, workspace.pyramid_mask, state.roi.size(), 0.0, 0.0,
+                   cv::INTER_NEAREST);
+        result.mask_frame = workspace.pyramid_mask;
+    }
+    translatePoints(spatial.roi_polygon, state.roi_rect.tl(), result.roi_polygon_points);
+    translatePoints(spatial.hood_polygon, state.roi_rect.tl(), result.hood_mask_polygon_points);
+    populateLookaheadReferences(result, state.corrected.size(), config_);
+    const cv::Mat input = std::move(state.input);
+    state = PipelineFrame{};
+    workspace.endFrame();
+
+    if (!config_.frame_arena_enabled) {
+        detachFromInput(result, input);
+    }
+}
+
 } // namespace road_segmentation_lab::pipeline
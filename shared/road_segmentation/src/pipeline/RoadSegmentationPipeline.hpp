@@ -6,7 +6,9 @@
 
 #include "config/LabConfig.hpp"
 #include "pipeline/BoundaryAnalyzer.hpp"
+#include "pipeline/FrameWorkspace.hpp"
 #include "pipeline/RoadSegmentationResult.hpp"
+#include "pipeline/StageProfiler.hpp"
 #include "pipeline/stages/GaussianStage.hpp"
 #include "pipeline/stages/IlluminationStage.hpp"
 #include "pipeline/stages/MorphologyStage.hpp"
@@ -17,6 +19,19 @@
 
 namespace road_segmentation_lab::pipeline {
 
+// Estado intermediario de um frame entre os grupos de estagios. As Mats apontam para
+// buffers do FrameWorkspace usado no frame, exceto input, que e o frame do chamador.
+struct PipelineFrame {
+    cv::Mat input;
+    cv::Mat corrected;
+    cv::Rect roi_rect;
+    cv::Mat roi;
+    cv::Mat illuminated;
+    cv::Mat mask;
+    int pyramid_scale{1};
+    CaptureRequest capture{CaptureRequest::All};
+};
+
 class RoadSegmentationPipeline {
   public:
     RoadSegmentationPipeline();
@@ -26,18 +41,47 @@ class RoadSegmentationPipeline {
     const config::LabConfig &config() const noexcept;
     std::string calibrationStatus() const;
 
-    RoadSegmentationResult process(const cv::Mat &frame) const;
+    // Sem CaptureRequest::Mask, mask_frame fica vazio e o componente vencedor nao e
+    // materializado; sem Preprocessed, maskColorFrame nao roda.
+    RoadSegmentationResult process(const cv::Mat &frame,
+                                   CaptureRequest capture = CaptureRequest::All);
+    // Variante que reaproveita result (vetores de pontos e string) entre frames: com o arena
+    // ligado e sem filtros do OpenCV, o frame rastreado nao aloca nada no heap.
+    void process(const cv::Mat &frame, RoadSegmentationResult &result,
+                 CaptureRequest capture = CaptureRequest::All);
+    const FrameWorkspace &workspace() const noexcept;
+
+    // Tempo de cada estagio; liga com LANE_PROFILING_ENABLED ou setEnabled() em runtime.
+    // updateConfig so mexe no perfil quando LANE_PROFILING_ENABLED muda de valor.
+    StageProfiler &profiler() noexcept;
+    const StageProfiler &profiler() const noexcept;
+
+    // Grupos que process() encadeia; cada um so toca os proprios estagios e o workspace dado,
+    // entao grupos diferentes podem rodar em threads diferentes.
+    void prepareFrame(const cv::Mat &frame, FrameWorkspace &workspace, PipelineFrame &state,
+                      CaptureRequest capture = CaptureRequest::All);
+    void segmentFrame(FrameWorkspace &workspace, PipelineFrame &state);
+    RoadSegmentationResult analyzeFrame(FrameWorkspace &workspace, PipelineFrame &state);
+    void analyzeFrame(FrameWorkspace &workspace, PipelineFrame &state,
+                      RoadSegmentationResult &result);
 
   private:
+    void refreshSpatialMask(FrameWorkspace &workspace, const cv::Size &roi_size,
+                            const cv::Size &analysis_size) const;
+
     config::LabConfig config_;
+    FrameWorkspace workspace_;
     stages::ResizeStage resize_stage_{true, {320, 240}};
     stages::UndistortStage undistort_stage_;
     stages::RoiStage roi_stage_{0.5, 1.0};
     stages::GaussianStage gaussian_stage_{true, {5, 5}, 1.2};
+    // Blur com o kernel da resolucao cheia, usado no refinamento de bordas do modo piramide.
+    stages::GaussianStage refine_gaussian_stage_{true, {5, 5}, 1.2};
     stages::IlluminationStage illumination_stage_{false};
     stages::SegmentationStage segmentation_stage_{config_};
     stages::MorphologyStage morphology_stage_{true, {5, 5}, 1};
     BoundaryAnalyzer boundary_analyzer_{400.0};
+    StageProfiler profiler_;
 };
 
 } // namespace road_segmentation_lab::pipeline
@@ -7,6 +7,28 @@
 
 namespace road_segmentation_lab::pipeline {
 
+// Imagens de depuracao que o chamador vai desenhar. O que nao for pedido nao e produzido
+// nem retido no resultado; a geometria da faixa sai sempre.
+enum class CaptureRequest : unsigned {
+    None = 0,
+    Frame = 1u << 0,        // resized_frame e roi_frame
+    Preprocessed = 1u << 1, // preprocessed_frame
+    Mask = 1u << 2,         // mask_frame
+    All = (1u << 0) | (1u << 1) | (1u << 2),
+};
+
+constexpr CaptureRequest operator|(CaptureRequest lhs, CaptureRequest rhs) noexcept {
+    return static_cast<CaptureRequest>(static_cast<unsigned>(lhs) | static_cast<unsigned>(rhs));
+}
+
+constexpr CaptureRequest operator&(CaptureRequest lhs, CaptureRequest rhs) noexcept {
+    return static_cast<CaptureRequest>(static_cast<unsigned>(lhs) & static_cast<unsigned>(rhs));
+}
+
+constexpr bool captures(CaptureRequest request, CaptureRequest artifact) noexcept {
+    return (request & artifact) == artifact;
+}
+
 struct LaneBoundarySegment {
     cv::Point top;
     cv::Point bottom;
@@ -41,6 +63,7 @@ struct RoadSegmentationResult {
     double curvature_indicator_rad{0.0};
     bool heading_valid{false};
     bool curvature_valid{false};
+    bool tracking_active{false};
     std::string segmentation_mode;
     LookaheadReference near_reference;
     LookaheadReference mid_reference;
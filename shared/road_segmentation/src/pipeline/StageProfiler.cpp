@@ -0,0 +1,121 @@
+#include "pipeline/StageProfiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace road_segmentation_lab::pipeline {
+namespace {
+
+double nanosecondsToMs(std::uint32_t value) { return static_cast<double>(value) / 1.0e6; }
+
+// Percentil pelo metodo nearest-rank sobre amostras ja ordenadas.
+double percentileMs(const std::vector<std::uint32_t> &sorted, double percentile) {
+    const auto rank = static_cast<std::size_t>(
+        std::ceil((percentile / 100.0) * static_cast<double>(sorted.size())));
+    return nanosecondsToMs(sorted[std::clamp<std::size_t>(rank, 1, sorted.size()) - 1]);
+}
+
+} // namespace
+
+const char *toString(ProfiledStage stage) {
+    switch (stage) {
+    case ProfiledStage::Resize:
+        return "resize";
+    case ProfiledStage::Pyramid:
+        return "pyramid";
+    case ProfiledStage::Gaussian:
+        return "gaussian";
+    case ProfiledStage::Illumination:
+        return "illumination";
+    case ProfiledStage::Segmentation:
+        return "segmentation";
+    case ProfiledStage::Morphology:
+        return "morphology";
+    case ProfiledStage::BoundaryAnalysis:
+        return "boundary";
+    case ProfiledStage::Output:
+        return "output";
+    case ProfiledStage::Frame:
+        return "frame";
+    }
+
+    return "frame";
+}
+
+StageProfiler::Scope::Scope(StageProfiler &profiler, ProfiledStage stage) noexcept : stage_(stage) {
+    if (profiler.enabled()) {
+        profiler_ = &profiler;
+        started_ = Clock::now();
+    }
+}
+
+StageProfiler::Scope::~Scope() {
+    if (profiler_ != nullptr) {
+        profiler_->record(stage_, Clock::now() - started_);
+    }
+}
+
+void StageProfiler::setEnabled(bool enabled) noexcept {
+    enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+bool StageProfiler::enabled() const noexcept { return enabled_.load(std::memory_order_relaxed); }
+
+void StageProfiler::record(ProfiledStage stage, Clock::duration elapsed) {
+    const auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    const auto sample = static_cast<std::uint32_t>(std::clamp<long long>(
+        nanoseconds, 0, std::numeric_limits<std::uint32_t>::max()));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    StageWindow &window = windows_[static_cast<std::size_t>(stage)];
+    window.samples_ns[window.next] = sample;
+    window.next = (window.next + 1) % kWindowSize;
+    window.count = std::min(window.count + 1, kWindowSize);
+    if (stage == ProfiledStage::Frame) {
+        ++frames_;
+    }
+}
+
+StageProfileSnapshot StageProfiler::snapshot() const {
+    StageProfileSnapshot snapshot;
+    snapshot.enabled = enabled();
+
+    std::array<StageWindow, kProfiledStageCount> windows;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        windows = windows_;
+        snapshot.frames = frames_;
+    }
+
+    std::vector<std::uint32_t> sorted;
+    sorted.reserve(kWindowSize);
+    for (std::size_t index = 0; index < kProfiledStageCount; ++index) {
+        const StageWindow &window = windows[index];
+        if (window.count == 0) {
+            continue;
+        }
+
+        sorted.assign(window.samples_ns.begin(), window.samples_ns.begin() + window.count);
+        std::sort(sorted.begin(), sorted.end());
+
+        StageLatencySummary summary;
+        summary.stage = static_cast<ProfiledStage>(index);
+        summary.samples = window.count;
+        summary.p50_ms = percentileMs(sorted, 50.0);
+        summary.p95_ms = percentileMs(sorted, 95.0);
+        summary.p99_ms = percentileMs(sorted, 99.0);
+        summary.max_ms = nanosecondsToMs(sorted.back());
+        snapshot.stages.push_back(summary);
+    }
+
+    return snapshot;
+}
+
+void StageProfiler::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    windows_ = {};
+    frames_ = 0;
+}
+
+} // namespace road_segmentation_lab::pipeline
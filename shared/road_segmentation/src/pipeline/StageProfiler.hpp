@@ -0,0 +1,87 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace road_segmentation_lab::pipeline {
+
+enum class ProfiledStage : std::size_t {
+    Resize,
+    Pyramid,
+    Gaussian,
+    Illumination,
+    Segmentation,
+    Morphology,
+    BoundaryAnalysis,
+    Output,
+    Frame,
+};
+
+inline constexpr std::size_t kProfiledStageCount = static_cast<std::size_t>(ProfiledStage::Frame) + 1;
+
+const char *toString(ProfiledStage stage);
+
+struct StageLatencySummary {
+    ProfiledStage stage{ProfiledStage::Frame};
+    std::size_t samples{0};
+    double p50_ms{0.0};
+    double p95_ms{0.0};
+    double p99_ms{0.0};
+    double max_ms{0.0};
+};
+
+struct StageProfileSnapshot {
+    bool enabled{false};
+    std::uint64_t frames{0};
+    // Apenas estagios com amostras na janela, na ordem de ProfiledStage.
+    std::vector<StageLatencySummary> stages;
+};
+
+// Janela deslizante com as ultimas kWindowSize duracoes de cada estagio. Desligado, Scope
+// custa uma leitura atomica; ligado, dois steady_clock::now() e um lock sem disputa por
+// estagio. Os percentis so sao calculados em snapshot().
+class StageProfiler {
+  public:
+    using Clock = std::chrono::steady_clock;
+    static constexpr std::size_t kWindowSize = 256;
+
+    class Scope {
+      public:
+        Scope(StageProfiler &profiler, ProfiledStage stage) noexcept;
+        ~Scope();
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+      private:
+        StageProfiler *profiler_{nullptr};
+        ProfiledStage stage_;
+        Clock::time_point started_;
+    };
+
+    void setEnabled(bool enabled) noexcept;
+    bool enabled() const noexcept;
+
+    void record(ProfiledStage stage, Clock::duration elapsed);
+    StageProfileSnapshot snapshot() const;
+    void reset();
+
+  private:
+    struct StageWindow {
+        std::array<std::uint32_t, kWindowSize> samples_ns{};
+        std::size_t next{0};
+        std::size_t count{0};
+    };
+
+    std::atomic<bool> enabled_{false};
+    mutable std::mutex mutex_;
+    std::array<StageWindow, kProfiledStageCount> windows_{};
+    std::uint64_t frames_{0};
+};
+
+} // namespace road_segmentation_lab::pipeline
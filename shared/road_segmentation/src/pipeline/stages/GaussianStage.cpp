@@ -7,18 +7,17 @@ namespace road_segmentation_lab::pipeline::stages {
 GaussianStage::GaussianStage(bool enabled, cv::Size kernel_size, double sigma)
     : enabled_(enabled), kernel_size_(kernel_size), sigma_(sigma) {}
 
-cv::Mat GaussianStage::apply(const cv::Mat &frame) const {
+cv::Mat GaussianStage::apply(const cv::Mat &frame, cv::Mat &output) const {
     if (frame.empty()) {
         return cv::Mat();
     }
 
     if (!enabled_) {
-        return frame.clone();
+        return frame;
     }
 
-    cv::Mat blurred;
-    cv::GaussianBlur(frame, blurred, kernel_size_, sigma_);
-    return blurred;
+    cv::GaussianBlur(frame, output, kernel_size_, sigma_);
+    return output;
 }
 
 } // namespace road_segmentation_lab::pipeline::stages
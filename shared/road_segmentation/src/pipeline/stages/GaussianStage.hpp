@@ -8,7 +8,7 @@ class GaussianStage {
   public:
     GaussianStage(bool enabled, cv::Size kernel_size, double sigma);
 
-    cv::Mat apply(const cv::Mat &frame) const;
+    cv::Mat apply(const cv::Mat &frame, cv::Mat &output) const;
 
   private:
     bool enabled_{true};
@@ -1,34 +1,29 @@
 #include "pipeline/stages/IlluminationStage.hpp"
 
-#include <vector>
-
-#include <opencv2/imgproc.hpp>
-
 namespace road_segmentation_lab::pipeline::stages {
 
-IlluminationStage::IlluminationStage(bool clahe_enabled) : clahe_enabled_(clahe_enabled) {}
+IlluminationStage::IlluminationStage(bool clahe_enabled) : clahe_enabled_(clahe_enabled) {
+    if (clahe_enabled_) {
+        clahe_ = cv::createCLAHE(2.0, cv::Size(8, 8));
+    }
+}
 
-cv::Mat IlluminationStage::apply(const cv::Mat &frame) const {
+cv::Mat IlluminationStage::apply(const cv::Mat &frame, cv::Mat &output, cv::Mat &lab_scratch,
+                                 cv::Mat &channel_scratch) const {
     if (frame.empty()) {
         return cv::Mat();
     }
 
     if (!clahe_enabled_) {
-        return frame.clone();
+        return frame;
     }
 
-    cv::Mat lab;
-    cv::cvtColor(frame, lab, cv::COLOR_BGR2Lab);
-
-    std::vector<cv::Mat> channels;
-    cv::split(lab, channels);
-    auto clahe = cv::createCLAHE(2.0, cv::Size(8, 8));
-    clahe->apply(channels[0], channels[0]);
-    cv::merge(channels, lab);
-
-    cv::Mat result;
-    cv::cvtColor(lab, result, cv::COLOR_Lab2BGR);
-    return result;
+    cv::cvtColor(frame, lab_scratch, cv::COLOR_BGR2Lab);
+    cv::extractChannel(lab_scratch, channel_scratch, 0);
+    clahe_->apply(channel_scratch, channel_scratch);
+    cv::insertChannel(channel_scratch, lab_scratch, 0);
+    cv::cvtColor(lab_scratch, output, cv::COLOR_Lab2BGR);
+    return output;
 }
 
 } // namespace road_segmentation_lab::pipeline::stages
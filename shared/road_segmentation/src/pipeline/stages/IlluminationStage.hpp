@@ -1,6 +1,7 @@
 #pragma once
 
 #include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
 
 namespace road_segmentation_lab::pipeline::stages {
 
@@ -8,10 +9,12 @@ class IlluminationStage {
   public:
     explicit IlluminationStage(bool clahe_enabled);
 
-    cv::Mat apply(const cv::Mat &frame) const;
+    cv::Mat apply(const cv::Mat &frame, cv::Mat &output, cv::Mat &lab_scratch,
+                  cv::Mat &channel_scratch) const;
 
   private:
     bool clahe_enabled_{false};
+    cv::Ptr<cv::CLAHE> clahe_;
 };
 
 } // namespace road_segmentation_lab::pipeline::stages
@@ -5,24 +5,23 @@
 namespace road_segmentation_lab::pipeline::stages {
 
 MorphologyStage::MorphologyStage(bool enabled, cv::Size kernel_size, int iterations)
-    : enabled_(enabled), kernel_size_(kernel_size), iterations_(iterations) {}
+    : enabled_(enabled),
+      kernel_size_(kernel_size),
+      iterations_(iterations),
+      kernel_(cv::getStructuringElement(cv::MORPH_RECT, kernel_size_)) {}
 
-cv::Mat MorphologyStage::apply(const cv::Mat &frame) const {
+cv::Mat MorphologyStage::apply(const cv::Mat &frame, cv::Mat &output, cv::Mat &scratch) const {
     if (frame.empty()) {
         return cv::Mat();
     }
 
     if (!enabled_) {
-        return frame.clone();
+        return frame;
     }
 
-    const cv::Mat kernel = cv::getStructuringElement(cv::MORPH_RECT, kernel_size_);
-    cv::Mat closed;
-    cv::morphologyEx(frame, closed, cv::MORPH_CLOSE, kernel, {-1, -1}, iterations_);
-
-    cv::Mat result;
-    cv::morphologyEx(closed, result, cv::MORPH_OPEN, kernel, {-1, -1}, 1);
-    return result;
+    cv::morphologyEx(frame, scratch, cv::MORPH_CLOSE, kernel_, {-1, -1}, iterations_);
+    cv::morphologyEx(scratch, output, cv::MORPH_OPEN, kernel_, {-1, -1}, 1);
+    return output;
 }
 
 } // namespace road_segmentation_lab::pipeline::stages
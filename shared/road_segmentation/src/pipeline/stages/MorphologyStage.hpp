@@ -8,12 +8,13 @@ class MorphologyStage {
   public:
     MorphologyStage(bool enabled, cv::Size kernel_size, int iterations);
 
-    cv::Mat apply(const cv::Mat &frame) const;
+    cv::Mat apply(const cv::Mat &frame, cv::Mat &output, cv::Mat &scratch) const;
 
   private:
     bool enabled_{true};
     cv::Size kernel_size_{5, 5};
     int iterations_{1};
+    cv::Mat kernel_;
 };
 
 } // namespace road_segmentation_lab::pipeline::stages
@@ -7,19 +7,26 @@ namespace road_segmentation_lab::pipeline::stages {
 ResizeStage::ResizeStage(bool enabled, cv::Size target_size)
     : enabled_(enabled), target_size_(target_size) {}
 
-cv::Mat ResizeStage::apply(const cv::Mat &frame) const {
+cv::Mat ResizeStage::apply(const cv::Mat &frame, cv::Mat &output) const {
     if (frame.empty()) {
         return cv::Mat();
     }
 
-    if (!enabled_ || target_size_.width <= 0 || target_size_.height <= 0 ||
-        frame.size() == target_size_) {
-        return frame.clone();
+    const cv::Size output_size = outputSize(frame.size());
+    if (output_size == frame.size()) {
+        return frame;
     }
 
-    cv::Mat resized;
-    cv::resize(frame, resized, target_size_, 0.0, 0.0, cv::INTER_AREA);
-    return resized;
+    cv::resize(frame, output, output_size, 0.0, 0.0, cv::INTER_AREA);
+    return output;
+}
+
+cv::Size ResizeStage::outputSize(const cv::Size &frame_size) const noexcept {
+    if (!enabled_ || target_size_.width <= 0 || target_size_.height <= 0) {
+        return frame_size;
+    }
+
+    return target_size_;
 }
 
 } // namespace road_segmentation_lab::pipeline::stages
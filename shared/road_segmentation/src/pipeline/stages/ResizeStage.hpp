@@ -8,7 +8,8 @@ class ResizeStage {
   public:
     ResizeStage(bool enabled, cv::Size target_size);
 
-    cv::Mat apply(const cv::Mat &frame) const;
+    cv::Mat apply(const cv::Mat &frame, cv::Mat &output) const;
+    cv::Size outputSize(const cv::Size &frame_size) const noexcept;
 
   private:
     bool enabled_{true};
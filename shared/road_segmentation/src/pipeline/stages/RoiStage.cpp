@@ -44,7 +44,7 @@ cv::Mat RoiStage::apply(const cv::Mat &frame, cv::Rect *rect) const {
     if (roi.width <= 0 || roi.height <= 0) {
         return cv::Mat();
     }
-    return frame(roi).clone();
+    return frame(roi);
 }
 
 } // namespace road_segmentation_lab::pipeline::stages
@@ -1,10 +1,122 @@
 #include "pipeline/stages/SegmentationStage.hpp"
 
-#include <vector>
+#include <algorithm>
 
+#include <opencv2/core/hal/intrin.hpp>
 #include <opencv2/imgproc.hpp>
 
 namespace road_segmentation_lab::pipeline::stages {
+namespace {
+
+// Coeficientes em ponto fixo (15 bits) do caminho bit-exact do cv::cvtColor em COLOR_BGR2GRAY.
+constexpr int kGrayShift = 15;
+constexpr std::uint32_t kBlueToGray = 3735;
+constexpr std::uint32_t kGreenToGray = 19235;
+constexpr std::uint32_t kRedToGray = 9798;
+
+constexpr int kLabSearchSteps = 9;
+
+// Limite exclusivo da soma ponderada B*cb + G*cg + R*cr abaixo do qual o cinza
+// arredondado fica <= threshold, equivalente a cvtColor seguido de THRESH_BINARY_INV.
+std::uint32_t grayDarkLimit(int threshold) {
+    const int clamped = std::clamp(threshold, -1, 255);
+    return static_cast<std::uint32_t>(std::max(0, ((clamped + 1) << kGrayShift) - (1 << (kGrayShift - 1))));
+}
+
+// Para cada par (B, G), quantos valores de R mantem o L do cv::cvtColor(COLOR_BGR2Lab)
+// <= threshold. L cresce com cada canal, entao o conjunto valido de R e um prefixo e
+// uma busca binaria por par basta; a conversao continua sendo a do proprio OpenCV.
+std::vector<std::uint16_t> buildLabDarkLimits(int threshold) {
+    std::vector<std::uint16_t> low(256 * 256, 0);
+    std::vector<std::uint16_t> high(256 * 256, 256);
+    cv::Mat probe(256, 256, CV_8UC3);
+    cv::Mat lab;
+
+    for (int step = 0; step < kLabSearchSteps; ++step) {
+        for (int blue = 0; blue < 256; ++blue) {
+            auto *row = probe.ptr<cv::Vec3b>(blue);
+            for (int green = 0; green < 256; ++green) {
+                const int index = (blue << 8) | green;
+                const int red = std::min(255, (low[index] + high[index]) / 2);
+                row[green] = cv::Vec3b(static_cast<uchar>(blue), static_cast<uchar>(green),
+                                       static_cast<uchar>(red));
+            }
+        }
+
+        cv::cvtColor(probe, lab, cv::COLOR_BGR2Lab);
+        for (int blue = 0; blue < 256; ++blue) {
+            const auto *row = lab.ptr<cv::Vec3b>(blue);
+            for (int green = 0; green < 256; ++green) {
+                const int index = (blue << 8) | green;
+                if (low[index] >= high[index]) {
+                    continue;
+                }
+
+                const int red = (low[index] + high[index]) / 2;
+                if (row[green][0] <= threshold) {
+                    low[index] = static_cast<std::uint16_t>(red + 1);
+                } else {
+                    high[index] = static_cast<std::uint16_t>(red);
+                }
+            }
+        }
+    }
+
+    return low;
+}
+
+void grayThresholdRow(const uchar *bgr, const uchar *spatial, uchar *dst, int width,
+                      std::uint32_t limit) {
+    int x = 0;
+#if CV_SIMD128
+    const cv::v_uint32x4 blue_coeff = cv::v_setall_u32(kBlueToGray);
+    const cv::v_uint32x4 green_coeff = cv::v_setall_u32(kGreenToGray);
+    const cv::v_uint32x4 red_coeff = cv::v_setall_u32(kRedToGray);
+    const cv::v_uint32x4 limit_vec = cv::v_setall_u32(limit);
+    const auto dark_lanes = [&](const cv::v_uint16x8 &blue, const cv::v_uint16x8 &green,
+                                const cv::v_uint16x8 &red) {
+        cv::v_uint32x4 blue_lo, blue_hi, green_lo, green_hi, red_lo, red_hi;
+        cv::v_expand(blue, blue_lo, blue_hi);
+        cv::v_expand(green, green_lo, green_hi);
+        cv::v_expand(red, red_lo, red_hi);
+        const cv::v_uint32x4 sum_lo = blue_lo * blue_coeff + green_lo * green_coeff + red_lo * red_coeff;
+        const cv::v_uint32x4 sum_hi = blue_hi * blue_coeff + green_hi * green_coeff + red_hi * red_coeff;
+        return cv::v_pack(sum_lo < limit_vec, sum_hi < limit_vec);
+    };
+
+    for (; x <= width - 16; x += 16) {
+        cv::v_uint8x16 blue, green, red;
+        cv::v_load_deinterleave(bgr + x * 3, blue, green, red);
+        cv::v_uint16x8 blue_lo, blue_hi, green_lo, green_hi, red_lo, red_hi;
+        cv::v_expand(blue, blue_lo, blue_hi);
+        cv::v_expand(green, green_lo, green_hi);
+        cv::v_expand(red, red_lo, red_hi);
+        cv::v_uint8x16 dark =
+            cv::v_pack(dark_lanes(blue_lo, green_lo, red_lo), dark_lanes(blue_hi, green_hi, red_hi));
+        if (spatial != nullptr) {
+            dark = dark & cv::v_load(spatial + x);
+        }
+        cv::v_store(dst + x, dark);
+    }
+#endif
+    for (; x < width; ++x) {
+        const uchar *pixel = bgr + x * 3;
+        const std::uint32_t sum = pixel[0] * kBlueToGray + pixel[1] * kGreenToGray + pixel[2] * kRedToGray;
+        const uchar dark = sum < limit ? 255 : 0;
+        dst[x] = spatial != nullptr ? static_cast<uchar>(dark & spatial[x]) : dark;
+    }
+}
+
+void labDarkRow(const uchar *bgr, const uchar *spatial, uchar *dst, int width,
+                const std::uint16_t *limits) {
+    for (int x = 0; x < width; ++x) {
+        const uchar *pixel = bgr + x * 3;
+        const uchar dark = pixel[2] < limits[(pixel[0] << 8) | pixel[1]] ? 255 : 0;
+        dst[x] = spatial != nullptr ? static_cast<uchar>(dark & spatial[x]) : dark;
+    }
+}
+
+} // namespace
 
 SegmentationStage::SegmentationStage(const config::LabConfig &config)
     : mode_(config.segmentation_mode),
@@ -12,47 +124,67 @@ SegmentationStage::SegmentationStage(const config::LabConfig &config)
       hsv_high_(config.hsv_high),
       gray_threshold_(config.gray_threshold),
       adaptive_block_size_(config.adaptive_block_size),
-      adaptive_c_(config.adaptive_c) {}
+      adaptive_c_(config.adaptive_c) {
+    if (mode_ == config::SegmentationMode::LabDark) {
+        lab_dark_limits_ = buildLabDarkLimits(gray_threshold_);
+    }
+}
 
-cv::Mat SegmentationStage::apply(const cv::Mat &frame) const {
+cv::Mat SegmentationStage::apply(const cv::Mat &frame, cv::Mat &output, cv::Mat &scratch,
+                                 const cv::Mat &spatial_mask) const {
     if (frame.empty()) {
         return cv::Mat();
     }
 
-    cv::Mat mask;
+    const bool use_spatial_mask = !spatial_mask.empty();
+    if ((mode_ == config::SegmentationMode::GrayThreshold || mode_ == config::SegmentationMode::LabDark) &&
+        frame.type() == CV_8UC3) {
+        output.create(frame.size(), CV_8UC1);
+        const std::uint32_t gray_limit = grayDarkLimit(gray_threshold_);
+        for (int y = 0; y < frame.rows; ++y) {
+            const uchar *spatial = use_spatial_mask ? spatial_mask.ptr<uchar>(y) : nullptr;
+            if (mode_ == config::SegmentationMode::GrayThreshold) {
+                grayThresholdRow(frame.ptr<uchar>(y), spatial, output.ptr<uchar>(y), frame.cols,
+                                 gray_limit);
+            } else {
+                labDarkRow(frame.ptr<uchar>(y), spatial, output.ptr<uchar>(y), frame.cols,
+                           lab_dark_limits_.data());
+            }
+        }
+        return output;
+    }
+
     switch (mode_) {
-    case config::SegmentationMode::HsvDark: {
-        cv::Mat hsv;
-        cv::cvtColor(frame, hsv, cv::COLOR_BGR2HSV);
-        cv::inRange(hsv, hsv_low_, hsv_high_, mask);
+    case config::SegmentationMode::HsvDark:
+        cv::cvtColor(frame, scratch, cv::COLOR_BGR2HSV);
+        cv::inRange(scratch, hsv_low_, hsv_high_, output);
         break;
-    }
-    case config::SegmentationMode::GrayThreshold: {
-        cv::Mat gray;
-        cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
-        cv::threshold(gray, mask, gray_threshold_, 255, cv::THRESH_BINARY_INV);
+    case config::SegmentationMode::GrayThreshold:
+        cv::cvtColor(frame, output, cv::COLOR_BGR2GRAY);
+        cv::threshold(output, output, gray_threshold_, 255, cv::THRESH_BINARY_INV);
         break;
-    }
-    case config::SegmentationMode::LabDark: {
-        cv::Mat lab;
-        cv::cvtColor(frame, lab, cv::COLOR_BGR2Lab);
-        std::vector<cv::Mat> channels;
-        cv::split(lab, channels);
-        cv::threshold(channels[0], mask, gray_threshold_, 255, cv::THRESH_BINARY_INV);
+    case config::SegmentationMode::LabDark:
+        cv::cvtColor(frame, scratch, cv::COLOR_BGR2Lab);
+        cv::extractChannel(scratch, output, 0);
+        cv::threshold(output, output, gray_threshold_, 255, cv::THRESH_BINARY_INV);
         break;
-    }
-    case config::SegmentationMode::AdaptiveGray: {
-        cv::Mat gray;
-        cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
-        cv::adaptiveThreshold(gray, mask, 255, cv::ADAPTIVE_THRESH_GAUSSIAN_C,
+    case config::SegmentationMode::AdaptiveGray:
+        cv::cvtColor(frame, scratch, cv::COLOR_BGR2GRAY);
+        cv::adaptiveThreshold(scratch, output, 255, cv::ADAPTIVE_THRESH_GAUSSIAN_C,
                               cv::THRESH_BINARY_INV, adaptive_block_size_, adaptive_c_);
         break;
     }
-    }
 
-    return mask;
+    if (use_spatial_mask) {
+        cv::bitwise_and(output, spatial_mask, output);
+    }
+    return output;
 }
 
 std::string SegmentationStage::modeName() const { return config::segmentationModeToString(mode_); }
 
+bool SegmentationStage::classifiesPixelsIndependently() const noexcept {
+    return mode_ != config::SegmentationMode::AdaptiveGray;
+}
+
 } // namespace road_segmentation_lab::pipeline::stages
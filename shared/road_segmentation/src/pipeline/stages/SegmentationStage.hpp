@@ -2,7 +2,9 @@
 
 #include <opencv2/core.hpp>
 
+#include <cstdint>
 #include <string>
+#include <vector>
 
 #include "config/LabConfig.hpp"
 
@@ -12,8 +14,14 @@ class SegmentationStage {
   public:
     explicit SegmentationStage(const config::LabConfig &config);
 
-    cv::Mat apply(const cv::Mat &frame) const;
+    // spatial_mask, quando informado, e aplicado sobre a saida (no mesmo passo nos modos
+    // GRAY_THRESHOLD e LAB_DARK).
+    cv::Mat apply(const cv::Mat &frame, cv::Mat &output, cv::Mat &scratch,
+                  const cv::Mat &spatial_mask = cv::Mat()) const;
     std::string modeName() const;
+    // true quando cada pixel e classificado sozinho (sem vizinhanca, como no AdaptiveGray), o
+    // que permite classificar um trecho de linha isolado.
+    bool classifiesPixelsIndependently() const noexcept;
 
   private:
     config::SegmentationMode mode_{config::SegmentationMode::HsvDark};
@@ -22,6 +30,7 @@ class SegmentationStage {
     int gray_threshold_{90};
     int adaptive_block_size_{31};
     double adaptive_c_{9.0};
+    std::vector<std::uint16_t> lab_dark_limits_;
 };
 
 } // namespace road_segmentation_lab::pipeline::stages
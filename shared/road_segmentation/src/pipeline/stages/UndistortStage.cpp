@@ -4,6 +4,7 @@
 
 #include <opencv2/calib3d.hpp>
 #include <opencv2/core/persistence.hpp>
+#include <opencv2/imgproc.hpp>
 
 namespace road_segmentation_lab::pipeline::stages {
 
@@ -48,18 +49,47 @@ UndistortStage::UndistortStage(const std::string &calibration_file) {
     status_message_ = "Calibracao ativa";
 }
 
-cv::Mat UndistortStage::apply(const cv::Mat &frame) const {
+cv::Mat UndistortStage::apply(const cv::Mat &frame, cv::Mat &output) {
+    return apply(frame, frame.size(), output);
+}
+
+cv::Mat UndistortStage::apply(const cv::Mat &frame, const cv::Size &output_size, cv::Mat &output) {
     if (frame.empty()) {
         return cv::Mat();
     }
 
     if (!active_) {
-        return frame.clone();
+        return frame;
+    }
+
+    prepareMaps(frame.size(), output_size);
+    cv::remap(frame, output, map_xy_, map_interpolation_, cv::INTER_LINEAR, cv::BORDER_CONSTANT);
+    return output;
+}
+
+void UndistortStage::prepareMaps(const cv::Size &source_size, const cv::Size &output_size) {
+    if (!map_xy_.empty() && map_source_size_ == source_size && map_output_size_ == output_size) {
+        return;
+    }
+
+    cv::Mat map_x;
+    cv::Mat map_y;
+    cv::initUndistortRectifyMap(camera_matrix_, dist_coeffs_, cv::Mat(), camera_matrix_, output_size,
+                                CV_32FC1, map_x, map_y);
+    if (source_size != output_size) {
+        // Leva as coordenadas do frame redimensionado para o frame de origem,
+        // alinhando os centros dos pixels como o cv::resize faz.
+        const double scale_x =
+            static_cast<double>(source_size.width) / static_cast<double>(output_size.width);
+        const double scale_y =
+            static_cast<double>(source_size.height) / static_cast<double>(output_size.height);
+        map_x.convertTo(map_x, CV_32FC1, scale_x, 0.5 * scale_x - 0.5);
+        map_y.convertTo(map_y, CV_32FC1, scale_y, 0.5 * scale_y - 0.5);
     }
 
-    cv::Mat corrected;
-    cv::undistort(frame, corrected, camera_matrix_, dist_coeffs_);
-    return corrected;
+    cv::convertMaps(map_x, map_y, map_xy_, map_interpolation_, CV_16SC2);
+    map_source_size_ = source_size;
+    map_output_size_ = output_size;
 }
 
 bool UndistortStage::isActive() const noexcept { return active_; }
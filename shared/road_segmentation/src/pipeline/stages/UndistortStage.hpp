@@ -10,15 +10,24 @@ class UndistortStage {
   public:
     explicit UndistortStage(const std::string &calibration_file = {});
 
-    cv::Mat apply(const cv::Mat &frame) const;
+    cv::Mat apply(const cv::Mat &frame, cv::Mat &output);
+    // Corrige a distorcao e reamostra para output_size em uma unica passada. A matriz
+    // da camera continua expressa nas coordenadas de output_size.
+    cv::Mat apply(const cv::Mat &frame, const cv::Size &output_size, cv::Mat &output);
     bool isActive() const noexcept;
     const std::string &statusMessage() const noexcept;
 
   private:
+    void prepareMaps(const cv::Size &source_size, const cv::Size &output_size);
+
     bool active_{false};
     std::string status_message_;
     cv::Mat camera_matrix_;
     cv::Mat dist_coeffs_;
+    cv::Mat map_xy_;
+    cv::Mat map_interpolation_;
+    cv::Size map_source_size_;
+    cv::Size map_output_size_;
 };
 
 } // namespace road_segmentation_lab::pipeline::stages
@@ -24,6 +24,8 @@ const cv::Scalar kNearReferenceColor{60, 220, 120};
 const cv::Scalar kSidebarBackground{26, 26, 26};
 const cv::Scalar kSidebarBorder{64, 64, 64};
 constexpr int kSidebarWidth = 250;
+constexpr int kProfileColumns = 3;
+constexpr int kProfileRowHeight = 18;
 
 std::string formatDouble(double value, int precision = 3) {
     std::ostringstream stream;
@@ -45,6 +47,19 @@ cv::Scalar referenceColor(const std::string &label) {
     return kNearReferenceColor;
 }
 
+// Mistura a cor so no retangulo: fora dele o resultado da mistura seria o proprio pixel.
+void blendRect(cv::Mat &image, const cv::Rect &rect, const cv::Scalar &color, double alpha,
+               double beta) {
+    const cv::Rect clipped = rect & cv::Rect(0, 0, image.cols, image.rows);
+    if (clipped.area() <= 0) {
+        return;
+    }
+
+    cv::Mat region = image(clipped);
+    const cv::Mat overlay(region.size(), region.type(), color);
+    cv::addWeighted(overlay, alpha, region, beta, 0.0, region);
+}
+
 void drawReferenceBand(cv::Mat &image, const pipeline::LookaheadReference &reference,
                        const cv::Rect &roi_rect, const std::string &label) {
     if (image.empty() || roi_rect.area() <= 0 || reference.bottom_y < reference.top_y) {
@@ -58,10 +73,7 @@ void drawReferenceBand(cv::Mat &image, const pipeline::LookaheadReference &refer
     }
 
     const cv::Scalar color = referenceColor(label);
-    cv::Mat overlay = image.clone();
-    cv::rectangle(overlay, {roi_rect.x, top_y}, {roi_rect.x + roi_rect.width - 1, bottom_y}, color,
-                  cv::FILLED);
-    cv::addWeighted(overlay, 0.14, image, 0.86, 0.0, image);
+    blendRect(image, {roi_rect.x, top_y, roi_rect.width, bottom_y - top_y + 1}, color, 0.14, 0.86);
     cv::rectangle(image, {roi_rect.x, top_y}, {roi_rect.x + roi_rect.width - 1, bottom_y}, color, 1,
                   cv::LINE_AA);
 
@@ -82,6 +94,16 @@ void drawReferencePoint(cv::Mat &image, const pipeline::LookaheadReference &refe
                 color, 1, cv::LINE_AA);
 }
 
+bool hasProfileStrip(const pipeline::StageProfileSnapshot *profile) {
+    return profile != nullptr && profile->enabled && !profile->stages.empty();
+}
+
+int profileStripHeight(const pipeline::StageProfileSnapshot &profile) {
+    const int rows =
+        (static_cast<int>(profile.stages.size()) + kProfileColumns - 1) / kProfileColumns;
+    return 36 + (rows * kProfileRowHeight);
+}
+
 void drawLookaheadOverlay(cv::Mat &image, const pipeline::RoadSegmentationResult &result) {
     if (image.empty() || result.roi_rect.area() <= 0) {
         return;
@@ -100,24 +122,97 @@ void drawLookaheadOverlay(cv::Mat &image, const pipeline::RoadSegmentationResult
 
 cv::Mat DebugRenderer::render(const pipeline::RoadSegmentationResult &result,
                               const config::LabConfig &config, const std::string &source_label,
-                              const std::string &calibration_status) const {
-    if (result.resized_frame.empty()) {
+                              const std::string &calibration_status,
+                              const pipeline::StageProfileSnapshot *profile) const {
+    const cv::Size size = panelSize(result, profile);
+    if (size.empty()) {
         return cv::Mat();
     }
 
-    const cv::Mat original_tile = buildOriginalTile(result, source_label);
-    const cv::Mat preprocess_tile = buildPreprocessTile(result, config, calibration_status);
-    const cv::Mat mask_tile = buildMaskTile(result);
-    const cv::Mat output_tile = buildOutputTile(result);
+    cv::Mat panel(size, CV_8UC3);
+    renderInto(panel, result, config, source_label, calibration_status, profile);
+    return panel;
+}
+
+cv::Size DebugRenderer::panelSize(const pipeline::RoadSegmentationResult &result,
+                                  const pipeline::StageProfileSnapshot *profile) const {
+    if (result.resized_frame.empty()) {
+        return {};
+    }
+
+    const cv::Size tile = result.resized_frame.size();
+    int height = tile.height * 2;
+    if (hasProfileStrip(profile)) {
+        height += profileStripHeight(*profile);
+    }
+    return {(tile.width + kSidebarWidth) * 2, height};
+}
 
-    cv::Mat top_row;
-    cv::Mat bottom_row;
-    cv::hconcat(original_tile, preprocess_tile, top_row);
-    cv::hconcat(mask_tile, output_tile, bottom_row);
+void DebugRenderer::renderInto(cv::Mat &panel, const pipeline::RoadSegmentationResult &result,
+                               const config::LabConfig &config, const std::string &source_label,
+                               const std::string &calibration_status,
+                               const pipeline::StageProfileSnapshot *profile) const {
+    if (result.resized_frame.empty()) {
+        return;
+    }
 
-    cv::Mat panel;
-    cv::vconcat(top_row, bottom_row, panel);
-    return panel;
+    // Cards em grade 2x2: tile do frame e barra lateral a direita de cada um.
+    const int tile_width = result.resized_frame.cols;
+    const int tile_height = result.resized_frame.rows;
+    const int card_width = tile_width + kSidebarWidth;
+    const cv::Rect original_rect(0, 0, tile_width, tile_height);
+    const cv::Rect preprocess_rect(card_width, 0, tile_width, tile_height);
+    const cv::Rect mask_rect(0, tile_height, tile_width, tile_height);
+    const cv::Rect output_rect(card_width, tile_height, tile_width, tile_height);
+    const auto sidebar_of = [&](const cv::Rect &tile) {
+        return panel(cv::Rect(tile.x + tile_width, tile.y, kSidebarWidth, tile_height));
+    };
+
+    paintOriginalOverlay(result, panel(original_rect));
+    paintPreprocessView(result, panel(preprocess_rect));
+    paintMaskView(result, panel(mask_rect));
+    copyAsColor(result.resized_frame, panel(output_rect));
+    paintAnnotations(result, panel(output_rect));
+
+    paintSidebar(sidebar_of(original_rect), 0, "Original",
+                 {source_label,
+                  "ROI: trapezio util",
+                  "Lookahead: FAR/MID/NEAR",
+                  "Capo: " +
+                      std::string(result.hood_mask_polygon_points.empty() ? "off" : "masked")});
+    paintSidebar(sidebar_of(preprocess_rect), 1, "ROI + preprocessamento",
+                 {"Seg: " + result.segmentation_mode,
+                  "Blur: " + std::string(config.gaussian_enabled ? "on" : "off"),
+                  "CLAHE: " + std::string(config.clahe_enabled ? "on" : "off"),
+                  "Conf.: " + formatDouble(result.confidence_score, 2),
+                  calibration_status});
+    paintSidebar(sidebar_of(mask_rect), 2, "Mascara binaria",
+                 {"Area: " + formatDouble(result.mask_area_px, 0) + " px2",
+                  "Largura: " + formatDouble(result.lane_width_px, 1) + " px",
+                  "Score: " + formatDouble(result.confidence_score, 2)});
+    paintSidebar(sidebar_of(output_rect), 3, "Saida anotada",
+                 {"Lane ratio: " + formatDouble(result.lane_center_ratio),
+                  "Erro norm.: " + formatDouble(result.steering_error_normalized),
+                  "Offset: " + formatDouble(result.lateral_offset_px, 1) + " px",
+                  "Near: " + formatReferenceStatus(result.near_reference) + " off=" +
+                      formatDouble(result.near_reference.lateral_offset_px, 1),
+                  "Mid: " + formatReferenceStatus(result.mid_reference) + " off=" +
+                      formatDouble(result.mid_reference.lateral_offset_px, 1),
+                  "Far: " + formatReferenceStatus(result.far_reference) + " off=" +
+                      formatDouble(result.far_reference.lateral_offset_px, 1),
+                  "Heading: " + std::string(result.heading_valid
+                                                ? formatDouble(result.heading_error_rad)
+                                                : "missing"),
+                  "Curv.: " + std::string(result.curvature_valid
+                                              ? formatDouble(result.curvature_indicator_rad)
+                                              : "missing"),
+                  "Confianca: " + formatDouble(result.confidence_score, 2),
+                  "Status: " + std::string(result.lane_found ? "detected" : "missing")});
+
+    if (hasProfileStrip(profile)) {
+        buildProfileStrip(*profile, panel.cols)
+            .copyTo(panel(cv::Rect(0, tile_height * 2, panel.cols, profileStripHeight(*profile))));
+    }
 }
 
 cv::Mat DebugRenderer::renderRawView(const pipeline::RoadSegmentationResult &result) const {
@@ -133,11 +228,37 @@ cv::Mat DebugRenderer::renderPreprocessView(const pipeline::RoadSegmentationResu
         return cv::Mat();
     }
 
-    cv::Mat tile(result.resized_frame.size(), CV_8UC3, kBackground);
+    cv::Mat tile(result.resized_frame.size(), CV_8UC3);
+    paintPreprocessView(result, tile);
+    return tile;
+}
+
+cv::Mat DebugRenderer::renderMaskView(const pipeline::RoadSegmentationResult &result) const {
+    if (result.resized_frame.empty()) {
+        return cv::Mat();
+    }
+
+    cv::Mat tile(result.resized_frame.size(), CV_8UC3);
+    paintMaskView(result, tile);
+    return tile;
+}
+
+cv::Mat DebugRenderer::renderAnnotatedView(const pipeline::RoadSegmentationResult &result) const {
+    if (result.resized_frame.empty()) {
+        return cv::Mat();
+    }
+
+    cv::Mat tile = result.resized_frame.clone();
+    paintAnnotations(result, tile);
+    return tile;
+}
+
+void DebugRenderer::paintPreprocessView(const pipeline::RoadSegmentationResult &result,
+                                        cv::Mat tile) {
+    tile.setTo(kBackground);
 
     if (!result.preprocessed_frame.empty() && result.roi_rect.area() > 0) {
-        cv::Mat preprocessed = ensureColor(result.preprocessed_frame);
-        preprocessed.copyTo(tile(result.roi_rect));
+        copyAsColor(result.preprocessed_frame, tile(result.roi_rect));
     }
 
     if (!result.roi_polygon_points.empty()) {
@@ -148,37 +269,30 @@ cv::Mat DebugRenderer::renderPreprocessView(const pipeline::RoadSegmentationResu
         std::vector<std::vector<cv::Point>> polygons = {result.hood_mask_polygon_points};
         cv::polylines(tile, polygons, true, kHoodMaskColor, 1, cv::LINE_AA);
     }
-
-    return tile;
 }
 
-cv::Mat DebugRenderer::renderMaskView(const pipeline::RoadSegmentationResult &result) const {
-    if (result.resized_frame.empty()) {
-        return cv::Mat();
-    }
-
-    cv::Mat tile(result.resized_frame.size(), CV_8UC3, kBackground);
+void DebugRenderer::paintMaskView(const pipeline::RoadSegmentationResult &result, cv::Mat tile) {
+    tile.setTo(kBackground);
     if (!result.mask_frame.empty() && result.roi_rect.area() > 0) {
         cv::Mat mask_color;
         cv::applyColorMap(result.mask_frame, mask_color, cv::COLORMAP_BONE);
         mask_color.copyTo(tile(result.roi_rect));
     }
-
-    return tile;
 }
 
-cv::Mat DebugRenderer::renderAnnotatedView(const pipeline::RoadSegmentationResult &result) const {
-    if (result.resized_frame.empty()) {
-        return cv::Mat();
-    }
-
-    cv::Mat tile = result.resized_frame.clone();
-
+void DebugRenderer::paintAnnotations(const pipeline::RoadSegmentationResult &result,
+                                     cv::Mat tile) {
     if (!result.road_polygon_points.empty()) {
-        cv::Mat overlay = tile.clone();
-        std::vector<std::vector<cv::Point>> polygons = {result.road_polygon_points};
-        cv::fillPoly(overlay, polygons, kLaneFillColor);
-        cv::addWeighted(overlay, 0.28, tile, 0.72, 0.0, tile);
+        // A mistura so precisa da caixa do poligono, nao do frame inteiro.
+        const cv::Rect bounds =
+            cv::boundingRect(result.road_polygon_points) & cv::Rect(0, 0, tile.cols, tile.rows);
+        if (bounds.area() > 0) {
+            cv::Mat region = tile(bounds);
+            cv::Mat overlay = region.clone();
+            std::vector<std::vector<cv::Point>> polygons = {result.road_polygon_points};
+            cv::fillPoly(overlay, polygons, kLaneFillColor, cv::LINE_8, 0, -bounds.tl());
+            cv::addWeighted(overlay, 0.28, region, 0.72, 0.0, region);
+        }
     }
 
     drawLookaheadOverlay(tile, result);
@@ -205,74 +319,11 @@ cv::Mat DebugRenderer::renderAnnotatedView(const pipeline::RoadSegmentationResul
     } else {
         cv::rectangle(tile, {2, 2}, {tile.cols - 3, tile.rows - 3}, {0, 0, 255}, 2, cv::LINE_AA);
     }
-
-    return tile;
-}
-
-cv::Mat DebugRenderer::buildOriginalTile(const pipeline::RoadSegmentationResult &result,
-                                         const std::string &source_label) const {
-    cv::Mat tile = renderOriginalOverlayView(result);
-
-    return composeTileCard(tile, "Original",
-                           {source_label,
-                            "ROI: trapezio util",
-                            "Lookahead: FAR/MID/NEAR",
-                            "Capo: " +
-                                std::string(result.hood_mask_polygon_points.empty() ? "off" : "masked")});
-}
-
-cv::Mat DebugRenderer::buildPreprocessTile(const pipeline::RoadSegmentationResult &result,
-                                           const config::LabConfig &config,
-                                           const std::string &calibration_status) const {
-    cv::Mat tile = renderPreprocessView(result);
-
-    return composeTileCard(tile, "ROI + preprocessamento",
-                           {"Seg: " + result.segmentation_mode,
-                            "Blur: " + std::string(config.gaussian_enabled ? "on" : "off"),
-                            "CLAHE: " + std::string(config.clahe_enabled ? "on" : "off"),
-                            "Conf.: " + formatDouble(result.confidence_score, 2),
-                            calibration_status});
 }
 
-cv::Mat DebugRenderer::buildMaskTile(const pipeline::RoadSegmentationResult &result) const {
-    cv::Mat tile = renderMaskView(result);
-
-    return composeTileCard(tile, "Mascara binaria",
-                           {"Area: " + formatDouble(result.mask_area_px, 0) + " px2",
-                            "Largura: " + formatDouble(result.lane_width_px, 1) + " px",
-                            "Score: " + formatDouble(result.confidence_score, 2)});
-}
-
-cv::Mat DebugRenderer::buildOutputTile(const pipeline::RoadSegmentationResult &result) const {
-    cv::Mat tile = renderAnnotatedView(result);
-
-    return composeTileCard(tile, "Saida anotada",
-                           {"Lane ratio: " + formatDouble(result.lane_center_ratio),
-                            "Erro norm.: " + formatDouble(result.steering_error_normalized),
-                            "Offset: " + formatDouble(result.lateral_offset_px, 1) + " px",
-                            "Near: " + formatReferenceStatus(result.near_reference) + " off=" +
-                                formatDouble(result.near_reference.lateral_offset_px, 1),
-                            "Mid: " + formatReferenceStatus(result.mid_reference) + " off=" +
-                                formatDouble(result.mid_reference.lateral_offset_px, 1),
-                            "Far: " + formatReferenceStatus(result.far_reference) + " off=" +
-                                formatDouble(result.far_reference.lateral_offset_px, 1),
-                            "Heading: " + std::string(result.heading_valid
-                                                          ? formatDouble(result.heading_error_rad)
-                                                          : "missing"),
-                            "Curv.: " + std::string(result.curvature_valid
-                                                        ? formatDouble(result.curvature_indicator_rad)
-                                                        : "missing"),
-                            "Confianca: " + formatDouble(result.confidence_score, 2),
-                            "Status: " + std::string(result.lane_found ? "detected" : "missing")});
-}
-
-cv::Mat DebugRenderer::renderOriginalOverlayView(
-    const pipeline::RoadSegmentationResult &result) const {
-    if (result.resized_frame.empty()) {
-        return cv::Mat();
-    }
-
-    cv::Mat tile = result.resized_frame.clone();
+void DebugRenderer::paintOriginalOverlay(const pipeline::RoadSegmentationResult &result,
+                                         cv::Mat tile) {
+    copyAsColor(result.resized_frame, tile);
     drawLookaheadOverlay(tile, result);
     if (!result.roi_polygon_points.empty()) {
         std::vector<std::vector<cv::Point>> polygons = {result.roi_polygon_points};
@@ -284,40 +335,59 @@ cv::Mat DebugRenderer::renderOriginalOverlayView(
         std::vector<std::vector<cv::Point>> polygons = {result.hood_mask_polygon_points};
         cv::polylines(tile, polygons, true, kHoodMaskColor, 2, cv::LINE_AA);
     }
-
-    return tile;
 }
 
-cv::Mat DebugRenderer::composeTileCard(const cv::Mat &image, const std::string &title,
-                                       const std::vector<std::string> &lines) {
-    cv::Mat content = ensureColor(image);
-    if (content.empty()) {
-        return cv::Mat();
+void DebugRenderer::paintSidebar(cv::Mat sidebar, std::size_t card, const std::string &title,
+                                 std::vector<std::string> lines) const {
+    std::lock_guard<std::mutex> lock(sidebar_mutex_);
+    SidebarCache &cache = sidebars_[card];
+    if (cache.chrome.size() != sidebar.size() || cache.title != title) {
+        cache.chrome.create(sidebar.size(), CV_8UC3);
+        cache.chrome.setTo(kSidebarBackground);
+        drawLabelChrome(cache.chrome, title);
+        cache.title = title;
+        cache.image.release();
     }
-
-    cv::Mat sidebar(content.rows, kSidebarWidth, CV_8UC3, kSidebarBackground);
-    drawLabelBlock(sidebar, title, lines);
-    cv::line(sidebar, {0, 0}, {0, sidebar.rows - 1}, kSidebarBorder, 1, cv::LINE_AA);
-
-    cv::Mat card;
-    cv::hconcat(content, sidebar, card);
-    return card;
+    if (cache.image.empty() || cache.lines != lines) {
+        cache.chrome.copyTo(cache.image);
+        drawLabelLines(cache.image, lines);
+        cv::line(cache.image, {0, 0}, {0, cache.image.rows - 1}, kSidebarBorder, 1, cv::LINE_AA);
+        cache.lines = std::move(lines);
+    }
+    cache.image.copyTo(sidebar);
 }
 
-cv::Mat DebugRenderer::ensureColor(const cv::Mat &frame) {
-    if (frame.empty()) {
-        return cv::Mat();
+cv::Mat DebugRenderer::buildProfileStrip(const pipeline::StageProfileSnapshot &profile, int width) {
+    cv::Mat strip(profileStripHeight(profile), width, CV_8UC3, kSidebarBackground);
+    cv::line(strip, {0, 0}, {strip.cols - 1, 0}, kSidebarBorder, 1, cv::LINE_AA);
+    cv::putText(strip, "Perfil (ms) p50 / p95 / p99 / max  - " + std::to_string(profile.frames) +
+                           " frames",
+                {12, 22}, cv::FONT_HERSHEY_SIMPLEX, 0.52, {255, 255, 255}, 1, cv::LINE_AA);
+
+    const int column_width = width / kProfileColumns;
+    for (std::size_t index = 0; index < profile.stages.size(); ++index) {
+        const pipeline::StageLatencySummary &stage = profile.stages[index];
+        const int column = static_cast<int>(index) % kProfileColumns;
+        const int row = static_cast<int>(index) / kProfileColumns;
+        const std::string line = std::string(pipeline::toString(stage.stage)) + ": " +
+                                 formatDouble(stage.p50_ms, 2) + " / " + formatDouble(stage.p95_ms, 2) +
+                                 " / " + formatDouble(stage.p99_ms, 2) + " / " +
+                                 formatDouble(stage.max_ms, 2);
+        cv::putText(strip, line, {12 + (column * column_width), 44 + (row * kProfileRowHeight)},
+                    cv::FONT_HERSHEY_SIMPLEX, 0.42, {220, 220, 220}, 1, cv::LINE_AA);
     }
+    return strip;
+}
+
+void DebugRenderer::copyAsColor(const cv::Mat &frame, cv::Mat target) {
     if (frame.channels() == 3) {
-        return frame.clone();
+        frame.copyTo(target);
+    } else {
+        cv::cvtColor(frame, target, cv::COLOR_GRAY2BGR);
     }
-    cv::Mat color;
-    cv::cvtColor(frame, color, cv::COLOR_GRAY2BGR);
-    return color;
 }
 
-void DebugRenderer::drawLabelBlock(cv::Mat &image, const std::string &title,
-                                   const std::vector<std::string> &lines) {
+void DebugRenderer::drawLabelChrome(cv::Mat &image, const std::string &title) {
     if (image.empty()) {
         return;
     }
@@ -326,7 +396,9 @@ void DebugRenderer::drawLabelBlock(cv::Mat &image, const std::string &title,
     cv::rectangle(image, {10, 10}, {image.cols - 11, 42}, {0, 0, 0}, cv::FILLED);
     cv::putText(image, title, {18, 33}, cv::FONT_HERSHEY_SIMPLEX, 0.62, {255, 255, 255}, 2,
                 cv::LINE_AA);
+}
 
+void DebugRenderer::drawLabelLines(cv::Mat &image, const std::vector<std::string> &lines) {
     int y = 60;
     for (const std::string &line : lines) {
         cv::putText(image, line, {18, y}, cv::FONT_HERSHEY_SIMPLEX, 0.48, {220, 220, 220}, 1,
@@ -2,39 +2,69 @@
 
 #include <opencv2/core.hpp>
 
+#include <array>
+#include <cstddef>
+#include <mutex>
 #include <string>
 #include <vector>
 
 #include "config/LabConfig.hpp"
 #include "pipeline/RoadSegmentationResult.hpp"
+#include "pipeline/StageProfiler.hpp"
 
 namespace road_segmentation_lab::render {
 
+// Paineis de debug da segmentacao. As views isoladas saem em Mats novos; o painel completo e
+// desenhado num canvas so, com cada tile pintado direto no seu ROI, e as barras laterais dos
+// cards ficam retidas entre chamadas: o cromo (fundo, borda e titulo) e composto uma vez por
+// tamanho e as linhas de texto so sao redesenhadas quando mudam. Pode ser chamado de varias
+// threads; so as barras laterais sao compartilhadas, atras de um mutex.
 class DebugRenderer {
 public:
+    // Com profile ligado, uma faixa com os percentis por estagio e anexada abaixo do painel.
     cv::Mat render(const pipeline::RoadSegmentationResult &result,
                    const config::LabConfig &config, const std::string &source_label,
-                   const std::string &calibration_status) const;
+                   const std::string &calibration_status,
+                   const pipeline::StageProfileSnapshot *profile = nullptr) const;
+    // Tamanho do painel de render(); vazio sem frame.
+    cv::Size panelSize(const pipeline::RoadSegmentationResult &result,
+                       const pipeline::StageProfileSnapshot *profile = nullptr) const;
+    // Mesmo painel de render(), desenhado em panel (por exemplo um ROI do canvas de quem chama),
+    // que deve ser CV_8UC3 com panelSize().
+    void renderInto(cv::Mat &panel, const pipeline::RoadSegmentationResult &result,
+                    const config::LabConfig &config, const std::string &source_label,
+                    const std::string &calibration_status,
+                    const pipeline::StageProfileSnapshot *profile = nullptr) const;
     cv::Mat renderRawView(const pipeline::RoadSegmentationResult &result) const;
     cv::Mat renderPreprocessView(const pipeline::RoadSegmentationResult &result) const;
     cv::Mat renderMaskView(const pipeline::RoadSegmentationResult &result) const;
     cv::Mat renderAnnotatedView(const pipeline::RoadSegmentationResult &result) const;
 
 private:
-    cv::Mat buildOriginalTile(const pipeline::RoadSegmentationResult &result,
-                              const std::string &source_label) const;
-    cv::Mat buildPreprocessTile(const pipeline::RoadSegmentationResult &result,
-                                const config::LabConfig &config,
-                                const std::string &calibration_status) const;
-    cv::Mat buildMaskTile(const pipeline::RoadSegmentationResult &result) const;
-    cv::Mat buildOutputTile(const pipeline::RoadSegmentationResult &result) const;
-    cv::Mat renderOriginalOverlayView(const pipeline::RoadSegmentationResult &result) const;
-
-    static cv::Mat composeTileCard(const cv::Mat &image, const std::string &title,
-                                   const std::vector<std::string> &lines);
-    static cv::Mat ensureColor(const cv::Mat &frame);
-    static void drawLabelBlock(cv::Mat &image, const std::string &title,
-                               const std::vector<std::string> &lines);
+    struct SidebarCache {
+        std::string title;
+        std::vector<std::string> lines;
+        cv::Mat chrome;
+        cv::Mat image;
+    };
+
+    static constexpr std::size_t kCardCount = 4;
+
+    // Os paint* desenham num tile CV_8UC3 do tamanho do frame, ja alocado.
+    static void paintPreprocessView(const pipeline::RoadSegmentationResult &result, cv::Mat tile);
+    static void paintMaskView(const pipeline::RoadSegmentationResult &result, cv::Mat tile);
+    static void paintAnnotations(const pipeline::RoadSegmentationResult &result, cv::Mat tile);
+    static void paintOriginalOverlay(const pipeline::RoadSegmentationResult &result, cv::Mat tile);
+    void paintSidebar(cv::Mat sidebar, std::size_t card, const std::string &title,
+                      std::vector<std::string> lines) const;
+    static cv::Mat buildProfileStrip(const pipeline::StageProfileSnapshot &profile, int width);
+
+    static void copyAsColor(const cv::Mat &frame, cv::Mat target);
+    static void drawLabelChrome(cv::Mat &image, const std::string &title);
+    static void drawLabelLines(cv::Mat &image, const std::vector<std::string> &lines);
+
+    mutable std::mutex sidebar_mutex_;
+    mutable std::array<SidebarCache, kCardCount> sidebars_;
 };
 
 } // namespace road_segmentation_lab::render
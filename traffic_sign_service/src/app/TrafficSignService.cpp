@@ -34,6 +34,10 @@ TrafficSignService::TrafficSignService(config::ServiceConfig config,
       now_provider_{now_provider ? std::move(now_provider) : NowProvider(defaultNowMs)} {
     transport_->setOpenHandler([this]() { handleTransportOpened(); });
     transport_->setMessageHandler([this](const std::string &payload) { handleTransportMessage(payload); });
+    transport_->setBinaryMessageHandler(
+        [this](std::string payload) { handleBinaryTransportMessage(std::move(payload)); });
+    transport_->setFrameHandler(
+        [this](vision::VisionFrameMessage frame) { acceptFrame(std::move(frame)); });
 }
 
 TrafficSignService::~TrafficSignService() { stop(); }
@@ -64,17 +68,29 @@ void TrafficSignService::stop() {
 
 void TrafficSignService::handleTransportOpened() {
     const bool registered = transport_->sendText("client:telemetry");
+    if (transport_->deliversFramesLocally()) {
+        // Frames chegam pela memoria compartilhada; o WebSocket fica so com telemetria e sinais.
+        std::cout << "[service] client:telemetry => " << (registered ? "ok" : "falhou")
+                  << " (frames via memoria compartilhada)" << std::endl;
+        return;
+    }
+
+    // Antes do subscribe para que o primeiro frame ja venha binario; um carro antigo ignora
+    // o pedido e continua mandando JSON, que tambem e aceito.
+    const bool binary_format = transport_->sendText("stream:format=binary");
     const bool subscribed = transport_->sendText("stream:subscribe=raw");
 
     std::cout << "[service] client:telemetry => " << (registered ? "ok" : "falhou")
               << std::endl;
+    std::cout << "[service] stream:format=binary => " << (binary_format ? "ok" : "falhou")
+              << std::endl;
     std::cout << "[service] stream:subscribe=raw => " << (subscribed ? "ok" : "falhou")
               << std::endl;
 }
 
 void TrafficSignService::handleTransportMessage(const std::string &payload) {
     std::string parse_error;
-    const auto frame = vision::parseVisionFrameMessage(payload, &parse_error);
+    auto frame = vision::parseVisionFrameMessage(payload, &parse_error);
     if (!frame) {
         if (!parse_error.empty()) {
             std::cerr << "[service] payload ignorado: " << parse_error << std::endl;
@@ -82,9 +98,24 @@ void TrafficSignService::handleTransportMessage(const std::string &payload) {
         return;
     }
 
-    std::cout << "[service] frame raw recebido em " << frame->timestamp_ms << " ms"
+    acceptFrame(std::move(*frame));
+}
+
+void TrafficSignService::handleBinaryTransportMessage(std::string payload) {
+    std::string parse_error;
+    auto frame = vision::parseBinaryVisionFrame(std::move(payload), &parse_error);
+    if (!frame) {
+        std::cerr << "[service] frame binario ignorado: " << parse_error << std::endl;
+        return;
+    }
+
+    acceptFrame(std::move(*frame));
+}
+
+void TrafficSignService::acceptFrame(vision::VisionFrameMessage frame) {
+    std::cout << "[service] frame raw recebido em " << frame.timestamp_ms << " ms"
               << std::endl;
-    latest_frame_store_.push(*frame);
+    latest_frame_store_.push(std::move(frame));
 }
 
 void TrafficSignService::inferenceLoop() {
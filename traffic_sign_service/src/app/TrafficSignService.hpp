@@ -34,8 +34,10 @@ public:
 
     void handleTransportOpened();
     void handleTransportMessage(const std::string &payload);
+    void handleBinaryTransportMessage(std::string payload);
 
 private:
+    void acceptFrame(vision::VisionFrameMessage frame);
     void inferenceLoop();
     std::optional<SignalDetection> selectPrimaryDetection(
         const std::vector<SignalDetection> &detections) const;
@@ -1,13 +1,16 @@
 #pragma once
 
 #include <atomic>
-#include <condition_variable>
 #include <cstdint>
-#include <mutex>
 #include <optional>
+#include <utility>
+
+#include "concurrency/LatestValueChannel.hpp"
 
 namespace traffic_sign_service::concurrency {
 
+// Ultimo frame recebido pelo transporte, consumido pela thread de inferencia. push() vem
+// sempre da thread do transporte e as leituras sempre da thread de inferencia.
 template <typename T>
 class LatestFrameStore {
 public:
@@ -17,38 +20,34 @@ public:
     };
 
     std::uint64_t push(T value) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        latest_ = Snapshot{++generation_, std::move(value)};
-        cv_.notify_all();
-        return generation_;
+        const std::uint64_t generation = ++generation_;
+        channel_.offer(Snapshot{generation, std::move(value)});
+        return generation;
     }
 
-    std::optional<Snapshot> latest() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return latest_;
-    }
+    // Frame mais novo ainda nao consumido, sem bloquear.
+    std::optional<Snapshot> latest() { return channel_.tryPop(); }
 
     std::optional<Snapshot> waitForNext(std::uint64_t last_seen_generation,
                                         const std::atomic<bool> &running) {
-        std::unique_lock<std::mutex> lock(mutex_);
-        cv_.wait(lock, [&] {
-            return generation_ > last_seen_generation || !running.load();
-        });
-
-        if (generation_ <= last_seen_generation) {
-            return std::nullopt;
+        while (true) {
+            auto snapshot = channel_.waitPop([&] { return !running.load(); });
+            if (!snapshot) {
+                return std::nullopt;
+            }
+            if (snapshot->generation > last_seen_generation) {
+                return snapshot;
+            }
         }
-
-        return latest_;
     }
 
-    void notifyAll() { cv_.notify_all(); }
+    void notifyAll() { channel_.notifyAll(); }
+
+    [[nodiscard]] std::uint64_t droppedCount() const noexcept { return channel_.droppedCount(); }
 
 private:
-    mutable std::mutex mutex_;
-    mutable std::condition_variable cv_;
     std::uint64_t generation_{0};
-    std::optional<Snapshot> latest_;
+    shared::concurrency::LatestValueChannel<Snapshot> channel_;
 };
 
 } // namespace traffic_sign_service::concurrency
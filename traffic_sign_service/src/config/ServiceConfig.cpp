@@ -192,6 +192,22 @@ bool loadServiceConfigFromFile(const std::string &path, ServiceConfig &config,
             continue;
         }
 
+        if (key == "LOCAL_FRAME_RING") {
+            if (value.empty()) {
+                loaded.local_frame_ring_name.clear();
+                continue;
+            }
+            // shm_open aceita so "/nome"; a barra inicial e opcional no arquivo.
+            const std::string name = value.front() == '/' ? value : "/" + value;
+            if (name.size() < 2 || name.find('/', 1) != std::string::npos) {
+                pushWarning(warnings, "LOCAL_FRAME_RING invalido: " + value);
+                success = false;
+                continue;
+            }
+            loaded.local_frame_ring_name = name;
+            continue;
+        }
+
         pushWarning(warnings, "Chave desconhecida em service.env: " + key);
     }
 
@@ -16,6 +16,8 @@ struct ServiceConfig {
     std::uint64_t detection_cooldown_ms{2000};
     double inference_max_fps{5.0};
     bool frame_preview_enabled{false};
+    // Nome do anel de frames crus do carro na mesma maquina; vazio recebe frames pelo WebSocket.
+    std::string local_frame_ring_name;
 };
 
 bool loadServiceConfigFromFile(const std::string &path, ServiceConfig &config,
@@ -1,13 +1,16 @@
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <csignal>
 #include <iostream>
+#include <memory>
 #include <thread>
 #include <vector>
 
 #include "app/TrafficSignService.hpp"
 #include "config/ServiceConfig.hpp"
 #include "edge_impulse/EdgeImpulseClassifier.hpp"
+#include "transport/SharedMemoryVehicleTransport.hpp"
 #include "transport/VehicleWebSocketClient.hpp"
 
 namespace {
@@ -38,9 +41,16 @@ int main(int argc, char **argv) {
     std::signal(SIGINT, handleSignal);
     std::signal(SIGTERM, handleSignal);
 
-    auto transport =
+    std::unique_ptr<traffic_sign_service::transport::IVehicleTransport> transport =
         std::make_unique<traffic_sign_service::transport::VehicleWebSocketClient>(
             config.vehicle_ws_url);
+    if (!config.local_frame_ring_name.empty()) {
+        transport =
+            std::make_unique<traffic_sign_service::transport::SharedMemoryVehicleTransport>(
+                config.local_frame_ring_name, std::move(transport),
+                std::chrono::milliseconds(
+                    static_cast<long long>(1000.0 / std::max(config.inference_max_fps, 0.1))));
+    }
     auto classifier =
         std::make_unique<traffic_sign_service::edge_impulse::EdgeImpulseClassifier>();
 
@@ -48,7 +58,12 @@ int main(int argc, char **argv) {
         config, std::move(transport), std::move(classifier));
 
     std::cout << "traffic_sign_service iniciado." << std::endl;
-    std::cout << "Consumindo raw de " << config.vehicle_ws_url << std::endl;
+    if (config.local_frame_ring_name.empty()) {
+        std::cout << "Consumindo raw de " << config.vehicle_ws_url << std::endl;
+    } else {
+        std::cout << "Consumindo raw do anel " << config.local_frame_ring_name
+                  << "; sinais via " << config.vehicle_ws_url << std::endl;
+    }
     std::cout << "Modelo configurado em " << config.edge_impulse_model_zip_path << std::endl;
     std::cout << "Preview de frame: "
               << (config.frame_preview_enabled ? "habilitado" : "desabilitado")
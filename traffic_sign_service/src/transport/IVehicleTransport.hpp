@@ -3,20 +3,32 @@
 #include <functional>
 #include <string>
 
+#include "vision/VisionFrame.hpp"
+
 namespace traffic_sign_service::transport {
 
 class IVehicleTransport {
 public:
     using MessageHandler = std::function<void(const std::string &)>;
+    // Frames com opcode binario; recebe o payload por valor para o parser reaproveitar o buffer.
+    using BinaryMessageHandler = std::function<void(std::string)>;
     using OpenHandler = std::function<void()>;
+    // Frames que chegam por fora do canal de texto, ja decodificados pelo transporte.
+    using FrameHandler = std::function<void(vision::VisionFrameMessage)>;
 
     virtual ~IVehicleTransport() = default;
 
     virtual void setMessageHandler(MessageHandler handler) = 0;
+    virtual void setBinaryMessageHandler(BinaryMessageHandler handler) = 0;
     virtual void setOpenHandler(OpenHandler handler) = 0;
     virtual void start() = 0;
     virtual void stop() = 0;
     virtual bool sendText(const std::string &payload) = 0;
+
+    // Transportes que entregam frames localmente (memoria compartilhada) dispensam o
+    // stream:subscribe no WebSocket.
+    virtual void setFrameHandler(FrameHandler) {}
+    [[nodiscard]] virtual bool deliversFramesLocally() const { return false; }
 };
 
 } // namespace traffic_sign_service::transport
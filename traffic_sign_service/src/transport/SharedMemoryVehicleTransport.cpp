@@ -0,0 +1,95 @@
+#include "transport/SharedMemoryVehicleTransport.hpp"
+
+#include <cstdint>
+#include <iostream>
+#include <utility>
+
+#include "frame_transport/SharedFrameRing.hpp"
+
+namespace traffic_sign_service::transport {
+
+SharedMemoryVehicleTransport::SharedMemoryVehicleTransport(
+    std::string ring_name, std::unique_ptr<IVehicleTransport> control,
+    std::chrono::milliseconds min_frame_interval)
+    : ring_name_{std::move(ring_name)},
+      control_{std::move(control)},
+      min_frame_interval_{min_frame_interval} {}
+
+SharedMemoryVehicleTransport::~SharedMemoryVehicleTransport() { stop(); }
+
+void SharedMemoryVehicleTransport::setMessageHandler(MessageHandler handler) {
+    control_->setMessageHandler(std::move(handler));
+}
+
+void SharedMemoryVehicleTransport::setBinaryMessageHandler(BinaryMessageHandler handler) {
+    control_->setBinaryMessageHandler(std::move(handler));
+}
+
+void SharedMemoryVehicleTransport::setOpenHandler(OpenHandler handler) {
+    control_->setOpenHandler(std::move(handler));
+}
+
+void SharedMemoryVehicleTransport::setFrameHandler(FrameHandler handler) {
+    frame_handler_ = std::move(handler);
+}
+
+void SharedMemoryVehicleTransport::start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+
+    reader_thread_ = std::thread(&SharedMemoryVehicleTransport::readLoop, this);
+    control_->start();
+}
+
+void SharedMemoryVehicleTransport::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    if (reader_thread_.joinable()) {
+        reader_thread_.join();
+    }
+    control_->stop();
+}
+
+bool SharedMemoryVehicleTransport::sendText(const std::string &payload) {
+    return control_->sendText(payload);
+}
+
+void SharedMemoryVehicleTransport::readLoop() {
+    shared::frame_transport::SharedFrameRingReader reader(ring_name_);
+    reader.setMinPublishInterval(min_frame_interval_);
+
+    std::uint64_t last_sequence = 0;
+    bool was_attached = false;
+    while (running_.load()) {
+        std::string pixels;
+        // Timeout curto para reavaliar running_ e renovar o heartbeat visto pelo escritor.
+        const auto info = reader.waitNext(last_sequence, pixels, std::chrono::milliseconds(100));
+        if (reader.attached() != was_attached) {
+            was_attached = reader.attached();
+            std::cout << "[shm] anel " << ring_name_
+                      << (was_attached ? " conectado" : " desconectado") << std::endl;
+        }
+        if (!info) {
+            continue;
+        }
+        last_sequence = info->sequence;
+
+        vision::VisionFrameMessage frame;
+        frame.view = "raw";
+        frame.timestamp_ms = static_cast<std::uint64_t>(info->timestamp_ms);
+        frame.width = info->width;
+        frame.height = info->height;
+        frame.data = std::move(pixels);
+        frame.encoding = info->format == shared::frame_transport::PixelFormat::Gray8
+                             ? vision::VisionFrameEncoding::Gray8
+                             : vision::VisionFrameEncoding::Bgr8;
+        if (frame_handler_) {
+            frame_handler_(std::move(frame));
+        }
+    }
+}
+
+} // namespace traffic_sign_service::transport
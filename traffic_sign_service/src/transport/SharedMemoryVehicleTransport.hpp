@@ -0,0 +1,41 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "transport/IVehicleTransport.hpp"
+
+namespace traffic_sign_service::transport {
+
+// Frames crus pelo anel VISION_LOCAL_FRAME_RING numa thread propria; o texto segue no control.
+class SharedMemoryVehicleTransport : public IVehicleTransport {
+public:
+    // min_frame_interval e repassado ao escritor do anel.
+    SharedMemoryVehicleTransport(std::string ring_name, std::unique_ptr<IVehicleTransport> control,
+                                 std::chrono::milliseconds min_frame_interval);
+    ~SharedMemoryVehicleTransport() override;
+
+    void setMessageHandler(MessageHandler handler) override;
+    void setBinaryMessageHandler(BinaryMessageHandler handler) override;
+    void setOpenHandler(OpenHandler handler) override;
+    void setFrameHandler(FrameHandler handler) override;
+    void start() override;
+    void stop() override;
+    bool sendText(const std::string &payload) override;
+    [[nodiscard]] bool deliversFramesLocally() const override { return true; }
+
+private:
+    void readLoop();
+
+    std::string ring_name_;
+    std::unique_ptr<IVehicleTransport> control_;
+    std::chrono::milliseconds min_frame_interval_;
+    FrameHandler frame_handler_;
+    std::atomic<bool> running_{false};
+    std::thread reader_thread_;
+};
+
+} // namespace traffic_sign_service::transport
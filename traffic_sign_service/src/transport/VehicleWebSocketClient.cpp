@@ -16,6 +16,11 @@ void VehicleWebSocketClient::setMessageHandler(MessageHandler handler) {
     message_handler_ = std::move(handler);
 }
 
+void VehicleWebSocketClient::setBinaryMessageHandler(BinaryMessageHandler handler) {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    binary_message_handler_ = std::move(handler);
+}
+
 void VehicleWebSocketClient::setOpenHandler(OpenHandler handler) {
     std::lock_guard<std::mutex> lock(state_mutex_);
     open_handler_ = std::move(handler);
@@ -104,6 +109,20 @@ void VehicleWebSocketClient::runLoop() {
 
         client.set_message_handler([this](websocketpp::connection_hdl,
                                           Client::message_ptr message) {
+            if (message->get_opcode() == websocketpp::frame::opcode::binary) {
+                BinaryMessageHandler handler;
+                {
+                    std::lock_guard<std::mutex> lock(state_mutex_);
+                    handler = binary_message_handler_;
+                }
+
+                if (handler) {
+                    // A mensagem e descartada depois do handler; o payload pode ser movido.
+                    handler(std::move(message->get_raw_payload()));
+                }
+                return;
+            }
+
             MessageHandler handler;
             {
                 std::lock_guard<std::mutex> lock(state_mutex_);
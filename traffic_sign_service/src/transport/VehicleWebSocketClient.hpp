@@ -19,6 +19,7 @@ public:
     ~VehicleWebSocketClient() override;
 
     void setMessageHandler(MessageHandler handler) override;
+    void setBinaryMessageHandler(BinaryMessageHandler handler) override;
     void setOpenHandler(OpenHandler handler) override;
     void start() override;
     void stop() override;
@@ -36,6 +37,7 @@ private:
 
     mutable std::mutex state_mutex_;
     MessageHandler message_handler_;
+    BinaryMessageHandler binary_message_handler_;
     OpenHandler open_handler_;
     Client *active_client_{nullptr};
     websocketpp::connection_hdl active_connection_;
@@ -1,8 +1,10 @@
 #include "vision/FrameDecoder.hpp"
 
+#include <algorithm>
 #include <vector>
 
 #include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
 
 #include "vision/Base64.hpp"
 
@@ -17,18 +19,57 @@ void setError(std::string *error, const std::string &message) {
 } // namespace
 
 namespace traffic_sign_service::vision {
+namespace {
+
+cv::Mat wrapPixelFrame(const VisionFrameMessage &frame, std::string *error) {
+    const bool color = frame.encoding == VisionFrameEncoding::Bgr8;
+    const std::size_t expected_size = static_cast<std::size_t>(std::max(frame.width, 0)) *
+                                      static_cast<std::size_t>(std::max(frame.height, 0)) *
+                                      (color ? 3 : 1);
+    if (expected_size == 0 || frame.data.size() != expected_size) {
+        setError(error, "Frame cru com tamanho incompativel com width x height.");
+        return {};
+    }
+
+    cv::Mat pixels(frame.height, frame.width, color ? CV_8UC3 : CV_8UC1,
+                   const_cast<char *>(frame.data.data()));
+    if (color) {
+        return pixels;
+    }
+
+    // O classificador espera BGR, como o imdecode com IMREAD_COLOR.
+    cv::Mat converted;
+    cv::cvtColor(pixels, converted, cv::COLOR_GRAY2BGR);
+    return converted;
+}
+
+} // namespace
 
 cv::Mat decodeVisionFrameImage(const VisionFrameMessage &frame, std::string *error) {
-    auto bytes = decodeBase64(frame.data, error);
-    if (bytes.empty()) {
-        if (!frame.data.empty()) {
+    if (frame.encoding == VisionFrameEncoding::Bgr8 || frame.encoding == VisionFrameEncoding::Gray8) {
+        return wrapPixelFrame(frame, error);
+    }
+
+    std::vector<unsigned char> bytes;
+    cv::Mat encoded;
+    if (frame.encoding == VisionFrameEncoding::Jpeg) {
+        // imdecode so le o buffer; nao ha copia dos bytes do JPEG.
+        encoded = cv::Mat(1, static_cast<int>(frame.data.size()), CV_8UC1,
+                          const_cast<char *>(frame.data.data()));
+    } else {
+        bytes = decodeBase64(frame.data, error);
+        if (!bytes.empty()) {
+            encoded = cv::Mat(1, static_cast<int>(bytes.size()), CV_8UC1, bytes.data());
+        } else if (!frame.data.empty()) {
             return {};
         }
+    }
+
+    if (encoded.empty()) {
         setError(error, "Frame sem bytes decodificados.");
         return {};
     }
 
-    cv::Mat encoded(1, static_cast<int>(bytes.size()), CV_8UC1, bytes.data());
     cv::Mat decoded = cv::imdecode(encoded, cv::IMREAD_COLOR);
     if (decoded.empty()) {
         setError(error, "Falha ao decodificar JPEG do frame.");
@@ -8,6 +8,7 @@
 
 namespace traffic_sign_service::vision {
 
+// Frames Bgr8 viram um cv::Mat sobre frame.data, sem copia: valido enquanto o frame existir.
 cv::Mat decodeVisionFrameImage(const VisionFrameMessage &frame, std::string *error = nullptr);
 
 } // namespace traffic_sign_service::vision
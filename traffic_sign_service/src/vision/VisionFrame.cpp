@@ -20,6 +20,19 @@ bool isNonNegativeInteger(const nlohmann::json &value) {
     return value.is_number_integer() && value.get<std::int64_t>() >= 0;
 }
 
+constexpr std::size_t kBinaryHeaderSize = 24;
+constexpr unsigned char kBinaryVersion = 1;
+constexpr unsigned char kBinaryViewRaw = 0;
+constexpr unsigned char kBinaryCodecJpeg = 1;
+
+std::uint64_t readBigEndian(const std::string &payload, std::size_t offset, std::size_t bytes) {
+    std::uint64_t value = 0;
+    for (std::size_t index = 0; index < bytes; ++index) {
+        value = (value << 8) | static_cast<unsigned char>(payload[offset + index]);
+    }
+    return value;
+}
+
 } // namespace
 
 namespace traffic_sign_service::vision {
@@ -85,4 +98,52 @@ std::optional<VisionFrameMessage> parseVisionFrameMessage(const std::string &pay
     };
 }
 
+std::optional<VisionFrameMessage> parseBinaryVisionFrame(std::string payload,
+                                                         std::string *error) {
+    if (payload.size() < kBinaryHeaderSize || payload.compare(0, 2, "VF") != 0) {
+        setError(error, "Frame binario sem cabecalho VF.");
+        return std::nullopt;
+    }
+
+    if (static_cast<unsigned char>(payload[2]) != kBinaryVersion) {
+        setError(error, "Versao de frame binario nao suportada.");
+        return std::nullopt;
+    }
+
+    if (static_cast<unsigned char>(payload[3]) != kBinaryViewRaw) {
+        setError(error, "Apenas view raw e suportada pelo servico.");
+        return std::nullopt;
+    }
+
+    if (static_cast<unsigned char>(payload[4]) != kBinaryCodecJpeg) {
+        setError(error, "Codec de frame binario nao suportado.");
+        return std::nullopt;
+    }
+
+    const auto width = static_cast<int>(readBigEndian(payload, 16, 2));
+    const auto height = static_cast<int>(readBigEndian(payload, 18, 2));
+    if (width <= 0 || height <= 0) {
+        setError(error, "Dimensoes do frame invalidas.");
+        return std::nullopt;
+    }
+
+    const auto image_size = readBigEndian(payload, 20, 4);
+    if (image_size == 0 || image_size != payload.size() - kBinaryHeaderSize) {
+        setError(error, "Tamanho do JPEG nao confere com o frame binario.");
+        return std::nullopt;
+    }
+
+    VisionFrameMessage frame;
+    frame.view = "raw";
+    frame.timestamp_ms = readBigEndian(payload, 8, 8);
+    frame.mime = "image/jpeg";
+    frame.width = width;
+    frame.height = height;
+    // Reaproveita o buffer da mensagem: so o cabecalho e removido.
+    payload.erase(0, kBinaryHeaderSize);
+    frame.data = std::move(payload);
+    frame.encoding = VisionFrameEncoding::Jpeg;
+    return frame;
+}
+
 } // namespace traffic_sign_service::vision
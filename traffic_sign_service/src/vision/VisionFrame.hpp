@@ -6,6 +6,10 @@
 
 namespace traffic_sign_service::vision {
 
+// JSON traz data em base64; o frame binario traz os bytes do JPEG direto em data. O anel em
+// memoria compartilhada entrega pixels crus, linhas compactas de width * canais bytes.
+enum class VisionFrameEncoding { Base64, Jpeg, Bgr8, Gray8 };
+
 struct VisionFrameMessage {
     std::string view;
     std::uint64_t timestamp_ms{0};
@@ -13,9 +17,16 @@ struct VisionFrameMessage {
     int width{0};
     int height{0};
     std::string data;
+    VisionFrameEncoding encoding{VisionFrameEncoding::Base64};
 };
 
 std::optional<VisionFrameMessage> parseVisionFrameMessage(const std::string &payload,
                                                           std::string *error = nullptr);
 
+// Frame binario do carro (stream:format=binary): cabecalho big-endian de 24 bytes
+// ("VF", versao, view, codec, reservado, timestamp_ms u64, width u16, height u16,
+// tamanho u32) seguido do JPEG.
+std::optional<VisionFrameMessage> parseBinaryVisionFrame(std::string payload,
+                                                         std::string *error = nullptr);
+
 } // namespace traffic_sign_service::vision
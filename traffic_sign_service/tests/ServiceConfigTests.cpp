@@ -23,7 +23,8 @@ void testConfigParsesFramePreviewFlag() {
         "traffic_sign_service_config.env",
         "VEHICLE_WS_URL=ws://127.0.0.1:8080\n"
         "EDGE_IMPULSE_MODEL_ZIP=../../edgeImpulse/model.zip\n"
-        "FRAME_PREVIEW_ENABLED=true\n");
+        "FRAME_PREVIEW_ENABLED=true\n"
+        "LOCAL_FRAME_RING=autonomous_car_frames\n");
 
     ServiceConfig config;
     std::vector<std::string> warnings;
@@ -32,6 +33,8 @@ void testConfigParsesFramePreviewFlag() {
     expect(loaded, "Config valida deve carregar com sucesso.");
     expect(config.frame_preview_enabled,
            "FRAME_PREVIEW_ENABLED=true deve habilitar o preview.");
+    expect(config.local_frame_ring_name == "/autonomous_car_frames",
+           "LOCAL_FRAME_RING deve ganhar a barra inicial do nome POSIX.");
 }
 
 void testConfigRejectsInvalidFramePreviewFlag() {
@@ -0,0 +1,109 @@
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "TestRegistry.hpp"
+#include "frame_transport/SharedFrameRing.hpp"
+#include "transport/SharedMemoryVehicleTransport.hpp"
+#include "vision/FrameDecoder.hpp"
+
+namespace {
+
+using traffic_sign_service::tests::TestRegistrar;
+using traffic_sign_service::tests::expect;
+using traffic_sign_service::transport::IVehicleTransport;
+using traffic_sign_service::transport::SharedMemoryVehicleTransport;
+using traffic_sign_service::vision::VisionFrameEncoding;
+using traffic_sign_service::vision::VisionFrameMessage;
+
+class RecordingControlTransport final : public IVehicleTransport {
+public:
+    void setMessageHandler(MessageHandler) override {}
+    void setBinaryMessageHandler(BinaryMessageHandler) override {}
+    void setOpenHandler(OpenHandler) override {}
+    void start() override { started_ = true; }
+    void stop() override { started_ = false; }
+    bool sendText(const std::string &payload) override {
+        sent_messages_.push_back(payload);
+        return true;
+    }
+
+    bool started() const { return started_; }
+    const std::vector<std::string> &sentMessages() const { return sent_messages_; }
+
+private:
+    bool started_{false};
+    std::vector<std::string> sent_messages_;
+};
+
+void testSharedMemoryTransportDeliversRawFrames() {
+    const std::string ring_name =
+        "/traffic_sign_service_test_" + std::to_string(getpid());
+    shared::frame_transport::SharedFrameRingWriter writer(ring_name);
+
+    auto *control = new RecordingControlTransport();
+    SharedMemoryVehicleTransport transport(ring_name, std::unique_ptr<IVehicleTransport>(control),
+                                           std::chrono::milliseconds(0));
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::optional<VisionFrameMessage> received;
+    transport.setFrameHandler([&](VisionFrameMessage frame) {
+        std::lock_guard<std::mutex> lock(mutex);
+        received = std::move(frame);
+        cv.notify_all();
+    });
+    transport.start();
+
+    expect(transport.deliversFramesLocally(),
+           "Transporte por memoria compartilhada deve entregar frames localmente.");
+    expect(control->started(), "Transporte de controle deve iniciar junto.");
+    expect(transport.sendText("client:telemetry") &&
+               control->sentMessages().back() == "client:telemetry",
+           "Texto deve seguir pelo transporte de controle.");
+
+    std::vector<std::uint8_t> pixels(6 * 4 * 3);
+    for (std::size_t index = 0; index < pixels.size(); ++index) {
+        pixels[index] = static_cast<std::uint8_t>(index);
+    }
+    shared::frame_transport::FrameView view{pixels.data(), 6, 4, 18,
+                                            shared::frame_transport::PixelFormat::Bgr8, 77};
+
+    // O escritor so copia depois que o leitor se anexa e manda heartbeat.
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    bool delivered = false;
+    while (!delivered && std::chrono::steady_clock::now() < deadline) {
+        writer.publish(view);
+        std::unique_lock<std::mutex> lock(mutex);
+        delivered = cv.wait_for(lock, std::chrono::milliseconds(20),
+                                [&] { return received.has_value(); });
+    }
+    transport.stop();
+
+    expect(delivered, "Frame publicado no anel deve chegar ao handler.");
+    expect(received->encoding == VisionFrameEncoding::Bgr8, "Frame deve chegar como BGR cru.");
+    expect(received->timestamp_ms == 77 && received->width == 6 && received->height == 4,
+           "Metadados do frame devem ser preservados.");
+    expect(received->data.size() == pixels.size() &&
+               static_cast<std::uint8_t>(received->data[20]) == 20,
+           "Pixels devem chegar sem alteracao.");
+
+    const cv::Mat image = traffic_sign_service::vision::decodeVisionFrameImage(*received);
+    expect(image.cols == 6 && image.rows == 4 && image.type() == CV_8UC3,
+           "Frame cru deve virar cv::Mat BGR sem passar por imdecode.");
+    expect(!control->started(), "Parar o transporte deve parar o controle.");
+}
+
+TestRegistrar shared_memory_transport_test("shared_memory_transport_delivers_raw_frames",
+                                           testSharedMemoryTransportDeliversRawFrames);
+
+} // namespace
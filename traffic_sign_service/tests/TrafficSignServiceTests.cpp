@@ -28,7 +28,14 @@ using traffic_sign_service::vision::encodeBase64;
 class FakeVehicleTransport final : public IVehicleTransport {
 public:
     void setMessageHandler(MessageHandler handler) override { message_handler_ = std::move(handler); }
+    void setBinaryMessageHandler(BinaryMessageHandler handler) override {
+        binary_message_handler_ = std::move(handler);
+    }
     void setOpenHandler(OpenHandler handler) override { open_handler_ = std::move(handler); }
+    void setFrameHandler(FrameHandler handler) override { frame_handler_ = std::move(handler); }
+    bool deliversFramesLocally() const override { return delivers_frames_locally_; }
+
+    void setDeliversFramesLocally(bool value) { delivers_frames_locally_ = value; }
 
     void start() override { started_ = true; }
 
@@ -58,6 +65,18 @@ public:
         }
     }
 
+    void emitBinaryMessage(std::string payload) {
+        if (binary_message_handler_) {
+            binary_message_handler_(std::move(payload));
+        }
+    }
+
+    void emitFrame(traffic_sign_service::vision::VisionFrameMessage frame) {
+        if (frame_handler_) {
+            frame_handler_(std::move(frame));
+        }
+    }
+
     bool waitForSentCount(std::size_t expected, std::chrono::milliseconds timeout) {
         std::unique_lock<std::mutex> lock(mutex_);
         return cv_.wait_for(lock, timeout,
@@ -71,7 +90,10 @@ public:
 
 private:
     MessageHandler message_handler_;
+    BinaryMessageHandler binary_message_handler_;
     OpenHandler open_handler_;
+    FrameHandler frame_handler_;
+    bool delivers_frames_locally_{false};
     bool started_{false};
     mutable std::mutex mutex_;
     mutable std::condition_variable cv_;
@@ -106,13 +128,29 @@ private:
     std::condition_variable cv_;
 };
 
-std::string buildValidVisionFramePayload() {
+std::vector<unsigned char> encodeTestJpeg() {
     cv::Mat image(8, 8, CV_8UC3, cv::Scalar(0, 0, 255));
     std::vector<unsigned char> encoded_bytes;
     cv::imencode(".jpg", image, encoded_bytes);
+    return encoded_bytes;
+}
 
+std::string buildValidVisionFramePayload() {
     return std::string(R"({"type":"vision.frame","view":"raw","timestamp_ms":1,"mime":"image/jpeg","width":8,"height":8,"data":")") +
-           encodeBase64(encoded_bytes) + R"("})";
+           encodeBase64(encodeTestJpeg()) + R"("})";
+}
+
+std::string buildValidBinaryVisionFrame() {
+    const auto jpeg = encodeTestJpeg();
+    std::string payload("VF\x01\x00\x01\x00\x00\x00"
+                        "\x00\x00\x00\x00\x00\x00\x00\x01"
+                        "\x00\x08\x00\x08",
+                        20);
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        payload.push_back(static_cast<char>((jpeg.size() >> shift) & 0xFF));
+    }
+    payload.append(jpeg.begin(), jpeg.end());
+    return payload;
 }
 
 SignalDetection makeStopDetection() {
@@ -134,25 +172,81 @@ void testServiceSubscribesOnOpenAndReconnect() {
 
     service.start();
     transport->emitOpen();
-    expect(transport->waitForSentCount(2, std::chrono::milliseconds(250)),
+    expect(transport->waitForSentCount(3, std::chrono::milliseconds(250)),
            "Ao abrir o socket o servico deve se registrar como telemetry e assinar raw.");
 
     transport->emitOpen();
-    expect(transport->waitForSentCount(4, std::chrono::milliseconds(250)),
+    expect(transport->waitForSentCount(6, std::chrono::milliseconds(250)),
            "Ao reconectar o servico deve reenviar os comandos de registro e subscribe.");
 
     const auto sent_messages = transport->sentMessages();
     expect(sent_messages[0] == "client:telemetry", "Primeira mensagem deve registrar telemetry.");
-    expect(sent_messages[1] == "stream:subscribe=raw",
-           "Segunda mensagem deve assinar apenas a view raw.");
-    expect(sent_messages[2] == "client:telemetry",
+    expect(sent_messages[1] == "stream:format=binary",
+           "Segunda mensagem deve pedir frames binarios antes do subscribe.");
+    expect(sent_messages[2] == "stream:subscribe=raw",
+           "Terceira mensagem deve assinar apenas a view raw.");
+    expect(sent_messages[3] == "client:telemetry",
            "Reconexao deve repetir o registro telemetry.");
-    expect(sent_messages[3] == "stream:subscribe=raw",
+    expect(sent_messages[4] == "stream:format=binary",
+           "Reconexao deve repetir o pedido de frames binarios.");
+    expect(sent_messages[5] == "stream:subscribe=raw",
            "Reconexao deve repetir a assinatura raw.");
 
     service.stop();
 }
 
+void testServiceClassifiesBinaryFrames() {
+    auto *transport = new FakeVehicleTransport();
+    auto *classifier = new FakeClassifier({});
+
+    ServiceConfig config;
+    config.inference_max_fps = 60.0;
+    TrafficSignService service(config, std::unique_ptr<IVehicleTransport>(transport),
+                               std::unique_ptr<traffic_sign_service::ITrafficSignClassifier>(classifier),
+                               [] { return static_cast<std::uint64_t>(1000); });
+
+    service.start();
+    transport->emitBinaryMessage(buildValidBinaryVisionFrame());
+    expect(classifier->waitForInvocations(1, std::chrono::milliseconds(500)),
+           "Frame binario deve ser decodificado sem base64 e chegar ao classificador.");
+
+    service.stop();
+}
+
+void testServiceUsesLocalFramesWithoutSubscribe() {
+    auto *transport = new FakeVehicleTransport();
+    transport->setDeliversFramesLocally(true);
+    auto *classifier = new FakeClassifier({});
+
+    ServiceConfig config;
+    config.inference_max_fps = 60.0;
+    TrafficSignService service(config, std::unique_ptr<IVehicleTransport>(transport),
+                               std::unique_ptr<traffic_sign_service::ITrafficSignClassifier>(classifier),
+                               [] { return static_cast<std::uint64_t>(1000); });
+
+    service.start();
+    transport->emitOpen();
+    expect(transport->waitForSentCount(1, std::chrono::milliseconds(250)),
+           "Servico deve se registrar como telemetry mesmo com frames locais.");
+
+    traffic_sign_service::vision::VisionFrameMessage frame;
+    frame.view = "raw";
+    frame.timestamp_ms = 1;
+    frame.width = 8;
+    frame.height = 8;
+    frame.data.assign(8 * 8 * 3, '\x7f');
+    frame.encoding = traffic_sign_service::vision::VisionFrameEncoding::Bgr8;
+    transport->emitFrame(std::move(frame));
+    expect(classifier->waitForInvocations(1, std::chrono::milliseconds(500)),
+           "Frame cru do anel deve chegar ao classificador sem decodificacao JPEG.");
+
+    const auto sent_messages = transport->sentMessages();
+    expect(sent_messages.size() == 1 && sent_messages[0] == "client:telemetry",
+           "Com frames locais o servico nao deve assinar o stream do WebSocket.");
+
+    service.stop();
+}
+
 void testServiceEmitsSingleEventForStableDetection() {
     auto *transport = new FakeVehicleTransport();
     auto *classifier = new FakeClassifier({
@@ -175,7 +269,7 @@ void testServiceEmitsSingleEventForStableDetection() {
 
     service.start();
     transport->emitOpen();
-    expect(transport->waitForSentCount(2, std::chrono::milliseconds(250)),
+    expect(transport->waitForSentCount(3, std::chrono::milliseconds(250)),
            "Servico deve concluir handshake do consumidor telemetry.");
 
     const auto frame_payload = buildValidVisionFramePayload();
@@ -194,7 +288,7 @@ void testServiceEmitsSingleEventForStableDetection() {
     transport->emitMessage(frame_payload);
     expect(classifier->waitForInvocations(3, std::chrono::milliseconds(500)),
            "Terceiro frame deve chegar ao classificador.");
-    expect(transport->waitForSentCount(3, std::chrono::milliseconds(500)),
+    expect(transport->waitForSentCount(4, std::chrono::milliseconds(500)),
            "Deteccao confirmada deve gerar um unico signal:detected.");
 
     now_ms = 4000;
@@ -202,7 +296,7 @@ void testServiceEmitsSingleEventForStableDetection() {
     expect(classifier->waitForInvocations(4, std::chrono::milliseconds(500)),
            "Frames repetidos devem continuar sendo processados.");
     std::this_thread::sleep_for(std::chrono::milliseconds(50));
-    expect(transport->sentMessages().size() == 3,
+    expect(transport->sentMessages().size() == 4,
            "Mesma sequencia de frames nao deve gerar evento duplicado.");
 
     now_ms = 4100;
@@ -224,13 +318,13 @@ void testServiceEmitsSingleEventForStableDetection() {
     transport->emitMessage(frame_payload);
     expect(classifier->waitForInvocations(8, std::chrono::milliseconds(500)),
            "Nova aparicao 3 deve ser processada.");
-    expect(transport->waitForSentCount(4, std::chrono::milliseconds(500)),
+    expect(transport->waitForSentCount(5, std::chrono::milliseconds(500)),
            "Reaparicao estavel apos reset deve emitir novo evento.");
 
     const auto sent_messages = transport->sentMessages();
-    expect(sent_messages[2] == "signal:detected=stop",
-           "Primeiro evento emitido deve apontar para stop.");
     expect(sent_messages[3] == "signal:detected=stop",
+           "Primeiro evento emitido deve apontar para stop.");
+    expect(sent_messages[4] == "signal:detected=stop",
            "Reaparicao confirmada deve reenviar apenas o mesmo sinal canonical.");
 
     service.stop();
@@ -238,6 +332,10 @@ void testServiceEmitsSingleEventForStableDetection() {
 
 TestRegistrar service_open_test("traffic_sign_service_resubscribes_after_reconnect",
                                 testServiceSubscribesOnOpenAndReconnect);
+TestRegistrar service_binary_test("traffic_sign_service_classifies_binary_frames",
+                                  testServiceClassifiesBinaryFrames);
+TestRegistrar service_local_frames_test("traffic_sign_service_uses_local_frames_without_subscribe",
+                                        testServiceUsesLocalFramesWithoutSubscribe);
 TestRegistrar service_emit_test("traffic_sign_service_emits_single_signal_events",
                                 testServiceEmitsSingleEventForStableDetection);
 
@@ -1,3 +1,6 @@
+#include <cstdint>
+#include <string>
+
 #include "TestRegistry.hpp"
 #include "vision/VisionFrame.hpp"
 
@@ -6,7 +9,21 @@ namespace {
 using traffic_sign_service::tests::TestRegistrar;
 using traffic_sign_service::tests::expect;
 using traffic_sign_service::tests::expectEqual;
+using traffic_sign_service::vision::parseBinaryVisionFrame;
 using traffic_sign_service::vision::parseVisionFrameMessage;
+using traffic_sign_service::vision::VisionFrameEncoding;
+
+std::string binaryFrameHeader(char view, std::uint32_t image_size) {
+    std::string header("VF\x01", 3);
+    header.push_back(view);
+    header.append("\x01\x00\x00\x00", 4);
+    header.append("\x00\x00\x00\x00\x00\x00\x03\xE8", 8);
+    header.append("\x02\x80\x01\xE0", 4);
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        header.push_back(static_cast<char>((image_size >> shift) & 0xFF));
+    }
+    return header;
+}
 
 void testValidRawVisionFrameParses() {
     const std::string payload =
@@ -50,6 +67,30 @@ void testUnsupportedViewIsRejected() {
     expect(!error.empty(), "Erro deve indicar que a view nao e suportada.");
 }
 
+void testBinaryRawVisionFrameParses() {
+    std::string error;
+    const auto parsed = parseBinaryVisionFrame(binaryFrameHeader('\x00', 4) + "jpeg", &error);
+
+    expect(parsed.has_value(), "Frame binario raw valido deve ser aceito.");
+    expect(error.empty(), "Frame binario valido nao deve preencher erro.");
+    expect(parsed->timestamp_ms == 1000, "Timestamp deve vir do cabecalho big-endian.");
+    expect(parsed->width == 640 && parsed->height == 480,
+           "Dimensoes devem vir do cabecalho big-endian.");
+    expect(parsed->encoding == VisionFrameEncoding::Jpeg,
+           "Frame binario deve carregar os bytes do JPEG sem base64.");
+    expectEqual(parsed->data, "jpeg", "Payload deve conter somente os bytes apos o cabecalho.");
+}
+
+void testInvalidBinaryFramesAreRejected() {
+    std::string error;
+    expect(!parseBinaryVisionFrame(binaryFrameHeader('\x00', 8) + "jpeg", &error).has_value(),
+           "Tamanho declarado diferente do JPEG deve ser rejeitado.");
+    expect(!error.empty(), "Erro deve explicar o tamanho divergente.");
+    expect(!parseBinaryVisionFrame(binaryFrameHeader('\x03', 4) + "jpeg").has_value(),
+           "Views fora de raw nao devem entrar no servico.");
+    expect(!parseBinaryVisionFrame("VF").has_value(), "Cabecalho truncado deve ser rejeitado.");
+}
+
 TestRegistrar vision_frame_valid_test("vision_frame_parser_accepts_raw_messages",
                                       testValidRawVisionFrameParses);
 TestRegistrar vision_frame_json_test("vision_frame_parser_rejects_invalid_json",
@@ -58,5 +99,9 @@ TestRegistrar vision_frame_base64_test("vision_frame_parser_rejects_invalid_base
                                        testInvalidBase64IsRejected);
 TestRegistrar vision_frame_view_test("vision_frame_parser_rejects_unsupported_view",
                                      testUnsupportedViewIsRejected);
+TestRegistrar vision_frame_binary_test("vision_frame_parser_accepts_binary_raw_frames",
+                                       testBinaryRawVisionFrameParses);
+TestRegistrar vision_frame_binary_invalid_test("vision_frame_parser_rejects_invalid_binary_frames",
+                                               testInvalidBinaryFramesAreRejected);
 
 } // namespace